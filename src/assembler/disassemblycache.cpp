@@ -0,0 +1,25 @@
+#include "disassemblycache.h"
+
+namespace Ripes {
+namespace Assembler {
+
+OpDisassembleResult DisassemblyCache::disassemble(
+    AInt address, VInt word, const AssemblerBase &assembler,
+    const ReverseSymbolMap &symbols) {
+  std::lock_guard lock(m_lock);
+  auto it = m_entries.find(address);
+  if (it != m_entries.end() && it->second.word == word)
+    return it->second.result;
+
+  auto result = assembler.disassemble(word, symbols, address);
+  m_entries[address] = {word, result};
+  return result;
+}
+
+void DisassemblyCache::clear() {
+  std::lock_guard lock(m_lock);
+  m_entries.clear();
+}
+
+} // namespace Assembler
+} // namespace Ripes
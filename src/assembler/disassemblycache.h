@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "assemblerbase.h"
+
+namespace Ripes {
+namespace Assembler {
+
+/**
+ * @brief The DisassemblyCache class
+ * Memoizes the disassembly of instruction words by address. An entry is only
+ * valid for the instruction word which it was disassembled from, so writes to
+ * the text section (i.e., self-modifying programs) are reflected upon the next
+ * lookup of the written address, without any explicit invalidation. The
+ * disassembled strings are implicitly shared, such that all views which
+ * display an instruction share its storage.
+ *
+ * The cache must be cleared whenever the ISA or the symbols of the program
+ * change.
+ */
+class DisassemblyCache {
+public:
+  /**
+   * @brief disassemble
+   * @returns the disassembly of @p word located at @p address. On a miss, the
+   * word is disassembled through @p assembler.
+   */
+  OpDisassembleResult disassemble(AInt address, VInt word,
+                                  const AssemblerBase &assembler,
+                                  const ReverseSymbolMap &symbols);
+  void clear();
+
+private:
+  struct Entry {
+    VInt word;
+    OpDisassembleResult result;
+  };
+
+  std::unordered_map<AInt, Entry> m_entries;
+  // Views may disassemble from the GUI thread while the processor runs.
+  std::mutex m_lock;
+};
+
+} // namespace Assembler
+} // namespace Ripes
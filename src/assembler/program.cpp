@@ -68,20 +68,15 @@ const DisassembledProgram &Program::getDisassembled() const {
     return disassembled;
   }
   if (disassembled.empty()) {
-    auto &assembler = ProcessorHandler::getAssembler();
-    auto &memory = ProcessorHandler::getMemory();
-    auto &symbols = ProcessorHandler::getProgram()->symbols;
-
-    // Initialize caching
+    // Initialize caching. Instructions are disassembled through the
+    // disassembly cache shared with the other views of the program.
     const unsigned instrBytes = ProcessorHandler::currentISA()->instrBytes();
     const VInt textSectionBaseAddr = textSection->address;
     unsigned line = 0;
     for (AInt addr = 0;
          addr < static_cast<AInt>(ProcessorHandler::getCurrentProgramSize());) {
       const VInt disassembleAddr = addr + textSectionBaseAddr;
-      auto disRes =
-          assembler->disassemble(memory.readMem(disassembleAddr, instrBytes),
-                                 symbols, disassembleAddr);
+      auto disRes = ProcessorHandler::disassemble(disassembleAddr);
       // todo(mortbopet): shouldn't we do something about the possibility of the
       // disassembling returning an error?
       const VInt realAddr = textSectionBaseAddr + addr;
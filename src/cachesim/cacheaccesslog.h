@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheAccessLog class
+ * A compact, append-only log of the accesses performed on a cache, used for
+ * plotting cache statistics over time. Each access is stored as a small
+ * fixed-size entry. Cumulative access counters are checkpointed at a fixed
+ * interval of entries, such that the counters at any point in the log can be
+ * reconstructed without storing them for every access. Checkpoints are computed
+ * lazily when the counters are queried, keeping appends to the log trivial.
+ */
+class CacheAccessLog {
+public:
+  enum Flags : uint16_t {
+    Read = 0b1,
+    Write = 0b10,
+    Hit = 0b100,
+    Writeback = 0b1000,
+    // The entry is a prefetch rather than a demand access.
+    Prefetch = 0b10000,
+    // See CacheSim::CacheTransaction.
+    UsefulPrefetch = 0b100000,
+    LatePrefetch = 0b1000000,
+    PollutingPrefetch = 0b10000000,
+    // The 3C classification of a miss; see MissClassifier.
+    CompulsoryMiss = 0b100000000,
+    CapacityMiss = 0b1000000000,
+    ConflictMiss = 0b10000000000
+  };
+
+  struct Entry {
+    AInt address = 0;
+    unsigned cycle = 0;
+    uint16_t flags = 0;
+
+    bool isHit() const { return flags & Hit; }
+    bool isPrefetch() const { return flags & Prefetch; }
+  };
+
+  struct Counters {
+    unsigned hits = 0;
+    unsigned misses = 0;
+    unsigned reads = 0;
+    unsigned writes = 0;
+    unsigned writebacks = 0;
+    unsigned prefetches = 0;
+    unsigned usefulPrefetches = 0;
+    unsigned latePrefetches = 0;
+    unsigned pollutingPrefetches = 0;
+    unsigned compulsoryMisses = 0;
+    unsigned capacityMisses = 0;
+    unsigned conflictMisses = 0;
+
+    void add(const Entry &entry) {
+      writebacks += entry.flags & Writeback ? 1 : 0;
+      if (entry.flags & Prefetch) {
+        prefetches++;
+        return;
+      }
+      hits += entry.flags & Hit ? 1 : 0;
+      misses += entry.flags & Hit ? 0 : 1;
+      reads += entry.flags & Read ? 1 : 0;
+      writes += entry.flags & Write ? 1 : 0;
+      usefulPrefetches += entry.flags & UsefulPrefetch ? 1 : 0;
+      latePrefetches += entry.flags & LatePrefetch ? 1 : 0;
+      pollutingPrefetches += entry.flags & PollutingPrefetch ? 1 : 0;
+      compulsoryMisses += entry.flags & CompulsoryMiss ? 1 : 0;
+      capacityMisses += entry.flags & CapacityMiss ? 1 : 0;
+      conflictMisses += entry.flags & ConflictMiss ? 1 : 0;
+    }
+  };
+
+  void push(const Entry &entry) { m_entries.push_back(entry); }
+
+  void pop() {
+    m_entries.pop_back();
+    // Discard the checkpoint which covered the popped entry, if computed.
+    const std::size_t nCheckpoints = m_entries.size() / s_checkpointInterval;
+    if (m_checkpoints.size() > nCheckpoints + 1)
+      m_checkpoints.resize(nCheckpoints + 1);
+  }
+
+  void clear() {
+    m_entries.clear();
+    m_checkpoints.clear();
+  }
+
+  bool empty() const { return m_entries.empty(); }
+  std::size_t size() const { return m_entries.size(); }
+  const Entry &at(std::size_t idx) const { return m_entries.at(idx); }
+  const Entry &back() const { return m_entries.back(); }
+  const std::vector<Entry> &entries() const { return m_entries; }
+
+  /**
+   * @brief countersBefore
+   * @returns the cumulative access counters of all entries preceding the entry
+   * at @p idx.
+   */
+  Counters countersBefore(std::size_t idx) const {
+    idx = std::min(idx, m_entries.size());
+    const std::size_t checkpoint = idx / s_checkpointInterval;
+    updateCheckpoints(checkpoint);
+    Counters counters = m_checkpoints[checkpoint];
+    for (std::size_t i = checkpoint * s_checkpointInterval; i < idx; ++i)
+      counters.add(m_entries[i]);
+    return counters;
+  }
+
+  /**
+   * @brief upperBound
+   * @returns the index of the first entry recorded after @p cycle.
+   */
+  std::size_t upperBound(unsigned cycle) const {
+    return std::upper_bound(m_entries.begin(), m_entries.end(), cycle,
+                            [](unsigned c, const Entry &entry) {
+                              return c < entry.cycle;
+                            }) -
+           m_entries.begin();
+  }
+
+private:
+  static constexpr std::size_t s_checkpointInterval = 1024;
+
+  /**
+   * @brief updateCheckpoints
+   * Computes all checkpoints up until (and including) checkpoint @p idx.
+   */
+  void updateCheckpoints(std::size_t idx) const {
+    if (m_checkpoints.empty())
+      m_checkpoints.push_back(Counters());
+    while (m_checkpoints.size() <= idx) {
+      Counters counters = m_checkpoints.back();
+      const std::size_t from =
+          (m_checkpoints.size() - 1) * s_checkpointInterval;
+      for (std::size_t i = from; i < from + s_checkpointInterval; ++i)
+        counters.add(m_entries[i]);
+      m_checkpoints.push_back(counters);
+    }
+  }
+
+  std::vector<Entry> m_entries;
+  // m_checkpoints[i] holds the counters preceding entry i * interval.
+  mutable std::vector<Counters> m_checkpoints;
+};
+
+} // namespace Ripes
@@ -22,7 +22,7 @@ CacheConfigWidget::CacheConfigWidget(QWidget *parent)
   // to the current configuration
   m_configItems = {
       m_ui->presets,           m_ui->ways,   m_ui->lines, m_ui->blocks,
-      m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit};
+      m_ui->replacementPolicy, m_ui->wrMiss, m_ui->wrHit, m_ui->prefetchPolicy};
 }
 
 void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
@@ -31,6 +31,7 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
   setupEnumCombobox(m_ui->replacementPolicy, s_cacheReplPolicyStrings);
   setupEnumCombobox(m_ui->wrHit, s_cacheWritePolicyStrings);
   setupEnumCombobox(m_ui->wrMiss, s_cacheWriteAllocateStrings);
+  setupEnumCombobox(m_ui->prefetchPolicy, s_cachePrefetchPolicyStrings);
 
   m_ui->ways->setValue(m_cache->getWaysBits());
   m_ui->lines->setValue(m_cache->getLineBits());
@@ -59,6 +60,12 @@ void CacheConfigWidget::setCache(const std::shared_ptr<CacheSim> &cache) {
             m_cache->setWriteAllocatePolicy(
                 qvariant_cast<WriteAllocPolicy>(m_ui->wrMiss->itemData(index)));
           });
+  connect(m_ui->prefetchPolicy,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), cache.get(),
+          [=](int index) {
+            m_cache->setPrefetchPolicy(qvariant_cast<PrefetchPolicy>(
+                m_ui->prefetchPolicy->itemData(index)));
+          });
   connect(m_ui->savePresetButton, &QPushButton::clicked, this,
           &CacheConfigWidget::storePreset);
   m_ui->savePresetButton->setIcon(QIcon(":/icons/save.svg"));
@@ -90,6 +97,7 @@ void CacheConfigWidget::storePreset() {
     preset.wrPolicy = getEnumValue<WritePolicy>(m_ui->wrHit);
     preset.wrAllocPolicy = getEnumValue<WriteAllocPolicy>(m_ui->wrMiss);
     preset.replPolicy = getEnumValue<ReplPolicy>(m_ui->replacementPolicy);
+    preset.seed = m_cache->getSeed();
 
     auto presets = RipesSettings::value(RIPES_SETTING_CACHE_PRESETS)
                        .value<QList<Ripes::CachePreset>>();
@@ -159,6 +167,7 @@ void CacheConfigWidget::handleConfigurationChanged() {
   setEnumIndex(m_ui->wrHit, m_cache->getWritePolicy());
   setEnumIndex(m_ui->wrMiss, m_cache->getWriteAllocPolicy());
   setEnumIndex(m_ui->replacementPolicy, m_cache->getReplacementPolicy());
+  setEnumIndex(m_ui->prefetchPolicy, m_cache->getPrefetchPolicy());
 
   if (!m_justSetPreset) {
     m_ui->presets->setCurrentIndex(-1);
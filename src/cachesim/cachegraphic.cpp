@@ -91,9 +91,9 @@ CacheGraphic::CacheGraphic(CacheSim &cache)
 }
 
 void CacheGraphic::updateLineReplFields(unsigned lineIdx) {
-  auto *cacheLine = m_cache.getLine(lineIdx);
+  const auto cacheLine = m_cache.getLine(lineIdx);
 
-  if (cacheLine == nullptr) {
+  if (!cacheLine) {
     // Nothing to do
     return;
   }
@@ -137,11 +137,7 @@ void CacheGraphic::updateWay(unsigned lineIdx, unsigned wayIdx) {
   }
   CacheWay &way = wayIt->second;
 
-  CacheSim::CacheWay simWay = CacheSim::CacheWay();
-
-  if (auto *cacheLine = m_cache.getLine(lineIdx)) {
-    simWay = cacheLine->at(wayIdx);
-  };
+  const CacheSim::CacheWay simWay = m_cache.getWay(lineIdx, wayIdx);
 
   const unsigned bytes = ProcessorHandler::currentISA()->bytes();
   // ======================== Update block text fields ======================
@@ -519,7 +515,7 @@ void CacheGraphic::cacheInvalidated() {
 
   // Update all entries in the cache
   for (int lineIdx = 0; lineIdx < m_cache.getLines(); lineIdx++) {
-    if (const auto *line = m_cache.getLine(lineIdx)) {
+    if (const auto line = m_cache.getLine(lineIdx)) {
       for (const auto &way : *line) {
         updateWay(lineIdx, way.first);
       }
@@ -3,25 +3,34 @@
 
 #include <QCheckBox>
 #include <QClipboard>
+#include <QDialog>
 #include <QFileDialog>
 #include <QPushButton>
 #include <QToolBar>
+#include <QVBoxLayout>
 #include <QtCharts/QAreaSeries>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
+#include <QtCharts/QLogValueAxis>
+#include <QtCharts/QScatterSeries>
 #include <QtCharts/QValueAxis>
 
 #include <algorithm>
+#include <set>
 
 #include "colors.h"
 #include "enumcombobox.h"
 #include "processorhandler.h"
 #include "ripessettings.h"
+#include "stackdistance.h"
 
 #include "limits.h"
 
 namespace Ripes {
 
+// Curves are plotted for associativities up to 2^s_missRatioCurveMaxWayBits.
+static constexpr unsigned s_missRatioCurveMaxWayBits = 3;
+
 static QPointF stepPoint(const QPointF &p1, const QPointF &p2) {
   return QPointF(p2.x(), p1.y());
 }
@@ -241,6 +250,13 @@ void CachePlotWidget::setupPlotActions() {
   m_ui->savePlot->setDefaultAction(m_savePlotAction);
   connect(m_savePlotAction, &QAction::triggered, this,
           &CachePlotWidget::savePlot);
+
+  const QIcon missRatioCurveIcon = QIcon(":/icons/analytics.svg");
+  m_missRatioCurveAction = new QAction("Show miss-ratio curve", this);
+  m_missRatioCurveAction->setIcon(missRatioCurveIcon);
+  m_ui->missRatioCurve->setDefaultAction(m_missRatioCurveAction);
+  connect(m_missRatioCurveAction, &QAction::triggered, this,
+          &CachePlotWidget::showMissRatioCurve);
 }
 
 void CachePlotWidget::savePlot() {
@@ -252,6 +268,68 @@ void CachePlotWidget::savePlot() {
   }
 }
 
+void CachePlotWidget::showMissRatioCurve() {
+  StackDistanceAnalyzer analyzer(m_cache->getByteOffset(),
+                                 m_cache->getBlockBits());
+  for (const auto &entry : m_cache->getAccessLog().entries()) {
+    if (!entry.isPrefetch())
+      analyzer.access(entry.address);
+  }
+
+  auto *chart = new QChart();
+  chart->setTitle(QString("LRU miss-ratio curve (%1 blocks per line)")
+                      .arg(m_cache->getBlocks()));
+
+  // Plot a curve for each of the lower associativities, as well as for the
+  // associativity of the current cache configuration.
+  std::set<unsigned> wayBitsToPlot;
+  for (unsigned wayBits = 0; wayBits <= s_missRatioCurveMaxWayBits; ++wayBits)
+    wayBitsToPlot.insert(wayBits);
+  wayBitsToPlot.insert(m_cache->getWaysBits());
+
+  for (const unsigned wayBits : wayBitsToPlot) {
+    auto *series = new QLineSeries(chart);
+    series->setName(QString::number(1 << wayBits) + "-way");
+    for (unsigned lineBits = 0; lineBits <= analyzer.maxLineBits(); ++lineBits)
+      series->append(1 << lineBits,
+                     analyzer.missRate(lineBits, wayBits) * 100.0);
+    chart->addSeries(series);
+  }
+
+  auto *currentSeries = new QScatterSeries(chart);
+  currentSeries->setName("Current configuration");
+  currentSeries->setColor(Colors::Medalist);
+  currentSeries->append(m_cache->getLines(),
+                        analyzer.missRate(m_cache->getLineBits(),
+                                          m_cache->getWaysBits()) *
+                            100.0);
+  chart->addSeries(currentSeries);
+
+  auto *axisX = new QLogValueAxis();
+  axisX->setBase(2);
+  axisX->setLabelFormat("%d  ");
+  axisX->setTitleText("Lines");
+  auto *axisY = new QValueAxis();
+  axisY->setRange(0, 100);
+  axisY->setLabelFormat("%d  ");
+  axisY->setTitleText("Miss rate (%)");
+  chart->addAxis(axisX, Qt::AlignBottom);
+  chart->addAxis(axisY, Qt::AlignLeft);
+  for (auto *series : chart->series()) {
+    series->attachAxis(axisX);
+    series->attachAxis(axisY);
+  }
+
+  QDialog dialog(this);
+  dialog.setWindowTitle("Miss-Ratio Curve");
+  auto *layout = new QVBoxLayout(&dialog);
+  auto *view = new QChartView(chart, &dialog);
+  view->setRenderHint(QPainter::Antialiasing);
+  layout->addWidget(view);
+  dialog.resize(640, 480);
+  dialog.exec();
+}
+
 void CachePlotWidget::copyPlotDataToClipboard() const {
   std::vector<Variable> allVariables;
   for (int i = 0; i < N_TraceVars; ++i) {
@@ -309,34 +387,56 @@ void CachePlotWidget::variablesChanged() {
 std::map<CachePlotWidget::Variable, QList<QPoint>>
 CachePlotWidget::gatherData(unsigned fromCycle) const {
   std::map<Variable, QList<QPoint>> cacheData;
-  const auto &trace = m_cache->getAccessTrace();
-
-  for (int i = 0; i < N_TraceVars; ++i) {
-    cacheData[static_cast<Variable>(i)].reserve(trace.size());
-  }
+  const auto &log = m_cache->getAccessLog();
 
-  // Gather data up until the end of the trace or the maximum plotted cycles
+  // Gather data up until the end of the log or the maximum plotted cycles
   const unsigned maxCycles =
       RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toInt();
   if (fromCycle > maxCycles) {
     return {};
   }
 
-  for (auto it = trace.upper_bound(fromCycle);
-       it != trace.lower_bound(maxCycles); it++) {
-    const auto &entry = it->second;
-    Q_ASSERT(it->first <= maxCycles);
-    cacheData[Variable::Writes].append(QPoint(it->first, entry.writes));
-    cacheData[Variable::Reads].append(QPoint(it->first, entry.reads));
-    cacheData[Variable::Hits].append(QPoint(it->first, entry.hits));
-    cacheData[Variable::Misses].append(QPoint(it->first, entry.misses));
-    cacheData[Variable::Writebacks].append(QPoint(it->first, entry.writebacks));
+  const std::size_t fromIdx = log.upperBound(fromCycle);
+  for (int i = 0; i < N_TraceVars; ++i) {
+    cacheData[static_cast<Variable>(i)].reserve(log.size() - fromIdx);
+  }
+
+  // The log stores individual accesses; accumulate these to retrieve the
+  // cumulative statistics at each cycle.
+  auto counters = log.countersBefore(fromIdx);
+  for (std::size_t idx = fromIdx; idx < log.size(); ++idx) {
+    const auto &entry = log.at(idx);
+    if (entry.cycle >= maxCycles) {
+      break;
+    }
+    const int cycle = entry.cycle;
+    counters.add(entry);
+    cacheData[Variable::Writes].append(QPoint(cycle, counters.writes));
+    cacheData[Variable::Reads].append(QPoint(cycle, counters.reads));
+    cacheData[Variable::Hits].append(QPoint(cycle, counters.hits));
+    cacheData[Variable::Misses].append(QPoint(cycle, counters.misses));
+    cacheData[Variable::Writebacks].append(QPoint(cycle, counters.writebacks));
     cacheData[Variable::Accesses].append(
-        QPoint(it->first, entry.hits + entry.misses));
+        QPoint(cycle, counters.hits + counters.misses));
+    cacheData[Variable::Prefetches].append(QPoint(cycle, counters.prefetches));
+    cacheData[Variable::UsefulPrefetches].append(
+        QPoint(cycle, counters.usefulPrefetches));
+    cacheData[Variable::LatePrefetches].append(
+        QPoint(cycle, counters.latePrefetches));
+    cacheData[Variable::PollutingPrefetches].append(
+        QPoint(cycle, counters.pollutingPrefetches));
+    cacheData[Variable::CompulsoryMisses].append(
+        QPoint(cycle, counters.compulsoryMisses));
+    cacheData[Variable::CapacityMisses].append(
+        QPoint(cycle, counters.capacityMisses));
+    cacheData[Variable::ConflictMisses].append(
+        QPoint(cycle, counters.conflictMisses));
+    // Prefetches are neither demand hits nor misses.
+    const bool isAccess = !entry.isPrefetch();
     cacheData[Variable::WasHit].append(
-        QPoint(it->first, entry.lastTransaction.isHit));
+        QPoint(cycle, isAccess && entry.isHit()));
     cacheData[Variable::WasMiss].append(
-        QPoint(it->first, !entry.lastTransaction.isHit));
+        QPoint(cycle, isAccess && !entry.isHit()));
   }
 
   return cacheData;
@@ -51,6 +51,13 @@ public:
     WasMiss,
     Writebacks,
     Accesses,
+    Prefetches,
+    UsefulPrefetches,
+    LatePrefetches,
+    PollutingPrefetches,
+    CompulsoryMisses,
+    CapacityMisses,
+    ConflictMisses,
     N_TraceVars,
     Unary
   };
@@ -76,6 +83,14 @@ private:
   void showSizeBreakdown();
   void copyPlotDataToClipboard() const;
   void savePlot();
+
+  /**
+   * @brief showMissRatioCurve
+   * Computes the LRU miss-ratio curve of the accesses recorded in the access
+   * log of the cache, for all cache sizes and associativities at the current
+   * block size, and shows it in a dialog.
+   */
+  void showMissRatioCurve();
   void updateRatioPlot();
   void updatePlotAxes();
   void updateAllowedRange(const RangeChangeSource src);
@@ -109,6 +124,7 @@ private:
 
   QAction *m_copyDataAction = nullptr;
   QAction *m_savePlotAction = nullptr;
+  QAction *m_missRatioCurveAction = nullptr;
   QAction *m_ratioMarkerAction = nullptr;
   QAction *m_mavgMarkerAction = nullptr;
 
@@ -123,6 +139,14 @@ const static std::map<CachePlotWidget::Variable, QString>
         {CachePlotWidget::Variable::Misses, "Misses"},
         {CachePlotWidget::Variable::Writebacks, "Writebacks"},
         {CachePlotWidget::Variable::Accesses, "Access count"},
+        {CachePlotWidget::Variable::Prefetches, "Prefetches"},
+        {CachePlotWidget::Variable::UsefulPrefetches, "Useful prefetches"},
+        {CachePlotWidget::Variable::LatePrefetches, "Late prefetches"},
+        {CachePlotWidget::Variable::PollutingPrefetches,
+         "Polluting prefetches"},
+        {CachePlotWidget::Variable::CompulsoryMisses, "Compulsory misses"},
+        {CachePlotWidget::Variable::CapacityMisses, "Capacity misses"},
+        {CachePlotWidget::Variable::ConflictMisses, "Conflict misses"},
         {CachePlotWidget::Variable::Unary, "1"},
         {CachePlotWidget::Variable::WasHit, "Was hit"},
         {CachePlotWidget::Variable::WasMiss, "Was miss"}};
@@ -2,14 +2,63 @@
 #include "binutils.h"
 
 #include "processorhandler.h"
+#include "ripessettings.h"
 
 #include <QApplication>
 #include <QThread>
+#include <algorithm>
 #include <random>
 #include <utility>
 
 namespace Ripes {
 
+namespace {
+/// Calls @p f with the address of each block of size @p blockBytes which holds
+/// data within the range [@p address, @p address + @p bytes), and the # of
+/// bytes of the range within that block. The first call receives @p address
+/// itself.
+template <typename F>
+void forEachBlock(AInt address, unsigned bytes, unsigned blockBytes, F f) {
+  AInt blockAddress = address;
+  do {
+    const AInt nextBlockAddress =
+        (blockAddress & ~static_cast<AInt>(blockBytes - 1)) + blockBytes;
+    const unsigned blockPart = static_cast<unsigned>(
+        std::min<AInt>(bytes, nextBlockAddress - blockAddress));
+    f(blockAddress, blockPart);
+    bytes -= blockPart;
+    blockAddress = nextBlockAddress;
+  } while (bytes > 0);
+}
+
+uint16_t missClassFlag(MissClassifier::MissClass missClass) {
+  switch (missClass) {
+  case MissClassifier::MissClass::None:
+    return 0;
+  case MissClassifier::MissClass::Compulsory:
+    return CacheAccessLog::CompulsoryMiss;
+  case MissClassifier::MissClass::Capacity:
+    return CacheAccessLog::CapacityMiss;
+  case MissClassifier::MissClass::Conflict:
+    return CacheAccessLog::ConflictMiss;
+  }
+  return 0;
+}
+} // namespace
+
+void CacheInterface::setNextLevelCache(const std::shared_ptr<CacheSim> &cache) {
+  // Caches register themselves with their next level cache, such that the next
+  // level cache may maintain inclusion.
+  auto *self = dynamic_cast<CacheSim *>(this);
+  if (self && m_nextLevelCache) {
+    m_nextLevelCache->removeUpperLevelCache(self);
+  }
+  m_nextLevelCache = cache;
+  if (self && m_nextLevelCache) {
+    m_nextLevelCache->addUpperLevelCache(self);
+  }
+}
+
 void CacheInterface::reset() {
   if (m_nextLevelCache) {
     static_cast<CacheInterface *>(m_nextLevelCache.get())->reset();
@@ -25,7 +74,13 @@ void CacheInterface::reverse() {
 CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
   m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
   m_wordBits = ProcessorHandler::currentISA()->bits();
+  // runStarted is emitted from the GUI thread before the processor starts
+  // running, ensuring that throughput mode is enabled for the entire run.
+  connect(ProcessorHandler::get(), &ProcessorHandler::runStarted, this,
+          [=] { m_throughputMode = true; });
   connect(ProcessorHandler::get(), &ProcessorHandler::runFinished, this, [=] {
+    m_throughputMode = false;
+
     // Given that we are not updating the graphical state of the cache simulator
     // whilst the processor is running, once running is finished, the entirety
     // of the cache view should be reloaded in the graphical view.
@@ -33,42 +88,37 @@ CacheSim::CacheSim(QObject *parent) : CacheInterface(parent) {
     emit cacheInvalidated();
   });
 
+  m_maxLoggedCycles =
+      RipesSettings::value(RIPES_SETTING_CACHE_MAXCYCLES).toUInt();
+  connect(RipesSettings::getObserver(RIPES_SETTING_CACHE_MAXCYCLES),
+          &SettingObserver::modified, this,
+          [=](const auto &cycles) { m_maxLoggedCycles = cycles.toUInt(); });
+
   updateConfiguration();
 }
 
-void CacheSim::updateCacheLineReplFields(CacheLine &line, unsigned wayIdx) {
-  if (getReplacementPolicy() == ReplPolicy::LRU) {
-    // Find previous LRU value for the updated index
-    const unsigned preLRU = line[wayIdx].lru;
+CacheSim::CacheSim(unsigned wordBits, QObject *parent)
+    : CacheInterface(parent), m_standalone(true) {
+  m_wordBits = wordBits;
+  m_byteOffset = log2Ceil(wordBits / 8);
+  updateConfiguration();
+}
 
-    // All indicies which are currently more recent than preLRU shall be
-    // incremented
-    for (auto &set : line) {
-      if (set.second.valid && set.second.lru < preLRU) {
-        set.second.lru++;
-      }
-    }
+CacheSim::~CacheSim() { setNextLevelCache(nullptr); }
 
-    // Upgrade @p lruIdx to the most recently used
-    line[wayIdx].lru = 0;
-  }
+void CacheSim::addUpperLevelCache(CacheSim *cache) {
+  m_upperLevelCaches.push_back(cache);
 }
 
-void CacheSim::revertCacheLineReplFields(CacheLine &line,
-                                         const CacheWay &oldWay,
-                                         unsigned wayIdx) {
-  if (getReplacementPolicy() == ReplPolicy::LRU) {
-    // All indicies which are currently less than or equal to the old LRU shall
-    // be decremented
-    for (auto &set : line) {
-      if (set.second.valid && set.second.lru <= oldWay.lru) {
-        set.second.lru--;
-      }
-    }
+void CacheSim::removeUpperLevelCache(CacheSim *cache) {
+  m_upperLevelCaches.erase(std::remove(m_upperLevelCaches.begin(),
+                                       m_upperLevelCaches.end(), cache),
+                           m_upperLevelCaches.end());
+}
 
-    // Revert the oldWay LRU
-    line[wayIdx].lru = oldWay.lru;
-  }
+void CacheSim::invalidateWay(unsigned lineIdx, unsigned wayIdx) {
+  m_replacement->invalidate(lineIdx, wayIdx);
+  m_storage.invalidate(m_storage.index(lineIdx, wayIdx));
 }
 
 CacheSim::CacheSize CacheSim::getCacheSize() const {
@@ -88,10 +138,11 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
     size.bits += componentBits;
   }
 
-  if (m_replPolicy == ReplPolicy::LRU) {
-    // LRU bits
-    componentBits = getWaysBits() * entries;
-    size.components.push_back("LRU bits: " + QString::number(componentBits));
+  // Replacement bits
+  componentBits = m_replacement->bitsPerLine() * getLines();
+  if (componentBits > 0) {
+    size.components.push_back(s_cacheReplPolicyStrings.at(m_replPolicy) +
+                              " bits: " + QString::number(componentBits));
     size.bits += componentBits;
   }
 
@@ -108,119 +159,102 @@ CacheSim::CacheSize CacheSim::getCacheSize() const {
   return size;
 }
 
-std::pair<unsigned, CacheSim::CacheWay *>
-CacheSim::locateEvictionWay(const CacheTransaction &transaction) {
-  auto &cacheLine = m_cacheLines[transaction.index.line];
-
-  std::pair<unsigned, CacheSim::CacheWay *> ew;
-  ew.first = s_invalidIndex;
-  ew.second = nullptr;
-
-  // Locate a new way based on replacement policy.
-  if (m_replPolicy == ReplPolicy::Random) {
-    // Select a random way
-    ew.first = std::rand() % getWays();
-    ew.second = &cacheLine[ew.first];
-  } else if (m_replPolicy == ReplPolicy::LRU) {
-    if (getWays() == 1) {
-      // Nothing to do if we are in LRU and only have 1 set.
-      ew.first = 0;
-      ew.second = &cacheLine[ew.first];
-    } else {
-      // Lazily initialize all ways in the cacheline before starting to iterate.
-      for (int i = 0; i < getWays(); ++i)
-        cacheLine[i];
-
-      // If there is an invalid cache line, select that.
-      auto it =
-          std::find_if(cacheLine.begin(), cacheLine.end(),
-                       [=](const auto &way) { return !way.second.valid; });
-      if (it != cacheLine.end()) {
-        ew.first = it->first;
-        ew.second = &it->second;
-      }
-      if (ew.second == nullptr) {
-        // Else, Find LRU way.
-        for (auto &way : cacheLine) {
-          if (static_cast<long>(way.second.lru) == getWays() - 1) {
-            ew.first = way.first;
-            ew.second = &way.second;
-            break;
-          }
-        }
-      }
-    }
+unsigned
+CacheSim::locateEvictionWay(const CacheTransaction &transaction) const {
+  unsigned wayIdx = s_invalidIndex;
+
+  // If there is an invalid cache way, select that.
+  if (m_replacement->fillsInvalidWaysFirst()) {
+    wayIdx = m_storage.findInvalidWay(transaction.index.line);
+  }
+  // Else, locate a way based on the replacement policy.
+  if (wayIdx == s_invalidIndex) {
+    wayIdx = m_replacement->victim(transaction.index.line);
   }
 
-  Q_ASSERT(ew.first != s_invalidIndex && "Unable to locate way for eviction");
-  Q_ASSERT(ew.second != nullptr && "Unable to locate way for eviction");
-  return ew;
+  Q_ASSERT(wayIdx != s_invalidIndex && "Unable to locate way for eviction");
+  return wayIdx;
 }
 
-CacheSim::CacheWay CacheSim::evictAndUpdate(CacheTransaction &transaction) {
-  const auto [wayIdx, wayPtr] = locateEvictionWay(transaction);
+void CacheSim::snapshotWay(unsigned slot, unsigned lineIdx, unsigned wayIdx) {
+  const unsigned idx = m_storage.index(lineIdx, wayIdx);
+  CacheTrace &trace = m_undoLog[slot];
+  trace.oldTag = m_storage.tag(idx);
+  trace.oldFlags = m_storage.flags(idx);
+  trace.oldReadyCycle = m_storage.readyCycle(idx);
+  trace.oldPollutionTag = m_storage.pollutionTag(idx);
+  const unsigned nWords = m_storage.dirtyWordsPerWay();
+  std::copy_n(m_storage.dirtyWords(idx), nWords,
+              &m_undoDirtyBlocks[static_cast<std::size_t>(slot) * nWords]);
+  const unsigned nReplWords = m_replacement->wordsPerLine();
+  std::copy_n(m_replacement->lineState(lineIdx), nReplWords,
+              &m_undoReplState[static_cast<std::size_t>(slot) * nReplWords]);
+}
+
+void CacheSim::restoreWay(unsigned slot, unsigned lineIdx, unsigned wayIdx) {
+  const unsigned idx = m_storage.index(lineIdx, wayIdx);
+  const CacheTrace &trace = m_undoLog[slot];
+  m_storage.setTag(idx, trace.oldTag);
+  m_storage.setReadyCycle(idx, trace.oldReadyCycle);
+  m_storage.setPollutionTag(idx, trace.oldPollutionTag);
+  // Restored last, given that setting the pollution tag marks it as valid.
+  m_storage.setFlags(idx, trace.oldFlags);
+  const unsigned nWords = m_storage.dirtyWordsPerWay();
+  std::copy_n(&m_undoDirtyBlocks[static_cast<std::size_t>(slot) * nWords],
+              nWords, m_storage.dirtyWords(idx));
+  const unsigned nReplWords = m_replacement->wordsPerLine();
+  std::copy_n(&m_undoReplState[static_cast<std::size_t>(slot) * nReplWords],
+              nReplWords, m_replacement->lineState(lineIdx));
+}
 
-  CacheWay eviction;
+void CacheSim::evictAndUpdate(CacheTransaction &transaction, unsigned wayIdx) {
+  const unsigned idx = m_storage.index(transaction.index.line, wayIdx);
 
-  if (!wayPtr->valid) {
+  if (!m_storage.valid(idx)) {
     // Record that this was an invalid->valid transition
     transaction.transToValid = true;
-  } else {
-    // Store the old way info in our eviction trace, in case of rollbacks
-    eviction = *wayPtr;
-
-    if (eviction.dirty) {
-      // The eviction will result in a writeback
-      transaction.isWriteback = true;
-    }
+  } else if (m_storage.dirty(idx)) {
+    // The eviction will result in a writeback
+    transaction.isWriteback = true;
   }
 
   // Invalidate the target way
-  *wayPtr = CacheWay();
+  m_storage.invalidate(idx);
 
   // Set required values in way, reflecting the newly loaded address
-  wayPtr->valid = true;
-  wayPtr->dirty = false;
-  wayPtr->tag = getTag(transaction.address);
+  m_storage.setValid(idx, true);
+  m_storage.setTag(idx, getTag(transaction.address));
   transaction.tagChanged = true;
   transaction.index.way = wayIdx;
-
-  return eviction;
 }
 
-unsigned CacheSim::getHits() const {
-  if (m_accessTrace.size() == 0) {
-    return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.hits;
-  }
+unsigned CacheSim::getHits() const { return m_totals.hits; }
+
+unsigned CacheSim::getMisses() const { return m_totals.misses; }
+
+unsigned CacheSim::getWritebacks() const { return m_totals.writebacks; }
+
+double CacheSim::missPenalty() const {
+  return m_nextLevelCache ? m_nextLevelCache->getAMAT() : m_memoryLatency;
 }
 
-unsigned CacheSim::getMisses() const {
-  if (m_accessTrace.size() == 0) {
-    return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.misses;
-  }
+double CacheSim::getAMAT() const {
+  return m_hitLatency + (1.0 - getHitRate()) * missPenalty();
 }
 
-unsigned CacheSim::getWritebacks() const {
-  if (m_accessTrace.size() == 0) {
-    return 0;
-  } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return trace.writebacks;
+unsigned CacheSim::currentCycle() const {
+  if (m_standalone) {
+    return m_totals.hits + m_totals.misses;
   }
+  return ProcessorHandler::getProcessor()->getCycleCount();
 }
 
 double CacheSim::getHitRate() const {
-  if (m_accessTrace.size() == 0) {
+  const unsigned accesses = m_totals.hits + m_totals.misses;
+  if (accesses == 0) {
     return 0;
   } else {
-    auto &trace = m_accessTrace.rbegin()->second;
-    return static_cast<double>(trace.hits) / (trace.hits + trace.misses);
+    return static_cast<double>(m_totals.hits) / accesses;
   }
 }
 
@@ -228,85 +262,226 @@ void CacheSim::analyzeCacheAccess(CacheTransaction &transaction) const {
   transaction.index.line = getLineIdx(transaction.address);
   transaction.index.block = getBlockIdx(transaction.address);
 
-  transaction.isHit = false;
-  if (m_cacheLines.count(transaction.index.line) != 0) {
-    for (const auto &way : m_cacheLines.at(transaction.index.line)) {
-      if ((way.second.tag == getTag(transaction.address)) && way.second.valid) {
-        transaction.index.way = way.first;
-        transaction.isHit = true;
-        break;
-      }
-    }
+  const unsigned wayIdx =
+      m_storage.findWay(transaction.index.line, getTag(transaction.address));
+  transaction.isHit = wayIdx != s_invalidIndex;
+  if (transaction.isHit) {
+    transaction.index.way = wayIdx;
   }
 }
 
-void CacheSim::pushAccessTrace(const CacheTransaction &transaction) {
-  // Access traces are pushed in sorted order into the access trace map; indexed
-  // by a key corresponding to the cycle of the access.
-  const unsigned currentCycle =
-      ProcessorHandler::getProcessor()->getCycleCount();
-
-  const CacheAccessTrace &mostRecentTrace =
-      m_accessTrace.size() == 0 ? CacheAccessTrace()
-                                : m_accessTrace.rbegin()->second;
-
-  m_accessTrace[currentCycle] = CacheAccessTrace(mostRecentTrace, transaction);
+void CacheSim::pushAccessTrace(const CacheTransaction &transaction,
+                               unsigned cycle) {
+  m_totals = CacheAccessTrace(m_totals, transaction);
+
+  // Accesses are only logged for as long as they may be plotted.
+  if (cycle < m_maxLoggedCycles) {
+    CacheAccessLog::Entry entry;
+    entry.address = transaction.address;
+    entry.cycle = cycle;
+    entry.flags =
+        (transaction.type == MemoryAccess::Read ? CacheAccessLog::Read : 0) |
+        (transaction.type == MemoryAccess::Write ? CacheAccessLog::Write : 0) |
+        (transaction.isHit ? CacheAccessLog::Hit : 0) |
+        (transaction.isWriteback ? CacheAccessLog::Writeback : 0) |
+        (transaction.isPrefetch ? CacheAccessLog::Prefetch : 0) |
+        (transaction.usefulPrefetch ? CacheAccessLog::UsefulPrefetch : 0) |
+        (transaction.latePrefetch ? CacheAccessLog::LatePrefetch : 0) |
+        (transaction.pollutingPrefetch ? CacheAccessLog::PollutingPrefetch
+                                       : 0) |
+        missClassFlag(transaction.missClass);
+    m_accessLog.push(entry);
+  }
 
-  if (!ProcessorHandler::isRunning()) {
+  if (!m_throughputMode) {
     emit hitrateChanged();
   }
 }
 
-void CacheSim::popAccessTrace() {
-  Q_ASSERT(m_accessTrace.size() > 0);
-  // The access trace should have an entry
-  m_accessTrace.erase(m_accessTrace.rbegin()->first);
+void CacheSim::popAccessTrace(const CacheTrace &trace) {
+  const CacheTransaction &transaction = trace.transaction;
+  if (transaction.type == MemoryAccess::None) {
+    // Not an access; see CacheTrace.
+    return;
+  }
+  m_totals.writebacks -= transaction.isWriteback ? 1 : 0;
+  if (transaction.isPrefetch) {
+    m_totals.prefetches--;
+  } else {
+    if (trace.pcCounted) {
+      auto it = m_pcCounters.find(transaction.pc);
+      Q_ASSERT(it != m_pcCounters.end());
+      it->second.accesses--;
+      it->second.misses -= transaction.isHit ? 0 : 1;
+      if (it->second.accesses == 0) {
+        m_pcCounters.erase(it);
+      }
+    }
+    m_totals.reads -= transaction.type == MemoryAccess::Read ? 1 : 0;
+    m_totals.writes -= transaction.type == MemoryAccess::Write ? 1 : 0;
+    m_totals.hits -= transaction.isHit ? 1 : 0;
+    m_totals.misses -= transaction.isHit ? 0 : 1;
+    m_totals.usefulPrefetches -= transaction.usefulPrefetch ? 1 : 0;
+    m_totals.latePrefetches -= transaction.latePrefetch ? 1 : 0;
+    m_totals.pollutingPrefetches -= transaction.pollutingPrefetch ? 1 : 0;
+    using MissClass = MissClassifier::MissClass;
+    m_totals.compulsoryMisses -=
+        transaction.missClass == MissClass::Compulsory ? 1 : 0;
+    m_totals.capacityMisses -=
+        transaction.missClass == MissClass::Capacity ? 1 : 0;
+    m_totals.conflictMisses -=
+        transaction.missClass == MissClass::Conflict ? 1 : 0;
+  }
+
+  if (!m_accessLog.empty() && m_accessLog.back().cycle == trace.cycle) {
+    m_accessLog.pop();
+  }
   emit hitrateChanged();
 }
 
-void CacheSim::access(AInt address, MemoryAccess::Type type) {
-  address = address & ~0b11; // Disregard unaligned accesses
-  CacheTrace trace;
-  CacheWay oldWay;
+void CacheSim::access(AInt address, MemoryAccess::Type type, AInt pc,
+                      unsigned bytes) {
+  if (bytes == 0) {
+    bytes = 1 << m_byteOffset;
+  }
+
+  // Accesses which straddle a block boundary (misaligned accesses, or accesses
+  // wider than a block) are split into one access per block.
+  forEachBlock(address, bytes, getBlockBytes(),
+               [&](AInt blockAddress, unsigned blockPart) {
+                 if (type == MemoryAccess::Read &&
+                     m_inclusionPolicy == InclusionPolicy::Exclusive &&
+                     !m_upperLevelCaches.empty()) {
+                   exclusiveRead(blockAddress, pc);
+                 } else {
+                   // Writes reaching an exclusive cache (i.e., write-throughs
+                   // of upper level caches) are handled as regular accesses.
+                   performAccess(blockAddress, blockPart, type, pc,
+                                 AccessSource::Demand);
+                 }
+               });
+}
+
+void CacheSim::performAccess(AInt address, unsigned bytes,
+                             MemoryAccess::Type type, AInt pc,
+                             AccessSource source) {
+  // The words within the block which are accessed
+  const unsigned firstWord = getBlockIdx(address);
+  const unsigned lastWord = getBlockIdx(address + bytes - 1);
+  const AInt accessAddress = address;
+  address = address & ~static_cast<AInt>((1 << m_byteOffset) - 1);
   CacheTransaction transaction;
   transaction.address = address;
+  transaction.pc = pc;
   transaction.type = type;
+  transaction.isPrefetch = source == AccessSource::Prefetch;
 
   analyzeCacheAccess(transaction);
-
-  if (!transaction.isHit) {
-    if (type == MemoryAccess::Read ||
-        (type == MemoryAccess::Write &&
-         getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate)) {
-      oldWay = evictAndUpdate(transaction);
-    }
-  } else {
-    oldWay = m_cacheLines[transaction.index.line][transaction.index.way];
+  if (transaction.isPrefetch && transaction.isHit) {
+    // The block is already present; the prefetch is dropped.
+    return;
   }
 
-  // === Update dirty and LRU bits ===
-
   // Initially, we need a check for the case of "write + miss + noWriteAlloc".
-  // In this case, we should not update replacement/dirty fields. In all other
-  // cases, this is a valid action.
+  // In this case, nothing is pulled into the cache, and we should not update
+  // replacement/dirty fields. In all other cases, this is a valid action.
   const bool writeMissNoAlloc =
-      !transaction.isHit && type == MemoryAccess::Write &&
+      source == AccessSource::Demand && !transaction.isHit &&
+      type == MemoryAccess::Write &&
       getWriteAllocPolicy() == WriteAllocPolicy::NoWriteAllocate;
 
-  if (!writeMissNoAlloc) {
-    // Lazily ensure that the located way has been initialized
-    m_cacheLines[transaction.index.line][transaction.index.way];
+  // A demand miss on a block which was evicted by a prefetch is attributed to
+  // the prefetch. The pollution tag is consumed, such that each prefetch is
+  // counted as polluting at most once.
+  if (source == AccessSource::Demand && !transaction.isHit) {
+    const unsigned pollutionWay = m_storage.findPollutionWay(
+        transaction.index.line, getTag(transaction.address));
+    if (pollutionWay != s_invalidIndex) {
+      transaction.pollutingPrefetch = true;
+      CacheTransaction pollution;
+      pollution.address = address;
+      pollution.index = {transaction.index.line, pollutionWay,
+                         transaction.index.block};
+      const unsigned slot = beginTrace(transaction.index.line, pollutionWay);
+      m_storage.clearPollutionTag(
+          m_storage.index(transaction.index.line, pollutionWay));
+      recordTransaction(slot, pollution, false);
+    }
+  }
+
+  // Locate the way which is modified by this access
+  unsigned wayIdx = transaction.index.way;
+  if (!transaction.isHit && !writeMissNoAlloc) {
+    wayIdx = locateEvictionWay(transaction);
+  }
+
+  // Record the state of the way prior to the access, in case of rollbacks
+  const unsigned traceSlot = beginTrace(transaction.index.line, wayIdx);
+
+  // The shadow cache of the miss classifier is subject to the same accesses
+  // as this cache, but only demand misses are classified.
+  const auto missClass = m_missClassifier.access(
+      address / getBlockBytes(), transaction.isHit, !writeMissNoAlloc,
+      traceSlot != s_invalidIndex ? &m_undoLog[traceSlot].classifierUndo
+                                  : nullptr);
+  if (source == AccessSource::Demand) {
+    transaction.missClass = missClass;
+  }
+
+  if (source == AccessSource::Demand && transaction.isHit) {
+    // The first demand hit on a prefetched block makes the prefetch useful.
+    // If the prefetch has yet to complete, it was issued too late to fully
+    // hide the miss penalty.
+    const unsigned idx = m_storage.index(transaction.index.line, wayIdx);
+    if (m_storage.prefetched(idx)) {
+      transaction.usefulPrefetch = true;
+      transaction.latePrefetch = currentCycle() < m_storage.readyCycle(idx);
+      m_storage.setPrefetched(idx, false);
+    }
+  }
 
+  // The block evicted by this access, if any
+  bool evicted = false;
+  bool evictedDirty = false;
+  AInt evictedAddress = 0;
+  if (!transaction.isHit && !writeMissNoAlloc) {
+    const unsigned idx = m_storage.index(transaction.index.line, wayIdx);
+    if (m_storage.valid(idx)) {
+      evicted = true;
+      evictedDirty = m_storage.dirty(idx);
+      evictedAddress =
+          buildAddress(m_storage.tag(idx), transaction.index.line, 0);
+    }
+    evictAndUpdate(transaction, wayIdx);
+
+    if (transaction.isPrefetch) {
+      m_storage.setPrefetched(idx, true);
+      m_storage.setReadyCycle(
+          idx, currentCycle() + static_cast<unsigned>(missPenalty()));
+      if (evicted) {
+        m_storage.setPollutionTag(idx, getTag(evictedAddress));
+      }
+    }
+  }
+
+  // === Update dirty and replacement bits ===
+  if (!writeMissNoAlloc) {
     if (type == MemoryAccess::Write &&
         getWritePolicy() == WritePolicy::WriteBack) {
-      CacheWay &way =
-          m_cacheLines[transaction.index.line][transaction.index.way];
-      way.dirty = true;
-      way.dirtyBlocks.insert(transaction.index.block);
+      const unsigned idx =
+          m_storage.index(transaction.index.line, transaction.index.way);
+      m_storage.setDirty(idx, true);
+      for (unsigned word = firstWord; word <= lastWord; ++word) {
+        m_storage.setBlockDirty(idx, word);
+      }
     }
 
-    updateCacheLineReplFields(m_cacheLines[transaction.index.line],
-                              transaction.index.way);
+    if (transaction.isHit) {
+      m_replacement->touch(transaction.index.line, transaction.index.way);
+    } else {
+      m_replacement->insert(transaction.index.line, transaction.index.way,
+                            !transaction.transToValid);
+    }
   } else {
     // In case of a write miss with no write allocate, the value is always
     // written through to memory (a writeback)
@@ -320,95 +495,372 @@ void CacheSim::access(AInt address, MemoryAccess::Type type) {
     transaction.isWriteback = true;
   }
 
+  // An inclusive cache must invalidate the evicted block in all caches above
+  // it. Dirty copies in those caches are written back along with the block.
+  if (evicted && m_inclusionPolicy == InclusionPolicy::Inclusive) {
+    for (auto *upperLevelCache : m_upperLevelCaches) {
+      evictedDirty |=
+          upperLevelCache->invalidate(evictedAddress, getBlockBytes());
+    }
+    transaction.isWriteback |= evictedDirty;
+  }
+
   // ===========================
 
   // At this point, no further changes shall be made to the transaction.
-  // We record the transaction as well as a possible eviction
-  trace.oldWay = oldWay;
-  trace.transaction = transaction;
-  pushTrace(trace);
-  pushAccessTrace(transaction);
+  const MemoryAccess::Type accessType = type;
+  if (source == AccessSource::Fill) {
+    transaction.type = MemoryAccess::None;
+  }
+  recordTransaction(traceSlot, transaction, false);
+
+  // === Propagate the access to the next level cache ===
+  if (m_nextLevelCache) {
+    // Victims are moved into an exclusive cache before fetching the allocated
+    // block, such that the caches below cannot evict the victim (maintaining
+    // their inclusion) whilst it is in transit. Else, the allocated block is
+    // fetched first, such that a writeback cannot evict it.
+    const bool victimFirst =
+        m_nextLevelCache->getInclusionPolicy() == InclusionPolicy::Exclusive;
+    if (evicted && victimFirst) {
+      m_nextLevelCache->upperLevelEviction(evictedAddress, getBlockBytes(),
+                                           evictedDirty);
+    }
+    if (!transaction.isHit && !writeMissNoAlloc &&
+        source != AccessSource::Fill) {
+      // Fetch the allocated block
+      forwardAccess(address & ~static_cast<AInt>(getBlockBytes() - 1),
+                    getBlockBytes(), MemoryAccess::Read, pc);
+    }
+    if (accessType == MemoryAccess::Write &&
+        (writeMissNoAlloc || getWritePolicy() == WritePolicy::WriteThrough)) {
+      forwardAccess(accessAddress, bytes, MemoryAccess::Write, pc);
+    }
+    if (evicted && !victimFirst) {
+      m_nextLevelCache->upperLevelEviction(evictedAddress, getBlockBytes(),
+                                           evictedDirty);
+    }
+  }
+
+  // === Train the prefetcher and issue its prefetches ===
+  if (source == AccessSource::Demand && m_prefetcher) {
+    m_prefetches.clear();
+    m_prefetcher->train(address, pc,
+                        !transaction.isHit || transaction.usefulPrefetch,
+                        m_prefetches);
+    for (const AInt prefetchAddress : m_prefetches) {
+      performAccess(prefetchAddress, 1 << m_byteOffset, MemoryAccess::Read, pc,
+                    AccessSource::Prefetch);
+    }
+  }
 
   // === Some sanity checking ===
   // It should never be possible that a read returns an invalid way index
-  if (type == MemoryAccess::Read) {
+  if (accessType == MemoryAccess::Read) {
     transaction.index.assertValid();
   }
 
   // It should never be possible that a write returns an invalid way index if we
   // write-allocate
-  if (type == MemoryAccess::Write &&
+  if (accessType == MemoryAccess::Write &&
       getWriteAllocPolicy() == WriteAllocPolicy::WriteAllocate) {
     transaction.index.assertValid();
   }
 
   // ===========================
-  if (writeMissNoAlloc) {
+  if (writeMissNoAlloc || m_standalone || m_throughputMode) {
     // There are no graphical changes to perform since nothing is pulled into
-    // the cache upon a missed write without write allocation
+    // the cache upon a missed write without write allocation, standalone
+    // caches are never drawn, and the cache is redrawn in its entirety after
+    // running.
     return;
   }
 
-  if (!ProcessorHandler::isRunning()) {
+  if (source != AccessSource::Demand) {
+    // Fills and prefetches are not accesses, and thus not highlighted.
+    emit wayInvalidated(transaction.index.line, transaction.index.way);
+  } else {
     emit dataChanged(transaction);
   }
 }
 
+void CacheSim::exclusiveRead(AInt address, AInt pc) {
+  address = address & ~static_cast<AInt>((1 << m_byteOffset) - 1);
+  CacheTransaction transaction;
+  transaction.address = address;
+  transaction.pc = pc;
+  transaction.type = MemoryAccess::Read;
+
+  analyzeCacheAccess(transaction);
+  const unsigned traceSlot =
+      beginTrace(transaction.index.line, transaction.index.way);
+
+  // Blocks are allocated in an exclusive cache through fills, rather than
+  // reads.
+  transaction.missClass = m_missClassifier.access(
+      address / getBlockBytes(), transaction.isHit, false, nullptr);
+
+  bool dirty = false;
+  if (transaction.isHit) {
+    // The block moves to the requesting cache. A dirty block is written back,
+    // given that the requesting cache receives it as a clean block.
+    dirty = m_storage.dirty(
+        m_storage.index(transaction.index.line, transaction.index.way));
+    invalidateWay(transaction.index.line, transaction.index.way);
+    transaction.isWriteback = dirty;
+  }
+  recordTransaction(traceSlot, transaction, true);
+
+  if (m_nextLevelCache && (!transaction.isHit || dirty)) {
+    forwardAccess(address & ~static_cast<AInt>(getBlockBytes() - 1),
+                  getBlockBytes(),
+                  transaction.isHit ? MemoryAccess::Write : MemoryAccess::Read);
+  }
+
+  if (!transaction.isHit || m_standalone || m_throughputMode) {
+    return;
+  }
+  emit dataChanged(transaction);
+}
+
+bool CacheSim::invalidate(AInt address, unsigned bytes) {
+  bool dirty = false;
+  forEachBlock(address, bytes, getBlockBytes(),
+               [&](AInt blockAddress, unsigned) {
+                 dirty |= invalidateBlock(blockAddress);
+               });
+  return dirty;
+}
+
+bool CacheSim::invalidateBlock(AInt address) {
+  CacheTransaction transaction;
+  transaction.address = address & ~static_cast<AInt>((1 << m_byteOffset) - 1);
+  analyzeCacheAccess(transaction);
+
+  // Copies of the block must be invalidated in all caches above this cache,
+  // given that caches above a non-inclusive cache may hold blocks which are not
+  // present in this cache.
+  bool dirty = false;
+  for (auto *upperLevelCache : m_upperLevelCaches) {
+    dirty |= upperLevelCache->invalidate(
+        transaction.address & ~static_cast<AInt>(getBlockBytes() - 1),
+        getBlockBytes());
+  }
+
+  if (!transaction.isHit) {
+    return dirty;
+  }
+
+  const unsigned traceSlot =
+      beginTrace(transaction.index.line, transaction.index.way);
+  dirty |= m_storage.dirty(
+      m_storage.index(transaction.index.line, transaction.index.way));
+  invalidateWay(transaction.index.line, transaction.index.way);
+  recordTransaction(traceSlot, transaction, true);
+
+  if (!m_standalone && !m_throughputMode) {
+    emit wayInvalidated(transaction.index.line, transaction.index.way);
+  }
+  return dirty;
+}
+
+void CacheSim::upperLevelEviction(AInt address, unsigned bytes, bool dirty) {
+  if (m_inclusionPolicy == InclusionPolicy::Exclusive) {
+    // Exclusive caches are filled with the victims of upper level caches.
+    forEachBlock(address, bytes, getBlockBytes(),
+                 [&](AInt blockAddress, unsigned blockPart) {
+                   performAccess(blockAddress, blockPart,
+                                 dirty ? MemoryAccess::Write
+                                       : MemoryAccess::Read,
+                                 0, AccessSource::Fill);
+                 });
+  } else if (dirty) {
+    forEachBlock(address, bytes, getBlockBytes(),
+                 [&](AInt blockAddress, unsigned blockPart) {
+                   access(blockAddress, MemoryAccess::Write, 0, blockPart);
+                 });
+  }
+}
+
+void CacheSim::forwardAccess(AInt address, unsigned bytes,
+                             MemoryAccess::Type type, AInt pc) {
+  forEachBlock(address, bytes, m_nextLevelCache->getBlockBytes(),
+               [&](AInt blockAddress, unsigned blockPart) {
+                 m_nextLevelCache->access(blockAddress, type, pc, blockPart);
+               });
+}
+
+unsigned CacheSim::beginTrace(unsigned lineIdx, unsigned wayIdx) {
+  const unsigned traceSlot = m_standalone ? s_invalidIndex : pushTrace();
+  if (traceSlot != s_invalidIndex) {
+    m_undoLog[traceSlot].classifierUndo = MissClassifier::UndoRecord();
+  }
+  if (traceSlot != s_invalidIndex && wayIdx != s_invalidIndex) {
+    snapshotWay(traceSlot, lineIdx, wayIdx);
+  }
+  return traceSlot;
+}
+
+void CacheSim::recordTransaction(unsigned traceSlot,
+                                 const CacheTransaction &transaction,
+                                 bool invalidation) {
+  const bool pcCounted = m_pcAccounting &&
+                         transaction.type != MemoryAccess::None &&
+                         !transaction.isPrefetch;
+  if (pcCounted) {
+    auto &counters = m_pcCounters[transaction.pc];
+    counters.accesses++;
+    counters.misses += transaction.isHit ? 0 : 1;
+  }
+
+  if (m_standalone) {
+    // Standalone caches only maintain the access counters
+    if (transaction.type != MemoryAccess::None) {
+      m_totals = CacheAccessTrace(m_totals, transaction);
+    }
+    return;
+  }
+
+  // We record the transaction along with the prior state of the way
+  const unsigned cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  if (traceSlot != s_invalidIndex) {
+    m_undoLog[traceSlot].transaction = transaction;
+    m_undoLog[traceSlot].cycle = cycle;
+    m_undoLog[traceSlot].invalidation = invalidation;
+    m_undoLog[traceSlot].pcCounted = pcCounted;
+  }
+  if (transaction.type != MemoryAccess::None) {
+    pushAccessTrace(transaction, cycle);
+  }
+}
+
+void CacheSim::setPCAccounting(bool enabled) {
+  if (m_pcAccounting && !enabled) {
+    m_pcCounters.clear();
+    // Accesses in the undo log are no longer part of the counters.
+    for (auto &trace : m_undoLog)
+      trace.pcCounted = false;
+  }
+  m_pcAccounting = enabled;
+}
+
 void CacheSim::undo() {
-  if (m_traceStack.size() == 0)
+  if (m_undoSize == 0)
     return;
 
-  const auto trace = popTrace();
-  popAccessTrace();
+  const unsigned slot = topTrace();
+  const CacheTrace &trace = m_undoLog[slot];
+  popTrace();
+  popAccessTrace(trace);
+  m_missClassifier.undo(trace.classifierUndo);
 
-  const auto &oldWay = trace.oldWay;
   const unsigned &lineIdx = trace.transaction.index.line;
   const unsigned &wayIdx = trace.transaction.index.way;
-  auto &line = m_cacheLines.at(lineIdx);
-  auto &way = line.at(wayIdx);
-
-  // Case 1: A cache way was transitioned to valid. In this case, we simply
-  // invalidate the cache way
-  if (trace.transaction.transToValid) {
-    // Invalidate the way
-    Q_ASSERT(m_cacheLines.at(lineIdx).count(wayIdx) != 0);
-    way = CacheWay();
-  }
-  // Case 2: A miss occurred on a valid entry. In this case, we have to restore
-  // the old way, which was evicted
-  // - Restore the old entry which was evicted
-  else if (!trace.transaction.isHit) {
-    way = oldWay;
-  }
-  // Case 3: Else, it was a cache hit; Revert replacement fields and dirty
-  // blocks
-  way.dirtyBlocks = oldWay.dirtyBlocks;
-  revertCacheLineReplFields(line, oldWay, wayIdx);
+
+  if (wayIdx == s_invalidIndex) {
+    // A write miss without write allocation, or a miss in an exclusive cache;
+    // the cache state was not modified.
+    emitPreviousTransaction();
+    return;
+  }
+
+  // The recorded state reflects the way and the replacement state of its line
+  // prior to the transaction. This covers ways which transitioned to valid,
+  // were evicted, hit or invalidated.
+  restoreWay(slot, lineIdx, wayIdx);
 
   // Notify that changes to the way has been performed
   emit wayInvalidated(lineIdx, wayIdx);
 
   // Finally, re-emit the transaction which occurred in the previous cache
   // access to update the cache highlighting state
-  if (m_traceStack.size() > 0) {
-    emit dataChanged(m_traceStack.begin()->transaction);
+  emitPreviousTransaction();
+}
+
+void CacheSim::emitPreviousTransaction() {
+  if (m_undoSize > 0) {
+    emit dataChanged(m_undoLog[topTrace()].transaction);
   } else {
     emit dataChanged(CacheTransaction());
   }
 }
 
-CacheSim::CacheTrace CacheSim::popTrace() {
-  Q_ASSERT(m_traceStack.size() > 0);
-  auto val = m_traceStack.front();
-  m_traceStack.pop_front();
-  return val;
-}
+unsigned CacheSim::pushTrace() {
+  const unsigned depth = vsrtl::core::ClockedComponent::reverseStackSize();
+  if (depth != m_undoDepth) {
+    // The undo stack size changed; previously recorded entries are discarded.
+    clearUndoLog();
+    m_undoDepth = depth;
+  }
+  if (depth == 0) {
+    return s_invalidIndex;
+  }
 
-void CacheSim::pushTrace(const CacheTrace &eviction) {
-  m_traceStack.push_front(eviction);
-  if (m_traceStack.size() > vsrtl::core::ClockedComponent::reverseStackSize()) {
-    m_traceStack.pop_back();
+  const unsigned cycle = ProcessorHandler::getProcessor()->getCycleCount();
+  if (m_undoSize == m_undoLog.size()) {
+    const unsigned oldestCycle =
+        m_undoSize > 0 ? m_undoLog[oldestTrace()].cycle : cycle;
+    if (oldestCycle + depth < cycle) {
+      // The oldest cycle in the log can no longer be reversed. All of its
+      // entries are dropped, such that no cycle is ever partially undone.
+      while (m_undoSize > 0 && m_undoLog[oldestTrace()].cycle == oldestCycle)
+        m_undoSize--;
+    } else {
+      growUndoLog();
+    }
   }
+
+  const unsigned slot = m_undoHead;
+  m_undoHead = (m_undoHead + 1) % m_undoLog.size();
+  m_undoSize++;
+  m_undoLog[slot].cycle = cycle;
+  return slot;
+}
+
+void CacheSim::growUndoLog() {
+  // Unwrap the ring such that the oldest entry is first, and append free
+  // entries after the newest entry.
+  const std::size_t size = m_undoLog.size();
+  const std::size_t oldest = size > 0 ? oldestTrace() : 0;
+  const std::size_t nWords = m_storage.dirtyWordsPerWay();
+  const std::size_t nReplWords = m_replacement->wordsPerLine();
+  std::rotate(m_undoLog.begin(), m_undoLog.begin() + oldest, m_undoLog.end());
+  std::rotate(m_undoDirtyBlocks.begin(),
+              m_undoDirtyBlocks.begin() + oldest * nWords,
+              m_undoDirtyBlocks.end());
+  std::rotate(m_undoReplState.begin(),
+              m_undoReplState.begin() + oldest * nReplWords,
+              m_undoReplState.end());
+
+  const std::size_t newSize = std::max<std::size_t>(2 * size, s_minUndoEntries);
+  m_undoLog.resize(newSize);
+  m_undoDirtyBlocks.resize(newSize * nWords);
+  m_undoReplState.resize(newSize * nReplWords);
+  m_undoHead = static_cast<unsigned>(size);
+}
+
+void CacheSim::popTrace() {
+  Q_ASSERT(m_undoSize > 0);
+  m_undoHead = topTrace();
+  m_undoSize--;
+}
+
+unsigned CacheSim::topTrace() const {
+  Q_ASSERT(m_undoSize > 0);
+  return (m_undoHead + m_undoLog.size() - 1) % m_undoLog.size();
+}
+
+unsigned CacheSim::oldestTrace() const {
+  Q_ASSERT(m_undoSize > 0);
+  return (m_undoHead + m_undoLog.size() - m_undoSize) % m_undoLog.size();
+}
+
+void CacheSim::clearUndoLog() {
+  m_undoLog.clear();
+  m_undoDirtyBlocks.clear();
+  m_undoReplState.clear();
+  m_undoHead = 0;
+  m_undoSize = 0;
 }
 
 AInt CacheSim::buildAddress(unsigned tag, unsigned lineIdx,
@@ -438,30 +890,56 @@ unsigned CacheSim::getBlockIdx(const AInt address) const {
   return maskedAddress;
 }
 
-const CacheSim::CacheLine *CacheSim::getLine(unsigned idx) const {
-  if (m_cacheLines.count(idx)) {
-    return &m_cacheLines.at(idx);
-  } else {
-    return nullptr;
+CacheSim::CacheWay CacheSim::getWay(unsigned lineIdx, unsigned wayIdx) const {
+  CacheWay way;
+  if (lineIdx >= m_storage.lines() || wayIdx >= m_storage.ways()) {
+    return way;
   }
+
+  const unsigned idx = m_storage.index(lineIdx, wayIdx);
+  way.valid = m_storage.valid(idx);
+  way.dirty = m_storage.dirty(idx);
+  if (way.valid) {
+    way.tag = m_storage.tag(idx);
+    way.lru = m_replacement->wayValue(lineIdx, wayIdx);
+  }
+  if (way.dirty) {
+    for (int i = 0; i < getBlocks(); ++i) {
+      if (m_storage.blockDirty(idx, i)) {
+        way.dirtyBlocks.insert(i);
+      }
+    }
+  }
+  return way;
 }
 
-void CacheSim::reverse() {
-  if (m_accessTrace.size() == 0) {
-    // Nothing to reverse
-    return;
+std::optional<CacheSim::CacheLine> CacheSim::getLine(unsigned idx) const {
+  if (idx >= m_storage.lines()) {
+    return std::nullopt;
+  }
+
+  CacheLine line;
+  for (int i = 0; i < getWays(); ++i) {
+    line[i] = getWay(idx, i);
   }
+  return line;
+}
 
+void CacheSim::reverse() {
+  // Undo all accesses performed in the cycle that is being reversed.
   const unsigned cycleToUndo =
       ProcessorHandler::getProcessor()->getCycleCount() + 1;
-  if (m_accessTrace.rbegin()->first != cycleToUndo) {
+  bool undone = false;
+  while (m_undoSize > 0 && m_undoLog[topTrace()].cycle == cycleToUndo) {
+    undo();
+    undone = true;
+  }
+
+  if (!undone) {
     // No cache access in this cycle
     return;
   }
 
-  // It is now safe to undo the cycle at the top of our access stack(s).
-  undo();
-
   CacheInterface::reverse();
 }
 
@@ -482,12 +960,21 @@ void CacheSim::reset() {
 
   m_isResetting = true;
 
-  m_cacheLines.clear();
-  m_accessTrace.clear();
-  m_traceStack.clear();
-
-  m_wordBits = ProcessorHandler::currentISA()->bits();
-  m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  m_storage.resize(getLines(), getWays(), getBlocks());
+  m_replacement->resize(getLines(), getWays());
+  m_missClassifier.resize(getLines() * getWays());
+  if (m_prefetcher) {
+    m_prefetcher->reset();
+  }
+  m_accessLog.clear();
+  clearUndoLog();
+  m_totals = CacheAccessTrace();
+  m_pcCounters.clear();
+
+  if (!m_standalone) {
+    m_wordBits = ProcessorHandler::currentISA()->bits();
+    m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  }
   recalculateMasks();
   m_isResetting = false;
 
@@ -499,8 +986,19 @@ void CacheSim::reset() {
 
 void CacheSim::updateConfiguration() {
   // Recalculate masks
-  m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  if (!m_standalone) {
+    m_byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  }
   recalculateMasks();
+
+  // The cache storage is reallocated, so any recorded traces are no longer
+  // valid.
+  m_storage.resize(getLines(), getWays(), getBlocks());
+  m_replacement = createReplacementPolicy(m_replPolicy, m_seed);
+  m_replacement->resize(getLines(), getWays());
+  m_missClassifier.resize(getLines() * getWays());
+  m_prefetcher = createPrefetcher(m_prefetchPolicy, getBlockBytes());
+  clearUndoLog();
   emit configurationChanged();
 }
 
@@ -534,6 +1032,21 @@ void CacheSim::setReplacementPolicy(ReplPolicy policy) {
   updateConfiguration();
 }
 
+void CacheSim::setInclusionPolicy(InclusionPolicy policy) {
+  m_inclusionPolicy = policy;
+  updateConfiguration();
+}
+
+void CacheSim::setPrefetchPolicy(PrefetchPolicy policy) {
+  m_prefetchPolicy = policy;
+  updateConfiguration();
+}
+
+void CacheSim::setSeed(uint32_t seed) {
+  m_seed = seed;
+  updateConfiguration();
+}
+
 void CacheSim::setPreset(const CachePreset &preset) {
   m_blocks = preset.blocks;
   m_ways = preset.ways;
@@ -541,6 +1054,7 @@ void CacheSim::setPreset(const CachePreset &preset) {
   m_wrPolicy = preset.wrPolicy;
   m_wrAllocPolicy = preset.wrAllocPolicy;
   m_replPolicy = preset.replPolicy;
+  m_seed = preset.seed;
 
   updateConfiguration();
 }
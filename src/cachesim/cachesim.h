@@ -2,12 +2,20 @@
 
 #include <map>
 #include <math.h>
+#include <optional>
 #include <vector>
 
 #include <QDataStream>
+#include <QIODevice>
 #include <QObject>
 
 #include "VSRTL/core/vsrtl_register.h"
+#include "cacheaccesslog.h"
+#include "cachestorage.h"
+#include "missattribution.h"
+#include "missclassifier.h"
+#include "prefetcher.h"
+#include "replacementpolicy.h"
 #include "processors/RISC-V/rv_memory.h"
 #include "processors/interface/ripesprocessor.h"
 
@@ -16,7 +24,10 @@ class CacheSim;
 
 enum WriteAllocPolicy { WriteAllocate, NoWriteAllocate };
 enum WritePolicy { WriteThrough, WriteBack };
-enum ReplPolicy { Random, LRU };
+// The inclusion policy of a cache with respect to the contents of the caches
+// above it in the hierarchy; non-inclusive non-exclusive (NINE), inclusive or
+// exclusive.
+enum InclusionPolicy { NINE, Inclusive, Exclusive };
 
 struct CachePreset {
   QString name;
@@ -28,7 +39,17 @@ struct CachePreset {
   WriteAllocPolicy wrAllocPolicy;
   ReplPolicy replPolicy;
 
+  // Seed of the pseudo-random number generators of the Random replacement
+  // policy.
+  uint32_t seed = 0;
+
+  // Presets are serialized with a leading marker, which is distinguishable from
+  // the leading QString of presets serialized before the seed was added (the
+  // serialized length of a non-null QString is even).
+  static constexpr quint32 s_serializationMarker = 0xFFFFFFFD;
+
   friend QDataStream &operator<<(QDataStream &arch, const CachePreset &object) {
+    arch << s_serializationMarker;
     arch << object.name;
     arch << object.blocks;
     arch << object.lines;
@@ -36,10 +57,24 @@ struct CachePreset {
     arch << object.wrPolicy;
     arch << object.wrAllocPolicy;
     arch << object.replPolicy;
+    arch << object.seed;
     return arch;
   }
 
   friend QDataStream &operator>>(QDataStream &arch, CachePreset &object) {
+    bool hasMarker = false;
+    if (auto *device = arch.device()) {
+      quint32 marker = 0;
+      QDataStream peekStream(device->peek(sizeof(marker)));
+      peekStream.setByteOrder(arch.byteOrder());
+      peekStream >> marker;
+      hasMarker = peekStream.status() == QDataStream::Ok &&
+                  marker == s_serializationMarker;
+    }
+    if (hasMarker) {
+      quint32 marker;
+      arch >> marker;
+    }
     arch >> object.name;
     arch >> object.blocks;
     arch >> object.lines;
@@ -47,6 +82,9 @@ struct CachePreset {
     arch >> object.wrPolicy;
     arch >> object.wrAllocPolicy;
     arch >> object.replPolicy;
+    object.seed = 0;
+    if (hasMarker)
+      arch >> object.seed;
     return arch;
   }
 
@@ -64,12 +102,13 @@ public:
   /**
    * @brief access
    * A function called by the logical "child" of this cache, indicating that it
-   * desires to access this cache
+   * desires to access this cache. @p pc is the address of the instruction
+   * performing the access, if known. @p bytes is the width of the access, where
+   * 0 denotes a word-sized access.
    */
-  virtual void access(AInt address, MemoryAccess::Type type) = 0;
-  void setNextLevelCache(const std::shared_ptr<CacheSim> &cache) {
-    m_nextLevelCache = cache;
-  }
+  virtual void access(AInt address, MemoryAccess::Type type, AInt pc = 0,
+                      unsigned bytes = 0) = 0;
+  void setNextLevelCache(const std::shared_ptr<CacheSim> &cache);
 
   /**
    * @brief reset
@@ -103,8 +142,8 @@ public:
     bool dirty = false;
     bool valid = false;
 
-    // LRU algorithm relies on invalid cache ways to have an initial high value.
-    // -1 ensures maximum value for all way sizes.
+    // The replacement state of the way (e.g., its LRU position), as given by
+    // ReplacementPolicy::wayValue. -1 for invalid ways.
     unsigned lru = -1;
   };
 
@@ -127,6 +166,8 @@ public:
   struct CacheTransaction {
     AInt address;
     CacheIndex index;
+    // The address of the instruction which issued the access.
+    AInt pc = 0;
 
     bool isHit = false;
     bool isWriteback = false; // True if the transaction resulted in an eviction
@@ -136,6 +177,18 @@ public:
         false; // True if the cacheline just transitioned from invalid to valid
     bool tagChanged =
         false; // True if transToValid or the previous entry was evicted
+
+    // True if the transaction is a prefetch rather than a demand access.
+    bool isPrefetch = false;
+    // True if a demand access hit a prefetched block, before (usefulPrefetch)
+    // or while (latePrefetch) the block was being prefetched.
+    bool usefulPrefetch = false;
+    bool latePrefetch = false;
+    // True if a demand access missed on a block which was evicted by a
+    // prefetch.
+    bool pollutingPrefetch = false;
+    // The 3C classification of a demand miss; see MissClassifier.
+    MissClassifier::MissClass missClass = MissClassifier::MissClass::None;
   };
 
   struct CacheAccessTrace {
@@ -144,48 +197,185 @@ public:
     int reads = 0;
     int writes = 0;
     int writebacks = 0;
+    int prefetches = 0;
+    int usefulPrefetches = 0;
+    int latePrefetches = 0;
+    int pollutingPrefetches = 0;
+    int compulsoryMisses = 0;
+    int capacityMisses = 0;
+    int conflictMisses = 0;
     CacheTransaction lastTransaction;
     CacheAccessTrace() {}
     CacheAccessTrace(const CacheTransaction &transaction)
         : CacheAccessTrace(CacheAccessTrace(), transaction) {}
     CacheAccessTrace(const CacheAccessTrace &pre,
-                     const CacheTransaction &transaction) {
+                     const CacheTransaction &transaction)
+        : CacheAccessTrace(pre) {
       lastTransaction = transaction;
-      reads = pre.reads + (transaction.type == MemoryAccess::Read ? 1 : 0);
-      writes = pre.writes + (transaction.type == MemoryAccess::Write ? 1 : 0);
-      writebacks = pre.writebacks + (transaction.isWriteback ? 1 : 0);
-      hits = pre.hits + (transaction.isHit ? 1 : 0);
-      misses = pre.misses + (transaction.isHit ? 0 : 1);
+      writebacks += transaction.isWriteback ? 1 : 0;
+      if (transaction.isPrefetch) {
+        // Prefetches are not demand accesses.
+        prefetches++;
+        return;
+      }
+      reads += transaction.type == MemoryAccess::Read ? 1 : 0;
+      writes += transaction.type == MemoryAccess::Write ? 1 : 0;
+      hits += transaction.isHit ? 1 : 0;
+      misses += transaction.isHit ? 0 : 1;
+      usefulPrefetches += transaction.usefulPrefetch ? 1 : 0;
+      latePrefetches += transaction.latePrefetch ? 1 : 0;
+      pollutingPrefetches += transaction.pollutingPrefetch ? 1 : 0;
+      using MissClass = MissClassifier::MissClass;
+      compulsoryMisses +=
+          transaction.missClass == MissClass::Compulsory ? 1 : 0;
+      capacityMisses += transaction.missClass == MissClass::Capacity ? 1 : 0;
+      conflictMisses += transaction.missClass == MissClass::Conflict ? 1 : 0;
     }
   };
 
   using CacheLine = std::map<unsigned, CacheWay>;
 
+  /**
+   * @brief CacheSim
+   * Constructs a cache simulator for the currently instantiated processor.
+   * Accesses are recorded per processor cycle, such that they may be plotted
+   * and undone when the processor is reversed.
+   */
   CacheSim(QObject *parent);
+
+  /**
+   * @brief CacheSim
+   * Constructs a standalone cache simulator for a processor with a word width
+   * of @p wordBits. A standalone cache simulator does not interact with the
+   * ProcessorHandler, and only maintains the cache state and its access
+   * counters. It may thus be driven from any thread, e.g., when replaying a
+   * recorded access stream.
+   */
+  CacheSim(unsigned wordBits, QObject *parent = nullptr);
+  ~CacheSim();
   void setWritePolicy(WritePolicy policy);
   void setWriteAllocatePolicy(WriteAllocPolicy policy);
   void setReplacementPolicy(ReplPolicy policy);
+  void setInclusionPolicy(InclusionPolicy policy);
+  void setPrefetchPolicy(PrefetchPolicy policy);
+
+  /**
+   * @brief setSeed
+   * Sets the seed of the Random replacement policy. Caches configured with the
+   * same seed select the same victims for the same sequence of accesses.
+   */
+  void setSeed(uint32_t seed);
+
+  /**
+   * @brief setHitLatency/setMemoryLatency
+   * Sets the # of cycles taken by a hit in this cache, and by an access to main
+   * memory. The memory latency is only used if this is the last level cache.
+   */
+  void setHitLatency(unsigned cycles) { m_hitLatency = cycles; }
+  void setMemoryLatency(unsigned cycles) { m_memoryLatency = cycles; }
+
+  /**
+   * @brief access
+   * Accesses the cache. Misses, write-throughs and evictions are forwarded to
+   * the next level cache, if any. Demand accesses train the prefetcher of the
+   * cache, and any predicted blocks are subsequently prefetched.
+   * Accesses spanning multiple blocks are performed as one access per block,
+   * and thus counted once per block.
+   */
+  void access(AInt address, MemoryAccess::Type type, AInt pc = 0,
+              unsigned bytes = 0) override;
+
+  /**
+   * @brief invalidate
+   * Invalidates all blocks of this cache (and of the caches above it, if this
+   * cache is inclusive) which hold data within the range [@p address, @p
+   * address + @p bytes). Called by a lower level cache to maintain inclusion.
+   * @returns true if any of the invalidated blocks were dirty.
+   */
+  bool invalidate(AInt address, unsigned bytes);
+
+  /**
+   * @brief upperLevelEviction
+   * Called by a cache above this cache, when it evicts the block at @p address
+   * of size @p bytes. Exclusive caches allocate the victim block, whereas other
+   * caches only write back dirty victims. Exclusion is only maintained if the
+   * blocks of an exclusive cache are no larger than those of the caches above
+   * it.
+   */
+  void upperLevelEviction(AInt address, unsigned bytes, bool dirty);
 
-  void access(AInt address, MemoryAccess::Type type) override;
   void undo();
   void reset() override;
 
   WriteAllocPolicy getWriteAllocPolicy() const { return m_wrAllocPolicy; }
   ReplPolicy getReplacementPolicy() const { return m_replPolicy; }
   WritePolicy getWritePolicy() const { return m_wrPolicy; }
+  InclusionPolicy getInclusionPolicy() const { return m_inclusionPolicy; }
+  PrefetchPolicy getPrefetchPolicy() const { return m_prefetchPolicy; }
+  uint32_t getSeed() const { return m_seed; }
+  unsigned getHitLatency() const { return m_hitLatency; }
+  unsigned getMemoryLatency() const { return m_memoryLatency; }
 
-  const std::map<unsigned, CacheAccessTrace> &getAccessTrace() const {
-    return m_accessTrace;
-  }
+  const CacheAccessLog &getAccessLog() const { return m_accessLog; }
 
   double getHitRate() const;
   unsigned getHits() const;
   unsigned getMisses() const;
   unsigned getWritebacks() const;
+
+  /**
+   * @brief getPrefetches and friends
+   * The # of blocks prefetched into the cache, and the # of demand accesses
+   * which hit a prefetched block (useful), hit a prefetched block before its
+   * prefetch completed (late; a subset of the useful prefetches), or missed on
+   * a block which was evicted by a prefetch (polluting).
+   */
+  unsigned getPrefetches() const { return m_totals.prefetches; }
+  unsigned getUsefulPrefetches() const { return m_totals.usefulPrefetches; }
+  unsigned getLatePrefetches() const { return m_totals.latePrefetches; }
+  unsigned getPollutingPrefetches() const {
+    return m_totals.pollutingPrefetches;
+  }
+
+  /**
+   * @brief getCompulsoryMisses and friends
+   * The breakdown of the demand misses of the cache as per the 3C model; see
+   * MissClassifier.
+   */
+  unsigned getCompulsoryMisses() const { return m_totals.compulsoryMisses; }
+  unsigned getCapacityMisses() const { return m_totals.capacityMisses; }
+  unsigned getConflictMisses() const { return m_totals.conflictMisses; }
+
+  /**
+   * @brief getPCAccessCounters
+   * @returns the # of demand accesses and misses of the cache, per address of
+   * the instruction which issued the accesses.
+   */
+  const PCAccessCounters &getPCAccessCounters() const { return m_pcCounters; }
+
+  /**
+   * @brief setPCAccounting
+   * Per-PC access counters are only maintained if enabled, since they cost a
+   * hash table lookup per access. The counters cover the accesses performed
+   * while enabled; disabling the accounting clears them.
+   */
+  void setPCAccounting(bool enabled);
+  bool pcAccounting() const { return m_pcAccounting; }
   CacheSize getCacheSize() const;
 
+  /**
+   * @brief getAMAT
+   * @returns the average memory access time, in cycles, of accesses to this
+   * cache: the hit latency plus the miss rate times the AMAT of the next level
+   * cache (or the memory latency, for the last level cache). The local miss
+   * rate of each cache is used, i.e., writebacks and write-throughs which
+   * reach a lower level cache count as accesses to that cache.
+   */
+  double getAMAT() const;
+
   AInt buildAddress(unsigned tag, unsigned lineIdx, unsigned blockIdx) const;
 
+  unsigned getByteOffset() const { return m_byteOffset; }
   int getBlockBits() const { return m_blocks; }
   int getWaysBits() const { return m_ways; }
   int getLineBits() const { return m_lines; }
@@ -193,9 +383,10 @@ public:
     return 32 - 2 /*byte offset*/ - getBlockBits() - getLineBits();
   }
 
-  int getBlocks() const { return static_cast<int>(std::pow(2, m_blocks)); }
-  int getWays() const { return static_cast<int>(std::pow(2, m_ways)); }
-  int getLines() const { return static_cast<int>(std::pow(2, m_lines)); }
+  int getBlocks() const { return 1 << m_blocks; }
+  unsigned getBlockBytes() const { return getBlocks() << m_byteOffset; }
+  int getWays() const { return 1 << m_ways; }
+  int getLines() const { return 1 << m_lines; }
   unsigned getBlockMask() const { return m_blockMask; }
   unsigned getTagMask() const { return m_tagMask; }
   unsigned getLineMask() const { return m_lineMask; }
@@ -204,7 +395,15 @@ public:
   unsigned getBlockIdx(const AInt address) const;
   unsigned getTag(const AInt address) const;
 
-  const CacheLine *getLine(unsigned idx) const;
+  /**
+   * @brief getLine/getWay
+   * Materializes a snapshot of the state of a cache line or way. These are
+   * intended for inspecting the cache (e.g., for drawing it), and should not be
+   * used on any performance-critical path.
+   * @returns std::nullopt if @p idx is not a valid line index.
+   */
+  std::optional<CacheLine> getLine(unsigned idx) const;
+  CacheWay getWay(unsigned lineIdx, unsigned wayIdx) const;
 
 public slots:
   void setBlocks(unsigned blocks);
@@ -240,17 +439,107 @@ signals:
   void cacheInvalidated();
 
 private:
+  friend class CacheInterface;
+
+  /**
+   * @brief The CacheTrace struct
+   * An entry of the undo log. Records a transaction along with the state of the
+   * cache way which it modified, prior to the transaction. The dirty blocks of
+   * the way and the replacement state of its line are stored separately, in
+   * m_undoDirtyBlocks and m_undoReplState. Transactions of type
+   * MemoryAccess::None modify the cache without being accesses (fills of
+   * victims from upper level caches and invalidations), and are not counted.
+   */
   struct CacheTrace {
     CacheTransaction transaction;
-    CacheWay oldWay;
+    unsigned cycle = 0;
+    VInt oldTag = 0;
+    VInt oldPollutionTag = 0;
+    unsigned oldReadyCycle = 0;
+    uint8_t oldFlags = 0;
+    // True if the transaction invalidated the way.
+    bool invalidation = false;
+    // True if the transaction was added to the per-PC access counters.
+    bool pcCounted = false;
+    MissClassifier::UndoRecord classifierUndo;
   };
 
-  std::pair<unsigned, CacheSim::CacheWay *>
-  locateEvictionWay(const CacheTransaction &transaction);
-  CacheWay evictAndUpdate(CacheTransaction &transaction);
+  // Initial # of entries of the undo log. Caches within a hierarchy may be
+  // modified several times per cycle (fills, writebacks, invalidations and
+  // prefetches), so the log grows by entries rather than by cycles.
+  static constexpr unsigned s_minUndoEntries = 64;
+
+  void snapshotWay(unsigned slot, unsigned lineIdx, unsigned wayIdx);
+  void restoreWay(unsigned slot, unsigned lineIdx, unsigned wayIdx);
+
+  unsigned locateEvictionWay(const CacheTransaction &transaction) const;
+  void evictAndUpdate(CacheTransaction &transaction, unsigned wayIdx);
   void analyzeCacheAccess(CacheTransaction &transaction) const;
-  void pushAccessTrace(const CacheTransaction &transaction);
-  void popAccessTrace();
+  void pushAccessTrace(const CacheTransaction &transaction, unsigned cycle);
+  void popAccessTrace(const CacheTrace &trace);
+
+  enum class AccessSource {
+    // An access by the processor or an upper level cache.
+    Demand,
+    // The fill of a victim block of an upper level cache into this (exclusive)
+    // cache, which is always allocated and not counted as an access.
+    Fill,
+    // A prefetch issued by the prefetcher of this cache. Prefetches of blocks
+    // which are already present in the cache are dropped.
+    Prefetch
+  };
+
+  /**
+   * @brief performAccess
+   * Performs an access of @p bytes bytes to the cache, originating from @p
+   * source. The access must not span multiple blocks.
+   */
+  void performAccess(AInt address, unsigned bytes, MemoryAccess::Type type,
+                     AInt pc, AccessSource source);
+
+  /**
+   * @brief missPenalty
+   * @returns the # of cycles taken to fetch a block which misses in this cache.
+   */
+  double missPenalty() const;
+
+  /**
+   * @brief currentCycle
+   * @returns the current cycle of the processor. Standalone caches have no
+   * notion of cycles, and instead count time in accesses.
+   */
+  unsigned currentCycle() const;
+
+  /**
+   * @brief exclusiveRead
+   * Performs a read requested by an upper level cache of this exclusive cache.
+   * Hits move the block to the upper level cache, invalidating it in this
+   * cache, and misses are forwarded without allocating the block.
+   */
+  void exclusiveRead(AInt address, AInt pc);
+  bool invalidateBlock(AInt address);
+
+  /**
+   * @brief forwardAccess
+   * Forwards an access of the range [@p address, @p address + @p bytes) to the
+   * next level cache, as one access per block of the next level cache.
+   */
+  void forwardAccess(AInt address, unsigned bytes, MemoryAccess::Type type,
+                     AInt pc = 0);
+
+  /**
+   * @brief beginTrace/recordTransaction
+   * Allocates an undo log entry recording the state of way @p wayIdx (if
+   * valid) prior to modifying it, and subsequently records the transaction
+   * which modified the way, updating the access counters.
+   */
+  unsigned beginTrace(unsigned lineIdx, unsigned wayIdx);
+  void recordTransaction(unsigned traceSlot,
+                         const CacheTransaction &transaction,
+                         bool invalidation);
+
+  void addUpperLevelCache(CacheSim *cache);
+  void removeUpperLevelCache(CacheSim *cache);
 
   /**
    * @brief updateConfiguration
@@ -270,6 +559,19 @@ private:
   ReplPolicy m_replPolicy = ReplPolicy::LRU;
   WritePolicy m_wrPolicy = WritePolicy::WriteBack;
   WriteAllocPolicy m_wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
+  InclusionPolicy m_inclusionPolicy = InclusionPolicy::NINE;
+  PrefetchPolicy m_prefetchPolicy = PrefetchPolicy::NoPrefetch;
+  uint32_t m_seed = 0;
+
+  unsigned m_hitLatency = 1;
+  unsigned m_memoryLatency = 100;
+
+  /**
+   * @brief m_upperLevelCaches
+   * The caches which have this cache as their next level cache. Registered
+   * through CacheInterface::setNextLevelCache.
+   */
+  std::vector<CacheSim *> m_upperLevelCaches;
 
   unsigned m_blockMask = -1;
   unsigned m_lineMask = -1;
@@ -282,36 +584,70 @@ private:
   unsigned m_wordBits = -1;
 
   /**
-   * @brief m_cacheLines
+   * @brief m_storage
    * The datastructure for storing our cache hierachy, as per the current cache
    * configuration.
    */
-  std::map<unsigned, CacheLine> m_cacheLines;
+  CacheStorage m_storage;
+
+  /**
+   * @brief m_replacement
+   * The replacement state of the cache, as per the current replacement policy.
+   * Undoing a transaction restores the replacement state of its line from the
+   * undo log.
+   */
+  std::unique_ptr<ReplacementPolicy> m_replacement;
 
-  void updateCacheLineReplFields(CacheLine &line, unsigned wayIdx);
   /**
-   * @brief revertCacheLineReplFields
-   * Called whenever undoing a transaction to the cache. Reverts a cacheline's
-   * replacement fields according to the configured replacement policy.
+   * @brief m_missClassifier
+   * Classifies the demand misses of the cache. Undoing a transaction undoes its
+   * access to the classifier, if any.
    */
-  void revertCacheLineReplFields(CacheLine &line, const CacheWay &oldWay,
-                                 unsigned wayIdx);
+  MissClassifier m_missClassifier;
 
   /**
-   * @brief m_accessTrace
-   * The access trace stack contains cache access statistics for each simulation
-   * cycle. Contrary to the TraceStack (m_traceStack).
+   * @brief m_prefetcher
+   * The prefetcher of the cache, as per the current prefetch policy; nullptr if
+   * prefetching is disabled. m_prefetches holds the blocks to be prefetched
+   * after a demand access.
    */
-  std::map<unsigned, CacheAccessTrace> m_accessTrace;
+  std::unique_ptr<Prefetcher> m_prefetcher;
+  std::vector<AInt> m_prefetches;
+
+  void invalidateWay(unsigned lineIdx, unsigned wayIdx);
 
   /**
-   * @brief m_traceStack
-   * The following information is used to track all most-recent modifications
-   * made to the stack. The stack is of a fixed sized which is equal to the undo
-   * stack of VSRTL memory elements. Storing all modifications allows us to
-   * rollback any changes performed to the cache, when clock cycles are undone.
+   * @brief m_accessLog
+   * Log of the accesses performed on the cache, used for plotting. Accesses are
+   * only logged up until the maximum # of plotted cycles
+   * (RIPES_SETTING_CACHE_MAXCYCLES), bounding its memory usage.
    */
-  std::deque<CacheTrace> m_traceStack;
+  CacheAccessLog m_accessLog;
+  unsigned m_maxLoggedCycles = 0;
+
+  /**
+   * @brief m_undoLog
+   * Ring buffer of the most recent modifications made to the cache. The log
+   * holds all entries of the cycles which the VSRTL memory elements are able
+   * to reverse (RIPES_SETTING_REWINDSTACKSIZE), and grows on demand. Entries
+   * are only overwritten once all entries of their cycle are beyond the undo
+   * stack, such that a reversible cycle is always restored completely.
+   * Storing these modifications allows us to rollback any changes performed to
+   * the cache, when clock cycles are undone.
+   */
+  std::vector<CacheTrace> m_undoLog;
+  // The dirty blocks of each entry in the undo log; dirtyWordsPerWay words per
+  // entry.
+  std::vector<uint64_t> m_undoDirtyBlocks;
+  // The replacement state of the line of each entry in the undo log;
+  // ReplacementPolicy::wordsPerLine words per entry.
+  std::vector<ReplacementPolicy::Word> m_undoReplState;
+  // Index of the next entry to be written in the undo log.
+  unsigned m_undoHead = 0;
+  // # of valid entries in the undo log.
+  unsigned m_undoSize = 0;
+  // The size of the VSRTL undo stack that the undo log was recorded for.
+  unsigned m_undoDepth = 0;
 
   /**
    * @brief m_isResetting
@@ -324,12 +660,63 @@ private:
    */
   bool m_isResetting = false;
 
-  CacheTrace popTrace();
-  void pushTrace(const CacheTrace &trace);
+  /**
+   * @brief m_standalone
+   * True if this cache simulator is not attached to the ProcessorHandler. See
+   * the standalone constructor.
+   */
+  bool m_standalone = false;
+
+  /**
+   * @brief m_throughputMode
+   * Enabled whilst the processor is running. In throughput mode, accesses only
+   * update the cache state, its counters and the (bounded) undo and access
+   * logs; no signals are emitted, and plotting summaries are computed lazily
+   * once plotted after the run.
+   */
+  bool m_throughputMode = false;
+
+  /**
+   * @brief m_totals
+   * Running totals of all accesses performed on the cache.
+   */
+  CacheAccessTrace m_totals;
+
+  /**
+   * @brief m_pcCounters
+   * Demand accesses and misses per PC; maintained alongside m_totals if
+   * m_pcAccounting is set.
+   */
+  PCAccessCounters m_pcCounters;
+  bool m_pcAccounting = false;
+
+  /**
+   * @brief pushTrace
+   * Allocates a new entry in the undo log for the current cycle. If the log is
+   * full, the entries of the oldest cycle are overwritten if that cycle can no
+   * longer be reversed; else, the log is grown.
+   * @returns the index of the entry, or s_invalidIndex if undoing is disabled.
+   */
+  unsigned pushTrace();
+  void growUndoLog();
+  void popTrace();
+  unsigned topTrace() const;
+  unsigned oldestTrace() const;
+  void clearUndoLog();
+
+  /**
+   * @brief emitPreviousTransaction
+   * Re-emits the most recent transaction on the trace stack, to restore the
+   * cache highlighting state after an undo.
+   */
+  void emitPreviousTransaction();
 };
 
 const static std::map<ReplPolicy, QString> s_cacheReplPolicyStrings{
-    {ReplPolicy::Random, "Random"}, {ReplPolicy::LRU, "LRU"}};
+    {ReplPolicy::Random, "Random"}, {ReplPolicy::LRU, "LRU"},
+    {ReplPolicy::PLRU, "Tree-PLRU"}, {ReplPolicy::FIFO, "FIFO"},
+    {ReplPolicy::SRRIP, "SRRIP"},   {ReplPolicy::BRRIP, "BRRIP"},
+    {ReplPolicy::LFU, "LFU"}};
 const static std::map<WriteAllocPolicy, QString> s_cacheWriteAllocateStrings{
     {WriteAllocPolicy::WriteAllocate, "Write allocate"},
     {WriteAllocPolicy::NoWriteAllocate, "No write allocate"}};
@@ -338,6 +725,17 @@ const static std::map<WritePolicy, QString> s_cacheWritePolicyStrings{
     {WritePolicy::WriteThrough, "Write-through"},
     {WritePolicy::WriteBack, "Write-back"}};
 
+const static std::map<PrefetchPolicy, QString> s_cachePrefetchPolicyStrings{
+    {PrefetchPolicy::NoPrefetch, "None"},
+    {PrefetchPolicy::NextLine, "Next-line"},
+    {PrefetchPolicy::Stride, "Stride (RPT)"},
+    {PrefetchPolicy::Stream, "Stream"}};
+
+const static std::map<InclusionPolicy, QString> s_cacheInclusionPolicyStrings{
+    {InclusionPolicy::NINE, "Non-inclusive non-exclusive"},
+    {InclusionPolicy::Inclusive, "Inclusive"},
+    {InclusionPolicy::Exclusive, "Exclusive"}};
+
 } // namespace Ripes
 
 Q_DECLARE_METATYPE(Ripes::CacheSim::CacheTransaction);
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The CacheStorage class
+ * Flat, structure-of-arrays storage of the state of a set-associative cache.
+ * Every per-way array is indexed by (lineIdx * ways + wayIdx), meaning that all
+ * ways of a cache line are laid out contiguously in memory. This allows for
+ * cache lookups without any tree traversals or heap allocations on the access
+ * path. Replacement state is maintained separately, by the ReplacementPolicy
+ * of the cache.
+ */
+class CacheStorage {
+public:
+  static constexpr unsigned s_invalidIndex = static_cast<unsigned>(-1);
+
+  /**
+   * @brief resize
+   * (Re)allocates the storage for a cache of the given geometry. All ways are
+   * invalidated.
+   */
+  void resize(unsigned lines, unsigned ways, unsigned blocks) {
+    m_lines = lines;
+    m_ways = ways;
+    m_blocks = blocks;
+    m_dirtyWordsPerWay = (blocks + 63) / 64;
+    const unsigned entries = lines * ways;
+    m_tags.assign(entries, 0);
+    m_flags.assign(entries, 0);
+    m_readyCycles.assign(entries, 0);
+    m_pollutionTags.assign(entries, 0);
+    m_dirtyBlocks.assign(static_cast<std::size_t>(entries) * m_dirtyWordsPerWay,
+                         0);
+  }
+
+  /**
+   * @brief clear
+   * Invalidates all ways while retaining the current geometry.
+   */
+  void clear() { resize(m_lines, m_ways, m_blocks); }
+
+  unsigned lines() const { return m_lines; }
+  unsigned ways() const { return m_ways; }
+  unsigned blocks() const { return m_blocks; }
+
+  unsigned index(unsigned lineIdx, unsigned wayIdx) const {
+    return lineIdx * m_ways + wayIdx;
+  }
+
+  VInt tag(unsigned idx) const { return m_tags[idx]; }
+  bool valid(unsigned idx) const { return m_flags[idx] & Valid; }
+  bool dirty(unsigned idx) const { return m_flags[idx] & Dirty; }
+  bool prefetched(unsigned idx) const { return m_flags[idx] & Prefetched; }
+  uint8_t flags(unsigned idx) const { return m_flags[idx]; }
+
+  void setTag(unsigned idx, VInt tag) { m_tags[idx] = tag; }
+  void setValid(unsigned idx, bool v) { setFlag(idx, Valid, v); }
+  void setDirty(unsigned idx, bool v) { setFlag(idx, Dirty, v); }
+  void setPrefetched(unsigned idx, bool v) { setFlag(idx, Prefetched, v); }
+  void setFlags(unsigned idx, uint8_t flags) { m_flags[idx] = flags; }
+
+  /**
+   * @brief readyCycle
+   * The cycle at which the prefetch of the block in the way at @p idx
+   * completes. Only meaningful if the way is prefetched().
+   */
+  unsigned readyCycle(unsigned idx) const { return m_readyCycles[idx]; }
+  void setReadyCycle(unsigned idx, unsigned cycle) {
+    m_readyCycles[idx] = cycle;
+  }
+
+  bool hasPollutionTag(unsigned idx) const {
+    return m_flags[idx] & PollutionValid;
+  }
+  VInt pollutionTag(unsigned idx) const { return m_pollutionTags[idx]; }
+  void setPollutionTag(unsigned idx, VInt tag) {
+    m_pollutionTags[idx] = tag;
+    setFlag(idx, PollutionValid, true);
+  }
+  void clearPollutionTag(unsigned idx) { setFlag(idx, PollutionValid, false); }
+
+  bool blockDirty(unsigned idx, unsigned blockIdx) const {
+    return dirtyWords(idx)[blockIdx / 64] & (uint64_t(1) << (blockIdx % 64));
+  }
+  void setBlockDirty(unsigned idx, unsigned blockIdx) {
+    dirtyWords(idx)[blockIdx / 64] |= uint64_t(1) << (blockIdx % 64);
+  }
+  void clearDirtyBlocks(unsigned idx) {
+    uint64_t *words = dirtyWords(idx);
+    for (unsigned i = 0; i < m_dirtyWordsPerWay; ++i)
+      words[i] = 0;
+  }
+  unsigned dirtyWordsPerWay() const { return m_dirtyWordsPerWay; }
+  uint64_t *dirtyWords(unsigned idx) {
+    return &m_dirtyBlocks[static_cast<std::size_t>(idx) * m_dirtyWordsPerWay];
+  }
+  const uint64_t *dirtyWords(unsigned idx) const {
+    return &m_dirtyBlocks[static_cast<std::size_t>(idx) * m_dirtyWordsPerWay];
+  }
+
+  /**
+   * @brief invalidate
+   * Resets the way at @p idx to its initial (invalid) state. The pollution tag
+   * of the way is retained.
+   */
+  void invalidate(unsigned idx) {
+    m_tags[idx] = 0;
+    m_flags[idx] &= PollutionValid;
+    clearDirtyBlocks(idx);
+  }
+
+  /**
+   * @brief findWay
+   * @returns the index of the way within line @p lineIdx which holds a valid
+   * entry for @p tag, or s_invalidIndex if no such way exists.
+   */
+  unsigned findWay(unsigned lineIdx, VInt tag) const {
+    const unsigned base = index(lineIdx, 0);
+    for (unsigned i = 0; i < m_ways; ++i) {
+      if ((m_flags[base + i] & Valid) && m_tags[base + i] == tag)
+        return i;
+    }
+    return s_invalidIndex;
+  }
+
+  /**
+   * @brief findInvalidWay
+   * @returns the index of the first invalid way within line @p lineIdx, or
+   * s_invalidIndex if all ways are valid.
+   */
+  unsigned findInvalidWay(unsigned lineIdx) const {
+    const unsigned base = index(lineIdx, 0);
+    for (unsigned i = 0; i < m_ways; ++i) {
+      if (!(m_flags[base + i] & Valid))
+        return i;
+    }
+    return s_invalidIndex;
+  }
+
+  /**
+   * @brief findPollutionWay
+   * @returns the index of the way within line @p lineIdx which holds the
+   * pollution tag @p tag, or s_invalidIndex if no such way exists.
+   */
+  unsigned findPollutionWay(unsigned lineIdx, VInt tag) const {
+    const unsigned base = index(lineIdx, 0);
+    for (unsigned i = 0; i < m_ways; ++i) {
+      if ((m_flags[base + i] & PollutionValid) &&
+          m_pollutionTags[base + i] == tag)
+        return i;
+    }
+    return s_invalidIndex;
+  }
+
+private:
+  enum Flags : uint8_t {
+    Valid = 0b1,
+    Dirty = 0b10,
+    Prefetched = 0b100,
+    PollutionValid = 0b1000
+  };
+
+  void setFlag(unsigned idx, Flags flag, bool v) {
+    if (v)
+      m_flags[idx] |= flag;
+    else
+      m_flags[idx] &= ~flag;
+  }
+
+  unsigned m_lines = 0;
+  unsigned m_ways = 0;
+  unsigned m_blocks = 0;
+  unsigned m_dirtyWordsPerWay = 0;
+
+  std::vector<VInt> m_tags;
+  std::vector<uint8_t> m_flags;
+  std::vector<unsigned> m_readyCycles;
+  std::vector<VInt> m_pollutionTags;
+  // Per-way bitmask of dirty blocks; m_dirtyWordsPerWay words per way.
+  std::vector<uint64_t> m_dirtyBlocks;
+};
+
+} // namespace Ripes
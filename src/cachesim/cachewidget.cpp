@@ -16,6 +16,9 @@ CacheWidget::CacheWidget(QWidget *parent)
 
   m_scene = std::make_unique<QGraphicsScene>(this);
   m_cacheSim = std::make_shared<CacheSim>(this);
+  // Misses of the caches of the GUI may be attributed to instructions in the
+  // program viewer.
+  m_cacheSim->setPCAccounting(true);
   m_ui->cacheConfig->setCache(m_cacheSim);
   m_ui->cachePlot->setCache(m_cacheSim);
 
@@ -21,7 +21,7 @@ L1CacheShim::L1CacheShim(CacheType type, QObject *parent)
   processorReset();
 }
 
-void L1CacheShim::access(AInt, MemoryAccess::Type) {
+void L1CacheShim::access(AInt, MemoryAccess::Type, AInt, unsigned) {
   // Should never occur; the shim determines accesses based on investigating the
   // associated memory.
   Q_ASSERT(false);
@@ -52,10 +52,12 @@ void L1CacheShim::processorWasClocked() {
     // if so, the access type.
     switch (dataAccess.type) {
     case MemoryAccess::Write:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write);
+      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Write,
+                               dataAccess.pc, dataAccess.bytes);
       break;
     case MemoryAccess::Read:
-      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read);
+      m_nextLevelCache->access(dataAccess.address, MemoryAccess::Read,
+                               dataAccess.pc, dataAccess.bytes);
       break;
     case MemoryAccess::None:
     default:
@@ -64,7 +66,10 @@ void L1CacheShim::processorWasClocked() {
   } else {
     const auto instrAccess = ProcessorHandler::getProcessor()->instrMemAccess();
     if (instrAccess.type == MemoryAccess::Read) {
-      m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read);
+      // Instruction fetches are performed by the fetched instruction itself.
+      m_nextLevelCache->access(instrAccess.address, MemoryAccess::Read,
+                               instrAccess.address,
+                               ProcessorHandler::currentISA()->instrBytes());
     }
   }
 }
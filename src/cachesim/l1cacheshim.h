@@ -19,7 +19,8 @@ class L1CacheShim : public CacheInterface {
 public:
   enum class CacheType { DataCache, InstrCache };
   L1CacheShim(CacheType type, QObject *parent);
-  void access(AInt address, MemoryAccess::Type type) override;
+  void access(AInt address, MemoryAccess::Type type, AInt pc = 0,
+              unsigned bytes = 0) override;
 
   void setType(CacheType type);
 
@@ -0,0 +1,55 @@
+#include "missattribution.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+std::vector<std::pair<AInt, AccessCounters>>
+sortByMisses(const PCAccessCounters &counters) {
+  std::vector<std::pair<AInt, AccessCounters>> sorted(counters.begin(),
+                                                      counters.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    if (a.second.misses != b.second.misses)
+      return a.second.misses > b.second.misses;
+    return a.first < b.first;
+  });
+  return sorted;
+}
+
+const ReverseSymbolMap::value_type *
+enclosingSymbol(AInt pc, const ReverseSymbolMap &symbols) {
+  auto it = symbols.upper_bound(pc);
+  while (it != symbols.begin()) {
+    --it;
+    if (!it->second.isLocal())
+      return &*it;
+  }
+  return nullptr;
+}
+
+std::vector<SymbolAccessCounters>
+aggregateBySymbol(const PCAccessCounters &counters,
+                  const ReverseSymbolMap &symbols) {
+  std::map<AInt, SymbolAccessCounters> aggregated;
+  for (const auto &[pc, pcCounters] : counters) {
+    const auto *symbol = enclosingSymbol(pc, symbols);
+    const AInt address = symbol ? symbol->first : 0;
+    auto &entry = aggregated[address];
+    entry.symbol = symbol ? symbol->second.v : QString();
+    entry.address = address;
+    entry.counters.accesses += pcCounters.accesses;
+    entry.counters.misses += pcCounters.misses;
+  }
+
+  std::vector<SymbolAccessCounters> sorted;
+  sorted.reserve(aggregated.size());
+  for (auto &entry : aggregated)
+    sorted.push_back(entry.second);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.counters.misses > b.counters.misses;
+                   });
+  return sorted;
+}
+
+} // namespace Ripes
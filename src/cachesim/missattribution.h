@@ -0,0 +1,57 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "isa/isa_defines.h"
+
+namespace Ripes {
+
+/**
+ * @brief The AccessCounters struct
+ * The # of demand accesses to a cache, and the # of those which missed,
+ * attributed to a single instruction or symbol.
+ */
+struct AccessCounters {
+  unsigned accesses = 0;
+  unsigned misses = 0;
+};
+
+/// Access counters of a cache, indexed by the address of the instruction which
+/// issued the accesses.
+using PCAccessCounters = std::unordered_map<AInt, AccessCounters>;
+
+struct SymbolAccessCounters {
+  QString symbol;
+  AInt address = 0;
+  AccessCounters counters;
+};
+
+/**
+ * @brief sortByMisses
+ * @returns the entries of @p counters, ordered by descending # of misses. Ties
+ * are ordered by ascending PC.
+ */
+std::vector<std::pair<AInt, AccessCounters>>
+sortByMisses(const PCAccessCounters &counters);
+
+/**
+ * @brief enclosingSymbol
+ * @returns the closest non-local symbol of @p symbols at or preceding @p pc,
+ * i.e., the function or label which contains the instruction at @p pc, or
+ * nullptr if no such symbol exists.
+ */
+const ReverseSymbolMap::value_type *
+enclosingSymbol(AInt pc, const ReverseSymbolMap &symbols);
+
+/**
+ * @brief aggregateBySymbol
+ * Aggregates @p counters per symbol of @p symbols, ordered by descending # of
+ * misses. Each PC is attributed to its enclosing symbol. PCs without an
+ * enclosing symbol are attributed to an unnamed symbol at address 0.
+ */
+std::vector<SymbolAccessCounters>
+aggregateBySymbol(const PCAccessCounters &counters,
+                  const ReverseSymbolMap &symbols);
+
+} // namespace Ripes
@@ -0,0 +1,144 @@
+#include "missclassifier.h"
+
+#include <QtGlobal>
+
+namespace Ripes {
+
+void MissClassifier::resize(unsigned capacity) {
+  m_capacity = capacity;
+  m_size = 0;
+  m_head = s_invalidNode;
+  m_tail = s_invalidNode;
+  m_blocks.assign(capacity, 0);
+  m_next.assign(capacity, s_invalidNode);
+  m_prev.assign(capacity, s_invalidNode);
+  m_freeNodes.clear();
+  m_nodes.clear();
+}
+
+MissClassifier::MissClass MissClassifier::access(AInt block, bool hit,
+                                                 bool allocate,
+                                                 UndoRecord *undo) {
+  if (undo)
+    *undo = UndoRecord();
+
+  auto it = m_nodes.find(block);
+  const bool referenced = it != m_nodes.end();
+  const bool resident = referenced && it->second != s_invalidNode;
+  MissClass missClass = MissClass::None;
+  if (!hit) {
+    missClass = !referenced ? MissClass::Compulsory
+                : resident  ? MissClass::Conflict
+                            : MissClass::Capacity;
+  }
+  if (!allocate || m_capacity == 0)
+    return missClass;
+
+  UndoRecord record;
+  record.valid = true;
+  record.block = block;
+  record.firstReference = !referenced;
+  record.wasResident = resident;
+
+  if (resident) {
+    const unsigned node = it->second;
+    record.hasOther = m_next[node] != s_invalidNode;
+    if (record.hasOther)
+      record.other = m_blocks[m_next[node]];
+    if (node != m_head) {
+      unlink(node);
+      pushFront(node);
+    }
+  } else {
+    unsigned node;
+    if (m_size == m_capacity) {
+      // Evict the least recently used block.
+      node = m_tail;
+      unlink(node);
+      record.hasOther = true;
+      record.other = m_blocks[node];
+      m_nodes[m_blocks[node]] = s_invalidNode;
+    } else if (!m_freeNodes.empty()) {
+      node = m_freeNodes.back();
+      m_freeNodes.pop_back();
+      m_size++;
+    } else {
+      node = m_size++;
+    }
+    m_blocks[node] = block;
+    pushFront(node);
+    if (referenced)
+      it->second = node;
+    else
+      m_nodes.emplace(block, node);
+  }
+
+  if (undo)
+    *undo = record;
+  return missClass;
+}
+
+void MissClassifier::undo(const UndoRecord &record) {
+  if (!record.valid)
+    return;
+
+  auto it = m_nodes.find(record.block);
+  Q_ASSERT(it != m_nodes.end() && it->second == m_head);
+  const unsigned node = it->second;
+  unlink(node);
+
+  if (record.wasResident) {
+    // Move the block back in front of its former successor.
+    if (record.hasOther)
+      insertBefore(node, m_nodes.at(record.other));
+    else
+      pushBack(node);
+    return;
+  }
+
+  if (record.firstReference)
+    m_nodes.erase(it);
+  else
+    it->second = s_invalidNode;
+
+  if (record.hasOther) {
+    // Reinstate the evicted block as the least recently used block.
+    m_blocks[node] = record.other;
+    m_nodes[record.other] = node;
+    pushBack(node);
+  } else {
+    m_freeNodes.push_back(node);
+    m_size--;
+  }
+}
+
+void MissClassifier::unlink(unsigned node) {
+  const unsigned prev = m_prev[node];
+  const unsigned next = m_next[node];
+  (prev == s_invalidNode ? m_head : m_next[prev]) = next;
+  (next == s_invalidNode ? m_tail : m_prev[next]) = prev;
+}
+
+void MissClassifier::pushFront(unsigned node) {
+  m_prev[node] = s_invalidNode;
+  m_next[node] = m_head;
+  (m_head == s_invalidNode ? m_tail : m_prev[m_head]) = node;
+  m_head = node;
+}
+
+void MissClassifier::pushBack(unsigned node) {
+  m_next[node] = s_invalidNode;
+  m_prev[node] = m_tail;
+  (m_tail == s_invalidNode ? m_head : m_next[m_tail]) = node;
+  m_tail = node;
+}
+
+void MissClassifier::insertBefore(unsigned node, unsigned successor) {
+  const unsigned prev = m_prev[successor];
+  m_prev[node] = prev;
+  m_next[node] = successor;
+  m_prev[successor] = node;
+  (prev == s_invalidNode ? m_head : m_next[prev]) = node;
+}
+
+} // namespace Ripes
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The MissClassifier class
+ * Classifies the misses of a cache as compulsory, capacity or conflict misses,
+ * as per the 3C model. A miss is compulsory if the block was never referenced
+ * before, a capacity miss if it also misses in a fully associative LRU cache of
+ * the same capacity (the shadow cache), and a conflict miss otherwise.
+ * The shadow cache is a doubly linked list of the resident blocks, ordered from
+ * the most to the least recently used block. A single hash map from block
+ * numbers to list nodes doubles as the set of referenced blocks, such that each
+ * access costs a single lookup.
+ * Accesses may be undone, given the UndoRecord returned for the access, in the
+ * reverse order of which they were performed.
+ */
+class MissClassifier {
+public:
+  enum class MissClass : uint8_t { None, Compulsory, Capacity, Conflict };
+
+  struct UndoRecord {
+    AInt block = 0;
+    // The least recently used block, if evicted by the access (for blocks
+    // which were not resident), or the block following the accessed block in
+    // the LRU order (for resident blocks).
+    AInt other = 0;
+    bool valid = false;
+    bool firstReference = false;
+    bool wasResident = false;
+    bool hasOther = false;
+  };
+
+  /**
+   * @brief resize
+   * Resets the classifier, for a cache holding @p capacity blocks.
+   */
+  void resize(unsigned capacity);
+  void clear() { resize(m_capacity); }
+
+  /**
+   * @brief access
+   * Performs an access to block @p block, which hit in the cache if @p hit is
+   * set. If @p allocate is not set, the access does not allocate the block
+   * (e.g., a write miss without write allocation) and leaves the classifier
+   * unmodified. @returns the class of the access if it was a miss, and
+   * MissClass::None otherwise. If @p undo is non-null, it is set to a record by
+   * which the access may be undone.
+   */
+  MissClass access(AInt block, bool hit, bool allocate, UndoRecord *undo);
+  void undo(const UndoRecord &record);
+
+private:
+  static constexpr unsigned s_invalidNode = static_cast<unsigned>(-1);
+
+  void unlink(unsigned node);
+  void pushFront(unsigned node);
+  void pushBack(unsigned node);
+  void insertBefore(unsigned node, unsigned successor);
+
+  unsigned m_capacity = 0;
+  unsigned m_size = 0;
+  unsigned m_head = s_invalidNode;
+  unsigned m_tail = s_invalidNode;
+  std::vector<AInt> m_blocks;
+  std::vector<unsigned> m_next;
+  std::vector<unsigned> m_prev;
+  std::vector<unsigned> m_freeNodes;
+
+  // All referenced blocks, mapped to their node in the shadow cache, or
+  // s_invalidNode if not resident.
+  std::unordered_map<AInt, unsigned> m_nodes;
+};
+
+} // namespace Ripes
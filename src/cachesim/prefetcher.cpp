@@ -0,0 +1,216 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Ripes {
+
+namespace {
+
+/**
+ * @brief The NextLinePrefetcher class
+ * Tagged next-line prefetching; each triggering access prefetches the block
+ * following the accessed block.
+ */
+class NextLinePrefetcher : public Prefetcher {
+public:
+  using Prefetcher::Prefetcher;
+
+  void train(AInt address, AInt, bool trigger,
+             std::vector<AInt> &prefetches) override {
+    if (trigger)
+      prefetches.push_back(blockAddress(address) + m_blockBytes);
+  }
+};
+
+/**
+ * @brief The StridePrefetcher class
+ * A PC-indexed reference prediction table (RPT). Each entry tracks the last
+ * address accessed by a load/store instruction along with the stride between
+ * its consecutive accesses. Once a stride has been observed repeatedly (the
+ * Steady state), the next address along the stride is prefetched. If that
+ * address lies within the accessed block, the next block in the direction of
+ * the stride is prefetched instead.
+ */
+class StridePrefetcher : public Prefetcher {
+public:
+  using Prefetcher::Prefetcher;
+
+  void train(AInt address, AInt pc, bool,
+             std::vector<AInt> &prefetches) override {
+    // Instructions are at least 2-byte aligned.
+    Entry &entry = m_table[(pc >> 1) % s_entries];
+    if (!entry.valid || entry.pc != pc) {
+      entry = Entry();
+      entry.valid = true;
+      entry.pc = pc;
+      entry.lastAddress = address;
+      return;
+    }
+
+    const AIntS stride = static_cast<AIntS>(address - entry.lastAddress);
+    const bool correct = stride == entry.stride;
+    switch (entry.state) {
+    case State::Initial:
+      entry.state = correct ? State::Steady : State::Transient;
+      break;
+    case State::Transient:
+      entry.state = correct ? State::Steady : State::NoPrediction;
+      break;
+    case State::Steady:
+      entry.state = correct ? State::Steady : State::Initial;
+      break;
+    case State::NoPrediction:
+      entry.state = correct ? State::Transient : State::NoPrediction;
+      break;
+    }
+    // The stride of a steady entry is retained upon a single misprediction.
+    if (!correct && entry.state != State::Initial)
+      entry.stride = stride;
+    entry.lastAddress = address;
+
+    if (entry.state != State::Steady || entry.stride == 0)
+      return;
+    AInt target = address + entry.stride;
+    if (blockAddress(target) == blockAddress(address)) {
+      target = entry.stride > 0 ? blockAddress(address) + m_blockBytes
+                                : blockAddress(address) - m_blockBytes;
+    }
+    prefetches.push_back(blockAddress(target));
+  }
+
+  void reset() override { m_table.fill(Entry()); }
+
+private:
+  static constexpr unsigned s_entries = 64;
+
+  enum class State { Initial, Transient, Steady, NoPrediction };
+  struct Entry {
+    AInt pc = 0;
+    AInt lastAddress = 0;
+    AIntS stride = 0;
+    State state = State::Initial;
+    bool valid = false;
+  };
+
+  std::array<Entry, s_entries> m_table;
+};
+
+/**
+ * @brief The StreamPrefetcher class
+ * Tracks up to s_streams sequential miss streams. A triggering access which
+ * lies within s_window blocks of the last access of a stream confirms the
+ * stream, and establishes its direction. Once confirmed s_confirmations times,
+ * each triggering access prefetches up to s_degree blocks of the stream, until
+ * running s_distance blocks ahead of the stream. Triggering accesses which do
+ * not belong to any stream allocate a new stream, replacing the least recently
+ * used stream.
+ */
+class StreamPrefetcher : public Prefetcher {
+public:
+  using Prefetcher::Prefetcher;
+
+  void train(AInt address, AInt, bool trigger,
+             std::vector<AInt> &prefetches) override {
+    if (!trigger)
+      return;
+
+    const AInt block = address / m_blockBytes;
+    Stream *stream = findStream(block);
+    if (!stream) {
+      stream = &*std::min_element(m_streams.begin(), m_streams.end(),
+                                  [](const Stream &a, const Stream &b) {
+                                    return a.lastUse < b.lastUse;
+                                  });
+      *stream = Stream();
+      stream->valid = true;
+      stream->lastBlock = block;
+      stream->frontier = block;
+      stream->lastUse = ++m_clock;
+      return;
+    }
+
+    stream->lastUse = ++m_clock;
+    if (block == stream->lastBlock)
+      return;
+    stream->direction = block > stream->lastBlock ? 1 : -1;
+    stream->confirmations++;
+    stream->lastBlock = block;
+    if (stream->confirmations < s_confirmations)
+      return;
+
+    // Continue from the furthest prefetched block, if still ahead of the
+    // stream.
+    const auto ahead = [&](AInt b) {
+      return static_cast<AIntS>(b - block) * stream->direction;
+    };
+    AInt next = ahead(stream->frontier) > 0 ? stream->frontier : block;
+    for (unsigned i = 0; i < s_degree; ++i) {
+      if (stream->direction < 0 && next == 0)
+        break;
+      next += stream->direction;
+      if (ahead(next) > s_distance)
+        break;
+      prefetches.push_back(next * m_blockBytes);
+      stream->frontier = next;
+    }
+  }
+
+  void reset() override {
+    m_streams.fill(Stream());
+    m_clock = 0;
+  }
+
+private:
+  static constexpr unsigned s_streams = 8;
+  static constexpr AIntS s_window = 4;
+  static constexpr unsigned s_confirmations = 2;
+  static constexpr unsigned s_degree = 2;
+  static constexpr AIntS s_distance = 8;
+
+  struct Stream {
+    AInt lastBlock = 0;
+    // The furthest block prefetched for the stream.
+    AInt frontier = 0;
+    int direction = 0;
+    unsigned confirmations = 0;
+    unsigned lastUse = 0;
+    bool valid = false;
+  };
+
+  Stream *findStream(AInt block) {
+    for (auto &stream : m_streams) {
+      if (!stream.valid)
+        continue;
+      const AIntS diff = static_cast<AIntS>(block - stream.lastBlock);
+      const bool inWindow = diff >= -s_window && diff <= s_window;
+      const bool inDirection = stream.direction == 0 || diff == 0 ||
+                               (diff > 0) == (stream.direction > 0);
+      if (inWindow && inDirection)
+        return &stream;
+    }
+    return nullptr;
+  }
+
+  std::array<Stream, s_streams> m_streams;
+  unsigned m_clock = 0;
+};
+
+} // namespace
+
+std::unique_ptr<Prefetcher> createPrefetcher(PrefetchPolicy policy,
+                                             unsigned blockBytes) {
+  switch (policy) {
+  case PrefetchPolicy::NoPrefetch:
+    return nullptr;
+  case PrefetchPolicy::NextLine:
+    return std::make_unique<NextLinePrefetcher>(blockBytes);
+  case PrefetchPolicy::Stride:
+    return std::make_unique<StridePrefetcher>(blockBytes);
+  case PrefetchPolicy::Stream:
+    return std::make_unique<StreamPrefetcher>(blockBytes);
+  }
+  return nullptr;
+}
+
+} // namespace Ripes
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+enum PrefetchPolicy { NoPrefetch, NextLine, Stride, Stream };
+
+/**
+ * @brief The Prefetcher class
+ * Interface of the hardware prefetchers of the cache simulator. A prefetcher is
+ * trained on the demand accesses of its cache, and returns the addresses of the
+ * blocks which it predicts are accessed next. The cache simulator fills these
+ * blocks into the cache, unless already present.
+ * The training state of a prefetcher is not rolled back when the processor is
+ * reversed; only the contents of the cache are.
+ */
+class Prefetcher {
+public:
+  Prefetcher(unsigned blockBytes) : m_blockBytes(blockBytes) {}
+  virtual ~Prefetcher() = default;
+
+  /**
+   * @brief train
+   * Called upon each demand access to @p address by the instruction at @p pc.
+   * @p trigger is true for demand misses, and for the first demand hit on a
+   * prefetched block (i.e., accesses which would have missed without
+   * prefetching). The addresses of any blocks to prefetch are appended to @p
+   * prefetches.
+   */
+  virtual void train(AInt address, AInt pc, bool trigger,
+                     std::vector<AInt> &prefetches) = 0;
+
+  /**
+   * @brief reset
+   * Discards all training state.
+   */
+  virtual void reset() {}
+
+protected:
+  AInt blockAddress(AInt address) const {
+    return address & ~static_cast<AInt>(m_blockBytes - 1);
+  }
+
+  unsigned m_blockBytes;
+};
+
+/**
+ * @brief createPrefetcher
+ * @returns a prefetcher for a cache with blocks of @p blockBytes bytes, or
+ * nullptr for PrefetchPolicy::NoPrefetch.
+ */
+std::unique_ptr<Prefetcher> createPrefetcher(PrefetchPolicy policy,
+                                             unsigned blockBytes);
+
+} // namespace Ripes
@@ -0,0 +1,350 @@
+#include "replacementpolicy.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+void ReplacementPolicy::resize(unsigned lines, unsigned ways) {
+  m_ways = ways;
+  m_wayBits = 0;
+  while ((1u << m_wayBits) < ways)
+    m_wayBits++;
+  m_wordsPerLine = stateWords(ways);
+  m_state.assign(static_cast<std::size_t>(lines) * m_wordsPerLine, 0);
+  for (unsigned line = 0; line < lines; ++line)
+    initLine(line, lineState(line));
+}
+
+namespace {
+
+/**
+ * @brief The RandomPolicy class
+ * Evicts a uniformly random way; invalid ways are not preferred.
+ * Each line holds the state of a xorshift32 generator, seeded from the seed of
+ * the policy and the index of the line, which is advanced upon each fill of
+ * the line. Keeping the generator state within the line state makes victim
+ * selection independent of other caches (and threads), and ensures that
+ * undoing an access also restores the generator.
+ */
+class RandomPolicy : public ReplacementPolicy {
+public:
+  RandomPolicy(uint32_t seed) : m_seed(seed) {}
+
+  void touch(unsigned, unsigned) override {}
+
+  void insert(unsigned line, unsigned, bool) override {
+    Word &state = lineState(line)[0];
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+  }
+
+  unsigned victim(unsigned line) const override {
+    // Map the state onto [0; ways) through the high bits of the state.
+    return (static_cast<uint64_t>(lineState(line)[0]) * m_ways) >> 32;
+  }
+
+  unsigned bitsPerLine() const override { return 0; }
+  bool fillsInvalidWaysFirst() const override { return false; }
+
+protected:
+  unsigned stateWords(unsigned) const override { return 1; }
+
+  void initLine(unsigned line, Word *state) const override {
+    // splitmix32-style mixing of the seed and line index, such that lines start
+    // from uncorrelated states. xorshift32 requires a non-zero state.
+    Word z = m_seed + (line + 1) * 0x9E3779B9u;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    state[0] = z != 0 ? z : 1;
+  }
+
+private:
+  uint32_t m_seed;
+};
+
+/**
+ * @brief The LRUPolicy class
+ * True LRU, maintained as a doubly linked list of the valid ways of each line,
+ * ordered from the most to the least recently used way. Hits, fills and
+ * victim selection are constant-time.
+ * State layout: [head, tail, next[ways], prev[ways]].
+ */
+class LRUPolicy : public ReplacementPolicy {
+public:
+  void touch(unsigned line, unsigned way) override {
+    Word *state = lineState(line);
+    if (state[Head] == way)
+      return;
+    unlink(state, way);
+    pushFront(state, way);
+  }
+
+  void insert(unsigned line, unsigned way, bool replaced) override {
+    if (replaced) {
+      touch(line, way);
+    } else {
+      pushFront(lineState(line), way);
+    }
+  }
+
+  void invalidate(unsigned line, unsigned way) override {
+    unlink(lineState(line), way);
+  }
+
+  unsigned victim(unsigned line) const override {
+    return lineState(line)[Tail];
+  }
+
+  unsigned wayValue(unsigned line, unsigned way) const override {
+    const Word *state = lineState(line);
+    unsigned position = 0;
+    for (Word i = state[Head]; i != s_invalidIndex; i = next(state, i)) {
+      if (i == way)
+        return position;
+      position++;
+    }
+    return s_invalidIndex;
+  }
+
+  // log2(ways) bits per way, encoding its LRU position.
+  unsigned bitsPerLine() const override { return m_ways * m_wayBits; }
+
+protected:
+  unsigned stateWords(unsigned ways) const override { return 2 + 2 * ways; }
+  void initLine(unsigned, Word *state) const override {
+    state[Head] = s_invalidIndex;
+    state[Tail] = s_invalidIndex;
+  }
+
+private:
+  enum { Head, Tail, Links };
+
+  Word &next(Word *state, unsigned way) const { return state[Links + way]; }
+  Word next(const Word *state, unsigned way) const {
+    return state[Links + way];
+  }
+  Word &prev(Word *state, unsigned way) const {
+    return state[Links + m_ways + way];
+  }
+
+  void unlink(Word *state, unsigned way) const {
+    const Word p = prev(state, way);
+    const Word n = next(state, way);
+    (p == s_invalidIndex ? state[Head] : next(state, p)) = n;
+    (n == s_invalidIndex ? state[Tail] : prev(state, n)) = p;
+  }
+
+  void pushFront(Word *state, unsigned way) const {
+    prev(state, way) = s_invalidIndex;
+    next(state, way) = state[Head];
+    (state[Head] == s_invalidIndex ? state[Tail] : prev(state, state[Head])) =
+        way;
+    state[Head] = way;
+  }
+};
+
+/**
+ * @brief The PLRUPolicy class
+ * Tree-based pseudo-LRU. Each line holds a binary tree of ways - 1 bits, where
+ * each bit points towards the less recently used half of its subtree. Node i
+ * (1-indexed, in heap order) is stored in bit i of the state.
+ */
+class PLRUPolicy : public ReplacementPolicy {
+public:
+  void touch(unsigned line, unsigned way) override {
+    Word *state = lineState(line);
+    unsigned node = 1;
+    for (int level = m_wayBits - 1; level >= 0; --level) {
+      const unsigned dir = (way >> level) & 1;
+      // Point away from the accessed way.
+      setBit(state, node, !dir);
+      node = 2 * node + dir;
+    }
+  }
+
+  void insert(unsigned line, unsigned way, bool) override { touch(line, way); }
+
+  unsigned victim(unsigned line) const override {
+    const Word *state = lineState(line);
+    unsigned node = 1;
+    unsigned way = 0;
+    for (unsigned level = 0; level < m_wayBits; ++level) {
+      const unsigned dir = bit(state, node);
+      way = 2 * way + dir;
+      node = 2 * node + dir;
+    }
+    return way;
+  }
+
+  unsigned bitsPerLine() const override { return m_ways - 1; }
+
+protected:
+  unsigned stateWords(unsigned ways) const override {
+    return (ways + s_wordBits - 1) / s_wordBits;
+  }
+
+private:
+  static constexpr unsigned s_wordBits = 32;
+
+  static unsigned bit(const Word *state, unsigned node) {
+    return (state[node / s_wordBits] >> (node % s_wordBits)) & 1;
+  }
+  static void setBit(Word *state, unsigned node, bool value) {
+    Word &word = state[node / s_wordBits];
+    const Word mask = Word(1) << (node % s_wordBits);
+    word = value ? word | mask : word & ~mask;
+  }
+};
+
+/**
+ * @brief The FIFOPolicy class
+ * Round-robin replacement; each line holds a pointer to the way which was
+ * filled the longest time ago.
+ */
+class FIFOPolicy : public ReplacementPolicy {
+public:
+  void touch(unsigned, unsigned) override {}
+
+  void insert(unsigned line, unsigned way, bool) override {
+    Word &pointer = lineState(line)[0];
+    if (pointer == way)
+      pointer = (pointer + 1) % m_ways;
+  }
+
+  unsigned victim(unsigned line) const override { return lineState(line)[0]; }
+
+  // Displayed such that the next victim has the highest value, as for LRU.
+  unsigned wayValue(unsigned line, unsigned way) const override {
+    return m_ways - 1 - (way + m_ways - lineState(line)[0]) % m_ways;
+  }
+
+  unsigned bitsPerLine() const override { return m_wayBits; }
+
+protected:
+  unsigned stateWords(unsigned) const override { return 1; }
+};
+
+/**
+ * @brief The RRIPPolicy class
+ * Static and bimodal re-reference interval prediction (SRRIP/BRRIP), with
+ * 2-bit re-reference prediction values (RRPVs) per way. Hits predict a
+ * near-immediate re-reference (RRPV 0). SRRIP inserts blocks with a long
+ * re-reference interval (RRPV 2), whereas BRRIP inserts blocks with a distant
+ * re-reference interval (RRPV 3), except for every s_brripLongInterval'th
+ * insertion into a line. The victim is the first way with a distant RRPV,
+ * after aging all ways until such a way exists.
+ * State layout: [rrpv[ways], insertion counter (BRRIP)].
+ */
+class RRIPPolicy : public ReplacementPolicy {
+public:
+  RRIPPolicy(bool bimodal) : m_bimodal(bimodal) {}
+
+  void touch(unsigned line, unsigned way) override { lineState(line)[way] = 0; }
+
+  void insert(unsigned line, unsigned way, bool replaced) override {
+    Word *state = lineState(line);
+    if (replaced) {
+      // Apply the aging which made the victim distant.
+      const Word age = s_distant - *std::max_element(state, state + m_ways);
+      for (unsigned i = 0; i < m_ways; ++i)
+        state[i] += age;
+    }
+
+    Word rrpv = s_long;
+    if (m_bimodal) {
+      Word &counter = state[m_ways];
+      rrpv = counter == 0 ? s_long : s_distant;
+      counter = (counter + 1) % s_brripLongInterval;
+    }
+    state[way] = rrpv;
+  }
+
+  unsigned victim(unsigned line) const override {
+    const Word *state = lineState(line);
+    return std::max_element(state, state + m_ways) - state;
+  }
+
+  unsigned wayValue(unsigned line, unsigned way) const override {
+    return lineState(line)[way];
+  }
+
+  unsigned bitsPerLine() const override {
+    return m_ways * s_rrpvBits + (m_bimodal ? s_brripCounterBits : 0);
+  }
+
+protected:
+  unsigned stateWords(unsigned ways) const override {
+    return ways + (m_bimodal ? 1 : 0);
+  }
+
+private:
+  static constexpr unsigned s_rrpvBits = 2;
+  static constexpr Word s_distant = (1 << s_rrpvBits) - 1;
+  static constexpr Word s_long = s_distant - 1;
+  static constexpr unsigned s_brripCounterBits = 5;
+  static constexpr Word s_brripLongInterval = 1 << s_brripCounterBits;
+
+  bool m_bimodal;
+};
+
+/**
+ * @brief The LFUPolicy class
+ * Least frequently used; each way holds a saturating access counter, which is
+ * reset upon filling the way. Ties are broken by the lowest way index.
+ */
+class LFUPolicy : public ReplacementPolicy {
+public:
+  void touch(unsigned line, unsigned way) override {
+    Word &count = lineState(line)[way];
+    count = std::min(count + 1, s_maxCount);
+  }
+
+  void insert(unsigned line, unsigned way, bool) override {
+    lineState(line)[way] = 1;
+  }
+
+  unsigned victim(unsigned line) const override {
+    const Word *state = lineState(line);
+    return std::min_element(state, state + m_ways) - state;
+  }
+
+  unsigned wayValue(unsigned line, unsigned way) const override {
+    return lineState(line)[way];
+  }
+
+  unsigned bitsPerLine() const override { return m_ways * s_counterBits; }
+
+protected:
+  unsigned stateWords(unsigned ways) const override { return ways; }
+
+private:
+  static constexpr unsigned s_counterBits = 8;
+  static constexpr Word s_maxCount = (1 << s_counterBits) - 1;
+};
+
+} // namespace
+
+std::unique_ptr<ReplacementPolicy> createReplacementPolicy(ReplPolicy policy,
+                                                           uint32_t seed) {
+  switch (policy) {
+  case ReplPolicy::Random:
+    return std::make_unique<RandomPolicy>(seed);
+  case ReplPolicy::LRU:
+    return std::make_unique<LRUPolicy>();
+  case ReplPolicy::PLRU:
+    return std::make_unique<PLRUPolicy>();
+  case ReplPolicy::FIFO:
+    return std::make_unique<FIFOPolicy>();
+  case ReplPolicy::SRRIP:
+    return std::make_unique<RRIPPolicy>(false);
+  case ReplPolicy::BRRIP:
+    return std::make_unique<RRIPPolicy>(true);
+  case ReplPolicy::LFU:
+    return std::make_unique<LFUPolicy>();
+  }
+  return nullptr;
+}
+
+} // namespace Ripes
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Ripes {
+
+enum ReplPolicy { Random, LRU, PLRU, FIFO, SRRIP, BRRIP, LFU };
+
+/**
+ * @brief The ReplacementPolicy class
+ * Interface of the replacement policies of the cache simulator. A policy keeps
+ * its replacement state in a flat array, with a fixed # of words per cache
+ * line. This allows the cache simulator to snapshot and restore the state of a
+ * line when accesses are undone, without any knowledge of the policy.
+ * The cache simulator tracks the validity of ways; unless
+ * fillsInvalidWaysFirst() is false, the policy is only asked to select a victim
+ * in lines wherein all ways are valid.
+ */
+class ReplacementPolicy {
+public:
+  using Word = uint32_t;
+  static constexpr unsigned s_invalidIndex = static_cast<unsigned>(-1);
+
+  virtual ~ReplacementPolicy() = default;
+
+  /**
+   * @brief resize
+   * (Re)allocates the replacement state of a cache with @p lines lines of @p
+   * ways ways, wherein all ways are invalid.
+   */
+  void resize(unsigned lines, unsigned ways);
+
+  /**
+   * @brief touch
+   * Called when the valid way @p way of line @p line is hit.
+   */
+  virtual void touch(unsigned line, unsigned way) = 0;
+
+  /**
+   * @brief insert
+   * Called when a block is allocated in way @p way of line @p line. @p replaced
+   * is true if a valid block was evicted from the way.
+   */
+  virtual void insert(unsigned line, unsigned way, bool replaced) = 0;
+
+  /**
+   * @brief invalidate
+   * Called when the valid way @p way of line @p line is invalidated.
+   */
+  virtual void invalidate(unsigned /*line*/, unsigned /*way*/) {}
+
+  /**
+   * @brief victim
+   * @returns the way of line @p line which should be evicted.
+   */
+  virtual unsigned victim(unsigned line) const = 0;
+
+  /**
+   * @brief wayValue
+   * @returns the replacement state of a valid way, as shown in the cache view
+   * (e.g., the LRU position of the way).
+   */
+  virtual unsigned wayValue(unsigned /*line*/, unsigned /*way*/) const {
+    return 0;
+  }
+
+  /**
+   * @brief bitsPerLine
+   * @returns the # of bits of replacement state required per cache line, in a
+   * hardware implementation of the policy.
+   */
+  virtual unsigned bitsPerLine() const = 0;
+
+  virtual bool fillsInvalidWaysFirst() const { return true; }
+
+  unsigned wordsPerLine() const { return m_wordsPerLine; }
+  Word *lineState(unsigned line) {
+    return m_state.data() + static_cast<std::size_t>(line) * m_wordsPerLine;
+  }
+  const Word *lineState(unsigned line) const {
+    return m_state.data() + static_cast<std::size_t>(line) * m_wordsPerLine;
+  }
+
+protected:
+  /**
+   * @brief stateWords
+   * @returns the # of state words per line of a cache with @p ways ways.
+   */
+  virtual unsigned stateWords(unsigned ways) const = 0;
+
+  /**
+   * @brief initLine
+   * Initializes the state of line @p line, wherein all ways are invalid. The
+   * state is zero-initialized beforehand.
+   */
+  virtual void initLine(unsigned /*line*/, Word * /*state*/) const {}
+
+  unsigned m_ways = 0;
+  unsigned m_wayBits = 0;
+
+private:
+  unsigned m_wordsPerLine = 0;
+  std::vector<Word> m_state;
+};
+
+/**
+ * @brief createReplacementPolicy
+ * @p seed seeds the pseudo-random number generators of the Random policy; the
+ * victims selected by a Random cache are fully determined by the seed and the
+ * sequence of accesses to the cache.
+ */
+std::unique_ptr<ReplacementPolicy> createReplacementPolicy(ReplPolicy policy,
+                                                           uint32_t seed = 0);
+
+} // namespace Ripes
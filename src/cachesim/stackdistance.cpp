@@ -0,0 +1,125 @@
+#include "stackdistance.h"
+
+namespace Ripes {
+
+static inline unsigned lowbit(unsigned i) { return i & (~i + 1); }
+
+uint32_t StackDistanceAnalyzer::LineState::prefix(unsigned t) const {
+  uint32_t sum = 0;
+  for (; t > 0; t -= lowbit(t))
+    sum += tree[t];
+  return sum;
+}
+
+void StackDistanceAnalyzer::LineState::clear(unsigned t) {
+  blocks[t] = s_noBlock;
+  live--;
+  for (; t <= time(); t += lowbit(t))
+    tree[t] -= 1;
+}
+
+unsigned StackDistanceAnalyzer::LineState::append(unsigned blockIndex) {
+  // A Fenwick tree node i covers the range (i - lowbit(i), i]. The node of the
+  // appended time is thus the sum of the (already present) nodes within its
+  // range, plus the newly set time itself.
+  const unsigned t = tree.size();
+  tree.push_back(1 + prefix(t - 1) - prefix(t - lowbit(t)));
+  blocks.push_back(blockIndex);
+  live++;
+  return t;
+}
+
+void StackDistanceAnalyzer::compact(LineState &line, unsigned lineBits) {
+  const unsigned nLevels = m_levels.size();
+  unsigned t = 0;
+  for (unsigned old = 1; old <= line.time(); ++old) {
+    const unsigned blockIndex = line.blocks[old];
+    if (blockIndex == LineState::s_noBlock)
+      continue;
+    line.blocks[++t] = blockIndex;
+    m_lastAccess[blockIndex * nLevels + lineBits] = t;
+  }
+  // Every renumbered time is set, so each node holds the size of its range.
+  line.blocks.resize(t + 1);
+  line.tree.resize(t + 1);
+  for (unsigned i = 1; i <= t; ++i)
+    line.tree[i] = lowbit(i);
+}
+
+StackDistanceAnalyzer::StackDistanceAnalyzer(unsigned byteOffset,
+                                             unsigned blockBits,
+                                             unsigned maxLineBits)
+    : m_byteOffset(byteOffset), m_blockBits(blockBits),
+      m_levels(maxLineBits + 1) {
+  reset();
+}
+
+void StackDistanceAnalyzer::reset() {
+  m_accesses = 0;
+  m_blockIndices.clear();
+  m_lastAccess.clear();
+  for (unsigned lineBits = 0; lineBits < m_levels.size(); ++lineBits) {
+    m_levels[lineBits].lines.assign(1 << lineBits, LineState());
+    m_levels[lineBits].histogram.clear();
+  }
+}
+
+void StackDistanceAnalyzer::access(AInt address) {
+  const AInt block = address >> (m_byteOffset + m_blockBits);
+  const unsigned nLevels = m_levels.size();
+  m_accesses++;
+
+  auto it = m_blockIndices.find(block);
+  const bool cold = it == m_blockIndices.end();
+  if (cold) {
+    it = m_blockIndices.emplace(block, m_blockIndices.size()).first;
+    m_lastAccess.resize(m_lastAccess.size() + nLevels);
+  }
+  unsigned *lastAccess = &m_lastAccess[it->second * nLevels];
+
+  for (unsigned lineBits = 0; lineBits < nLevels; ++lineBits) {
+    Level &level = m_levels[lineBits];
+    LineState &line = level.lines[block & ((AInt(1) << lineBits) - 1)];
+    if (!cold) {
+      const unsigned last = lastAccess[lineBits];
+      const unsigned distance = line.prefix(line.time()) - line.prefix(last);
+      if (distance >= level.histogram.size())
+        level.histogram.resize(distance + 1, 0);
+      level.histogram[distance]++;
+      line.clear(last);
+    }
+    lastAccess[lineBits] = line.append(it->second);
+    // Compacting leaves time() == live, and each append increments the # of
+    // cleared times by at most one. Thus, more than live appends happen in
+    // between compactions, and compacting amortizes to a constant per access.
+    if (line.time() > 2 * line.live)
+      compact(line, lineBits);
+  }
+}
+
+std::size_t StackDistanceAnalyzer::accessTimes() const {
+  std::size_t times = 0;
+  for (const auto &level : m_levels)
+    for (const auto &line : level.lines)
+      times += line.time();
+  return times;
+}
+
+uint64_t StackDistanceAnalyzer::misses(unsigned lineBits,
+                                       unsigned wayBits) const {
+  const auto &hist = histogram(lineBits);
+  const uint64_t ways = uint64_t(1) << wayBits;
+  uint64_t hits = 0;
+  for (uint64_t d = 0; d < ways && d < hist.size(); ++d)
+    hits += hist[d];
+  return m_accesses - hits;
+}
+
+double StackDistanceAnalyzer::missRate(unsigned lineBits,
+                                       unsigned wayBits) const {
+  if (m_accesses == 0)
+    return 0;
+  return static_cast<double>(misses(lineBits, wayBits)) / m_accesses;
+}
+
+} // namespace Ripes
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+/**
+ * @brief The StackDistanceAnalyzer class
+ * Computes the miss-ratio curve of LRU caches through a single pass over an
+ * access stream, using Mattson's stack algorithm.
+ * For a cache with 2^L lines, the stack distance of an access is the number of
+ * distinct blocks mapping to the same cache line which were accessed since the
+ * last access to the accessed block. Given LRU replacement, an access hits in a
+ * cache with 2^L lines and W ways if and only if its stack distance is less
+ * than W. Maintaining a stack distance histogram for each line count thus
+ * yields the number of misses for every combination of lines and ways, for a
+ * fixed block size.
+ * Stack distances are computed in logarithmic time using a Fenwick tree per
+ * cache line, marking the most recent access time of each block. The access
+ * times of a line are renumbered once the line has more than twice as many
+ * access times as live blocks, such that memory usage is proportional to the #
+ * of distinct blocks accessed rather than the # of accesses.
+ *
+ * The analysis assumes that every access allocates a block in the cache, i.e.,
+ * it matches the CacheSim with LRU replacement and a write-allocate policy.
+ */
+class StackDistanceAnalyzer {
+public:
+  /**
+   * @brief StackDistanceAnalyzer
+   * @param byteOffset: # of bits to represent the # of bytes in a word.
+   * @param blockBits: log2 of the # of words in a cache block.
+   * @param maxLineBits: log2 of the largest # of cache lines to analyze. Cache
+   * configurations with 2^0 to 2^maxLineBits lines are analyzed. Defaults to
+   * the largest # of lines selectable in the cache configuration widget.
+   */
+  StackDistanceAnalyzer(unsigned byteOffset, unsigned blockBits,
+                        unsigned maxLineBits = 10);
+
+  void access(AInt address);
+  void reset();
+
+  unsigned blockBits() const { return m_blockBits; }
+  unsigned maxLineBits() const { return m_levels.size() - 1; }
+  uint64_t accesses() const { return m_accesses; }
+
+  /**
+   * @brief coldMisses
+   * @returns the # of accesses to blocks which had not been accessed before.
+   * These miss in any cache configuration.
+   */
+  uint64_t coldMisses() const { return m_blockIndices.size(); }
+
+  /**
+   * @brief accessTimes
+   * @returns the # of access times currently tracked, across all cache lines of
+   * all analyzed line counts.
+   */
+  std::size_t accessTimes() const;
+
+  /**
+   * @brief histogram
+   * @returns the stack distance histogram for caches with 2^lineBits lines,
+   * indexed by stack distance. Cold misses are not included.
+   */
+  const std::vector<uint64_t> &histogram(unsigned lineBits) const {
+    return m_levels.at(lineBits).histogram;
+  }
+
+  /**
+   * @brief misses
+   * @returns the # of misses of an LRU cache with 2^lineBits lines and
+   * 2^wayBits ways.
+   */
+  uint64_t misses(unsigned lineBits, unsigned wayBits) const;
+  double missRate(unsigned lineBits, unsigned wayBits) const;
+
+private:
+  /**
+   * @brief The LineState struct
+   * A Fenwick tree over the access times of a single cache line. An access time
+   * is set if it is the most recent access to some block, such that the # of
+   * set times after the previous access to a block is its stack distance. The
+   * tree grows as accesses are appended, and shrinks when compacted.
+   */
+  struct LineState {
+    static constexpr unsigned s_noBlock = ~0u;
+
+    // 1-indexed; tree[0] and blocks[0] are unused.
+    std::vector<uint32_t> tree = {0};
+    // The index of the block most recently accessed at each set access time,
+    // or s_noBlock if the time is no longer set.
+    std::vector<unsigned> blocks = {s_noBlock};
+    // The # of set access times, i.e., the # of blocks mapping to this line.
+    unsigned live = 0;
+
+    unsigned time() const { return tree.size() - 1; }
+    uint32_t prefix(unsigned t) const;
+    void clear(unsigned t);
+    unsigned append(unsigned blockIndex);
+  };
+
+  /**
+   * @brief compact
+   * Renumbers the set access times of @p line to 1..live, preserving their
+   * order, and updates the most recent access times of its blocks in
+   * m_lastAccess at @p lineBits.
+   */
+  void compact(LineState &line, unsigned lineBits);
+
+  struct Level {
+    std::vector<LineState> lines;
+    std::vector<uint64_t> histogram;
+  };
+
+  unsigned m_byteOffset;
+  unsigned m_blockBits;
+  uint64_t m_accesses = 0;
+
+  std::vector<Level> m_levels;
+
+  /**
+   * @brief m_blockIndices
+   * Maps each block address seen to an index into m_lastAccess, wherein the
+   * most recent access time of the block is stored for each level.
+   */
+  std::unordered_map<AInt, unsigned> m_blockIndices;
+  std::vector<unsigned> m_lastAccess;
+};
+
+} // namespace Ripes
@@ -26,6 +26,7 @@ CacheTab::CacheTab(QToolBar *toolbar, QWidget *parent)
           [=](CacheWidget *widget) {
             m_ui->cacheView->setScene(widget->getScene());
             m_ui->cacheView->fitScene();
+            emit cacheFocusChanged(widget->getCacheSim());
           });
 
   // CacheTabWidget has a tendency to expand, but we'd like to minimize its
@@ -2,11 +2,14 @@
 
 #include "ripestab.h"
 #include <QWidget>
+#include <memory>
 
 #include "isa/isa_types.h"
 
 namespace Ripes {
 
+class CacheSim;
+
 namespace Ui {
 class CacheTab;
 }
@@ -22,6 +25,7 @@ public:
 
 signals:
   void focusAddressChanged(Ripes::AInt address);
+  void cacheFocusChanged(const std::shared_ptr<Ripes::CacheSim> &cache);
 
 private:
   Ui::CacheTab *m_ui;
@@ -77,9 +77,20 @@ CacheTabWidget::CacheTabWidget(QWidget *parent)
   m_ui->tabWidget->tabBar()->installEventFilter(new ScrollEventFilter(this));
 }
 
+std::vector<CacheWidget *> CacheTabWidget::upperLevelCacheWidgets(int index) {
+  // The L2 cache is shared by the L1 data and instruction caches.
+  if (index == InstrCache + 1) {
+    return {m_ui->dataCacheWidget, m_ui->instructionCacheWidget};
+  }
+  return {dynamic_cast<CacheWidget *>(m_ui->tabWidget->widget(index - 1))};
+}
+
 void CacheTabWidget::handleTabCloseRequest(int index) {
   // Only the last-level cache should be closeable
   Q_ASSERT(index == m_addTabIdx - 1 && index > InstrCache);
+  for (auto *upper : upperLevelCacheWidgets(index)) {
+    upper->setNextLevelCache(nullptr);
+  }
   const int newIndex = index - 1;
   m_ui->tabWidget->setCurrentIndex(newIndex);
   m_ui->tabWidget->removeTab(index);
@@ -97,6 +108,9 @@ void CacheTabWidget::handleTabIndexChanged(int index) {
   if (index == m_addTabIdx) {
     // Add new level of cache
     auto *cw = new CacheWidget(this);
+    for (auto *upper : upperLevelCacheWidgets(m_addTabIdx)) {
+      upper->setNextLevelCache(cw->getCacheSim());
+    }
     m_ui->tabWidget->insertTab(m_addTabIdx, cw,
                                QString("L%1 Cache").arg(m_nextCacheLevel));
     m_nextCacheLevel++;
@@ -1,6 +1,8 @@
 #pragma once
 #include <QWidget>
 
+#include <vector>
+
 #include "cachesim/l1cacheshim.h"
 
 // #define N_CACHES_ENABLED
@@ -36,6 +38,13 @@ private:
   void handleTabIndexChanged(int index);
   void handleTabCloseRequest(int index);
 
+  /**
+   * @brief upperLevelCacheWidgets
+   * @returns the widgets of the caches which have the cache at tab @p index as
+   * their next level cache.
+   */
+  std::vector<CacheWidget *> upperLevelCacheWidgets(int index);
+
   Ui::CacheTabWidget *m_ui;
 
   int m_addTabIdx = -1;
@@ -0,0 +1,283 @@
+#include "cachehierarchy.h"
+#include "cachesweep.h"
+
+namespace Ripes {
+
+namespace {
+
+// Upper bound on the log2 values accepted for the lines, ways and blocks
+// parameters of a cache level.
+constexpr int s_maxLevelBits = 16;
+
+const std::map<QString, InclusionPolicy> s_cliInclusionPolicies{
+    {"nine", InclusionPolicy::NINE},
+    {"inclusive", InclusionPolicy::Inclusive},
+    {"exclusive", InclusionPolicy::Exclusive}};
+
+QString invalidValueError(const QString &level, const QString &param,
+                          const QString &value) {
+  return "Invalid value '" + value + "' for parameter '" + param +
+         "' of cache level '" + level + "' (--cache-hierarchy).";
+}
+
+/// Parses a named value into @p out, based on the @p names map.
+template <typename T>
+bool parseNamedValue(const QString &level, const QString &param,
+                     const QString &value, const std::map<QString, T> &names,
+                     T &out, QString &errorMessage) {
+  auto it = names.find(value.toLower());
+  if (it == names.end()) {
+    QStringList validNames;
+    for (const auto &name : names)
+      validNames << name.first;
+    errorMessage = invalidValueError(level, param, value) +
+                   " Valid values are: " + validNames.join(", ");
+    return false;
+  }
+  out = it->second;
+  return true;
+}
+
+bool parseLevelSpec(const QString &level, const QString &spec,
+                    CacheLevelConfig &config, QString &errorMessage) {
+  for (const auto &paramSpec : spec.split(',', Qt::SkipEmptyParts)) {
+    const QStringList parts = paramSpec.split('=');
+    if (parts.size() != 2) {
+      errorMessage = "Invalid parameter '" + paramSpec + "' of cache level '" +
+                     level + "' (--cache-hierarchy).";
+      return false;
+    }
+    const QString param = parts.at(0).trimmed().toLower();
+    const QString value = parts.at(1).trimmed();
+
+    bool ok = false;
+    if (param == "lines" || param == "ways" || param == "blocks") {
+      const int bits = value.toInt(&ok);
+      ok &= bits >= 0 && bits <= s_maxLevelBits;
+      if (!ok) {
+        errorMessage = invalidValueError(level, param, value);
+      } else if (param == "lines") {
+        config.preset.lines = bits;
+      } else if (param == "ways") {
+        config.preset.ways = bits;
+      } else {
+        config.preset.blocks = bits;
+      }
+    } else if (param == "repl") {
+      ok = parseNamedValue(level, param, value, s_cliReplPolicies,
+                           config.preset.replPolicy, errorMessage);
+    } else if (param == "seed") {
+      config.preset.seed = value.toUInt(&ok, 0);
+      if (!ok)
+        errorMessage = invalidValueError(level, param, value);
+    } else if (param == "wr") {
+      ok = parseNamedValue(level, param, value, s_cliWritePolicies,
+                           config.preset.wrPolicy, errorMessage);
+    } else if (param == "alloc") {
+      ok = parseNamedValue(level, param, value, s_cliWriteAllocPolicies,
+                           config.preset.wrAllocPolicy, errorMessage);
+    } else if (param == "incl") {
+      ok = parseNamedValue(level, param, value, s_cliInclusionPolicies,
+                           config.inclusionPolicy, errorMessage);
+    } else if (param == "pf") {
+      ok = parseNamedValue(level, param, value, s_cliPrefetchPolicies,
+                           config.prefetchPolicy, errorMessage);
+    } else if (param == "lat") {
+      config.hitLatency = value.toUInt(&ok);
+      if (!ok)
+        errorMessage = invalidValueError(level, param, value);
+    } else {
+      errorMessage = "Unknown parameter '" + param + "' of cache level '" +
+                     level + "' (--cache-hierarchy).";
+    }
+    if (!ok)
+      return false;
+  }
+  return true;
+}
+
+CacheLevelConfig defaultLevelConfig(const QString &name) {
+  // Default values; equal to the defaults of the cache simulator.
+  CacheLevelConfig config;
+  config.preset.name = name;
+  config.preset.lines = 5;
+  config.preset.ways = 0;
+  config.preset.blocks = 2;
+  config.preset.replPolicy = ReplPolicy::LRU;
+  config.preset.wrPolicy = WritePolicy::WriteBack;
+  config.preset.wrAllocPolicy = WriteAllocPolicy::WriteAllocate;
+  return config;
+}
+
+std::shared_ptr<CacheSim> createCache(const CacheLevelConfig &config,
+                                      unsigned memoryLatency) {
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setPreset(config.preset);
+  cache->setInclusionPolicy(config.inclusionPolicy);
+  cache->setPrefetchPolicy(config.prefetchPolicy);
+  cache->setHitLatency(config.hitLatency);
+  cache->setMemoryLatency(memoryLatency);
+  return cache;
+}
+
+} // namespace
+
+bool parseCacheHierarchySpec(const QString &spec, CacheHierarchyConfig &config,
+                             QString &errorMessage) {
+  config = CacheHierarchyConfig();
+  config.l1i = defaultLevelConfig("L1I");
+  config.l1d = defaultLevelConfig("L1D");
+
+  for (const auto &levelSpec : spec.split(';', Qt::SkipEmptyParts)) {
+    const QString trimmed = levelSpec.trimmed();
+    if (trimmed.startsWith("mem=", Qt::CaseInsensitive)) {
+      bool ok = false;
+      config.memoryLatency = trimmed.mid(4).toUInt(&ok);
+      if (!ok) {
+        errorMessage = "Invalid memory latency '" + trimmed.mid(4) +
+                       "' (--cache-hierarchy).";
+        return false;
+      }
+      continue;
+    }
+
+    const int sep = trimmed.indexOf(':');
+    const QString level = trimmed.left(sep).toLower();
+    const QString params = sep == -1 ? QString() : trimmed.mid(sep + 1);
+    CacheLevelConfig *levelConfig = nullptr;
+    if (level == "l1i") {
+      levelConfig = &config.l1i;
+    } else if (level == "l1d") {
+      levelConfig = &config.l1d;
+    } else if (level == "l2") {
+      if (!config.l2)
+        config.l2 = defaultLevelConfig("L2");
+      levelConfig = &config.l2.value();
+    } else if (level == "l3") {
+      if (!config.l3)
+        config.l3 = defaultLevelConfig("L3");
+      levelConfig = &config.l3.value();
+    } else {
+      errorMessage = "Unknown cache level '" + level +
+                     "' (--cache-hierarchy). Valid levels are: l1i, l1d, l2, "
+                     "l3.";
+      return false;
+    }
+    if (!parseLevelSpec(level, params, *levelConfig, errorMessage))
+      return false;
+  }
+
+  if (config.l3 && !config.l2) {
+    errorMessage = "An L3 cache requires an L2 cache (--cache-hierarchy).";
+    return false;
+  }
+  return true;
+}
+
+CacheHierarchy::CacheHierarchy(const CacheHierarchyConfig &config) {
+  m_l1i = createCache(config.l1i, config.memoryLatency);
+  m_l1d = createCache(config.l1d, config.memoryLatency);
+  if (config.l2) {
+    m_l2 = createCache(*config.l2, config.memoryLatency);
+    m_l1i->setNextLevelCache(m_l2);
+    m_l1d->setNextLevelCache(m_l2);
+  }
+  if (config.l3) {
+    m_l3 = createCache(*config.l3, config.memoryLatency);
+    m_l2->setNextLevelCache(m_l3);
+  }
+
+  // The shims will, upon construction, connect to the ProcessorHandler and
+  // feed the memory accesses of the processor into the L1 caches.
+  m_l1iShim = std::make_unique<L1CacheShim>(
+      L1CacheShim::CacheType::InstrCache, nullptr);
+  m_l1dShim =
+      std::make_unique<L1CacheShim>(L1CacheShim::CacheType::DataCache, nullptr);
+  m_l1iShim->setNextLevelCache(m_l1i);
+  m_l1dShim->setNextLevelCache(m_l1d);
+}
+
+std::vector<std::pair<QString, std::shared_ptr<CacheSim>>>
+CacheHierarchy::caches() const {
+  std::vector<std::pair<QString, std::shared_ptr<CacheSim>>> caches = {
+      {"L1I", m_l1i}, {"L1D", m_l1d}};
+  if (m_l2)
+    caches.push_back({"L2", m_l2});
+  if (m_l3)
+    caches.push_back({"L3", m_l3});
+  return caches;
+}
+
+QVariant CacheHierarchyTelemetry::report(bool json) {
+  const QStringList columns = {
+      "level",    "lines",    "ways",      "blocks",     "repl",
+      "seed",     "wr",       "alloc",     "incl",       "pf",
+      "latency",  "accesses", "hits",      "misses",     "compulsory",
+      "capacity", "conflict", "hit rate",  "writebacks", "prefetches",
+      "useful",   "late",     "polluting"};
+
+  QVariantList rows;
+  for (const auto &[name, cache] : m_hierarchy->caches()) {
+    QVariantMap row;
+    row["level"] = name;
+    row["lines"] = cache->getLines();
+    row["ways"] = cache->getWays();
+    row["blocks"] = cache->getBlocks();
+    row["repl"] = s_cacheReplPolicyStrings.at(cache->getReplacementPolicy());
+    row["seed"] = cache->getSeed();
+    row["wr"] = s_cacheWritePolicyStrings.at(cache->getWritePolicy());
+    row["alloc"] = s_cacheWriteAllocateStrings.at(cache->getWriteAllocPolicy());
+    row["incl"] = s_cacheInclusionPolicyStrings.at(cache->getInclusionPolicy());
+    row["pf"] = s_cachePrefetchPolicyStrings.at(cache->getPrefetchPolicy());
+    row["latency"] = cache->getHitLatency();
+    row["accesses"] = cache->getHits() + cache->getMisses();
+    row["hits"] = cache->getHits();
+    row["misses"] = cache->getMisses();
+    row["compulsory"] = cache->getCompulsoryMisses();
+    row["capacity"] = cache->getCapacityMisses();
+    row["conflict"] = cache->getConflictMisses();
+    row["hit rate"] = cache->getHitRate();
+    row["writebacks"] = cache->getWritebacks();
+    row["prefetches"] = cache->getPrefetches();
+    row["useful"] = cache->getUsefulPrefetches();
+    row["late"] = cache->getLatePrefetches();
+    row["polluting"] = cache->getPollutingPrefetches();
+    rows << row;
+  }
+
+  // The AMAT of all accesses is weighted by the # of accesses to each L1 cache.
+  const auto &l1i = m_hierarchy->l1i();
+  const auto &l1d = m_hierarchy->l1d();
+  const double instrAccesses = l1i.getHits() + l1i.getMisses();
+  const double dataAccesses = l1d.getHits() + l1d.getMisses();
+  QVariantMap amat;
+  amat["instr"] = l1i.getAMAT();
+  amat["data"] = l1d.getAMAT();
+  amat["total"] = instrAccesses + dataAccesses == 0
+                      ? 0
+                      : (instrAccesses * l1i.getAMAT() +
+                         dataAccesses * l1d.getAMAT()) /
+                            (instrAccesses + dataAccesses);
+
+  if (json) {
+    QVariantMap report;
+    report["levels"] = rows;
+    report["amat"] = amat;
+    return report;
+  }
+
+  QString out = columns.join(',') + "\n";
+  for (const auto &row : rows) {
+    const QVariantMap rowMap = row.toMap();
+    QStringList values;
+    for (const auto &column : columns)
+      values << rowMap.value(column).toString();
+    out += values.join(',') + "\n";
+  }
+  out += "AMAT (instr): " + amat["instr"].toString() + "\n";
+  out += "AMAT (data): " + amat["data"].toString() + "\n";
+  out += "AMAT (total): " + amat["total"].toString();
+  return out;
+}
+
+} // namespace Ripes
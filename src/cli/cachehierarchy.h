@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QObject>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
+#include "telemetry.h"
+
+#include <memory>
+#include <optional>
+
+namespace Ripes {
+
+/// The configuration of a single level of a cache hierarchy.
+struct CacheLevelConfig {
+  CachePreset preset;
+  InclusionPolicy inclusionPolicy = InclusionPolicy::NINE;
+  PrefetchPolicy prefetchPolicy = PrefetchPolicy::NoPrefetch;
+  unsigned hitLatency = 1;
+};
+
+/// The configuration of a cache hierarchy with split L1 instruction and data
+/// caches, an optional unified L2 cache and an optional unified L3 cache.
+struct CacheHierarchyConfig {
+  CacheLevelConfig l1i;
+  CacheLevelConfig l1d;
+  std::optional<CacheLevelConfig> l2;
+  std::optional<CacheLevelConfig> l3;
+  unsigned memoryLatency = 100;
+};
+
+/// Parses a cache hierarchy specification. The specification is a semicolon
+/// separated list of <level>:<params>, where <level> is one of l1i, l1d, l2 or
+/// l3, and <params> is a comma separated list of <parameter>=<value>. The
+/// latency of main memory is specified as mem=<cycles>. Levels and parameters
+/// which are not specified retain the default values of the cache simulator.
+/// Returns true if the specification was parsed successfully.
+bool parseCacheHierarchySpec(const QString &spec, CacheHierarchyConfig &config,
+                             QString &errorMessage);
+
+/// A cache hierarchy which is driven by the memory accesses of the current
+/// processor. The L1 caches are fed through L1CacheShims, and misses propagate
+/// through the hierarchy as the processor is clocked.
+class CacheHierarchy {
+public:
+  CacheHierarchy(const CacheHierarchyConfig &config);
+
+  /// Returns the caches of the hierarchy along with their names, ordered from
+  /// the L1 caches and down.
+  std::vector<std::pair<QString, std::shared_ptr<CacheSim>>> caches() const;
+  const CacheSim &l1i() const { return *m_l1i; }
+  const CacheSim &l1d() const { return *m_l1d; }
+
+private:
+  std::unique_ptr<L1CacheShim> m_l1iShim;
+  std::unique_ptr<L1CacheShim> m_l1dShim;
+  std::shared_ptr<CacheSim> m_l1i;
+  std::shared_ptr<CacheSim> m_l1d;
+  std::shared_ptr<CacheSim> m_l2;
+  std::shared_ptr<CacheSim> m_l3;
+};
+
+/// Reports the statistics of each level of a simulated cache hierarchy, along
+/// with the average memory access time (AMAT) of instruction and data
+/// accesses.
+class CacheHierarchyTelemetry : public Telemetry {
+public:
+  CacheHierarchyTelemetry(const CacheHierarchyConfig &config)
+      : m_config(config) {}
+
+  void enable() override {
+    m_hierarchy = std::make_shared<CacheHierarchy>(m_config);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "cache-hierarchy"; }
+  QString prettyKey() const override { return "cache hierarchy"; }
+  QString description() const override {
+    return "cache hierarchy (per-level statistics and AMAT)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  CacheHierarchyConfig m_config;
+  std::shared_ptr<CacheHierarchy> m_hierarchy;
+};
+
+} // namespace Ripes
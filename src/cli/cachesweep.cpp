@@ -0,0 +1,474 @@
+#include "cachesweep.h"
+#include "binutils.h"
+#include "cachesim/stackdistance.h"
+#include "processorhandler.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <numeric>
+
+namespace Ripes {
+
+namespace {
+
+// Upper bound on the log2 values accepted for the lines, ways and blocks
+// parameters of a sweep.
+constexpr int s_maxSweepBits = 16;
+
+const std::map<QString, L1CacheShim::CacheType> s_sweepCacheTypes{
+    {"data", L1CacheShim::CacheType::DataCache},
+    {"instr", L1CacheShim::CacheType::InstrCache}};
+
+QString invalidValueError(const QString &param, const QString &value) {
+  return "Invalid value '" + value + "' for cache sweep parameter '" + param +
+         "' (--cache-sweep).";
+}
+
+/// Parses a list of log2 values and value ranges ('a-b') into @p out.
+bool parseBitValues(const QString &param, const QStringList &values,
+                    std::vector<int> &out, QString &errorMessage) {
+  out.clear();
+  for (const auto &value : values) {
+    const QStringList range = value.split('-');
+    bool okFrom = false;
+    bool okTo = false;
+    const int from = range.at(0).toInt(&okFrom);
+    const int to = range.size() == 2 ? range.at(1).toInt(&okTo) : from;
+    if (range.size() == 1)
+      okTo = okFrom;
+
+    if (range.size() > 2 || !okFrom || !okTo || from < 0 || to < from ||
+        to > s_maxSweepBits) {
+      errorMessage = invalidValueError(param, value);
+      return false;
+    }
+    for (int v = from; v <= to; ++v)
+      out.push_back(v);
+  }
+  return true;
+}
+
+/// Parses a list of unsigned 32-bit values into @p out.
+bool parseSeedValues(const QString &param, const QStringList &values,
+                     std::vector<uint32_t> &out, QString &errorMessage) {
+  out.clear();
+  for (const auto &value : values) {
+    bool ok = false;
+    const uint32_t seed = value.toUInt(&ok, 0);
+    if (!ok) {
+      errorMessage = invalidValueError(param, value);
+      return false;
+    }
+    out.push_back(seed);
+  }
+  return true;
+}
+
+/// Parses a list of named values into @p out, based on the @p names map.
+template <typename T>
+bool parseNamedValues(const QString &param, const QStringList &values,
+                      const std::map<QString, T> &names, std::vector<T> &out,
+                      QString &errorMessage) {
+  out.clear();
+  for (const auto &value : values) {
+    auto it = names.find(value.toLower());
+    if (it == names.end()) {
+      QStringList validNames;
+      for (const auto &name : names)
+        validNames << name.first;
+      errorMessage = invalidValueError(param, value) +
+                     " Valid values are: " + validNames.join(", ");
+      return false;
+    }
+    out.push_back(it->second);
+  }
+  return true;
+}
+
+CacheSweepResult replayConfig(const CacheAccessRecorder &recorder,
+                              const CacheSweepConfig &config,
+                              unsigned wordBits) {
+  CacheSim cache(wordBits);
+  cache.setPreset(config.preset);
+  cache.setPrefetchPolicy(config.prefetchPolicy);
+
+  if (config.type == L1CacheShim::CacheType::DataCache) {
+    for (const auto &access : recorder.dataAccesses())
+      cache.access(access.address, access.type, access.pc, access.bytes);
+  } else {
+    for (const auto &address : recorder.instrAccesses())
+      cache.access(address, MemoryAccess::Read, address,
+                   recorder.instrBytes());
+  }
+  return cacheSweepResult(cache);
+}
+
+/// Quotes @p value if it contains characters which are special to CSV.
+QString csvField(QString value) {
+  if (!value.contains(',') && !value.contains('"'))
+    return value;
+  return '"' + value.replace('"', "\"\"") + '"';
+}
+
+} // namespace
+
+QString rowsToCSV(const QStringList &columns, const QVariantList &rows) {
+  QString out = columns.join(',') + "\n";
+  for (const auto &row : rows) {
+    const QVariantMap rowMap = row.toMap();
+    QStringList values;
+    for (const auto &column : columns)
+      values << csvField(rowMap.value(column).toString());
+    out += values.join(',') + "\n";
+  }
+  return out;
+}
+
+CacheSweepResult cacheSweepResult(const CacheSim &cache) {
+  CacheSweepResult result;
+  result.hits = cache.getHits();
+  result.misses = cache.getMisses();
+  result.writebacks = cache.getWritebacks();
+  result.hitRate = cache.getHitRate();
+  result.sizeBits = cache.getCacheSize().bits;
+  result.prefetches = cache.getPrefetches();
+  result.usefulPrefetches = cache.getUsefulPrefetches();
+  result.latePrefetches = cache.getLatePrefetches();
+  result.pollutingPrefetches = cache.getPollutingPrefetches();
+  result.compulsoryMisses = cache.getCompulsoryMisses();
+  result.capacityMisses = cache.getCapacityMisses();
+  result.conflictMisses = cache.getConflictMisses();
+  return result;
+}
+
+bool parseCacheSweepSpec(const QString &spec,
+                         std::vector<CacheSweepConfig> &configs,
+                         QString &errorMessage) {
+  // Default values; equal to the defaults of the cache simulator.
+  std::vector<int> lines = {5};
+  std::vector<int> ways = {0};
+  std::vector<int> blocks = {2};
+  std::vector<ReplPolicy> replPolicies = {ReplPolicy::LRU};
+  std::vector<WritePolicy> wrPolicies = {WritePolicy::WriteBack};
+  std::vector<WriteAllocPolicy> wrAllocPolicies = {
+      WriteAllocPolicy::WriteAllocate};
+  std::vector<PrefetchPolicy> prefetchPolicies = {PrefetchPolicy::NoPrefetch};
+  std::vector<uint32_t> seeds = {0};
+  std::vector<L1CacheShim::CacheType> types = {
+      L1CacheShim::CacheType::DataCache};
+
+  for (const auto &paramSpec : spec.split(';', Qt::SkipEmptyParts)) {
+    const QStringList parts = paramSpec.split('=');
+    if (parts.size() != 2) {
+      errorMessage =
+          "Invalid cache sweep parameter '" + paramSpec + "' (--cache-sweep).";
+      return false;
+    }
+    const QString param = parts.at(0).trimmed().toLower();
+    const QStringList values = parts.at(1).split(',', Qt::SkipEmptyParts);
+    if (values.isEmpty()) {
+      errorMessage = invalidValueError(param, parts.at(1));
+      return false;
+    }
+
+    bool ok = false;
+    if (param == "lines") {
+      ok = parseBitValues(param, values, lines, errorMessage);
+    } else if (param == "ways") {
+      ok = parseBitValues(param, values, ways, errorMessage);
+    } else if (param == "blocks") {
+      ok = parseBitValues(param, values, blocks, errorMessage);
+    } else if (param == "repl") {
+      ok = parseNamedValues(param, values, s_cliReplPolicies, replPolicies,
+                            errorMessage);
+    } else if (param == "wr") {
+      ok = parseNamedValues(param, values, s_cliWritePolicies, wrPolicies,
+                            errorMessage);
+    } else if (param == "alloc") {
+      ok = parseNamedValues(param, values, s_cliWriteAllocPolicies,
+                            wrAllocPolicies, errorMessage);
+    } else if (param == "pf") {
+      ok = parseNamedValues(param, values, s_cliPrefetchPolicies,
+                            prefetchPolicies, errorMessage);
+    } else if (param == "seed") {
+      ok = parseSeedValues(param, values, seeds, errorMessage);
+    } else if (param == "cache") {
+      ok = parseNamedValues(param, values, s_sweepCacheTypes, types,
+                            errorMessage);
+    } else {
+      errorMessage =
+          "Unknown cache sweep parameter '" + param + "' (--cache-sweep).";
+    }
+    if (!ok)
+      return false;
+  }
+
+  configs.clear();
+  for (auto type : types)
+    for (int l : lines)
+      for (int w : ways)
+        for (int b : blocks)
+          for (auto repl : replPolicies)
+            for (auto wr : wrPolicies)
+              for (auto wrAlloc : wrAllocPolicies)
+                for (auto pf : prefetchPolicies)
+                  for (auto seed : seeds) {
+                    CacheSweepConfig config;
+                    config.type = type;
+                    config.prefetchPolicy = pf;
+                    config.preset.lines = l;
+                    config.preset.ways = w;
+                    config.preset.blocks = b;
+                    config.preset.replPolicy = repl;
+                    config.preset.wrPolicy = wr;
+                    config.preset.wrAllocPolicy = wrAlloc;
+                    config.preset.seed = seed;
+                    config.preset.name =
+                        QString("%1-L%2W%3B%4")
+                            .arg(type == L1CacheShim::CacheType::DataCache
+                                     ? "D"
+                                     : "I")
+                            .arg(l)
+                            .arg(w)
+                            .arg(b);
+                    configs.push_back(config);
+                  }
+  return true;
+}
+
+CacheAccessRecorder::CacheAccessRecorder(QObject *parent) : QObject(parent) {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          &CacheAccessRecorder::processorReset);
+
+  // Accesses must be recorded on each cycle, in lockstep with the processor
+  // itself. Ensure that the handler is executed in the thread that the
+  // processor lives in (direct connection).
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          &CacheAccessRecorder::processorWasClocked, Qt::DirectConnection);
+
+  processorReset();
+}
+
+void CacheAccessRecorder::processorReset() {
+  m_dataAccesses.clear();
+  m_instrAccesses.clear();
+  m_instrBytes = ProcessorHandler::currentISA()->instrBytes();
+
+  // Record the initial (cycle 0) state of the processor; see
+  // L1CacheShim::processorReset.
+  processorWasClocked();
+}
+
+void CacheAccessRecorder::processorWasClocked() {
+  const auto *processor = ProcessorHandler::getProcessor();
+  const auto dataAccess = processor->dataMemAccess();
+  if (dataAccess.type != MemoryAccess::None)
+    m_dataAccesses.push_back(
+        {dataAccess.address, dataAccess.type, dataAccess.pc, dataAccess.bytes});
+
+  const auto instrAccess = processor->instrMemAccess();
+  if (instrAccess.type == MemoryAccess::Read)
+    m_instrAccesses.push_back(instrAccess.address);
+}
+
+std::vector<CacheSweepResult>
+runCacheSweep(const CacheAccessRecorder &recorder,
+              const std::vector<CacheSweepConfig> &configs, unsigned wordBits) {
+  std::vector<CacheSweepResult> results(configs.size());
+  std::vector<unsigned> indices(configs.size());
+  std::iota(indices.begin(), indices.end(), 0);
+
+  // Each configuration owns a standalone cache simulator, so all
+  // configurations can be replayed concurrently.
+  QtConcurrent::blockingMap(indices, [&](const unsigned &i) {
+    results[i] = replayConfig(recorder, configs[i], wordBits);
+  });
+  return results;
+}
+
+QVariant cacheSweepReport(const std::vector<CacheSweepConfig> &configs,
+                          const std::vector<CacheSweepResult> &results,
+                          bool json) {
+  const QStringList columns = {
+      "name",     "cache",     "lines",       "ways",       "blocks",
+      "repl",     "seed",      "wr",          "alloc",      "pf",
+      "accesses", "hits",      "misses",      "compulsory", "capacity",
+      "conflict", "hit rate",  "writebacks",  "prefetches", "useful",
+      "late",     "polluting", "size (bits)"};
+
+  QVariantList rows;
+  for (unsigned i = 0; i < configs.size(); ++i) {
+    const auto &preset = configs.at(i).preset;
+    const auto &result = results.at(i);
+    QVariantMap row;
+    row["name"] = preset.name;
+    row["cache"] = configs.at(i).type == L1CacheShim::CacheType::DataCache
+                       ? "data"
+                       : "instr";
+    row["lines"] = 1 << preset.lines;
+    row["ways"] = 1 << preset.ways;
+    row["blocks"] = 1 << preset.blocks;
+    row["repl"] = s_cacheReplPolicyStrings.at(preset.replPolicy);
+    row["seed"] = preset.seed;
+    row["wr"] = s_cacheWritePolicyStrings.at(preset.wrPolicy);
+    row["alloc"] = s_cacheWriteAllocateStrings.at(preset.wrAllocPolicy);
+    row["pf"] = s_cachePrefetchPolicyStrings.at(configs.at(i).prefetchPolicy);
+    row["size (bits)"] = result.sizeBits;
+    row["accesses"] = result.hits + result.misses;
+    row["hits"] = result.hits;
+    row["misses"] = result.misses;
+    row["compulsory"] = result.compulsoryMisses;
+    row["capacity"] = result.capacityMisses;
+    row["conflict"] = result.conflictMisses;
+    row["hit rate"] = result.hitRate;
+    row["writebacks"] = result.writebacks;
+    row["prefetches"] = result.prefetches;
+    row["useful"] = result.usefulPrefetches;
+    row["late"] = result.latePrefetches;
+    row["polluting"] = result.pollutingPrefetches;
+    rows << row;
+  }
+
+  if (json)
+    return rows;
+  return rowsToCSV(columns, rows);
+}
+
+QVariant CacheSweepTelemetry::report(bool json) {
+  const auto results = runCacheSweep(*m_recorder, m_configs,
+                                     ProcessorHandler::currentISA()->bits());
+  return cacheSweepReport(m_configs, results, json);
+}
+
+QVariant MissRatioCurveTelemetry::report(bool json) {
+  const unsigned byteOffset = log2Ceil(ProcessorHandler::currentISA()->bytes());
+  // Default block size of the cache simulator.
+  const unsigned blockBits = 2;
+  // Maximum # of ways selectable in the cache configuration widget.
+  const unsigned maxWayBits = 10;
+
+  const QStringList columns = {"cache", "lines",  "ways",     "blocks",
+                               "size",  "misses", "miss rate"};
+  QVariantList rows;
+  for (auto type : {L1CacheShim::CacheType::DataCache,
+                    L1CacheShim::CacheType::InstrCache}) {
+    StackDistanceAnalyzer analyzer(byteOffset, blockBits);
+    if (type == L1CacheShim::CacheType::DataCache) {
+      for (const auto &access : m_recorder->dataAccesses())
+        analyzer.access(access.address);
+    } else {
+      for (const auto &address : m_recorder->instrAccesses())
+        analyzer.access(address);
+    }
+
+    for (unsigned lineBits = 0; lineBits <= analyzer.maxLineBits();
+         ++lineBits) {
+      for (unsigned wayBits = 0; wayBits <= maxWayBits; ++wayBits) {
+        QVariantMap row;
+        row["cache"] =
+            type == L1CacheShim::CacheType::DataCache ? "data" : "instr";
+        row["lines"] = 1 << lineBits;
+        row["ways"] = 1 << wayBits;
+        row["blocks"] = 1 << blockBits;
+        // Cache capacity, in words
+        row["size"] = 1 << (lineBits + wayBits + blockBits);
+        row["misses"] = static_cast<qulonglong>(
+            analyzer.misses(lineBits, wayBits));
+        row["miss rate"] = analyzer.missRate(lineBits, wayBits);
+        rows << row;
+      }
+    }
+  }
+
+  if (json)
+    return rows;
+  return rowsToCSV(columns, rows);
+}
+
+QVariant CacheMissesTelemetry::report(bool json) {
+  const auto program = ProcessorHandler::getProgram();
+  const ReverseSymbolMap symbols =
+      program ? program->symbols : ReverseSymbolMap();
+
+  const QStringList instrColumns = {
+      "cache",  "pc",        "symbol",     "instruction",     "accesses",
+      "misses", "miss rate", "miss share", "cumulative share"};
+  const QStringList symbolColumns = {"cache",     "symbol",    "address",
+                                     "accesses",  "misses",    "miss rate",
+                                     "miss share"};
+  auto missRate = [](const AccessCounters &counters) {
+    return counters.accesses == 0
+               ? 0.0
+               : static_cast<double>(counters.misses) / counters.accesses;
+  };
+
+  QVariantList instrRows;
+  QVariantList symbolRows;
+  for (auto type : {L1CacheShim::CacheType::DataCache,
+                    L1CacheShim::CacheType::InstrCache}) {
+    CacheSim cache(ProcessorHandler::currentISA()->bits());
+    cache.setPCAccounting(true);
+    if (type == L1CacheShim::CacheType::DataCache) {
+      for (const auto &access : m_recorder->dataAccesses())
+        cache.access(access.address, access.type, access.pc, access.bytes);
+    } else {
+      for (const auto &address : m_recorder->instrAccesses())
+        cache.access(address, MemoryAccess::Read, address,
+                     m_recorder->instrBytes());
+    }
+    const QString cacheName =
+        type == L1CacheShim::CacheType::DataCache ? "data" : "instr";
+    const unsigned totalMisses = cache.getMisses();
+    auto missShare = [&](const AccessCounters &counters) {
+      return totalMisses == 0
+                 ? 0.0
+                 : static_cast<double>(counters.misses) / totalMisses;
+    };
+
+    const auto &pcCounters = cache.getPCAccessCounters();
+    unsigned cumulativeMisses = 0;
+    for (const auto &[pc, counters] : sortByMisses(pcCounters)) {
+      cumulativeMisses += counters.misses;
+      const auto *symbol = enclosingSymbol(pc, symbols);
+      QVariantMap row;
+      row["cache"] = cacheName;
+      row["pc"] = "0x" + QString::number(pc, 16);
+      row["symbol"] = symbol ? symbol->second.v : QString();
+      if (program)
+        row["instruction"] =
+            program->getDisassembled().getFromAddr(pc).value_or(QString());
+      row["accesses"] = counters.accesses;
+      row["misses"] = counters.misses;
+      row["miss rate"] = missRate(counters);
+      row["miss share"] = missShare(counters);
+      row["cumulative share"] =
+          totalMisses == 0
+              ? 0.0
+              : static_cast<double>(cumulativeMisses) / totalMisses;
+      instrRows << row;
+    }
+
+    for (const auto &entry : aggregateBySymbol(pcCounters, symbols)) {
+      QVariantMap row;
+      row["cache"] = cacheName;
+      row["symbol"] = entry.symbol;
+      row["address"] = "0x" + QString::number(entry.address, 16);
+      row["accesses"] = entry.counters.accesses;
+      row["misses"] = entry.counters.misses;
+      row["miss rate"] = missRate(entry.counters);
+      row["miss share"] = missShare(entry.counters);
+      symbolRows << row;
+    }
+  }
+
+  if (json) {
+    QVariantMap report;
+    report["instructions"] = instrRows;
+    report["symbols"] = symbolRows;
+    return report;
+  }
+  return rowsToCSV(instrColumns, instrRows) + "\n" +
+         rowsToCSV(symbolColumns, symbolRows);
+}
+
+} // namespace Ripes
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <QObject>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
+#include "telemetry.h"
+
+#include <vector>
+
+namespace Ripes {
+
+/// Command line names of the cache policies.
+const static std::map<QString, ReplPolicy> s_cliReplPolicies{
+    {"lru", ReplPolicy::LRU},     {"random", ReplPolicy::Random},
+    {"plru", ReplPolicy::PLRU},   {"fifo", ReplPolicy::FIFO},
+    {"srrip", ReplPolicy::SRRIP}, {"brrip", ReplPolicy::BRRIP},
+    {"lfu", ReplPolicy::LFU}};
+const static std::map<QString, WritePolicy> s_cliWritePolicies{
+    {"wb", WritePolicy::WriteBack}, {"wt", WritePolicy::WriteThrough}};
+const static std::map<QString, WriteAllocPolicy> s_cliWriteAllocPolicies{
+    {"wa", WriteAllocPolicy::WriteAllocate},
+    {"nwa", WriteAllocPolicy::NoWriteAllocate}};
+const static std::map<QString, PrefetchPolicy> s_cliPrefetchPolicies{
+    {"none", PrefetchPolicy::NoPrefetch},
+    {"next-line", PrefetchPolicy::NextLine},
+    {"stride", PrefetchPolicy::Stride},
+    {"stream", PrefetchPolicy::Stream}};
+
+/// A single cache configuration which is evaluated during a cache sweep.
+struct CacheSweepConfig {
+  CachePreset preset;
+  PrefetchPolicy prefetchPolicy = PrefetchPolicy::NoPrefetch;
+  L1CacheShim::CacheType type = L1CacheShim::CacheType::DataCache;
+};
+
+/// The statistics gathered from replaying a recorded access stream through a
+/// single cache configuration.
+struct CacheSweepResult {
+  unsigned hits = 0;
+  unsigned misses = 0;
+  unsigned writebacks = 0;
+  double hitRate = 0;
+  unsigned sizeBits = 0;
+  unsigned prefetches = 0;
+  unsigned usefulPrefetches = 0;
+  unsigned latePrefetches = 0;
+  unsigned pollutingPrefetches = 0;
+  unsigned compulsoryMisses = 0;
+  unsigned capacityMisses = 0;
+  unsigned conflictMisses = 0;
+};
+
+/// Parses a cache sweep specification into the cartesian product of all
+/// configurations that it describes. The specification is a semicolon
+/// separated list of <parameter>=<values>, where <values> is a comma separated
+/// list. The lines, ways and blocks parameters are specified in log2 and
+/// additionally accept ranges ('a-b'). Parameters which are not specified
+/// retain the default value of the cache simulator. Returns true if the
+/// specification was parsed successfully.
+bool parseCacheSweepSpec(const QString &spec,
+                         std::vector<CacheSweepConfig> &configs,
+                         QString &errorMessage);
+
+/// The CacheAccessRecorder records the instruction and data memory access
+/// streams of the current processor, such that they may later be replayed
+/// through any number of cache configurations without re-running the
+/// processor model.
+class CacheAccessRecorder : public QObject {
+  Q_OBJECT
+public:
+  struct DataAccess {
+    AInt address;
+    MemoryAccess::Type type;
+    AInt pc;
+    unsigned bytes;
+  };
+
+  CacheAccessRecorder(QObject *parent = nullptr);
+
+  const std::vector<DataAccess> &dataAccesses() const { return m_dataAccesses; }
+  /// Instruction accesses are always reads of a single instruction, so only
+  /// the address is recorded.
+  const std::vector<AInt> &instrAccesses() const { return m_instrAccesses; }
+  unsigned instrBytes() const { return m_instrBytes; }
+
+private:
+  void processorReset();
+  void processorWasClocked();
+
+  std::vector<DataAccess> m_dataAccesses;
+  std::vector<AInt> m_instrAccesses;
+  unsigned m_instrBytes = 0;
+};
+
+/// Replays the access streams of @p recorder through each of the cache
+/// configurations in @p configs. Configurations are simulated in parallel on
+/// the global thread pool. Results are returned in the order of @p configs.
+std::vector<CacheSweepResult>
+runCacheSweep(const CacheAccessRecorder &recorder,
+              const std::vector<CacheSweepConfig> &configs, unsigned wordBits);
+
+/// Returns the statistics of the accesses performed on @p cache.
+CacheSweepResult cacheSweepResult(const CacheSim &cache);
+
+/// Reports the @p results of a cache sweep over @p configs, as a list of rows
+/// if @p json is set, and as CSV otherwise.
+QVariant cacheSweepReport(const std::vector<CacheSweepConfig> &configs,
+                          const std::vector<CacheSweepResult> &results,
+                          bool json);
+
+/// Formats @p rows as CSV, with a header of @p columns.
+QString rowsToCSV(const QStringList &columns, const QVariantList &rows);
+
+class CacheSweepTelemetry : public Telemetry {
+public:
+  CacheSweepTelemetry(const std::vector<CacheSweepConfig> &configs)
+      : m_configs(configs) {}
+
+  void enable() override {
+    // The recorder will, upon construction, connect to the ProcessorHandler
+    // and record all memory accesses during execution.
+    m_recorder = std::make_shared<CacheAccessRecorder>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "cache-sweep"; }
+  QString prettyKey() const override { return "cache sweep"; }
+  QString description() const override {
+    return "cache sweep (hit rate, misses by 3C class and writebacks per "
+           "cache configuration)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::vector<CacheSweepConfig> m_configs;
+  std::shared_ptr<CacheAccessRecorder> m_recorder;
+};
+
+/// Reports the miss-ratio curve of LRU caches for the data and instruction
+/// access streams of the program. The curve covers all combinations of 2^0 to
+/// 2^10 lines and ways, for blocks of the default cache block size, and is
+/// computed through a single pass over each access stream (see
+/// StackDistanceAnalyzer).
+class MissRatioCurveTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_recorder = std::make_shared<CacheAccessRecorder>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "miss-ratio-curve"; }
+  QString prettyKey() const override { return "miss-ratio curve"; }
+  QString description() const override {
+    return "miss-ratio curve (misses per LRU cache size and associativity)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::shared_ptr<CacheAccessRecorder> m_recorder;
+};
+
+/// Reports the instructions and symbols of the program which caused the most
+/// misses in the data and instruction caches. The access streams of the program
+/// are replayed through caches of the default configuration, and each access is
+/// attributed to the instruction which issued it.
+class CacheMissesTelemetry : public Telemetry {
+public:
+  void enable() override {
+    m_recorder = std::make_shared<CacheAccessRecorder>();
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "cache-misses"; }
+  QString prettyKey() const override { return "cache misses"; }
+  QString description() const override {
+    return "cache misses per instruction and symbol, in descending order";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::shared_ptr<CacheAccessRecorder> m_recorder;
+};
+
+} // namespace Ripes
@@ -1,7 +1,14 @@
 #include "clioptions.h"
+#include "cachehierarchy.h"
+#include "cachesweep.h"
+#include "multihartsimulation.h"
 #include "processorregistry.h"
 #include "radix.h"
+#include "sampledsimulation.h"
 #include "telemetry.h"
+#include "timeseries.h"
+#include "tracereplay.h"
+#include "tracetelemetry.h"
 #include <QFile>
 #include <QMetaEnum>
 
@@ -25,6 +32,66 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
   QString desc =
       "Processor model. Options: [" + processorOptions.join(", ") + "]";
   parser.addOption(QCommandLineOption("proc", desc, "name"));
+  parser.addOption(QCommandLineOption(
+      "engine",
+      "Simulation engine. Options: [auto, vsrtl, interpreter]. 'vsrtl' "
+      "simulates the circuit of the processor model. 'interpreter' executes "
+      "the program through an instruction-level interpreter of the processor, "
+      "which is significantly faster, and is provided by the single-cycle "
+      "processors. 'auto' selects the interpreter if the processor provides "
+      "one.",
+      "engine", "auto"));
+  parser.addOption(QCommandLineOption(
+      "fast-forward",
+      "Execute the program on a fast functional model until a marker is "
+      "reached, after which the registers, program counter and memory are "
+      "transferred into the processor model, which continues executing the "
+      "program. Reported statistics cover the program from the marker "
+      "onwards. Markers: pc=<address>, symbol=<name>, instrs=<count>.",
+      "marker"));
+  parser.addOption(QCommandLineOption(
+      "sample",
+      "Estimate the CPI of the processor model through sampled simulation. "
+      "The program is executed on a fast functional model, and once every "
+      "period instructions, its state is transferred into the processor "
+      "model, which executes 'warmup' instructions followed by a measured "
+      "window of 'window' instructions. Reports the mean CPI of the windows "
+      "and its 95% confidence interval. Semicolon-separated list of "
+      "<param>=<value>. Parameters: period (default 1000000), window (default "
+      "10000), warmup (default 1000). Example: "
+      "\"period=100000;window=2000;warmup=500\"",
+      "spec"));
+  parser.addOption(QCommandLineOption(
+      "break",
+      "Stop the simulation when a breakpoint is reached. Semicolon-separated "
+      "list of <location>[ if <condition>], where <location> is an address or "
+      "symbol, and <condition> is a &&-separated list of comparisons (==, !=, "
+      "<, <=, >, >=) between registers, pc, hits (number of times the "
+      "breakpoint was reached) and integers. Example: "
+      "\"loop if a0 == 5 && hits > 3;0x1000\"",
+      "breakpoints"));
+  parser.addOption(QCommandLineOption(
+      "watch",
+      "Stop the simulation when a watchpoint triggers. Semicolon-separated "
+      "list of <type>:<target>, where <type> is r (read), w (write), rw "
+      "(read or write) or c (value change), and <target> is "
+      "<address>[+<bytes>] or, for change watchpoints, a register. Example: "
+      "\"w:0x10000000+4;c:a0\"",
+      "watchpoints"));
+  parser.addOption(QCommandLineOption(
+      "harts",
+      "Number of harts executing the program. Each hart is an instance of the "
+      "processor model running on its own thread, and all harts share the "
+      "memory of the processor. Hart i starts with its hart ID in a0 and its "
+      "stack pointer 64 KiB * i below that of hart 0. The simulation finishes "
+      "once all harts have finished. Requires the interpreter engine.",
+      "n", "1"));
+  parser.addOption(QCommandLineOption(
+      "hart-quantum",
+      "Number of cycles which each hart executes between synchronizations of "
+      "all harts (--harts), bounding how far harts run ahead of each other. 0 "
+      "lets harts run unsynchronized.",
+      "cycles", "1000"));
   parser.addOption(QCommandLineOption("isaexts",
                                       "ISA extensions to enable (comma "
                                       "separated)",
@@ -49,13 +116,109 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
 
   parser.addOption(QCommandLineOption("all", "Enable all report options."));
 
+  parser.addOption(QCommandLineOption(
+      "cache-sweep",
+      "Record the memory access streams of the program and replay them "
+      "through a set of cache configurations, reporting hits, misses "
+      "(compulsory, capacity and conflict) and writebacks for each. "
+      "Semicolon-separated list of <param>=<values>, "
+      "where values are comma-separated. Parameters: lines, ways, blocks "
+      "(log2; ranges as 'a-b'), repl [lru, plru, fifo, srrip, brrip, lfu, "
+      "random], seed (seed of the random policy), wr [wb, wt], alloc [wa, "
+      "nwa], pf [none, next-line, stride, stream], cache [data, instr]. "
+      "Example: "
+      "\"lines=2-8;ways=0-2;pf=none,stream;cache=data,instr\"",
+      "spec"));
+
+  parser.addOption(QCommandLineOption(
+      "cache-hierarchy",
+      "Simulate a cache hierarchy alongside the processor, reporting the "
+      "statistics of each cache level and the average memory access time "
+      "(AMAT). Semicolon-separated list of <level>:<params>, where level is "
+      "one of [l1i, l1d, l2, l3] and params are comma-separated "
+      "<param>=<value>. Parameters: lines, ways, blocks (log2), repl [lru, "
+      "plru, fifo, srrip, brrip, lfu, random], seed (seed of the random "
+      "policy), wr [wb, wt], alloc [wa, nwa], "
+      "incl [nine, inclusive, exclusive], pf [none, next-line, stride, "
+      "stream], lat (hit latency in cycles). The "
+      "memory latency is specified as mem=<cycles>. Example: "
+      "\"l1d:lines=6,ways=1;l2:lines=9,ways=2,lat=10,incl=inclusive;mem=100\"",
+      "spec"));
+
+  parser.addOption(QCommandLineOption(
+      "trace",
+      "Record a binary execution trace of the processor model to a file. For "
+      "each cycle, the trace holds the fetched PC and instruction, the data "
+      "memory access, the registers written and the PC and state of each "
+      "pipeline stage. The trace is written by a background thread in blocks, "
+      "such that its memory use is bounded regardless of the length of the "
+      "run. Also reports the size of the trace.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "trace-compress",
+      "Compress the blocks of the execution trace (--trace)."));
+  parser.addOption(QCommandLineOption(
+      "timeseries",
+      "Write a time series of the execution to a file while the program "
+      "runs. Every interval of cycles (--timeseries-interval), a sample is "
+      "written holding the instructions retired, CPI and IPC of the interval, "
+      "the cumulative CPI, the accesses and hit rates of data and instruction "
+      "caches of the default configuration, and the number of each pipeline "
+      "event of the interval (see --stalls, --flushes, --forwards, "
+      "--dual-issue and --way-hazards), which is empty for events that the "
+      "processor does not count. Also reports the number of samples written.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "timeseries-interval",
+      "Number of cycles between samples of the time series (--timeseries).",
+      "cycles", "1000"));
+  parser.addOption(QCommandLineOption(
+      "timeseries-format",
+      "Format of the time series (--timeseries); csv, or jsonl (JSON Lines; "
+      "one JSON object per sample).",
+      "format", "csv"));
+  parser.addOption(QCommandLineOption(
+      "replay",
+      "Replay an execution trace recorded through --trace, instead of "
+      "simulating a program. The memory accesses of the trace drive the caches "
+      "of --cache-sweep, and its conditional branches drive the branch "
+      "predictors of --bp-sweep. --src and --proc are not required.",
+      "path"));
+  parser.addOption(QCommandLineOption(
+      "bp-sweep",
+      "Branch predictor configurations to evaluate when replaying a trace "
+      "(--replay). Semicolon-separated list of <param>=<values>, where values "
+      "are comma-separated. Parameters: type [not-taken, taken, bimodal, "
+      "gshare], bits (log2 of the number of 2-bit counters), history (bits of "
+      "global history of gshare); bits and history accept ranges as 'a-b'. "
+      "Example: \"type=bimodal,gshare;bits=8-12;history=4,8\"",
+      "spec"));
+
   // telemetry reporting
   options.telemetry.push_back(std::make_shared<CyclesTelemetry>());
   options.telemetry.push_back(std::make_shared<InstrsRetiredTelemetry>());
   options.telemetry.push_back(std::make_shared<CPITelemetry>());
   options.telemetry.push_back(std::make_shared<IPCTelemetry>());
+  using PipelineEvent = RipesProcessor::PipelineEvent;
+  options.telemetry.push_back(std::make_shared<PipelineEventTelemetry>(
+      PipelineEvent::DataHazardStall, "stalls", "# data hazard stalls",
+      "cycles stalled due to data (load-use) hazards"));
+  options.telemetry.push_back(std::make_shared<PipelineEventTelemetry>(
+      PipelineEvent::ControlFlush, "flushes", "# control flushes",
+      "control flow changes which flushed the pipeline"));
+  options.telemetry.push_back(std::make_shared<PipelineEventTelemetry>(
+      PipelineEvent::Forward, "forwards", "# forwarded operands",
+      "operands forwarded to the execute stage"));
+  options.telemetry.push_back(std::make_shared<PipelineEventTelemetry>(
+      PipelineEvent::DualIssue, "dual-issue", "# dual-issue cycles",
+      "cycles in which both ways of a dual-issue processor executed"));
+  options.telemetry.push_back(std::make_shared<PipelineEventTelemetry>(
+      PipelineEvent::WayHazard, "way-hazards", "# way hazards",
+      "fetched instruction pairs split due to a way hazard"));
   options.telemetry.push_back(std::make_shared<PipelineTelemetry>());
   options.telemetry.push_back(std::make_shared<RegisterTelemetry>());
+  options.telemetry.push_back(std::make_shared<MissRatioCurveTelemetry>());
+  options.telemetry.push_back(std::make_shared<CacheMissesTelemetry>());
   options.telemetry.push_back(std::make_shared<RunInfoTelemetry>(&parser));
 
   for (auto &telemetry : options.telemetry) {
@@ -65,10 +228,59 @@ void addCLIOptions(QCommandLineParser &parser, Ripes::CLIModeOptions &options) {
   }
 }
 
+/// Parses the options of replaying an execution trace (--replay), which
+/// replaces the simulation of a program.
+static bool parseReplayOptions(QCommandLineParser &parser,
+                               QString &errorMessage,
+                               CLIModeOptions &options) {
+  std::vector<CacheSweepConfig> cacheConfigs;
+  if (parser.isSet("cache-sweep") &&
+      !parseCacheSweepSpec(parser.value("cache-sweep"), cacheConfigs,
+                           errorMessage))
+    return false;
+  std::vector<BranchPredictorConfig> predictorConfigs;
+  if (parser.isSet("bp-sweep") &&
+      !parseBranchPredictorSweepSpec(parser.value("bp-sweep"),
+                                     predictorConfigs, errorMessage))
+    return false;
+  if (cacheConfigs.empty() && predictorConfigs.empty()) {
+    errorMessage = "Replaying a trace requires --cache-sweep or --bp-sweep "
+                   "(--replay).";
+    return false;
+  }
+
+  if (parser.isSet("timeout")) {
+    bool ok;
+    options.timeout = parser.value("timeout").toUInt(&ok);
+    if (!ok) {
+      errorMessage = "Invalid timeout value specified (--timeout).";
+      return false;
+    }
+  }
+  options.jsonOutput = parser.isSet("json");
+  options.outputFile = parser.value("output");
+
+  options.replay = std::make_shared<TraceReplay>(
+      parser.value("replay"), cacheConfigs, predictorConfigs);
+  // The replay is the only telemetry of a replayed trace.
+  options.telemetry.push_back(
+      std::make_shared<TraceReplayTelemetry>(options.replay));
+  options.telemetry.back()->enable();
+  return true;
+}
+
 bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
                      CLIModeOptions &options) {
   options.verbose = parser.isSet("v");
 
+  if (parser.isSet("replay"))
+    return parseReplayOptions(parser, errorMessage, options);
+  if (parser.isSet("bp-sweep")) {
+    errorMessage = "Branch predictors are evaluated by replaying a trace "
+                   "(--bp-sweep).";
+    return false;
+  }
+
   if (!parser.isSet("src")) {
     errorMessage = "No source file specified (--src)";
     return false;
@@ -107,6 +319,26 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
   }
   options.proc = static_cast<ProcessorID>(procID);
 
+  const bool hasInterpreter =
+      ProcessorRegistry::getDescription(options.proc).hasInterpreter();
+  const QString engine = parser.value("engine");
+  if (engine == "auto") {
+    options.interpreter = hasInterpreter;
+  } else if (engine == "vsrtl") {
+    options.interpreter = false;
+  } else if (engine == "interpreter") {
+    if (!hasInterpreter) {
+      errorMessage = "Processor '" + enumToString<ProcessorID>(options.proc) +
+                     "' does not provide an interpreter (--engine).";
+      return false;
+    }
+    options.interpreter = true;
+  } else {
+    errorMessage =
+        "Invalid simulation engine '" + engine + "' specified (--engine).";
+    return false;
+  }
+
   options.jsonOutput = parser.isSet("json");
 
   if (parser.isSet("isaexts")) {
@@ -216,6 +448,116 @@ bool parseCLIOptions(QCommandLineParser &parser, QString &errorMessage,
     }
   }
 
+  if (parser.isSet("cache-sweep")) {
+    std::vector<CacheSweepConfig> configs;
+    if (!parseCacheSweepSpec(parser.value("cache-sweep"), configs,
+                             errorMessage))
+      return false;
+    options.telemetry.push_back(std::make_shared<CacheSweepTelemetry>(configs));
+  }
+
+  if (parser.isSet("fast-forward")) {
+    FastForwardMarker marker;
+    if (!parseFastForwardMarker(parser.value("fast-forward"), marker,
+                                errorMessage))
+      return false;
+    options.fastForward = marker;
+  }
+
+  if (parser.isSet("sample")) {
+    SamplingConfig config;
+    if (!parseSamplingSpec(parser.value("sample"), config, errorMessage))
+      return false;
+    options.sampling = std::make_shared<SampledSimulation>(config);
+    options.telemetry.push_back(
+        std::make_shared<SamplingTelemetry>(options.sampling));
+  }
+
+  if (parser.isSet("break"))
+    options.breakpoints = parser.value("break").split(';', Qt::SkipEmptyParts);
+  if (parser.isSet("watch"))
+    options.watchpoints = parser.value("watch").split(';', Qt::SkipEmptyParts);
+
+  if (parser.isSet("harts")) {
+    bool ok = false;
+    const unsigned harts = parser.value("harts").toUInt(&ok);
+    if (!ok || harts == 0) {
+      errorMessage =
+          "Invalid number of harts '" + parser.value("harts") + "' (--harts).";
+      return false;
+    }
+    const unsigned long long quantum =
+        parser.value("hart-quantum").toULongLong(&ok);
+    if (!ok) {
+      errorMessage = "Invalid hart quantum '" + parser.value("hart-quantum") +
+                     "' (--hart-quantum).";
+      return false;
+    }
+    if (harts > 1) {
+      if (!options.interpreter) {
+        errorMessage = "Multiple harts require the interpreter engine "
+                       "(--harts).";
+        return false;
+      }
+      if (options.fastForward || options.sampling ||
+          !options.breakpoints.isEmpty() || !options.watchpoints.isEmpty()) {
+        errorMessage = "Multiple harts cannot be combined with "
+                       "--fast-forward, --sample, --break or --watch "
+                       "(--harts).";
+        return false;
+      }
+      options.harts = std::make_shared<MultiHartSimulation>(harts, quantum);
+      options.telemetry.push_back(
+          std::make_shared<HartTelemetry>(options.harts));
+    }
+  }
+
+  if (parser.isSet("cache-hierarchy")) {
+    CacheHierarchyConfig config;
+    if (!parseCacheHierarchySpec(parser.value("cache-hierarchy"), config,
+                                 errorMessage))
+      return false;
+    options.telemetry.push_back(
+        std::make_shared<CacheHierarchyTelemetry>(config));
+  }
+
+  if (parser.isSet("trace")) {
+    TraceWriter::Options traceOptions;
+    traceOptions.compress = parser.isSet("trace-compress");
+    options.telemetry.push_back(
+        std::make_shared<TraceTelemetry>(parser.value("trace"), traceOptions));
+  } else if (parser.isSet("trace-compress")) {
+    errorMessage = "Compressing the execution trace requires a trace file "
+                   "(--trace-compress).";
+    return false;
+  }
+
+  if (parser.isSet("timeseries")) {
+    TimeSeriesConfig config;
+    config.path = parser.value("timeseries");
+    bool ok = false;
+    config.interval = parser.value("timeseries-interval").toULongLong(&ok);
+    if (!ok || config.interval == 0) {
+      errorMessage = "Invalid time series interval '" +
+                     parser.value("timeseries-interval") +
+                     "' (--timeseries-interval).";
+      return false;
+    }
+    if (!parseTimeSeriesFormat(parser.value("timeseries-format"),
+                               config.format)) {
+      errorMessage = "Invalid time series format '" +
+                     parser.value("timeseries-format") +
+                     "' (--timeseries-format). Valid values are: csv, jsonl";
+      return false;
+    }
+    options.telemetry.push_back(std::make_shared<TimeSeriesTelemetry>(config));
+  } else if (parser.isSet("timeseries-interval") ||
+             parser.isSet("timeseries-format")) {
+    errorMessage = "Configuring the time series requires a time series file "
+                   "(--timeseries).";
+    return false;
+  }
+
   // Enable selected telemetry options.
   for (auto &telemetry : options.telemetry)
     if (parser.isSet("all") || parser.isSet(telemetry->key()))
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "assembler/program.h"
+#include "multihartsimulation.h"
 #include "processorregistry.h"
+#include "sampledsimulation.h"
 #include "telemetry.h"
+#include "tracereplay.h"
 #include <QCommandLineParser>
+#include <optional>
 #include <set>
 
 namespace Ripes {
@@ -13,6 +17,26 @@ struct CLIModeOptions {
   SourceType srcType;
   ProcessorID proc;
   QStringList isaExtensions;
+  // Simulate the processor through its instruction-level interpreter rather
+  // than its VSRTL model.
+  bool interpreter = false;
+  // If set, the program is executed on the functional model of 'proc' until
+  // the marker is reached, after which its state is transferred into 'proc'.
+  std::optional<FastForwardMarker> fastForward;
+  // If set, the program is executed on the functional model of 'proc', and
+  // the CPI of 'proc' is estimated through periodic windows of detailed
+  // simulation.
+  std::shared_ptr<SampledSimulation> sampling;
+  // Breakpoints (<location>[ if <condition>]) and watchpoints, which stop the
+  // simulation of 'proc' when triggered. Applied once the program is loaded.
+  QStringList breakpoints;
+  QStringList watchpoints;
+  // If set, the program is executed on multiple harts of 'proc', which share
+  // its memory.
+  std::shared_ptr<MultiHartSimulation> harts;
+  // If set, a recorded execution trace is replayed through cache and branch
+  // predictor models, instead of simulating a program on 'proc'.
+  std::shared_ptr<TraceReplay> replay;
   bool verbose = false;
   QString outputFile = "";
   bool jsonOutput = false;
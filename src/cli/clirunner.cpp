@@ -4,10 +4,12 @@
 #include "loaddialog.h"
 #include "processorhandler.h"
 #include "programutilities.h"
+#include "sampledsimulation.h"
 #include "syscall/systemio.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QtConcurrent/QtConcurrent>
 
 namespace Ripes {
 
@@ -50,8 +52,17 @@ static QString qVariantToString(QVariant &v) {
 CLIRunner::CLIRunner(const CLIModeOptions &options)
     : QObject(), m_options(options) {
   info("Ripes CLI mode", false, true);
-  ProcessorHandler::selectProcessor(m_options.proc, m_options.isaExtensions,
-                                    m_options.regInit);
+  // Fast-forwarding and sampling start out on the functional model of the
+  // processor; see runFunctional. Replaying a trace does not simulate a
+  // processor.
+  const bool functional = m_options.fastForward || m_options.sampling;
+  if (!m_options.replay) {
+    ProcessorHandler::setPreferInterpreter(functional ||
+                                           m_options.interpreter);
+    ProcessorHandler::selectProcessor(
+        functional ? functionalProcessor(m_options.proc) : m_options.proc,
+        m_options.isaExtensions, m_options.regInit);
+  }
 
   // Connect systemIO output to stdout.
   connect(&SystemIO::get(), &SystemIO::doPrint, this, [&](auto text) {
@@ -72,10 +83,22 @@ CLIRunner::CLIRunner(const CLIModeOptions &options)
  * @return 0 on success, or 1 if an error occurs during any phase.
  */
 int CLIRunner::run() {
+  if (m_options.replay) {
+    if (runReplay())
+      return 1;
+    return postRun() ? 1 : 0;
+  }
+
   if (processInput())
     return 1;
 
-  if (runModel())
+  if (runFunctional())
+    return 1;
+
+  if (setupBreakpoints())
+    return 1;
+
+  if (m_options.harts ? runHarts() : runModel())
     return 1;
 
   if (postRun())
@@ -186,6 +209,124 @@ int CLIRunner::processInput() {
   return 0;
 }
 
+/**
+ * Runs the functional phases of the simulation, if requested: fast-forwarding
+ * the program to the marker, followed by sampling the remainder of the program
+ * through windows of detailed simulation. When fast-forwarding without
+ * sampling, the state of the functional model is then transferred into the
+ * selected processor model, which continues the program in runModel.
+ *
+ * @return 0 on success, or 1 if an error occurs during functional execution.
+ */
+int CLIRunner::runFunctional() {
+  if (!m_options.fastForward && !m_options.sampling)
+    return 0;
+
+  info("Running functional model", false, true);
+
+  // As for ProcessorHandler::run, the model is executed off the main thread,
+  // such that system call I/O is serviced by the event loop.
+  QEventLoop loop;
+  QFutureWatcher<bool> watcher;
+  QObject::connect(&watcher, &QFutureWatcher<bool>::finished, &loop,
+                   &QEventLoop::quit);
+  std::atomic<bool> abort = false;
+  QTimer timeoutTimer;
+  timeoutTimer.setSingleShot(true);
+  QObject::connect(&timeoutTimer, &QTimer::timeout, &loop,
+                   [&]() { abort = true; });
+
+  // Observers of the processor (i.e., telemetry) only consider the program
+  // from the point where the detailed model takes over.
+  auto *processor = ProcessorHandler::getProcessorNonConst();
+  processor->setEmitsSignals(false);
+  QString errorMessage;
+  watcher.setFuture(QtConcurrent::run([&] {
+    if (m_options.fastForward &&
+        !fastForward(*m_options.fastForward, abort, errorMessage))
+      return false;
+    if (m_options.sampling)
+      return m_options.sampling->run(m_options.proc, m_options.isaExtensions,
+                                     abort, errorMessage);
+    return true;
+  }));
+  if (m_options.timeout != 0)
+    timeoutTimer.start(m_options.timeout);
+  loop.exec();
+  timeoutTimer.stop();
+  processor->setEmitsSignals(true);
+
+  if (!watcher.result()) {
+    error(errorMessage);
+    return 1;
+  }
+
+  if (m_options.fastForward && !m_options.sampling) {
+    info("Transferring state to processor model");
+    ProcessorHandler::setPreferInterpreter(m_options.interpreter);
+    if (!ProcessorHandler::switchProcessor(m_options.proc,
+                                           m_options.isaExtensions)) {
+      error("Failed to transfer the state of the functional model");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Sets the breakpoints and watchpoints of the CLI options for the loaded
+ * program. Breakpoint locations are either addresses or symbols of the
+ * program.
+ *
+ * @return 0 on success, or 1 if a breakpoint or watchpoint is invalid.
+ */
+int CLIRunner::setupBreakpoints() {
+  QString errorMessage;
+  for (const auto &spec : m_options.breakpoints) {
+    const int ifIndex = spec.indexOf(" if ");
+    const QString location = spec.left(ifIndex).trimmed();
+    const QString condition =
+        ifIndex < 0 ? QString() : spec.mid(ifIndex + 4).trimmed();
+
+    bool ok = false;
+    AInt address = location.toULongLong(&ok, 0);
+    if (!ok) {
+      for (const auto &[symbolAddress, symbol] :
+           ProcessorHandler::getProgram()->symbols) {
+        if (symbol.v == location) {
+          address = symbolAddress;
+          ok = true;
+          break;
+        }
+      }
+    }
+    if (!ok) {
+      error("Unknown breakpoint location '" + location + "' (--break).");
+      return 1;
+    }
+
+    ProcessorHandler::setBreakpoint(address, true);
+    if (!ProcessorHandler::hasBreakpoint(address)) {
+      error("Breakpoint location '" + location +
+            "' is not an executable address (--break).");
+      return 1;
+    }
+    if (!ProcessorHandler::setBreakpointCondition(address, condition,
+                                                  errorMessage)) {
+      error(errorMessage + " (--break).");
+      return 1;
+    }
+  }
+
+  for (const auto &spec : m_options.watchpoints) {
+    if (!ProcessorHandler::addWatchpoint(spec, errorMessage)) {
+      error(errorMessage + " (--watch).");
+      return 1;
+    }
+  }
+  return 0;
+}
+
 /**
  * Runs the processor model for the loaded program until the program is
  * finished (so ProcessorHandler::runFinished signal is emitted)
@@ -242,6 +383,83 @@ int CLIRunner::runModel() {
     return 1;
   }
 
+  const QString stopMessage = ProcessorHandler::stopMessage();
+  if (!stopMessage.isEmpty())
+    info(stopMessage, true);
+
+  return 0;
+}
+
+/**
+ * Runs the program on the harts of the multi-hart simulation of the CLI
+ * options. Harts are clocked on their own threads, while system call I/O is
+ * serviced by the event loop.
+ *
+ * @return 0 on success, or 1 if an error occurs during execution.
+ */
+int CLIRunner::runHarts() {
+  info("Running " + QString::number(m_options.harts->harts()) + " harts",
+       false, true);
+
+  QEventLoop loop;
+  QFutureWatcher<bool> watcher;
+  QObject::connect(&watcher, &QFutureWatcher<bool>::finished, &loop,
+                   &QEventLoop::quit);
+  std::atomic<bool> abort = false;
+  QTimer timeoutTimer;
+  timeoutTimer.setSingleShot(true);
+  QObject::connect(&timeoutTimer, &QTimer::timeout, &loop,
+                   [&]() { abort = true; });
+
+  QString errorMessage;
+  watcher.setFuture(QtConcurrent::run([&] {
+    return m_options.harts->run(m_options.proc, m_options.isaExtensions,
+                                abort, errorMessage);
+  }));
+  if (m_options.timeout != 0)
+    timeoutTimer.start(m_options.timeout);
+  loop.exec();
+  timeoutTimer.stop();
+
+  if (!watcher.result()) {
+    error(errorMessage);
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Replays the execution trace of the CLI options through the cache and branch
+ * predictor models of the options. The replay runs on the global thread pool,
+ * while the event loop services the timeout.
+ *
+ * @return 0 on success, or 1 if the trace could not be replayed.
+ */
+int CLIRunner::runReplay() {
+  info("Replaying trace '" + m_options.replay->path() + "'", false, true);
+
+  QEventLoop loop;
+  QFutureWatcher<bool> watcher;
+  QObject::connect(&watcher, &QFutureWatcher<bool>::finished, &loop,
+                   &QEventLoop::quit);
+  std::atomic<bool> abort = false;
+  QTimer timeoutTimer;
+  timeoutTimer.setSingleShot(true);
+  QObject::connect(&timeoutTimer, &QTimer::timeout, &loop,
+                   [&]() { abort = true; });
+
+  QString errorMessage;
+  watcher.setFuture(QtConcurrent::run(
+      [&] { return m_options.replay->run(abort, errorMessage); }));
+  if (m_options.timeout != 0)
+    timeoutTimer.start(m_options.timeout);
+  loop.exec();
+  timeoutTimer.stop();
+
+  if (!watcher.result()) {
+    error(errorMessage);
+    return 1;
+  }
   return 0;
 }
 
@@ -284,6 +502,10 @@ int CLIRunner::postRun() {
     for (auto &telemetry : m_options.telemetry)
       if (telemetry->isEnabled()) {
         *stream << "===== " << telemetry->description() << "\n";
+        if (telemetry->streamReport(*stream)) {
+          *stream << "\n";
+          continue;
+        }
         QVariant reportedValue = telemetry->report(/*json=*/false);
         *stream << qVariantToString(reportedValue) << "\n";
       }
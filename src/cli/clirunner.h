@@ -21,9 +21,24 @@ private:
   /// Process the provided source file (assembling, compiling, loading, ...)
   int processInput();
 
-  /// Runs the processor model until the program is finished.
+  /// Runs the functional model through fast-forwarding and/or sampling, if
+  /// requested.
+  int runFunctional();
+
+  /// Sets the breakpoints and watchpoints requested for the loaded program.
+  int setupBreakpoints();
+
+  /// Runs the processor model until the program is finished, or until a
+  /// breakpoint or watchpoint triggers.
   int runModel();
 
+  /// Runs the program on multiple harts until all harts have finished.
+  int runHarts();
+
+  /// Replays a recorded execution trace through cache and branch predictor
+  /// models, instead of running a program.
+  int runReplay();
+
   /// Prints requested telemetry to the console/output file.
   int postRun();
   void info(QString msg, bool alwaysPrint = false, bool header = false,
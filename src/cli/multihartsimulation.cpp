@@ -0,0 +1,196 @@
+#include "multihartsimulation.h"
+#include "processorhandler.h"
+#include "processors/interface/sharedaddressspace.h"
+
+#include <condition_variable>
+#include <thread>
+
+namespace Ripes {
+
+namespace {
+
+// Cycles which unsynchronized harts execute between checks for an abort.
+constexpr unsigned long long s_unsynchronizedBatch = 1 << 14;
+
+} // namespace
+
+/// A reusable barrier which threads may leave once they are done; the
+/// participants of the next phase are those which have not left.
+class MultiHartSimulation::QuantumBarrier {
+public:
+  explicit QuantumBarrier(unsigned count) : m_count(count) {}
+
+  /// Blocks until all participating threads have arrived.
+  void arriveAndWait() {
+    std::unique_lock lock(m_mutex);
+    const unsigned long long phase = m_phase;
+    if (++m_arrived == m_count) {
+      completePhase();
+      return;
+    }
+    m_cv.wait(lock, [&] { return m_phase != phase; });
+  }
+
+  /// Stops participating in the barrier, without waiting for the others.
+  void arriveAndDrop() {
+    std::lock_guard lock(m_mutex);
+    --m_count;
+    if (m_count != 0 && m_arrived == m_count)
+      completePhase();
+  }
+
+private:
+  void completePhase() {
+    m_arrived = 0;
+    ++m_phase;
+    m_cv.notify_all();
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  unsigned m_count;
+  unsigned m_arrived = 0;
+  unsigned long long m_phase = 0;
+};
+
+bool MultiHartSimulation::run(const ProcessorID &id,
+                              const QStringList &extensions,
+                              const std::atomic<bool> &abort,
+                              QString &errorMessage) {
+  auto *primary = ProcessorHandler::getProcessorNonConst();
+  const auto memory = primary->sharedMemory();
+  if (!memory) {
+    errorMessage = "Processor '" + enumToString<ProcessorID>(id) +
+                   "' cannot share its memory between harts; multiple harts "
+                   "require the interpreter engine (--harts).";
+    return false;
+  }
+
+  const auto isa = primary->implementsISA();
+  const auto spReg = isa->spReg();
+  const auto hartIdReg = isa->syscallArgReg(0);
+
+  // Harts 1 and up are private to the simulation, and are not observed by the
+  // rest of Ripes.
+  std::vector<std::unique_ptr<RipesProcessor>> secondaries;
+  std::vector<RipesProcessor *> harts = {primary};
+  for (unsigned hartId = 1; hartId < m_harts; ++hartId) {
+    auto hart = ProcessorRegistry::constructProcessor(id, extensions,
+                                                      /*interpreter=*/true);
+    hart->isExecutableAddress = [](AInt address) {
+      return ProcessorHandler::isExecutableAddress(address);
+    };
+    hart->postConstruct();
+    hart->setEmitsSignals(false);
+    if (!hart->joinHarts(memory, hartId)) {
+      errorMessage = "Processor '" + enumToString<ProcessorID>(id) +
+                     "' cannot share its memory between harts (--harts).";
+      return false;
+    }
+    hart->setPCInitialValue(primary->getPcForStage({0, 0}));
+    hart->resetProcessor();
+
+    for (const auto &regFile : primary->registerFiles()) {
+      const unsigned regCnt = isa->regInfo(regFile).value()->regCnt();
+      for (unsigned i = 0; i < regCnt; ++i)
+        hart->setRegister(regFile, i, primary->getRegister(regFile, i));
+    }
+    if (spReg)
+      hart->setRegister(spReg->file->regFileName(), spReg->index,
+                        primary->getRegister(spReg->file->regFileName(),
+                                             spReg->index) -
+                            hartId * s_hartStackBytes);
+    if (hartIdReg)
+      hart->setRegister(hartIdReg->file->regFileName(), hartIdReg->index,
+                        hartId);
+
+    harts.push_back(hart.get());
+    secondaries.push_back(std::move(hart));
+  }
+  if (hartIdReg)
+    primary->setRegister(hartIdReg->file->regFileName(), hartIdReg->index, 0);
+
+  const auto primaryTrapHandler = primary->trapHandler;
+  for (auto *hart : harts)
+    hart->trapHandler = [this, hart] { syscall(*hart); };
+
+  // Hart 0 runs on the calling thread.
+  m_stop = false;
+  m_syscallFailed = false;
+  memory->setConcurrent(true, m_harts);
+  QuantumBarrier barrier(m_harts);
+  std::vector<std::thread> threads;
+  for (unsigned hartId = 1; hartId < m_harts; ++hartId)
+    threads.emplace_back([&, hart = harts.at(hartId)] {
+      runHart(*hart, barrier, abort);
+    });
+  runHart(*primary, barrier, abort);
+  for (auto &thread : threads)
+    thread.join();
+  memory->setConcurrent(false);
+  primary->trapHandler = primaryTrapHandler;
+
+  m_stats.clear();
+  for (const auto *hart : harts)
+    m_stats.push_back({hart->getCycleCount(), hart->getInstructionsRetired()});
+
+  if (m_syscallFailed) {
+    errorMessage = "A system call of a hart failed (--harts).";
+    return false;
+  }
+  if (abort) {
+    errorMessage =
+        "Simulation did not finish within the specified timeout (--timeout).";
+    return false;
+  }
+  return true;
+}
+
+void MultiHartSimulation::runHart(RipesProcessor &hart,
+                                  QuantumBarrier &barrier,
+                                  const std::atomic<bool> &abort) {
+  RipesProcessor::StopConditions conditions;
+  conditions.stop = &m_stop;
+  const auto cycles = m_quantum == 0 ? s_unsynchronizedBatch : m_quantum;
+  while (!hart.finished() && !m_stop) {
+    if (abort) {
+      m_stop = true;
+      break;
+    }
+    hart.clockN(cycles, conditions);
+    if (m_quantum != 0 && !hart.finished())
+      barrier.arriveAndWait();
+  }
+  barrier.arriveAndDrop();
+}
+
+void MultiHartSimulation::syscall(RipesProcessor &hart) {
+  // The system call accesses the state of the hart through the
+  // ProcessorHandler.
+  std::lock_guard lock(m_syscallLock);
+  ProcessorHandler::HartScope scope(&hart);
+  const auto reg = hart.implementsISA()->syscallReg();
+  if (!reg || !ProcessorHandler::getSyscallManagerNonConst().execute(
+                  hart.getRegister(reg->file->regFileName(), reg->index))) {
+    m_syscallFailed = true;
+    m_stop = true;
+  }
+}
+
+QVariant HartTelemetry::report(bool) {
+  QVariantMap report;
+  report["quantum"] = static_cast<qulonglong>(m_simulation->quantum());
+  long long instructions = 0;
+  const auto &stats = m_simulation->stats();
+  for (unsigned hartId = 0; hartId < stats.size(); ++hartId) {
+    QVariantMap hart;
+    hart["cycles"] = stats.at(hartId).cycles;
+    hart["instructions retired"] = stats.at(hartId).instructions;
+    report["hart " + QString::number(hartId)] = hart;
+    instructions += stats.at(hartId).instructions;
+  }
+  report["instructions retired"] = instructions;
+  return report;
+}
+
+} // namespace Ripes
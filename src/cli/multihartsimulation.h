@@ -0,0 +1,82 @@
+#pragma once
+
+#include "processorregistry.h"
+#include "telemetry.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Ripes {
+
+/// The MultiHartSimulation class executes the program of the current processor
+/// on multiple harts. Each hart is an instance of the processor model, clocked
+/// on its own thread, and all harts share the memory of the current processor
+/// (hart 0). Harts synchronize once every 'quantum' cycles, such that no hart
+/// runs ahead of the others by more than a quantum.
+class MultiHartSimulation {
+public:
+  /// Bytes of stack of each hart. The stack of hart i starts at the initial
+  /// stack pointer of hart 0, minus i times the stack size.
+  static constexpr AInt s_hartStackBytes = 0x10000;
+
+  MultiHartSimulation(unsigned harts, unsigned long long quantum)
+      : m_harts(harts), m_quantum(quantum) {}
+
+  /// Executes the program of the current processor on all harts until they
+  /// have finished. Harts 1 and up are instances of processor @p id, which
+  /// start with the registers of hart 0, except for their hart ID (in the
+  /// first argument register) and stack pointer. Returns false if the current
+  /// processor cannot share its memory, if a system call failed, or if
+  /// @p abort was set.
+  bool run(const ProcessorID &id, const QStringList &extensions,
+           const std::atomic<bool> &abort, QString &errorMessage);
+
+  unsigned harts() const { return m_harts; }
+  /// Cycles between synchronizations of the harts; 0 if harts run
+  /// unsynchronized.
+  unsigned long long quantum() const { return m_quantum; }
+
+  struct HartStats {
+    long long cycles = 0;
+    long long instructions = 0;
+  };
+  /// Statistics of each hart of the last run.
+  const std::vector<HartStats> &stats() const { return m_stats; }
+
+private:
+  class QuantumBarrier;
+
+  /// Clocks @p hart until it finishes or the simulation stops, synchronizing
+  /// with the other harts through @p barrier.
+  void runHart(RipesProcessor &hart, QuantumBarrier &barrier,
+               const std::atomic<bool> &abort);
+  /// Executes the system call requested by @p hart. System calls of all harts
+  /// are serialized.
+  void syscall(RipesProcessor &hart);
+
+  unsigned m_harts;
+  unsigned long long m_quantum;
+  std::vector<HartStats> m_stats;
+  std::mutex m_syscallLock;
+  // Set to stop all harts; upon an abort or a failed system call.
+  std::atomic<bool> m_stop = false;
+  std::atomic<bool> m_syscallFailed = false;
+};
+
+class HartTelemetry : public Telemetry {
+public:
+  HartTelemetry(const std::shared_ptr<MultiHartSimulation> &simulation)
+      : m_simulation(simulation) {}
+
+  QString key() const override { return "harts"; }
+  QString description() const override {
+    return "cycles and instructions retired of each hart";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::shared_ptr<MultiHartSimulation> m_simulation;
+};
+
+} // namespace Ripes
@@ -0,0 +1,300 @@
+#include "sampledsimulation.h"
+#include "processorhandler.h"
+#include "processors/ripesvsrtlprocessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace Ripes {
+
+namespace {
+
+// z-value of a two-sided 95% confidence interval of a normal distribution.
+constexpr double s_z95 = 1.96;
+
+QString timeoutError() {
+  return "Simulation did not finish within the specified timeout (--timeout).";
+}
+
+/// Executes up to @p instructions on @p processor, stopping early if it
+/// finishes or if @p abort is set.
+void execute(RipesProcessor &processor, unsigned long long instructions,
+             const std::atomic<bool> &abort) {
+  RipesProcessor::StopConditions conditions;
+  conditions.stop = &abort;
+  const long long target = processor.getInstructionsRetired() + instructions;
+  while (processor.getInstructionsRetired() < target) {
+    const auto remaining = target - processor.getInstructionsRetired();
+    if (processor.clockN(remaining, conditions) !=
+        RipesProcessor::StopReason::Cycles)
+      return;
+  }
+}
+
+} // namespace
+
+bool parseFastForwardMarker(const QString &spec, FastForwardMarker &marker,
+                            QString &errorMessage) {
+  const QStringList parts = spec.split('=');
+  if (parts.size() != 2 || parts.at(1).trimmed().isEmpty()) {
+    errorMessage =
+        "Invalid fast-forward marker '" + spec + "' (--fast-forward).";
+    return false;
+  }
+  const QString type = parts.at(0).trimmed().toLower();
+  const QString value = parts.at(1).trimmed();
+
+  if (type == "symbol") {
+    marker.type = FastForwardMarker::Type::Symbol;
+    marker.symbol = value;
+    return true;
+  }
+
+  bool ok = false;
+  if (type == "pc") {
+    marker.type = FastForwardMarker::Type::Address;
+    marker.value = value.toULongLong(&ok, 0);
+  } else if (type == "instrs") {
+    marker.type = FastForwardMarker::Type::Instructions;
+    marker.value = value.toULongLong(&ok, 10);
+  } else {
+    errorMessage =
+        "Unknown fast-forward marker type '" + type + "' (--fast-forward).";
+    return false;
+  }
+  if (!ok) {
+    errorMessage = "Invalid value '" + value + "' for fast-forward marker '" +
+                   type + "' (--fast-forward).";
+    return false;
+  }
+  return true;
+}
+
+bool parseSamplingSpec(const QString &spec, SamplingConfig &config,
+                       QString &errorMessage) {
+  for (const auto &paramSpec : spec.split(';', Qt::SkipEmptyParts)) {
+    const QStringList parts = paramSpec.split('=');
+    if (parts.size() != 2) {
+      errorMessage =
+          "Invalid sampling parameter '" + paramSpec + "' (--sample).";
+      return false;
+    }
+    const QString param = parts.at(0).trimmed().toLower();
+    unsigned long long *target = nullptr;
+    if (param == "period")
+      target = &config.period;
+    else if (param == "window")
+      target = &config.window;
+    else if (param == "warmup")
+      target = &config.warmup;
+    else {
+      errorMessage = "Unknown sampling parameter '" + param + "' (--sample).";
+      return false;
+    }
+
+    bool ok = false;
+    *target = parts.at(1).trimmed().toULongLong(&ok, 10);
+    if (!ok) {
+      errorMessage = "Invalid value '" + parts.at(1) +
+                     "' for sampling parameter '" + param + "' (--sample).";
+      return false;
+    }
+  }
+
+  if (config.window == 0) {
+    errorMessage = "The sampling window must be non-empty (--sample).";
+    return false;
+  }
+  if (config.period < config.warmup + config.window) {
+    errorMessage = "The sampling period must be at least the sum of the "
+                   "warmup and window (--sample).";
+    return false;
+  }
+  return true;
+}
+
+ProcessorID functionalProcessor(const ProcessorID &id) {
+  const auto isa = ProcessorRegistry::getDescription(id).isaInfo().isa;
+  return isa->bits() == 64 ? ProcessorID::RV64_SS : ProcessorID::RV32_SS;
+}
+
+bool fastForward(const FastForwardMarker &marker,
+                 const std::atomic<bool> &abort, QString &errorMessage) {
+  auto *processor = ProcessorHandler::getProcessorNonConst();
+
+  AInt address = marker.value;
+  if (marker.type == FastForwardMarker::Type::Symbol) {
+    const auto &symbols = ProcessorHandler::getProgram()->symbols;
+    const auto it =
+        std::find_if(symbols.begin(), symbols.end(), [&](const auto &symbol) {
+          return symbol.second.v == marker.symbol;
+        });
+    if (it == symbols.end()) {
+      errorMessage = "Symbol '" + marker.symbol +
+                     "' not found in program (--fast-forward).";
+      return false;
+    }
+    address = it->first;
+  }
+
+  // Address markers are breakpoints of the functional model, which retires an
+  // instruction per cycle.
+  RipesProcessor::StopConditions conditions;
+  conditions.stop = &abort;
+  std::unordered_set<AInt> breakpoints;
+  auto cycles = std::numeric_limits<unsigned long long>::max();
+  if (marker.type == FastForwardMarker::Type::Instructions) {
+    const AInt retired = processor->getInstructionsRetired();
+    cycles = marker.value > retired ? marker.value - retired : 0;
+  } else {
+    breakpoints.insert(address);
+    conditions.breakpoints = &breakpoints;
+  }
+
+  switch (processor->clockN(cycles, conditions)) {
+  case RipesProcessor::StopReason::Cycles:
+  case RipesProcessor::StopReason::Breakpoint:
+  case RipesProcessor::StopReason::Triggered:
+    return true;
+  case RipesProcessor::StopReason::Stopped:
+    errorMessage = timeoutError();
+    return false;
+  case RipesProcessor::StopReason::Finished:
+    break;
+  }
+
+  errorMessage = "Program finished before reaching the fast-forward marker "
+                 "(--fast-forward).";
+  return false;
+}
+
+bool SampledSimulation::run(const ProcessorID &detailedID,
+                            const QStringList &extensions,
+                            const std::atomic<bool> &abort,
+                            QString &errorMessage) {
+  auto *functional = ProcessorHandler::getProcessorNonConst();
+  const auto program = ProcessorHandler::getProgram();
+
+  // The detailed model is private to the sampler; it is not observed by the
+  // rest of Ripes, and is reset with the program loaded before each window.
+  auto detailed = ProcessorRegistry::constructProcessor(detailedID, extensions);
+  detailed->isExecutableAddress = [](AInt address) {
+    return ProcessorHandler::isExecutableAddress(address);
+  };
+  detailed->trapHandler = [this] { m_trapped = true; };
+  detailed->postConstruct();
+  detailed->setEmitsSignals(false);
+  if (auto *vsrtlProc = dynamic_cast<vsrtl::SimDesign *>(detailed.get()))
+    vsrtlProc->setEnableSignals(false);
+
+  auto &memory = detailed->getMemory();
+  memory.clearInitializationMemories();
+  for (const auto &section : program->sections)
+    memory.addInitializationMemory(section.second.address,
+                                   section.second.data.data(),
+                                   section.second.data.length());
+  detailed->setPCInitialValue(program->entryPoint);
+
+  m_samples.clear();
+  m_detailedCycles = 0;
+  m_detailedInstructions = 0;
+
+  ArchitecturalState state;
+  const auto skipped = m_config.period - m_config.warmup - m_config.window;
+  while (!functional->finished() && !abort) {
+    execute(*functional, skipped, abort);
+    if (functional->finished() || abort)
+      break;
+
+    if (!ArchitecturalState::capture(*functional, state)) {
+      errorMessage = "The state of the functional model cannot be "
+                     "transferred (--sample).";
+      return false;
+    }
+    measureWindow(*detailed, state);
+
+    // The functional model executes the instructions of the window itself,
+    // including any system calls which ended the window early.
+    execute(*functional, m_config.warmup + m_config.window, abort);
+  }
+  m_functionalInstructions = functional->getInstructionsRetired();
+
+  if (abort) {
+    errorMessage = timeoutError();
+    return false;
+  }
+  return true;
+}
+
+void SampledSimulation::measureWindow(RipesProcessor &detailed,
+                                      const ArchitecturalState &state) {
+  detailed.resetProcessor();
+  state.restore(detailed);
+  m_trapped = false;
+
+  // Cycles and instructions retired at the end of the warmup.
+  long long startCycles = 0;
+  long long startRetired = 0;
+  bool warm = m_config.warmup == 0;
+  const long long warmup = m_config.warmup;
+  const long long window = m_config.window;
+  while (!detailed.finished() && !m_trapped) {
+    detailed.clock();
+    const long long retired = detailed.getInstructionsRetired();
+    if (!warm && retired >= warmup) {
+      warm = true;
+      startCycles = detailed.getCycleCount();
+      startRetired = retired;
+    } else if (warm && retired - startRetired >= window) {
+      break;
+    }
+  }
+
+  // Windows which ended (through a trap or the end of the program) during the
+  // warmup are discarded.
+  const long long cycles = detailed.getCycleCount() - startCycles;
+  const long long instructions =
+      detailed.getInstructionsRetired() - startRetired;
+  if (!warm || instructions == 0)
+    return;
+
+  m_samples.push_back(static_cast<double>(cycles) / instructions);
+  m_detailedCycles += cycles;
+  m_detailedInstructions += instructions;
+}
+
+double SampledSimulation::meanCPI() const {
+  if (m_samples.empty())
+    return 0;
+  double sum = 0;
+  for (const double cpi : m_samples)
+    sum += cpi;
+  return sum / m_samples.size();
+}
+
+double SampledSimulation::confidenceInterval() const {
+  const size_t n = m_samples.size();
+  if (n < 2)
+    return 0;
+  const double mean = meanCPI();
+  double squares = 0;
+  for (const double cpi : m_samples)
+    squares += (cpi - mean) * (cpi - mean);
+  const double stddev = std::sqrt(squares / (n - 1));
+  return s_z95 * stddev / std::sqrt(static_cast<double>(n));
+}
+
+QVariant SamplingTelemetry::report(bool) {
+  QVariantMap report;
+  report["samples"] = static_cast<qulonglong>(m_simulation->samples().size());
+  report["cpi"] = m_simulation->meanCPI();
+  report["cpi 95% ci"] = m_simulation->confidenceInterval();
+  report["detailed cycles"] = m_simulation->detailedCycles();
+  report["detailed instructions"] = m_simulation->detailedInstructions();
+  report["functional instructions"] = m_simulation->functionalInstructions();
+  return report;
+}
+
+} // namespace Ripes
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "processorregistry.h"
+#include "processors/interface/architecturalstate.h"
+#include "telemetry.h"
+
+#include <atomic>
+#include <vector>
+
+namespace Ripes {
+
+/// A point in the execution of a program at which fast-forwarding ends; either
+/// when the instruction at an address or symbol is about to be executed for
+/// the first time, or once a number of instructions have been executed.
+struct FastForwardMarker {
+  enum class Type { Address, Symbol, Instructions };
+  Type type = Type::Instructions;
+  QString symbol;
+  // The address or number of instructions of the marker.
+  AInt value = 0;
+};
+
+/// Parses a fast-forward marker of the form pc=<address>, symbol=<name> or
+/// instrs=<count>. Returns true if the marker was parsed successfully.
+bool parseFastForwardMarker(const QString &spec, FastForwardMarker &marker,
+                            QString &errorMessage);
+
+/// The configuration of a sampled simulation. For each period of instructions,
+/// the architectural state of the functional model is transferred into the
+/// detailed model, which executes 'warmup' instructions to warm up its
+/// pipeline, followed by 'window' instructions over which the CPI is measured.
+struct SamplingConfig {
+  unsigned long long period = 1000000;
+  unsigned long long window = 10000;
+  unsigned long long warmup = 1000;
+};
+
+/// Parses a sampling specification; a semicolon separated list of
+/// <parameter>=<value>, where the parameters are period, window and warmup.
+/// Returns true if the specification was parsed successfully.
+bool parseSamplingSpec(const QString &spec, SamplingConfig &config,
+                       QString &errorMessage);
+
+/// Returns the processor which functionally simulates programs for processor
+/// @p id; the single-cycle processor of the same register width, which
+/// provides an instruction-level interpreter.
+ProcessorID functionalProcessor(const ProcessorID &id);
+
+/// Executes the current processor until @p marker is reached, such that the
+/// instruction of the marker is the next instruction to execute. Returns false
+/// if the program finished before reaching the marker, or if @p abort was set.
+bool fastForward(const FastForwardMarker &marker,
+                 const std::atomic<bool> &abort, QString &errorMessage);
+
+/// The SampledSimulation class estimates the CPI of a program on a detailed
+/// processor model, by executing the program on the (functional) current
+/// processor and periodically measuring windows of it on the detailed model
+/// (SMARTS-style sampling).
+class SampledSimulation {
+public:
+  SampledSimulation(const SamplingConfig &config) : m_config(config) {}
+
+  /// Executes the program of the current processor to completion, sampling
+  /// windows of it on processor @p detailedID. The current processor must be
+  /// able to transfer its state (see ArchitecturalState). Returns false if
+  /// sampling failed, or if @p abort was set.
+  bool run(const ProcessorID &detailedID, const QStringList &extensions,
+           const std::atomic<bool> &abort, QString &errorMessage);
+
+  const SamplingConfig &config() const { return m_config; }
+  /// The CPI of each measured window.
+  const std::vector<double> &samples() const { return m_samples; }
+  double meanCPI() const;
+  /// Half-width of the 95% confidence interval of the mean CPI.
+  double confidenceInterval() const;
+  long long detailedCycles() const { return m_detailedCycles; }
+  long long detailedInstructions() const { return m_detailedInstructions; }
+  long long functionalInstructions() const { return m_functionalInstructions; }
+
+private:
+  /// Restores @p state into @p detailed, and measures the CPI of a window.
+  void measureWindow(RipesProcessor &detailed,
+                     const ArchitecturalState &state);
+
+  SamplingConfig m_config;
+  std::vector<double> m_samples;
+  long long m_detailedCycles = 0;
+  long long m_detailedInstructions = 0;
+  long long m_functionalInstructions = 0;
+  // Set when the detailed model traps, ending the current window; system calls
+  // are only executed by the functional model.
+  bool m_trapped = false;
+};
+
+class SamplingTelemetry : public Telemetry {
+public:
+  SamplingTelemetry(const std::shared_ptr<SampledSimulation> &simulation)
+      : m_simulation(simulation) {}
+
+  QString key() const override { return "sample"; }
+  QString prettyKey() const override { return "sampling"; }
+  QString description() const override {
+    return "sampled CPI (mean CPI of the detailed windows and its 95% "
+           "confidence interval)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::shared_ptr<SampledSimulation> m_simulation;
+};
+
+} // namespace Ripes
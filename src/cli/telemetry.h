@@ -20,6 +20,12 @@ public:
   // set, indicates that the output is intended for JSON export.
   virtual QVariant report(bool /*json*/) = 0;
 
+  // Writes the non-JSON report of this telemetry directly to 'stream'.
+  // Returns false if not supported, in which case report() is used instead.
+  // Telemetry with large reports should stream them rather than building them
+  // in memory.
+  virtual bool streamReport(QTextStream & /*stream*/) { return false; }
+
   // Returns the name of this telemetry.
   virtual QString key() const = 0;
 
@@ -88,6 +94,33 @@ class InstrsRetiredTelemetry : public Telemetry {
   }
 };
 
+/// Reports the number of occurrences of a pipeline event, or "n/a" if the
+/// processor does not count the event.
+class PipelineEventTelemetry : public Telemetry {
+public:
+  PipelineEventTelemetry(RipesProcessor::PipelineEvent event, QString key,
+                         QString prettyKey, QString description)
+      : m_event(event), m_key(key), m_prettyKey(prettyKey),
+        m_description(description) {}
+
+  QString key() const override { return m_key; }
+  QString prettyKey() const override { return m_prettyKey; }
+  QString description() const override { return m_description; }
+  QVariant report(bool /*json*/) override {
+    const auto count =
+        ProcessorHandler::getProcessor()->pipelineEventCount(m_event);
+    if (!count)
+      return "n/a";
+    return *count;
+  }
+
+private:
+  RipesProcessor::PipelineEvent m_event;
+  QString m_key;
+  QString m_prettyKey;
+  QString m_description;
+};
+
 class PipelineTelemetry : public Telemetry {
 public:
   PipelineTelemetry() {}
@@ -102,7 +135,15 @@ public:
   QString description() const override { return "pipeline state"; }
   QVariant report(bool /*json*/) override {
     // Simply grab the current state of the pipeline diagram model and print it.
-    return m_pipelineDiagramModel->toString();
+    QString textualRepr;
+    QTextStream stream(&textualRepr);
+    m_pipelineDiagramModel->toString(stream);
+    stream.flush();
+    return textualRepr;
+  }
+  bool streamReport(QTextStream &stream) override {
+    m_pipelineDiagramModel->toString(stream);
+    return true;
   }
 
 private:
@@ -0,0 +1,234 @@
+#include "timeseries.h"
+#include "processorhandler.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace Ripes {
+
+namespace {
+
+const std::map<QString, TimeSeriesConfig::Format> s_cliTimeSeriesFormats{
+    {"csv", TimeSeriesConfig::Format::CSV},
+    {"jsonl", TimeSeriesConfig::Format::JSONLines}};
+
+double ratio(long long numerator, long long denominator) {
+  return denominator == 0 ? 0.0
+                          : static_cast<double>(numerator) / denominator;
+}
+
+} // namespace
+
+bool parseTimeSeriesFormat(const QString &name,
+                           TimeSeriesConfig::Format &format) {
+  auto it = s_cliTimeSeriesFormats.find(name.toLower());
+  if (it == s_cliTimeSeriesFormats.end())
+    return false;
+  format = it->second;
+  return true;
+}
+
+QStringList PerformanceProbe::columns() const {
+  return {"instructions", "cpi", "ipc", "cumulative cpi"};
+}
+
+void PerformanceProbe::reset(const RipesProcessor &processor) {
+  m_cycle = processor.getCycleCount();
+  m_retired = processor.getInstructionsRetired();
+}
+
+void PerformanceProbe::sample(const RipesProcessor &processor,
+                              QVariantList &values) {
+  const long long cycle = processor.getCycleCount();
+  const long long retired = processor.getInstructionsRetired();
+  const long long cycles = cycle - m_cycle;
+  const long long instructions = retired - m_retired;
+  values << instructions << ratio(cycles, instructions)
+         << ratio(instructions, cycles) << ratio(cycle, retired);
+  m_cycle = cycle;
+  m_retired = retired;
+}
+
+QStringList CacheProbe::columns() const {
+  return {"dcache accesses", "dcache hit rate", "icache accesses",
+          "icache hit rate"};
+}
+
+void CacheProbe::reset(const RipesProcessor &processor) {
+  const auto isa = processor.implementsISA();
+  m_dataCache = std::make_unique<CacheSim>(isa->bits());
+  m_instrCache = std::make_unique<CacheSim>(isa->bits());
+  m_instrBytes = isa->instrBytes();
+  m_dataHits = m_dataMisses = m_instrHits = m_instrMisses = 0;
+  // Include the accesses of the initial (cycle 0) state of the processor;
+  // see L1CacheShim::processorReset.
+  clocked(processor);
+}
+
+void CacheProbe::clocked(const RipesProcessor &processor) {
+  const auto dataAccess = processor.dataMemAccess();
+  if (dataAccess.type != MemoryAccess::None)
+    m_dataCache->access(dataAccess.address, dataAccess.type, dataAccess.pc,
+                        dataAccess.bytes);
+
+  const auto instrAccess = processor.instrMemAccess();
+  if (instrAccess.type == MemoryAccess::Read)
+    m_instrCache->access(instrAccess.address, MemoryAccess::Read,
+                         instrAccess.address, m_instrBytes);
+}
+
+void CacheProbe::sample(const RipesProcessor &, QVariantList &values) {
+  const unsigned dataHits = m_dataCache->getHits() - m_dataHits;
+  const unsigned dataAccesses =
+      dataHits + m_dataCache->getMisses() - m_dataMisses;
+  const unsigned instrHits = m_instrCache->getHits() - m_instrHits;
+  const unsigned instrAccesses =
+      instrHits + m_instrCache->getMisses() - m_instrMisses;
+  values << dataAccesses << ratio(dataHits, dataAccesses) << instrAccesses
+         << ratio(instrHits, instrAccesses);
+  m_dataHits = m_dataCache->getHits();
+  m_dataMisses = m_dataCache->getMisses();
+  m_instrHits = m_instrCache->getHits();
+  m_instrMisses = m_instrCache->getMisses();
+}
+
+QStringList PipelineProbe::columns() const {
+  // In the order of RipesProcessor::PipelineEvent, and named as the CLI options
+  // reporting the totals of each event.
+  return {"stalls", "flushes", "forwards", "dual-issue", "way-hazards"};
+}
+
+void PipelineProbe::reset(const RipesProcessor &processor) {
+  for (unsigned i = 0; i < m_counts.size(); ++i)
+    m_counts[i] =
+        processor
+            .pipelineEventCount(static_cast<RipesProcessor::PipelineEvent>(i))
+            .value_or(0);
+}
+
+void PipelineProbe::sample(const RipesProcessor &processor,
+                           QVariantList &values) {
+  for (unsigned i = 0; i < m_counts.size(); ++i) {
+    const auto count = processor.pipelineEventCount(
+        static_cast<RipesProcessor::PipelineEvent>(i));
+    if (!count) {
+      values << QVariant();
+      continue;
+    }
+    values << static_cast<qlonglong>(*count - m_counts[i]);
+    m_counts[i] = *count;
+  }
+}
+
+TimeSeriesRecorder::TimeSeriesRecorder(const TimeSeriesConfig &config,
+                                       QObject *parent)
+    : QObject(parent), m_config(config) {
+  m_probes.push_back(std::make_unique<PerformanceProbe>());
+  m_probes.push_back(std::make_unique<CacheProbe>());
+  m_probes.push_back(std::make_unique<PipelineProbe>());
+  m_columns << "cycle";
+  for (const auto &probe : m_probes)
+    m_columns << probe->columns();
+
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          &TimeSeriesRecorder::processorReset);
+
+  // Cycles must be sampled in lockstep with the processor. Ensure that the
+  // handler is executed in the thread that the processor lives in (direct
+  // connection).
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          &TimeSeriesRecorder::processorWasClocked, Qt::DirectConnection);
+
+  processorReset();
+}
+
+bool TimeSeriesRecorder::finish(QString &errorMessage) {
+  if (m_file.isOpen()) {
+    const auto *processor = ProcessorHandler::getProcessor();
+    if (processor->getCycleCount() > m_lastSample)
+      writeSample(*processor);
+    m_stream.flush();
+    if (m_stream.status() != QTextStream::Ok && m_error.isEmpty())
+      m_error = "Failed to write time series file '" + m_config.path + "'.";
+    m_file.close();
+  }
+  errorMessage = m_error;
+  return m_error.isEmpty();
+}
+
+void TimeSeriesRecorder::processorReset() {
+  const auto *processor = ProcessorHandler::getProcessor();
+  for (const auto &probe : m_probes)
+    probe->reset(*processor);
+  m_lastSample = processor->getCycleCount();
+  m_nextSample = m_lastSample + m_config.interval;
+  m_samples = 0;
+
+  // Restarting the time series truncates the samples of the previous run.
+  if (m_file.isOpen()) {
+    m_stream.flush();
+    m_file.close();
+  }
+  m_file.setFileName(m_config.path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate |
+                   QIODevice::Text)) {
+    if (m_error.isEmpty())
+      m_error = "Failed to open time series file '" + m_config.path + "'.";
+    return;
+  }
+  m_stream.setDevice(&m_file);
+  if (m_config.format == TimeSeriesConfig::Format::CSV)
+    m_stream << m_columns.join(',') << '\n';
+}
+
+void TimeSeriesRecorder::processorWasClocked() {
+  if (!m_file.isOpen())
+    return;
+
+  const auto *processor = ProcessorHandler::getProcessor();
+  for (const auto &probe : m_probes)
+    probe->clocked(*processor);
+  if (processor->getCycleCount() >= m_nextSample) {
+    writeSample(*processor);
+    m_nextSample += m_config.interval;
+  }
+}
+
+void TimeSeriesRecorder::writeSample(const RipesProcessor &processor) {
+  m_lastSample = processor.getCycleCount();
+  m_values.clear();
+  m_values << m_lastSample;
+  for (const auto &probe : m_probes)
+    probe->sample(processor, m_values);
+  ++m_samples;
+
+  if (m_config.format == TimeSeriesConfig::Format::CSV) {
+    for (int i = 0; i < m_values.size(); ++i) {
+      if (i > 0)
+        m_stream << ',';
+      m_stream << m_values.at(i).toString();
+    }
+    m_stream << '\n';
+  } else {
+    QJsonObject sample;
+    for (int i = 0; i < m_values.size(); ++i)
+      sample.insert(m_columns.at(i), QJsonValue::fromVariant(m_values.at(i)));
+    m_stream << QJsonDocument(sample).toJson(QJsonDocument::Compact) << '\n';
+  }
+}
+
+QVariant TimeSeriesTelemetry::report(bool /*json*/) {
+  QVariantMap m;
+  QString errorMessage;
+  if (!m_recorder->finish(errorMessage))
+    m["error"] = errorMessage;
+  for (const auto &[name, format] : s_cliTimeSeriesFormats)
+    if (format == m_config.format)
+      m["format"] = name;
+  m["path"] = m_config.path;
+  m["interval"] = static_cast<qulonglong>(m_config.interval);
+  m["samples"] = static_cast<qulonglong>(m_recorder->samples());
+  return m;
+}
+
+} // namespace Ripes
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <QFile>
+#include <QObject>
+#include <QTextStream>
+
+#include "cachesim/cachesim.h"
+#include "telemetry.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Ripes {
+
+/// The configuration of a time series; every 'interval' cycles, a sample of
+/// the metrics of the preceding interval is written to 'path'.
+struct TimeSeriesConfig {
+  enum class Format { CSV, JSONLines };
+  QString path;
+  Format format = Format::CSV;
+  unsigned long long interval = 1000;
+};
+
+/// Parses the name of a time series format (csv, jsonl) into @p format.
+/// Returns true if the name is valid.
+bool parseTimeSeriesFormat(const QString &name,
+                           TimeSeriesConfig::Format &format);
+
+/// A TimeSeriesProbe accumulates metrics of the current processor over the
+/// cycles of a sampling interval, and contributes one value per column to
+/// each sample of the time series.
+class TimeSeriesProbe {
+public:
+  virtual ~TimeSeriesProbe() {}
+
+  /// Names of the values contributed to each sample.
+  virtual QStringList columns() const = 0;
+  /// Starts a new interval at the current cycle of @p processor.
+  virtual void reset(const RipesProcessor &processor) = 0;
+  /// Called on each cycle of @p processor.
+  virtual void clocked(const RipesProcessor & /*processor*/) {}
+  /// Appends the values of the interval which ends at the current cycle of
+  /// @p processor to @p values, and starts a new interval.
+  virtual void sample(const RipesProcessor &processor,
+                      QVariantList &values) = 0;
+};
+
+/// Instructions retired, CPI and IPC over the interval, and the CPI since the
+/// start of execution.
+class PerformanceProbe : public TimeSeriesProbe {
+public:
+  QStringList columns() const override;
+  void reset(const RipesProcessor &processor) override;
+  void sample(const RipesProcessor &processor, QVariantList &values) override;
+
+private:
+  long long m_cycle = 0;
+  long long m_retired = 0;
+};
+
+/// Accesses and hit rates of caches of the default configuration, driven by
+/// the instruction and data memory accesses of the processor.
+class CacheProbe : public TimeSeriesProbe {
+public:
+  QStringList columns() const override;
+  void reset(const RipesProcessor &processor) override;
+  void clocked(const RipesProcessor &processor) override;
+  void sample(const RipesProcessor &processor, QVariantList &values) override;
+
+private:
+  std::unique_ptr<CacheSim> m_dataCache;
+  std::unique_ptr<CacheSim> m_instrCache;
+  unsigned m_instrBytes = 0;
+  // Hits and misses of each cache at the start of the interval.
+  unsigned m_dataHits = 0;
+  unsigned m_dataMisses = 0;
+  unsigned m_instrHits = 0;
+  unsigned m_instrMisses = 0;
+};
+
+/// Number of each pipeline event counted by the processor over the interval
+/// (see RipesProcessor::pipelineEventCount). Events which the processor does
+/// not count are sampled as empty values.
+class PipelineProbe : public TimeSeriesProbe {
+public:
+  QStringList columns() const override;
+  void reset(const RipesProcessor &processor) override;
+  void sample(const RipesProcessor &processor, QVariantList &values) override;
+
+private:
+  // Counts of each event at the start of the interval.
+  std::array<long long,
+             static_cast<unsigned>(RipesProcessor::PipelineEvent::NEvents)>
+      m_counts{};
+};
+
+/**
+ * @brief The TimeSeriesRecorder class
+ * Samples the metrics of a set of probes at a fixed interval of cycles, and
+ * streams the samples to a file as they are taken. Upon construction, the
+ * recorder connects to the ProcessorHandler and follows the processor cycle by
+ * cycle. Whenever the processor is reset, the time series is restarted. No
+ * recorder exists unless a time series is requested, such that simulation is
+ * unaffected otherwise.
+ */
+class TimeSeriesRecorder : public QObject {
+  Q_OBJECT
+public:
+  TimeSeriesRecorder(const TimeSeriesConfig &config, QObject *parent = nullptr);
+
+  /// Writes the sample of the final (partial) interval and closes the file.
+  /// Returns false if writing the time series failed at any point.
+  bool finish(QString &errorMessage);
+
+  unsigned long long samples() const { return m_samples; }
+  const TimeSeriesConfig &config() const { return m_config; }
+
+private:
+  void processorReset();
+  void processorWasClocked();
+  void writeSample(const RipesProcessor &processor);
+
+  TimeSeriesConfig m_config;
+  std::vector<std::unique_ptr<TimeSeriesProbe>> m_probes;
+  QStringList m_columns;
+
+  QFile m_file;
+  QTextStream m_stream;
+  // The first error of writing the time series, if any.
+  QString m_error;
+
+  long long m_lastSample = 0;
+  long long m_nextSample = 0;
+  unsigned long long m_samples = 0;
+  // Reused across samples to avoid allocating.
+  QVariantList m_values;
+};
+
+class TimeSeriesTelemetry : public Telemetry {
+public:
+  TimeSeriesTelemetry(const TimeSeriesConfig &config) : m_config(config) {}
+
+  void enable() override {
+    // The recorder will, upon construction, connect to the ProcessorHandler
+    // and sample the processor during execution.
+    m_recorder = std::make_shared<TimeSeriesRecorder>(m_config);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "timeseries"; }
+  QString prettyKey() const override { return "time series"; }
+  QString description() const override {
+    return "time series (samples of CPI, IPC, cache hit rates and pipeline "
+           "events per interval of cycles)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  TimeSeriesConfig m_config;
+  std::shared_ptr<TimeSeriesRecorder> m_recorder;
+};
+
+} // namespace Ripes
@@ -0,0 +1,245 @@
+#include "tracereplay.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Ripes {
+
+namespace {
+
+// Upper bounds on the values accepted for the bits and history parameters of a
+// branch predictor sweep.
+constexpr unsigned s_maxTableBits = 24;
+constexpr unsigned s_maxHistoryBits = 32;
+
+const std::map<QString, BranchPredictorType> s_cliPredictorTypes{
+    {"not-taken", BranchPredictorType::NotTaken},
+    {"taken", BranchPredictorType::Taken},
+    {"bimodal", BranchPredictorType::Bimodal},
+    {"gshare", BranchPredictorType::GShare}};
+
+QString invalidValueError(const QString &param, const QString &value) {
+  return "Invalid value '" + value +
+         "' for branch predictor sweep parameter '" + param + "' (--bp-sweep).";
+}
+
+/// Parses a list of values and value ranges ('a-b'), no larger than
+/// @p maxValue, into @p out.
+bool parseRangeValues(const QString &param, const QStringList &values,
+                      unsigned maxValue, std::vector<unsigned> &out,
+                      QString &errorMessage) {
+  out.clear();
+  for (const auto &value : values) {
+    const QStringList range = value.split('-');
+    bool okFrom = false;
+    bool okTo = false;
+    const unsigned from = range.at(0).toUInt(&okFrom);
+    const unsigned to = range.size() == 2 ? range.at(1).toUInt(&okTo) : from;
+    if (range.size() == 1)
+      okTo = okFrom;
+
+    if (range.size() > 2 || !okFrom || !okTo || to < from || to > maxValue) {
+      errorMessage = invalidValueError(param, value);
+      return false;
+    }
+    for (unsigned v = from; v <= to; ++v)
+      out.push_back(v);
+  }
+  return true;
+}
+
+} // namespace
+
+bool parseBranchPredictorSweepSpec(const QString &spec,
+                                   std::vector<BranchPredictorConfig> &configs,
+                                   QString &errorMessage) {
+  // Default values; equal to the defaults of BranchPredictorConfig.
+  std::vector<BranchPredictorType> types = {BranchPredictorType::Bimodal};
+  std::vector<unsigned> bits = {10};
+  std::vector<unsigned> history = {8};
+
+  for (const auto &paramSpec : spec.split(';', Qt::SkipEmptyParts)) {
+    const QStringList parts = paramSpec.split('=');
+    if (parts.size() != 2) {
+      errorMessage = "Invalid branch predictor sweep parameter '" + paramSpec +
+                     "' (--bp-sweep).";
+      return false;
+    }
+    const QString param = parts.at(0).trimmed().toLower();
+    const QStringList values = parts.at(1).split(',', Qt::SkipEmptyParts);
+    if (values.isEmpty()) {
+      errorMessage = invalidValueError(param, parts.at(1));
+      return false;
+    }
+
+    bool ok = true;
+    if (param == "type") {
+      types.clear();
+      for (const auto &value : values) {
+        auto it = s_cliPredictorTypes.find(value.trimmed().toLower());
+        if (it == s_cliPredictorTypes.end()) {
+          QStringList validNames;
+          for (const auto &name : s_cliPredictorTypes)
+            validNames << name.first;
+          errorMessage = invalidValueError(param, value) +
+                         " Valid values are: " + validNames.join(", ");
+          return false;
+        }
+        types.push_back(it->second);
+      }
+    } else if (param == "bits") {
+      ok = parseRangeValues(param, values, s_maxTableBits, bits, errorMessage);
+    } else if (param == "history") {
+      ok = parseRangeValues(param, values, s_maxHistoryBits, history,
+                            errorMessage);
+    } else {
+      errorMessage = "Unknown branch predictor sweep parameter '" + param +
+                     "' (--bp-sweep).";
+      ok = false;
+    }
+    if (!ok)
+      return false;
+  }
+
+  // Parameters which do not apply to a predictor type do not multiply its
+  // configurations.
+  configs.clear();
+  for (auto type : types) {
+    BranchPredictorConfig config;
+    config.type = type;
+    config.tableBits = 0;
+    config.historyBits = 0;
+    if (type == BranchPredictorType::NotTaken ||
+        type == BranchPredictorType::Taken) {
+      configs.push_back(config);
+      continue;
+    }
+    for (unsigned b : bits) {
+      config.tableBits = b;
+      if (type == BranchPredictorType::Bimodal) {
+        configs.push_back(config);
+        continue;
+      }
+      for (unsigned h : history) {
+        config.historyBits = h;
+        configs.push_back(config);
+      }
+    }
+  }
+  return true;
+}
+
+bool TraceReplay::run(const std::atomic<bool> &abort, QString &errorMessage) {
+  TraceReader reader;
+  if (!reader.open(m_path, errorMessage))
+    return false;
+  m_info = reader.info();
+  reader.close();
+
+  std::vector<std::unique_ptr<CacheSim>> caches;
+  for (const auto &config : m_cacheConfigs) {
+    auto cache = std::make_unique<CacheSim>(m_info.bits);
+    cache->setPreset(config.preset);
+    cache->setPrefetchPolicy(config.prefetchPolicy);
+    caches.push_back(std::move(cache));
+  }
+  m_predictors.clear();
+  for (const auto &config : m_predictorConfigs)
+    m_predictors.emplace_back(config);
+
+  // Each thread replays the trace through its share of the models. Threads
+  // decode the trace independently, but share the pages of its mapping.
+  const unsigned models = caches.size() + m_predictors.size();
+  const unsigned threads = std::clamp<unsigned>(
+      QThreadPool::globalInstance()->maxThreadCount(), 1, std::max(models, 1u));
+  std::vector<TraceReplayer> replayers(threads);
+  for (unsigned i = 0; i < caches.size(); ++i) {
+    auto &replayer = replayers[i % threads];
+    if (m_cacheConfigs[i].type == L1CacheShim::CacheType::DataCache)
+      replayer.addDataCache(caches[i].get());
+    else
+      replayer.addInstrCache(caches[i].get());
+  }
+  for (unsigned i = 0; i < m_predictors.size(); ++i)
+    replayers[(caches.size() + i) % threads].addPredictor(&m_predictors[i]);
+
+  std::vector<QString> errors(threads);
+  std::vector<unsigned> indices(threads);
+  std::iota(indices.begin(), indices.end(), 0);
+  QElapsedTimer timer;
+  timer.start();
+  QtConcurrent::blockingMap(indices, [&](const unsigned &i) {
+    TraceReader threadReader;
+    if (threadReader.open(m_path, errors[i]))
+      replayers[i].replay(threadReader, abort, errors[i]);
+  });
+  m_seconds = timer.nsecsElapsed() / 1e9;
+
+  for (const auto &error : errors) {
+    if (!error.isEmpty()) {
+      errorMessage = "Failed to replay trace '" + m_path + "': " + error;
+      return false;
+    }
+  }
+
+  // All threads replay the same trace, so the statistics of any one of them
+  // describe the trace.
+  m_stats = replayers.front().stats();
+  m_cacheResults.clear();
+  for (const auto &cache : caches)
+    m_cacheResults.push_back(cacheSweepResult(*cache));
+  return true;
+}
+
+QVariant TraceReplayTelemetry::report(bool json) {
+  const auto &stats = m_replay->stats();
+  QVariantMap report;
+  report["trace"] = m_replay->path();
+  report["processor"] = m_replay->info().processor;
+  report["cycles"] = static_cast<qulonglong>(stats.cycles);
+  report["instructions retired"] = static_cast<qulonglong>(stats.retired);
+  report["instruction fetches"] = static_cast<qulonglong>(stats.instrAccesses);
+  report["data accesses"] = static_cast<qulonglong>(stats.dataAccesses);
+  report["replay seconds"] = m_replay->seconds();
+  report["cycles per second"] =
+      m_replay->seconds() == 0 ? 0.0 : stats.cycles / m_replay->seconds();
+
+  if (!m_replay->cacheConfigs().empty())
+    report["caches"] = cacheSweepReport(m_replay->cacheConfigs(),
+                                        m_replay->cacheResults(), json);
+
+  if (!m_replay->predictors().empty()) {
+    const QStringList columns = {"name",     "type",     "bits",
+                                 "history",  "branches", "mispredictions",
+                                 "accuracy", "MPKI"};
+    QVariantList rows;
+    for (const auto &predictor : m_replay->predictors()) {
+      const auto &config = predictor.config();
+      QVariantMap row;
+      row["name"] = config.name();
+      for (const auto &[name, type] : s_cliPredictorTypes)
+        if (type == config.type)
+          row["type"] = name;
+      row["bits"] = config.tableBits;
+      row["history"] = config.historyBits;
+      row["branches"] = static_cast<qulonglong>(predictor.branches());
+      row["mispredictions"] =
+          static_cast<qulonglong>(predictor.mispredictions());
+      row["accuracy"] = predictor.accuracy();
+      // Mispredictions per thousand instructions retired.
+      row["MPKI"] =
+          stats.retired == 0
+              ? 0.0
+              : 1000.0 * predictor.mispredictions() / stats.retired;
+      rows << row;
+    }
+    report["branch predictors"] =
+        json ? QVariant(rows) : QVariant(rowsToCSV(columns, rows));
+  }
+  return report;
+}
+
+} // namespace Ripes
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "cachesweep.h"
+#include "telemetry.h"
+#include "trace/tracereplayer.h"
+
+#include <atomic>
+#include <vector>
+
+namespace Ripes {
+
+/// Parses a branch predictor sweep specification into all predictor
+/// configurations that it describes. The specification is a semicolon
+/// separated list of <parameter>=<values>, where <values> is a comma separated
+/// list. Parameters: type [not-taken, taken, bimodal, gshare], bits (log2 of
+/// the number of counters) and history (bits of global history of gshare);
+/// bits and history additionally accept ranges ('a-b'). Returns true if the
+/// specification was parsed successfully.
+bool parseBranchPredictorSweepSpec(const QString &spec,
+                                   std::vector<BranchPredictorConfig> &configs,
+                                   QString &errorMessage);
+
+/// The TraceReplay class replays a recorded execution trace (see
+/// TraceRecorder) through a set of cache and branch predictor configurations,
+/// without simulating the processor which recorded the trace.
+class TraceReplay {
+public:
+  TraceReplay(const QString &path,
+              const std::vector<CacheSweepConfig> &cacheConfigs,
+              const std::vector<BranchPredictorConfig> &predictorConfigs)
+      : m_path(path), m_cacheConfigs(cacheConfigs),
+        m_predictorConfigs(predictorConfigs) {}
+
+  /// Replays the trace through all configurations. The configurations are
+  /// distributed over the threads of the global thread pool, each of which
+  /// reads the memory-mapped trace independently. Returns false if the trace
+  /// could not be read, or if @p abort was set.
+  bool run(const std::atomic<bool> &abort, QString &errorMessage);
+
+  const QString &path() const { return m_path; }
+  const TraceInfo &info() const { return m_info; }
+  const TraceReplayer::Stats &stats() const { return m_stats; }
+  /// Wall-clock duration of the last replay.
+  double seconds() const { return m_seconds; }
+
+  const std::vector<CacheSweepConfig> &cacheConfigs() const {
+    return m_cacheConfigs;
+  }
+  const std::vector<CacheSweepResult> &cacheResults() const {
+    return m_cacheResults;
+  }
+  /// The predictors of the last replay, in the order of the predictor
+  /// configurations.
+  const std::vector<BranchPredictor> &predictors() const {
+    return m_predictors;
+  }
+
+private:
+  QString m_path;
+  std::vector<CacheSweepConfig> m_cacheConfigs;
+  std::vector<BranchPredictorConfig> m_predictorConfigs;
+
+  TraceInfo m_info;
+  TraceReplayer::Stats m_stats;
+  double m_seconds = 0;
+  std::vector<CacheSweepResult> m_cacheResults;
+  std::vector<BranchPredictor> m_predictors;
+};
+
+class TraceReplayTelemetry : public Telemetry {
+public:
+  TraceReplayTelemetry(const std::shared_ptr<TraceReplay> &replay)
+      : m_replay(replay) {}
+
+  QString key() const override { return "replay"; }
+  QString prettyKey() const override { return "trace replay"; }
+  QString description() const override {
+    return "trace replay (cache and branch predictor statistics per "
+           "configuration)";
+  }
+  QVariant report(bool json) override;
+
+private:
+  std::shared_ptr<TraceReplay> m_replay;
+};
+
+} // namespace Ripes
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "telemetry.h"
+#include "trace/tracerecorder.h"
+
+namespace Ripes {
+
+class TraceTelemetry : public Telemetry {
+public:
+  TraceTelemetry(const QString &path, const TraceWriter::Options &options)
+      : m_path(path), m_options(options) {}
+
+  void enable() override {
+    // The recorder will, upon construction, connect to the ProcessorHandler
+    // and record each cycle during execution.
+    m_recorder = std::make_shared<TraceRecorder>(m_path, m_options);
+    Telemetry::enable();
+  }
+
+  QString key() const override { return "trace"; }
+  QString prettyKey() const override { return "execution trace"; }
+  QString description() const override {
+    return "execution trace (cycles recorded, trace file and record bytes)";
+  }
+  QVariant report(bool /*json*/) override {
+    QVariantMap m;
+    QString errorMessage;
+    if (!m_recorder->finish(errorMessage))
+      m["error"] = errorMessage;
+    const auto stats = m_recorder->stats();
+    m["path"] = m_path;
+    m["compressed"] = m_options.compress;
+    m["cycles"] = static_cast<qulonglong>(stats.cycles);
+    m["record bytes"] = static_cast<qulonglong>(stats.rawBytes);
+    m["file bytes"] = static_cast<qulonglong>(stats.fileBytes);
+    return m;
+  }
+
+private:
+  QString m_path;
+  TraceWriter::Options m_options;
+  std::shared_ptr<TraceRecorder> m_recorder;
+};
+
+} // namespace Ripes
@@ -0,0 +1,260 @@
+#include "debugconditions.h"
+
+#include "binutils.h"
+
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace Ripes {
+
+namespace {
+
+/// Looks up register @p name in any of the register files of @p isa.
+bool findRegister(const QString &name, const ISAInfoBase &isa,
+                  std::string_view &regFile, unsigned &index) {
+  for (const auto &regInfo : isa.regInfos()) {
+    bool ok = false;
+    index = regInfo->regNumber(name, ok);
+    if (ok) {
+      regFile = regInfo->regFileName();
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+bool BreakpointCondition::compile(const QString &expression,
+                                  const ISAInfoBase &isa,
+                                  BreakpointCondition &condition,
+                                  QString &errorMessage) {
+  static const QRegularExpression comparisonRe(
+      R"(^\s*([^\s=!<>]+)\s*(==|!=|<=|>=|<|>)\s*([^\s=!<>]+)\s*$)");
+
+  condition.m_expression = expression.trimmed();
+  condition.m_comparisons.clear();
+  condition.m_bits = isa.bits();
+
+  const auto parseOperand = [&](const QString &token, Operand &operand) {
+    const QString lower = token.toLower();
+    bool isLiteral = false;
+    const qlonglong literal = token.toLongLong(&isLiteral, 0);
+    if (lower == "pc") {
+      operand.kind = Operand::Kind::PC;
+    } else if (lower == "hits") {
+      operand.kind = Operand::Kind::Hits;
+    } else if (isLiteral) {
+      operand.kind = Operand::Kind::Literal;
+      operand.literal = literal;
+    } else if (findRegister(token, isa, operand.regFile, operand.index)) {
+      operand.kind = Operand::Kind::Register;
+    } else {
+      errorMessage = "Unknown operand '" + token + "' in condition '" +
+                     condition.m_expression + "'";
+      return false;
+    }
+    return true;
+  };
+
+  for (const auto &term : expression.split("&&")) {
+    const auto match = comparisonRe.match(term);
+    if (!match.hasMatch()) {
+      errorMessage = "Invalid comparison '" + term.trimmed() +
+                     "' in condition '" + condition.m_expression + "'";
+      return false;
+    }
+
+    Comparison comparison;
+    if (!parseOperand(match.captured(1), comparison.lhs) ||
+        !parseOperand(match.captured(3), comparison.rhs))
+      return false;
+
+    const QString op = match.captured(2);
+    if (op == "==")
+      comparison.op = Op::EQ;
+    else if (op == "!=")
+      comparison.op = Op::NE;
+    else if (op == "<")
+      comparison.op = Op::LT;
+    else if (op == "<=")
+      comparison.op = Op::LE;
+    else if (op == ">")
+      comparison.op = Op::GT;
+    else
+      comparison.op = Op::GE;
+    condition.m_comparisons.push_back(comparison);
+  }
+  return true;
+}
+
+int64_t BreakpointCondition::value(const Operand &operand,
+                                   const RipesProcessor &processor, AInt pc,
+                                   unsigned long long hits) const {
+  switch (operand.kind) {
+  case Operand::Kind::Literal:
+    return operand.literal;
+  case Operand::Kind::Register:
+    return vsrtl::signextend<int64_t>(
+        processor.getRegister(operand.regFile, operand.index), m_bits);
+  case Operand::Kind::PC:
+    return static_cast<int64_t>(pc);
+  case Operand::Kind::Hits:
+    return static_cast<int64_t>(hits);
+  }
+  Q_UNREACHABLE();
+}
+
+bool BreakpointCondition::evaluate(const RipesProcessor &processor, AInt pc,
+                                   unsigned long long hits) const {
+  for (const auto &comparison : m_comparisons) {
+    const int64_t lhs = value(comparison.lhs, processor, pc, hits);
+    const int64_t rhs = value(comparison.rhs, processor, pc, hits);
+    bool holds = false;
+    switch (comparison.op) {
+    case Op::EQ:
+      holds = lhs == rhs;
+      break;
+    case Op::NE:
+      holds = lhs != rhs;
+      break;
+    case Op::LT:
+      holds = lhs < rhs;
+      break;
+    case Op::LE:
+      holds = lhs <= rhs;
+      break;
+    case Op::GT:
+      holds = lhs > rhs;
+      break;
+    case Op::GE:
+      holds = lhs >= rhs;
+      break;
+    }
+    if (!holds)
+      return false;
+  }
+  return true;
+}
+
+bool Watchpoint::parse(const QString &spec, const ISAInfoBase &isa,
+                       Watchpoint &watchpoint, QString &errorMessage) {
+  watchpoint = Watchpoint();
+  watchpoint.spec = spec.trimmed();
+
+  const int separator = spec.indexOf(':');
+  if (separator < 0) {
+    errorMessage = "Invalid watchpoint '" + watchpoint.spec +
+                   "'; expected <type>:<target>";
+    return false;
+  }
+
+  const QString type = spec.left(separator).trimmed().toLower();
+  if (type == "r")
+    watchpoint.type = Type::Read;
+  else if (type == "w")
+    watchpoint.type = Type::Write;
+  else if (type == "rw")
+    watchpoint.type = Type::Access;
+  else if (type == "c")
+    watchpoint.type = Type::Change;
+  else {
+    errorMessage = "Unknown watchpoint type '" + type + "'";
+    return false;
+  }
+
+  const QString target = spec.mid(separator + 1).trimmed();
+  if (findRegister(target, isa, watchpoint.regFile, watchpoint.index)) {
+    if (watchpoint.type != Type::Change) {
+      errorMessage = "Register watchpoints must be change watchpoints (c:" +
+                     target + ")";
+      return false;
+    }
+    return true;
+  }
+
+  const QStringList range = target.split('+');
+  bool ok = range.size() <= 2;
+  if (ok)
+    watchpoint.address = range.at(0).trimmed().toULongLong(&ok, 0);
+  if (ok && range.size() == 2)
+    watchpoint.bytes = range.at(1).trimmed().toUInt(&ok, 0);
+  if (!ok || watchpoint.bytes == 0) {
+    errorMessage = "Invalid watchpoint target '" + target +
+                   "'; expected <address>[+<bytes>] or a register name";
+    return false;
+  }
+  return true;
+}
+
+void WatchpointMonitor::add(const Watchpoint &watchpoint) {
+  m_watchpoints.push_back(watchpoint);
+  m_armed = false;
+}
+
+void WatchpointMonitor::clear() {
+  m_watchpoints.clear();
+  m_snapshots.clear();
+  m_armed = false;
+}
+
+VInt WatchpointMonitor::read(const Watchpoint &watchpoint,
+                             RipesProcessor &processor,
+                             unsigned offset) const {
+  if (watchpoint.isRegister())
+    return processor.getRegister(watchpoint.regFile, watchpoint.index);
+  const unsigned bytes =
+      std::min<unsigned>(sizeof(VInt), watchpoint.bytes - offset);
+  return processor.getMemory().readMemConst(watchpoint.address + offset,
+                                            bytes);
+}
+
+void WatchpointMonitor::arm(RipesProcessor &processor) {
+  m_snapshots.resize(m_watchpoints.size());
+  for (size_t i = 0; i < m_watchpoints.size(); ++i) {
+    const auto &watchpoint = m_watchpoints.at(i);
+    auto &snapshot = m_snapshots.at(i);
+    snapshot.clear();
+    if (watchpoint.type != Watchpoint::Type::Change)
+      continue;
+    const unsigned bytes = watchpoint.isRegister() ? 1 : watchpoint.bytes;
+    for (unsigned offset = 0; offset < bytes; offset += sizeof(VInt))
+      snapshot.push_back(read(watchpoint, processor, offset));
+  }
+  m_armed = true;
+}
+
+const Watchpoint *WatchpointMonitor::check(RipesProcessor &processor) {
+  if (!m_armed)
+    arm(processor);
+
+  const Watchpoint *triggered = nullptr;
+  const MemoryAccess access = processor.dataMemAccess();
+  for (size_t i = 0; i < m_watchpoints.size(); ++i) {
+    const auto &watchpoint = m_watchpoints.at(i);
+    bool hit = false;
+    if (watchpoint.type == Watchpoint::Type::Change) {
+      // All change watchpoints are checked, such that their snapshots are
+      // kept up to date.
+      auto &snapshot = m_snapshots.at(i);
+      for (unsigned word = 0; word < snapshot.size(); ++word) {
+        const VInt value = read(watchpoint, processor, word * sizeof(VInt));
+        hit |= value != snapshot[word];
+        snapshot[word] = value;
+      }
+    } else if (access.type != MemoryAccess::None) {
+      const bool typeMatches =
+          watchpoint.type == Watchpoint::Type::Access ||
+          (watchpoint.type == Watchpoint::Type::Read) ==
+              (access.type == MemoryAccess::Read);
+      hit = typeMatches &&
+            access.address < watchpoint.address + watchpoint.bytes &&
+            watchpoint.address < access.address + access.bytes;
+    }
+    if (hit && !triggered)
+      triggered = &watchpoint;
+  }
+  return triggered;
+}
+
+} // namespace Ripes
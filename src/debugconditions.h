@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QString>
+#include <vector>
+
+#include "isa/isainfo.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The BreakpointCondition class
+ * A condition of a breakpoint, which must hold for the breakpoint to stop
+ * execution. A condition is a conjunction (&&) of comparisons between
+ * operands, e.g. "a0 == 5 && hits > 3". Operands are register names (as known
+ * to the ISA), "pc", "hits" (the number of times the breakpoint has been
+ * reached, including the current time) or integer literals. Register values
+ * are compared as signed integers.
+ * Conditions are compiled once into a list of comparisons, such that
+ * evaluating them does not involve any parsing.
+ */
+class BreakpointCondition {
+public:
+  /**
+   * @brief compile
+   * Compiles @p expression for processors implementing @p isa into
+   * @p condition. @returns false if @p expression is invalid, with the reason
+   * in @p errorMessage.
+   */
+  static bool compile(const QString &expression, const ISAInfoBase &isa,
+                      BreakpointCondition &condition, QString &errorMessage);
+
+  /// Returns true if the condition holds for @p processor, for a breakpoint
+  /// at @p pc which has been reached @p hits times.
+  bool evaluate(const RipesProcessor &processor, AInt pc,
+                unsigned long long hits) const;
+
+  /// The expression which the condition was compiled from.
+  const QString &expression() const { return m_expression; }
+
+private:
+  struct Operand {
+    enum class Kind { Literal, Register, PC, Hits };
+    Kind kind = Kind::Literal;
+    int64_t literal = 0;
+    std::string_view regFile;
+    unsigned index = 0;
+  };
+  enum class Op { EQ, NE, LT, LE, GT, GE };
+  struct Comparison {
+    Operand lhs;
+    Op op;
+    Operand rhs;
+  };
+
+  int64_t value(const Operand &operand, const RipesProcessor &processor,
+                AInt pc, unsigned long long hits) const;
+
+  QString m_expression;
+  std::vector<Comparison> m_comparisons;
+  unsigned m_bits = 32;
+};
+
+/**
+ * @brief The Watchpoint struct
+ * A watchpoint stops execution when a range of memory is read or written, or
+ * when the value of a memory range or register changes. Read and write
+ * watchpoints stop before the access is performed, whereas change watchpoints
+ * stop after the value has changed.
+ */
+struct Watchpoint {
+  enum class Type { Read, Write, Access, Change };
+  Type type = Type::Write;
+  AInt address = 0;
+  unsigned bytes = 1;
+  // Set for register watchpoints, which are always change watchpoints.
+  std::string_view regFile;
+  unsigned index = 0;
+  // The specification which the watchpoint was parsed from.
+  QString spec;
+
+  bool isRegister() const { return !regFile.empty(); }
+
+  /**
+   * @brief parse
+   * Parses a watchpoint specification of the form <type>:<target>, where
+   * <type> is one of r (read), w (write), rw (access) or c (change), and
+   * <target> is either <address>[+<bytes>] or, for change watchpoints, a
+   * register name of @p isa. @returns false if @p spec is invalid, with the
+   * reason in @p errorMessage.
+   */
+  static bool parse(const QString &spec, const ISAInfoBase &isa,
+                    Watchpoint &watchpoint, QString &errorMessage);
+};
+
+/**
+ * @brief The WatchpointMonitor class
+ * Checks a set of watchpoints against the state of a processor. Change
+ * watchpoints are checked against a snapshot of the values they watch, which
+ * is taken when the monitor is armed and updated upon each check.
+ */
+class WatchpointMonitor {
+public:
+  void add(const Watchpoint &watchpoint);
+  void clear();
+  const std::vector<Watchpoint> &watchpoints() const { return m_watchpoints; }
+  bool empty() const { return m_watchpoints.empty(); }
+
+  /// Snapshots the values watched by change watchpoints in @p processor.
+  /// Should be called whenever the state of the processor changes other than
+  /// by clocking it (resets, edits through the GUI, ...).
+  void arm(RipesProcessor &processor);
+
+  /// Returns the first watchpoint which triggers for the current cycle of
+  /// @p processor, if any.
+  const Watchpoint *check(RipesProcessor &processor);
+
+private:
+  VInt read(const Watchpoint &watchpoint, RipesProcessor &processor,
+            unsigned offset) const;
+
+  std::vector<Watchpoint> m_watchpoints;
+  // Values of the watched memory/registers of each change watchpoint, in
+  // words of at most sizeof(VInt) bytes.
+  std::vector<std::vector<VInt>> m_snapshots;
+  bool m_armed = false;
+};
+
+} // namespace Ripes
@@ -235,6 +235,11 @@ void EditTab::updateProgramViewerHighlighting() {
   }
 }
 
+void EditTab::setMissAttributionCache(
+    const std::shared_ptr<CacheSim> &cache) {
+  m_ui->programViewer->setMissAttributionCache(cache);
+}
+
 Errors *EditTab::errors() {
   if (m_sourceErrors->empty())
     return nullptr;
@@ -17,6 +17,7 @@ class EditTab;
 }
 
 struct LoadFileParams;
+class CacheSim;
 
 class EditTab : public RipesTab {
   Q_OBJECT
@@ -52,6 +53,7 @@ public slots:
   void onSave();
   void onProcessorChanged();
   void updateProgramViewerHighlighting();
+  void setMissAttributionCache(const std::shared_ptr<Ripes::CacheSim> &cache);
 
   /**
    * @brief sourceTypeChanged
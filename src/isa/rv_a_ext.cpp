@@ -0,0 +1,44 @@
+#include "rv_a_ext.h"
+namespace Ripes {
+namespace RVISA {
+namespace ExtA {
+
+namespace {
+
+template <Funct3 funct3, Ordering ordering>
+void enableOrdering(InstrVec &instructions) {
+  enableInstructions<
+      Lr<funct3, ordering>, Amo<Funct5::SC, funct3, ordering>,
+      Amo<Funct5::AMOSWAP, funct3, ordering>,
+      Amo<Funct5::AMOADD, funct3, ordering>,
+      Amo<Funct5::AMOXOR, funct3, ordering>,
+      Amo<Funct5::AMOAND, funct3, ordering>,
+      Amo<Funct5::AMOOR, funct3, ordering>,
+      Amo<Funct5::AMOMIN, funct3, ordering>,
+      Amo<Funct5::AMOMAX, funct3, ordering>,
+      Amo<Funct5::AMOMINU, funct3, ordering>,
+      Amo<Funct5::AMOMAXU, funct3, ordering>>(instructions);
+}
+
+template <Funct3 funct3>
+void enableWidth(InstrVec &instructions) {
+  enableOrdering<funct3, Ordering::NONE>(instructions);
+  enableOrdering<funct3, Ordering::AQ>(instructions);
+  enableOrdering<funct3, Ordering::RL>(instructions);
+  enableOrdering<funct3, Ordering::AQRL>(instructions);
+}
+
+} // namespace
+
+void enableExt(const ISAInfoBase *isa, InstrVec &instructions,
+               PseudoInstrVec &) {
+  enableWidth<Funct3::W>(instructions);
+
+  if (isa->bits() == 64) {
+    enableWidth<Funct3::D>(instructions);
+  }
+}
+
+} // namespace ExtA
+} // namespace RVISA
+} // namespace Ripes
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+
+#include "pseudoinstruction.h"
+#include "rvisainfo_common.h"
+
+namespace Ripes {
+namespace RVISA {
+
+namespace ExtA {
+
+/// The width of the memory operand of an atomic instruction.
+enum class Funct3 { W = 0b010, D = 0b011 };
+
+enum class Funct5 {
+  LR = 0b00010,
+  SC = 0b00011,
+  AMOSWAP = 0b00001,
+  AMOADD = 0b00000,
+  AMOXOR = 0b00100,
+  AMOAND = 0b01100,
+  AMOOR = 0b01000,
+  AMOMIN = 0b10000,
+  AMOMAX = 0b10100,
+  AMOMINU = 0b11000,
+  AMOMAXU = 0b11100
+};
+
+/// The memory ordering of an atomic instruction, given by its aq (bit 26) and
+/// rl (bit 25) bits.
+enum class Ordering { NONE = 0b00, RL = 0b01, AQ = 0b10, AQRL = 0b11 };
+
+/// All RISC-V Funct5 opcode parts are defined as a 5-bit field in bits 27-31
+/// of the instruction
+template <Funct5 funct5>
+struct OpPartFunct5
+    : public OpPart<static_cast<unsigned>(funct5), BitRange<27, 31>> {};
+
+/// The ordering opcode part is defined as a 2-bit field in bits 25-26 of the
+/// instruction
+template <Ordering ordering>
+struct OpPartOrdering
+    : public OpPart<static_cast<unsigned>(ordering), BitRange<25, 26>> {};
+
+/// Load-reserved instructions have no rs2 operand; its field is zero.
+struct OpPartNoRs2 : public OpPart<0, BitRange<20, 24>> {};
+
+constexpr std::string_view funct5Name(Funct5 funct5) {
+  switch (funct5) {
+  case Funct5::LR:
+    return "lr";
+  case Funct5::SC:
+    return "sc";
+  case Funct5::AMOSWAP:
+    return "amoswap";
+  case Funct5::AMOADD:
+    return "amoadd";
+  case Funct5::AMOXOR:
+    return "amoxor";
+  case Funct5::AMOAND:
+    return "amoand";
+  case Funct5::AMOOR:
+    return "amoor";
+  case Funct5::AMOMIN:
+    return "amomin";
+  case Funct5::AMOMAX:
+    return "amomax";
+  case Funct5::AMOMINU:
+    return "amominu";
+  case Funct5::AMOMAXU:
+    return "amomaxu";
+  }
+  return "";
+}
+
+constexpr std::string_view funct3Name(Funct3 funct3) {
+  return funct3 == Funct3::W ? ".w" : ".d";
+}
+
+constexpr std::string_view orderingName(Ordering ordering) {
+  switch (ordering) {
+  case Ordering::NONE:
+    return "";
+  case Ordering::RL:
+    return ".rl";
+  case Ordering::AQ:
+    return ".aq";
+  case Ordering::AQRL:
+    return ".aqrl";
+  }
+  return "";
+}
+
+/// Concatenates @p parts into a null-terminated array of @p size characters
+/// (excluding the terminator).
+template <size_t size, typename... Parts>
+constexpr std::array<char, size + 1> joinName(Parts... parts) {
+  std::array<char, size + 1> name{};
+  size_t i = 0;
+  for (const std::string_view part : {std::string_view(parts)...})
+    for (const char c : part)
+      name[i++] = c;
+  return name;
+}
+
+/// The name of an atomic instruction, composed at compile time from its
+/// operation, width and ordering; e.g. "amoadd.w.aqrl".
+template <Funct5 funct5, Funct3 funct3, Ordering ordering>
+struct Name {
+  constexpr static size_t size = funct5Name(funct5).size() +
+                                 funct3Name(funct3).size() +
+                                 orderingName(ordering).size();
+  constexpr static std::array<char, size + 1> chars = joinName<size>(
+      funct5Name(funct5), funct3Name(funct3), orderingName(ordering));
+  constexpr static std::string_view value{chars.data(), size};
+};
+
+/// A load-reserved instruction: lr.{w,d}[.aq][.rl] rd, (rs1)
+template <Funct3 funct3, Ordering ordering>
+struct Lr : public RV_Instruction<Lr<funct3, ordering>> {
+  struct Opcode
+      : public OpcodeSet<OpPartOpcode<OpcodeID::AMO>,
+                         OpPartFunct3<static_cast<unsigned>(funct3)>,
+                         OpPartFunct5<Funct5::LR>, OpPartOrdering<ordering>,
+                         OpPartNoRs2> {};
+  struct Fields : public FieldSet<RegRd, RegRs1> {};
+  constexpr static std::string_view NAME =
+      Name<Funct5::LR, funct3, ordering>::value;
+};
+
+/// A store-conditional or atomic memory operation (AMO) instruction:
+/// {sc,amo*}.{w,d}[.aq][.rl] rd, rs2, (rs1)
+template <Funct5 funct5, Funct3 funct3, Ordering ordering>
+struct Amo : public RV_Instruction<Amo<funct5, funct3, ordering>> {
+  static_assert(funct5 != Funct5::LR, "Use Lr for load-reserved instructions");
+  struct Opcode
+      : public OpcodeSet<OpPartOpcode<OpcodeID::AMO>,
+                         OpPartFunct3<static_cast<unsigned>(funct3)>,
+                         OpPartFunct5<funct5>, OpPartOrdering<ordering>> {};
+  struct Fields : public FieldSet<RegRd, RegRs2, RegRs1> {};
+  constexpr static std::string_view NAME =
+      Name<funct5, funct3, ordering>::value;
+};
+
+} // namespace ExtA
+
+} // namespace RVISA
+} // namespace Ripes
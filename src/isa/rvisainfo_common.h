@@ -171,6 +171,11 @@ void enableExt(const ISAInfoBase *isa, InstrVec &instructions,
                PseudoInstrVec &pseudoInstructions);
 }
 
+namespace ExtA {
+void enableExt(const ISAInfoBase *isa, InstrVec &instructions,
+               PseudoInstrVec &pseudoInstructions);
+}
+
 namespace ExtC {
 void enableExt(const ISAInfoBase *isa, InstrVec &instructions,
                PseudoInstrVec &pseudoInstructions);
@@ -179,7 +184,7 @@ void enableExt(const ISAInfoBase *isa, InstrVec &instructions,
 class RV_ISAInfoBase : public ISAInfoBase {
 public:
   static const QStringList &getSupportedExtensions() {
-    static const QStringList ext = {"M", "C"};
+    static const QStringList ext = {"M", "A", "C"};
     return ext;
   }
   static const QStringList &getDefaultExtensions() {
@@ -253,6 +258,8 @@ public:
   QString extensionDescription(const QString &ext) const override {
     if (ext == "M")
       return "Integer multiplication and division";
+    if (ext == "A")
+      return "Atomic instructions";
     if (ext == "C")
       return "Compressed instructions";
     Q_UNREACHABLE();
@@ -273,6 +280,9 @@ protected:
       case 'M':
         RVISA::ExtM::enableExt(this, m_instructions, m_pseudoInstructions);
         break;
+      case 'A':
+        RVISA::ExtA::enableExt(this, m_instructions, m_pseudoInstructions);
+        break;
       case 'C':
         RVISA::ExtC::enableExt(this, m_instructions, m_pseudoInstructions);
         break;
@@ -314,6 +324,7 @@ enum OpcodeID {
   OP32 = 0b0111011,
   SYSTEM = 0b1110011,
   AUIPC = 0b0010111,
+  AMO = 0b0101111,
   INVALID = 0b0
 };
 enum QuadrantID {
@@ -126,6 +126,10 @@ MainWindow::MainWindow(QWidget *parent)
 
   connect(cacheTab, &CacheTab::focusAddressChanged, memoryTab,
           &MemoryTab::setCentralAddress);
+  // The misses of the cache in focus are attributed to the instructions shown
+  // in the program viewer.
+  connect(cacheTab, &CacheTab::cacheFocusChanged, editTab,
+          &EditTab::setMissAttributionCache);
 
   connect(this, &MainWindow::prepareSave, editTab, &EditTab::onSave);
 
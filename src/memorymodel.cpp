@@ -10,6 +10,10 @@ namespace Ripes {
 
 MemoryModel::MemoryModel(QObject *parent) : QAbstractTableModel(parent) {}
 
+MemoryModel::~MemoryModel() {
+  ProcessorHandler::setSnapshotMemoryRange(this, 0, 0);
+}
+
 int MemoryModel::columnCount(const QModelIndex &) const {
   return FIXED_COLUMNS_CNT +
          ProcessorHandler::currentISA()->bytes() /* byte columns */;
@@ -21,6 +25,38 @@ void MemoryModel::processorWasClocked() {
   // Reload model
   beginResetModel();
   endResetModel();
+  updateSnapshotRange();
+}
+
+void MemoryModel::updateSnapshotRange() {
+  // Rows span downwards from half the visible rows above the central address.
+  const AInt bytes = ProcessorHandler::currentISA()->bytes();
+  const AInt above = (m_rowsVisible / 2 + 1) * bytes;
+  const AInt first = m_centralAddress > above ? m_centralAddress - above : 0;
+  ProcessorHandler::setSnapshotMemoryRange(this, first,
+                                           (m_rowsVisible + 2) * bytes);
+}
+
+bool MemoryModel::contains(AInt address) const {
+  if (ProcessorHandler::isRunning()) {
+    uint8_t byte;
+    return ProcessorHandler::runSnapshot().readByte(address, byte);
+  }
+  return ProcessorHandler::getMemory().contains(address);
+}
+
+VInt MemoryModel::readMem(AInt address, unsigned bytes) const {
+  if (!ProcessorHandler::isRunning())
+    return ProcessorHandler::getMemory().readMemConst(address, bytes);
+
+  VInt value = 0;
+  const auto &snapshot = ProcessorHandler::runSnapshot();
+  for (unsigned i = 0; i < bytes; ++i) {
+    uint8_t byte = 0;
+    snapshot.readByte(address + i, byte);
+    value |= static_cast<VInt>(byte) << (i * CHAR_BIT);
+  }
+  return value;
 }
 
 AInt maxAddress() {
@@ -170,8 +206,7 @@ QVariant MemoryModel::addrData(AInt address, bool validAddress) const {
 
 QVariant MemoryModel::fgColorData(AInt address, AInt byteOffset,
                                   bool validAddress) const {
-  if (!validAddress ||
-      !ProcessorHandler::getMemory().contains(address + byteOffset)) {
+  if (!validAddress || !contains(address + byteOffset)) {
     return QBrush(Qt::lightGray);
   } else {
     return QVariant(); // default
@@ -182,13 +217,12 @@ QVariant MemoryModel::byteData(AInt address, AInt byteOffset,
                                bool validAddress) const {
   if (!validAddress) {
     return "-";
-  } else if (!ProcessorHandler::getMemory().contains(address + byteOffset)) {
+  } else if (!contains(address + byteOffset)) {
     // Dont read the memory (this will create an entry in the memory if done
     // so). Instead, create a "fake" entry in the memory model, containing X's.
     return "X";
   } else {
-    VInt value =
-        ProcessorHandler::getMemory().readMemConst(address + byteOffset, 1);
+    VInt value = readMem(address + byteOffset, 1);
     return encodeRadixValue(value & 0xFF, m_radix, 1);
   }
 }
@@ -196,15 +230,13 @@ QVariant MemoryModel::byteData(AInt address, AInt byteOffset,
 QVariant MemoryModel::wordData(AInt address, bool validAddress) const {
   if (!validAddress) {
     return "-";
-  } else if (!ProcessorHandler::getMemory().contains(address)) {
+  } else if (!contains(address)) {
     // Dont read the memory (this will create an entry in the memory if done
     // so). Instead, create a "fake" entry in the memory model, containing X's.
     return "X";
   } else {
     unsigned bytes = ProcessorHandler::currentISA()->bytes();
-    return encodeRadixValue(
-        ProcessorHandler::getMemory().readMemConst(address, bytes), m_radix,
-        bytes);
+    return encodeRadixValue(readMem(address, bytes), m_radix, bytes);
   }
 }
 
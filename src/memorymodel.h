@@ -11,6 +11,7 @@ class MemoryModel : public QAbstractTableModel {
 public:
   enum Column { Address = 0, WordValue = 1, FIXED_COLUMNS_CNT };
   MemoryModel(QObject *parent = nullptr);
+  ~MemoryModel();
 
   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
   int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -37,6 +38,13 @@ private:
   QVariant wordData(AInt address, bool validAddress) const;
   QVariant fgColorData(AInt address, AInt byteOffset, bool validAddress) const;
 
+  /// Returns true if @p address is present in memory, and reads @p bytes bytes
+  /// of memory from it. While running, memory is read from the run snapshot.
+  bool contains(AInt address) const;
+  VInt readMem(AInt address, unsigned bytes) const;
+  /// Requests the visible memory range to be included in run snapshots.
+  void updateSnapshotRange();
+
   Radix m_radix = Radix::Hex;
 
   AInt m_centralAddress = 0; // Memory address at the center of the model
@@ -30,6 +30,8 @@ MemoryViewerWidget::MemoryViewerWidget(QWidget *parent)
           [=] { setEnabled(true); });
   connect(ProcessorHandler::get(), &ProcessorHandler::procStateChangedNonRun,
           this, [=] { this->updateView(); });
+  connect(ProcessorHandler::get(), &ProcessorHandler::runSnapshotUpdated, this,
+          [=] { this->updateView(); });
   connect(ProcessorHandler::get(), &ProcessorHandler::memoryFocusAddressChanged,
           this, &MemoryViewerWidget::setCentralAddress);
 }
@@ -3,10 +3,25 @@
 #include "processorhandler.h"
 #include "ripessettings.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace Ripes {
 
+namespace {
+
+// Number of cycles shown by a view of the model, unless set otherwise through
+// setViewport.
+constexpr unsigned s_defaultViewportCycles = 256;
+// Minimum number of cycles by which the ring buffer grows until reaching its
+// capacity.
+constexpr size_t s_minRecordGrowth = 64;
+// Set in the recorded state of a stage if the stage is valid.
+constexpr uint8_t s_validBit = 1 << 7;
+
+} // namespace
+
 static AInt indexToAddress(unsigned index) {
   if (auto spt = ProcessorHandler::getProgram()) {
     return (index * ProcessorHandler::currentISA()->instrBytes()) +
@@ -16,11 +31,12 @@ static AInt indexToAddress(unsigned index) {
 }
 
 PipelineDiagramModel::PipelineDiagramModel(QObject *parent)
-    : QAbstractTableModel(parent) {
+    : QAbstractTableModel(parent), m_viewportCycles(s_defaultViewportCycles) {
   connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
           &PipelineDiagramModel::processorWasClocked, Qt::DirectConnection);
   connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
           &PipelineDiagramModel::reset);
+  reset();
 }
 
 QVariant PipelineDiagramModel::headerData(int section,
@@ -30,7 +46,7 @@ QVariant PipelineDiagramModel::headerData(int section,
     return QVariant();
   if (orientation == Qt::Horizontal) {
     // Cycle number
-    return QString::number(section);
+    return QString::number(m_viewportFirstCycle + section);
   } else {
     const auto addr = indexToAddress(section);
     return ProcessorHandler::disassembleInstr(addr);
@@ -43,44 +59,136 @@ int PipelineDiagramModel::rowCount(const QModelIndex &) const {
 }
 
 int PipelineDiagramModel::columnCount(const QModelIndex &) const {
-  return m_cycleStageInfos.size();
+  const long long remaining = m_firstCycle + m_cycles - m_viewportFirstCycle;
+  return std::clamp<long long>(remaining, 0, m_viewportCycles);
 }
 
-void PipelineDiagramModel::processorWasClocked() {
-  if (m_atMaxCycles) {
-    return;
-  }
-  gatherStageInfo();
-
-  const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-  if (cycleCount >=
-      RipesSettings::value(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES).toInt()) {
-    m_atMaxCycles = true;
-  }
-}
+void PipelineDiagramModel::processorWasClocked() { gatherStageInfo(); }
 
 void PipelineDiagramModel::reset() {
-  m_atMaxCycles = false;
-  m_cycleStageInfos.clear();
+  m_stages.clear();
+  for (auto idx : ProcessorHandler::getProcessor()->structure().stageIt())
+    m_stages.push_back(idx);
+  // The capacity is fixed until the next reset, such that the settings do not
+  // have to be queried during each cycle of simulation.
+  m_capacity = std::max(
+      0, RipesSettings::value(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES).toInt());
+  m_pcs = {};
+  m_states = {};
+  m_namedStates = {};
+  m_head = 0;
+  m_firstCycle = 0;
+  m_cycles = 0;
+  m_stateNames = {QString()};
+  m_stateNameIds.clear();
+  m_viewportFirstCycle = 0;
   gatherStageInfo();
 }
 
 void PipelineDiagramModel::prepareForView() {
+  setViewport(m_viewportFirstCycle, m_viewportCycles);
+}
+
+void PipelineDiagramModel::setViewport(long long firstCycle, unsigned cycles) {
   beginResetModel();
+  m_viewportCycles = cycles;
+  // Prefer a full viewport when moved past the last recorded cycle.
+  const long long lastFirstCycle =
+      m_firstCycle + std::max<long long>(0, m_cycles - cycles);
+  m_viewportFirstCycle = std::clamp(firstCycle, m_firstCycle, lastFirstCycle);
   endResetModel();
 }
 
+uint16_t PipelineDiagramModel::internStateName(const QString &namedState) {
+  if (namedState.isEmpty())
+    return 0;
+  auto it = m_stateNameIds.constFind(namedState);
+  if (it != m_stateNameIds.constEnd())
+    return it.value();
+  // Processors name a handful of states; should the table ever fill up, the
+  // names of further states are dropped.
+  if (m_stateNames.size() > std::numeric_limits<uint16_t>::max())
+    return 0;
+  const uint16_t id = m_stateNames.size();
+  m_stateNames.push_back(namedState);
+  m_stateNameIds.insert(namedState, id);
+  return id;
+}
+
 void PipelineDiagramModel::gatherStageInfo() {
-  long long cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
-  auto stageInfoForCycle = m_cycleStageInfos.find(cycleCount);
-  if (stageInfoForCycle != m_cycleStageInfos.end()) {
-    // Already gathered stage info for this cycle.
+  if (m_capacity == 0 || m_stages.empty())
     return;
+
+  auto *processor = ProcessorHandler::getProcessor();
+  const long long cycleCount = processor->getCycleCount();
+  if (m_cycles > 0) {
+    if (cycleCount < m_firstCycle || cycleCount > m_firstCycle + m_cycles) {
+      // The processor was reversed past the recorded cycles; recording starts
+      // over.
+      m_cycles = 0;
+    } else {
+      // Cycles at or after the current cycle are recorded anew, which is the
+      // case if the processor was reversed.
+      m_cycles = cycleCount - m_firstCycle;
+    }
   }
-  m_cycleStageInfos[cycleCount];
-  for (auto idx : ProcessorHandler::getProcessor()->structure().stageIt())
-    m_cycleStageInfos[cycleCount][idx] =
-        ProcessorHandler::getProcessor()->stageInfo(idx);
+
+  if (m_cycles == 0) {
+    m_head = 0;
+    m_firstCycle = cycleCount;
+  } else if (static_cast<size_t>(m_cycles) == m_capacity) {
+    // Evict the oldest cycle.
+    m_head = (m_head + 1) % m_capacity;
+    ++m_firstCycle;
+    --m_cycles;
+  }
+  ++m_cycles;
+
+  // The records grow until reaching the capacity of the ring. Until then, the
+  // ring has not wrapped around, and the records are in cycle order.
+  const size_t allocated = m_pcs.size() / m_stages.size();
+  if (static_cast<size_t>(m_cycles) > allocated) {
+    const size_t records = std::min(
+        m_capacity, std::max(allocated * 2, allocated + s_minRecordGrowth));
+    m_pcs.resize(records * m_stages.size());
+    m_states.resize(records * m_stages.size());
+    m_namedStates.resize(records * m_stages.size());
+  }
+
+  for (unsigned i = 0; i < m_stages.size(); ++i) {
+    const StageInfo stageInfo = processor->stageInfo(m_stages[i]);
+    const size_t idx = recordIndex(cycleCount, i);
+    m_pcs[idx] = stageInfo.pc;
+    m_states[idx] = static_cast<uint8_t>(stageInfo.state) |
+                    (stageInfo.stage_valid ? s_validBit : 0);
+    m_namedStates[idx] = internStateName(stageInfo.namedState);
+  }
+}
+
+QString PipelineDiagramModel::cellText(AInt addr, long long cycle) const {
+  constexpr uint8_t executing =
+      s_validBit | static_cast<uint8_t>(StageInfo::State::None);
+  const bool hasPrevCycle = cycle > m_firstCycle;
+
+  QStringList stagesForAddr;
+  for (unsigned i = 0; i < m_stages.size(); ++i) {
+    const size_t idx = recordIndex(cycle, i);
+    if (m_pcs[idx] != addr || m_states[idx] != executing)
+      continue;
+
+    QString stageStr;
+    if (hasPrevCycle) {
+      const size_t prevIdx = recordIndex(cycle - 1, i);
+      if ((m_states[prevIdx] & s_validBit) && m_pcs[prevIdx] == addr)
+        stageStr = "-";
+    }
+    if (stageStr.isEmpty())
+      stageStr = ProcessorHandler::getProcessor()->stageName(m_stages[i]);
+    if (m_namedStates[idx] != 0)
+      stageStr += " (" + m_stateNames[m_namedStates[idx]] + ")";
+    stagesForAddr << stageStr;
+  }
+  return stagesForAddr.join('/');
 }
 
 QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
@@ -94,66 +202,35 @@ QVariant PipelineDiagramModel::data(const QModelIndex &index, int role) const {
   if (role != Qt::DisplayRole)
     return QVariant();
 
-  if (!m_cycleStageInfos.count(index.column()))
+  if (index.column() >= columnCount())
     return QVariant();
 
-  const AInt addr = indexToAddress(index.row());
-  const auto &stageInfo = m_cycleStageInfos.at(index.column());
-
-  QStringList stagesForAddr;
-  QString stageStr;
-  for (const auto &si : stageInfo) {
-    if (si.second.pc == addr && si.second.stage_valid &&
-        si.second.state == StageInfo::State::None) {
-      if (m_cycleStageInfos.count(index.column() - 1)) {
-        const auto &prevCycleStageInfo =
-            m_cycleStageInfos.at(index.column() - 1);
-        if (prevCycleStageInfo.at(si.first).stage_valid &&
-            prevCycleStageInfo.at(si.first).pc == si.second.pc) {
-          stageStr = "-";
-          if (!si.second.namedState.isEmpty()) {
-            stageStr += " (" + si.second.namedState + ")";
-          }
-          stagesForAddr << stageStr;
-          continue;
-        }
-      }
-      stageStr = ProcessorHandler::getProcessor()->stageName(si.first);
-      if (!si.second.namedState.isEmpty()) {
-        stageStr += " (" + si.second.namedState + ")";
-      }
-      stagesForAddr << stageStr;
-    }
-  }
-
-  if (stagesForAddr.size() == 0) {
+  const QString text = cellText(indexToAddress(index.row()),
+                                m_viewportFirstCycle + index.column());
+  if (text.isEmpty())
     return QVariant();
-  }
-
-  return stagesForAddr.join('/');
+  return text;
 }
 
-QString PipelineDiagramModel::toString() const {
-  QString textualRepr;
-
-  // Copy headers
-  textualRepr.append('\t');
-  for (int j = 0; j < columnCount(); j++) {
-    textualRepr.append(headerData(j, Qt::Horizontal).toString());
-    textualRepr.append('\t');
-  }
-  textualRepr.append('\n');
-  // Copy data
+void PipelineDiagramModel::toString(QTextStream &stream,
+                                    bool viewportOnly) const {
+  const long long firstCycle =
+      viewportOnly ? m_viewportFirstCycle : m_firstCycle;
+  const long long cycles = viewportOnly ? columnCount() : m_cycles;
+
+  // Headers
+  stream << '\t';
+  for (long long cycle = firstCycle; cycle < firstCycle + cycles; ++cycle)
+    stream << cycle << '\t';
+  stream << '\n';
+  // Data
   for (int i = 0; i < rowCount(); ++i) {
-    textualRepr.append(headerData(i, Qt::Vertical).toString());
-    textualRepr.append('\t');
-    for (int j = 0; j < columnCount(); j++) {
-      textualRepr.append(data(index(i, j)).toString());
-      textualRepr.append('\t');
-    }
-    textualRepr.append('\n');
+    const AInt addr = indexToAddress(i);
+    stream << headerData(i, Qt::Vertical).toString() << '\t';
+    for (long long cycle = firstCycle; cycle < firstCycle + cycles; ++cycle)
+      stream << cellText(addr, cycle) << '\t';
+    stream << '\n';
   }
-  return textualRepr;
 }
 
 } // namespace Ripes
@@ -2,9 +2,19 @@
 
 #include "processors/interface/ripesprocessor.h"
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QTextStream>
 
 namespace Ripes {
 
+/**
+ * @brief The PipelineDiagramModel class
+ * Records the stage information of the processor in a ring buffer holding the
+ * most recent RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES cycles. The columns of the
+ * model are a viewport of consecutive cycles within the recorded cycles, such
+ * that views never have to lay out more than a bounded number of columns,
+ * regardless of the number of recorded cycles.
+ */
 class PipelineDiagramModel : public QAbstractTableModel {
   Q_OBJECT
 public:
@@ -20,8 +30,21 @@ public:
                       int role = Qt::DisplayRole) const override;
   void prepareForView();
 
-  /// Returns a tab-separated stringified version of this pipeline diagram.
-  QString toString() const;
+  /// Moves the viewport of the model to show (at most) @p cycles cycles,
+  /// starting at @p firstCycle. The viewport is clamped to the recorded
+  /// cycles.
+  void setViewport(long long firstCycle, unsigned cycles);
+  long long viewportFirstCycle() const { return m_viewportFirstCycle; }
+  unsigned viewportCycles() const { return m_viewportCycles; }
+
+  /// The range of recorded cycles, [firstCycle, firstCycle + recordedCycles[.
+  long long firstCycle() const { return m_firstCycle; }
+  long long recordedCycles() const { return m_cycles; }
+
+  /// Writes a tab-separated version of this pipeline diagram to @p stream,
+  /// row by row. If @p viewportOnly is set, only the cycles of the viewport
+  /// are written, otherwise all recorded cycles.
+  void toString(QTextStream &stream, bool viewportOnly = false) const;
 
 public slots:
   void processorWasClocked();
@@ -29,20 +52,42 @@ public slots:
 
 private:
   void gatherStageInfo();
+  /// Returns the index of the name @p namedState in m_stateNames.
+  uint16_t internStateName(const QString &namedState);
+  /// Returns the text of the cell of instruction address @p addr at the
+  /// recorded cycle @p cycle.
+  QString cellText(AInt addr, long long cycle) const;
+  size_t recordIndex(long long cycle, unsigned stage) const {
+    return ((m_head + (cycle - m_firstCycle)) % m_capacity) * m_stages.size() +
+           stage;
+  }
 
   /**
-   * @brief m_cycleStageInfos
-   * map<cycle, map<stageId, stageInfo>>
+   * @brief m_stages
+   * The stages of the processor, in the order of the records of a cycle.
    */
-  std::map<long long, std::map<StageIndex, StageInfo>> m_cycleStageInfos;
+  std::vector<StageIndex> m_stages;
 
   /**
-   * @brief m_atMaxCycles
-   * Records the state that we've crossed the threshold set for
-   * RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES. This is to speed up execution by not
-   * having to check the settings value during each cycle of simulation, after
-   * the value has been reached.
+   * Recorded stage information. Each cycle occupies a fixed-size record of
+   * one entry per stage in each of the columns below. Records are kept in a
+   * ring of m_capacity cycles, of which the oldest cycle is at record m_head.
+   * The state of a stage is stored as (valid << 7 | StageInfo::State), and
+   * named states are interned in m_stateNames, with index 0 being the empty
+   * name.
    */
-  bool m_atMaxCycles = false;
+  std::vector<AInt> m_pcs;
+  std::vector<uint8_t> m_states;
+  std::vector<uint16_t> m_namedStates;
+  size_t m_capacity = 0;
+  size_t m_head = 0;
+  long long m_firstCycle = 0;
+  long long m_cycles = 0;
+
+  std::vector<QString> m_stateNames;
+  QHash<QString, uint16_t> m_stateNameIds;
+
+  long long m_viewportFirstCycle = 0;
+  unsigned m_viewportCycles;
 };
 } // namespace Ripes
@@ -3,6 +3,10 @@
 
 #include <QClipboard>
 #include <QHeaderView>
+#include <QTextStream>
+
+#include <algorithm>
+#include <climits>
 
 #include "pipelinediagrammodel.h"
 #include "ripessettings.h"
@@ -15,39 +19,39 @@ PipelineDiagramWidget::PipelineDiagramWidget(PipelineDiagramModel *model,
   m_ui->setupUi(this);
 
   m_stageModel = model;
+  m_stageModel->prepareForView();
   m_ui->pipelineDiagramView->setModel(m_stageModel);
 
+  // The view shows a window of the recorded cycles, which is moved through
+  // the first cycle spinbox.
+  const long long firstCycle = m_stageModel->firstCycle();
+  const long long lastCycle = firstCycle + m_stageModel->recordedCycles() - 1;
+  const int minValue = std::min<long long>(firstCycle, INT_MAX);
+  const int maxValue = std::clamp<long long>(lastCycle, minValue, INT_MAX);
+  m_ui->firstCycle->setRange(minValue, maxValue);
+  m_ui->firstCycle->setSingleStep(m_stageModel->viewportCycles() / 2);
+  m_ui->firstCycle->setValue(m_stageModel->viewportFirstCycle());
+  m_ui->recordedCycles->setText(QString("(recorded cycles: %1 - %2)")
+                                    .arg(firstCycle)
+                                    .arg(std::max(firstCycle, lastCycle)));
+  connect(m_ui->firstCycle, &QSpinBox::valueChanged, this, [=](int value) {
+    m_stageModel->setViewport(value, m_stageModel->viewportCycles());
+    m_ui->pipelineDiagramView->resizeColumnsToContents();
+  });
+
   m_ui->pipelineDiagramView->resizeColumnsToContents();
   m_ui->copy->setIcon(QIcon(":/icons/documents.svg"));
-
-  m_stageModel->prepareForView();
 }
 
 PipelineDiagramWidget::~PipelineDiagramWidget() { delete m_ui; }
 
 void PipelineDiagramWidget::on_copy_clicked() {
-  // Copy entire table to clipboard, including headers
+  // Copy the shown cycles to clipboard, including headers
   Q_ASSERT(m_stageModel != nullptr);
   QString textualRepr;
-
-  // Copy headers
-  textualRepr.append('\t');
-  for (int j = 0; j < m_stageModel->columnCount(); j++) {
-    textualRepr.append(m_stageModel->headerData(j, Qt::Horizontal).toString());
-    textualRepr.append('\t');
-  }
-  textualRepr.append('\n');
-  // Copy data
-  for (int i = 0; i < m_stageModel->rowCount(); ++i) {
-    textualRepr.append(m_stageModel->headerData(i, Qt::Vertical).toString());
-    textualRepr.append('\t');
-    for (int j = 0; j < m_stageModel->columnCount(); j++) {
-      textualRepr.append(
-          m_stageModel->data(m_stageModel->index(i, j)).toString());
-      textualRepr.append('\t');
-    }
-    textualRepr.append('\n');
-  }
+  QTextStream stream(&textualRepr);
+  m_stageModel->toString(stream, /*viewportOnly=*/true);
+  stream.flush();
   QApplication::clipboard()->setText(textualRepr);
 }
 } // namespace Ripes
@@ -1,6 +1,7 @@
 #include "processorhandler.h"
 
 #include "processorregistry.h"
+#include "processors/interface/architecturalstate.h"
 #include "processors/ripesvsrtlprocessor.h"
 #include "ripessettings.h"
 #include "statusmanager.h"
@@ -13,9 +14,27 @@
 
 #include <QMessageBox>
 #include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
 namespace Ripes {
 
+// Maximum number of cycles which are clocked per batch while running. Changes
+// to the set of breakpoints take effect, and snapshots are published, between
+// batches. Batches are shortened for processors which are too slow to publish
+// snapshots at the UI update rate.
+static constexpr unsigned long long s_runBatchCycles = 1 << 14;
+static constexpr unsigned long long s_minRunBatchCycles = 1 << 6;
+
+thread_local RipesProcessor *ProcessorHandler::s_hart = nullptr;
+
+static std::chrono::milliseconds uiUpdateInterval() {
+  const int updatesPerSecond =
+      RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt();
+  return std::chrono::milliseconds(1000 / std::max(1, updatesPerSecond));
+}
+
 ProcessorHandler::ProcessorHandler() {
   m_constructing = true;
 
@@ -57,8 +76,17 @@ ProcessorHandler::ProcessorHandler() {
             m_procStateChangeTimer.setInterval(
                 1000.0 /
                 RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
+            m_snapshotTimer.setInterval(uiUpdateInterval());
           });
 
+  // While running, the GUI samples the snapshots published by the run thread
+  // at the UI update rate.
+  m_snapshotTimer.setInterval(uiUpdateInterval());
+  connect(&m_snapshotTimer, &QTimer::timeout, this, [=] {
+    if (m_snapshots.fetch())
+      emit runSnapshotUpdated();
+  });
+
   connect(&m_procStateChangeTimer, &QTimer::timeout, this, [=] {
     emit procStateChangedNonRun();
     m_enqueueStateChangeLock.lock();
@@ -71,11 +99,18 @@ ProcessorHandler::ProcessorHandler() {
 
   // Connect the runwatcher finished signals
   connect(&m_runWatcher, &QFutureWatcher<void>::finished, this, [=] {
+    m_snapshotTimer.stop();
     emit runFinished();
     _triggerProcStateChangeTimer();
   });
-  connect(&m_runWatcher, &QFutureWatcher<void>::finished, this,
-          [=] { ProcessorStatusManager::clearStatus(); });
+  connect(&m_runWatcher, &QFutureWatcher<void>::finished, this, [=] {
+    // Report the breakpoint or watchpoint which stopped the run, if any.
+    const QString message = stopMessage();
+    if (message.isEmpty())
+      ProcessorStatusManager::clearStatus();
+    else
+      ProcessorStatusManager::setStatusTimed(message);
+  });
 
   // Connect relevant settings changes to VSRTL
   connect(RipesSettings::getObserver(RIPES_SETTING_REWINDSTACKSIZE),
@@ -128,6 +163,9 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
   auto &mem = m_currentProcessor->getMemory();
 
   m_program = p;
+  // Disassembly depends on the symbols of the program.
+  m_disassemblyCache.clear();
+
   // Memory initializations
   mem.clearInitializationMemories();
   for (const auto &seg : p->sections) {
@@ -148,7 +186,7 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
     }
   }
   for (const auto &bp : bpsToRemove) {
-    m_breakpoints.erase(bp);
+    _setBreakpoint(bp, false);
   }
 
   RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
@@ -156,7 +194,7 @@ void ProcessorHandler::_loadProgram(const std::shared_ptr<Program> &p) {
 }
 
 void ProcessorHandler::_writeMem(AInt address, VInt value, int size) {
-  m_currentProcessor->getMemory().writeMem(address, value, size);
+  _getProcessor()->getMemory().writeMem(address, value, size);
 }
 
 vsrtl::core::TrapChecker* ProcessorHandler::getTrapChecker() {
@@ -164,7 +202,7 @@ vsrtl::core::TrapChecker* ProcessorHandler::getTrapChecker() {
 }
 
 vsrtl::core::AddressSpaceMM &ProcessorHandler::_getMemory() {
-  return m_currentProcessor->getMemory();
+  return _getProcessor()->getMemory();
 }
 
 void ProcessorHandler::_triggerProcStateChangeTimer() {
@@ -208,32 +246,123 @@ void ProcessorHandler::_run() {
   ProcessorStatusManager::setStatusTimed("Running...");
   emit runStarted();
 
+  {
+    // The processor state may have been modified since watchpoints were last
+    // checked; have the run thread re-arm them.
+    std::lock_guard lock(m_debugLock);
+    m_stopMessage.clear();
+    ++m_watchpointsVersion;
+  }
+
+  // Publish an initial snapshot, such that a snapshot is available for as long
+  // as the processor is running.
+  _publishSnapshot();
+  m_snapshots.fetch();
+  m_snapshotTimer.start();
+  const auto snapshotInterval = m_snapshotTimer.intervalAsDuration();
+
   // Start running through the VSRTL Widget interface
   m_runWatcher.setFuture(QtConcurrent::run([=] {
-    auto *vsrtl_proc =
-        dynamic_cast<vsrtl::SimDesign *>(m_currentProcessor.get());
+    // The run thread checks its own copy of the watchpoints, such that the
+    // debug lock is not held while clocking (which may block on system calls
+    // serviced by the GUI thread).
+    std::unordered_set<AInt> breakpoints;
+    WatchpointMonitor watchpoints;
+    unsigned watchpointsVersion = 0;
+    const Watchpoint *watchpoint = nullptr;
+    const std::function<bool()> checkWatchpoints = [&] {
+      watchpoint = watchpoints.check(*m_currentProcessor);
+      return watchpoint != nullptr;
+    };
+    RipesProcessor::StopConditions conditions;
+    conditions.breakpoints = &breakpoints;
+    conditions.stop = &m_stopRunningFlag;
+
+    auto lastSnapshot = std::chrono::steady_clock::now();
+    unsigned long long batchCycles = s_runBatchCycles;
+
+    RipesProcessor::StopReason reason;
+    do {
+      // Breakpoints and watchpoints may be changed while running; refresh
+      // them between batches.
+      {
+        std::lock_guard lock(m_debugLock);
+        breakpoints = {m_breakpoints.begin(), m_breakpoints.end()};
+        if (watchpointsVersion != m_watchpointsVersion) {
+          watchpoints = m_watchpoints;
+          watchpoints.arm(*m_currentProcessor);
+          watchpointsVersion = m_watchpointsVersion;
+        }
+      }
+      conditions.trigger = watchpoints.empty() ? nullptr : &checkWatchpoints;
+      const auto batchStart = std::chrono::steady_clock::now();
+      reason = m_currentProcessor->clockN(batchCycles, conditions);
+
+      // Size batches such that snapshots are published at the UI update rate.
+      const auto now = std::chrono::steady_clock::now();
+      if (now - batchStart > snapshotInterval / 2)
+        batchCycles = std::max(s_minRunBatchCycles, batchCycles / 2);
+      else if (now - batchStart < snapshotInterval / 8)
+        batchCycles = std::min(s_runBatchCycles, batchCycles * 2);
+      if (now - lastSnapshot >= snapshotInterval) {
+        _publishSnapshot();
+        lastSnapshot = now;
+      }
+
+      bool resume = false;
+      if (reason == RipesProcessor::StopReason::Breakpoint) {
+        std::lock_guard lock(m_debugLock);
+        resume = !_breakpointReached(watchpoints);
+      }
+      if (resume) {
+        // The condition of the breakpoint does not hold; continue past it.
+        // Watchpoints and stop requests still apply to the stepped cycle.
+        auto step = conditions;
+        step.breakpoints = nullptr;
+        reason = m_currentProcessor->clockN(1, step);
+      }
+      if (reason == RipesProcessor::StopReason::Triggered) {
+        std::lock_guard lock(m_debugLock);
+        m_stopMessage = "Watchpoint " + watchpoint->spec + " triggered";
+      }
+    } while (reason == RipesProcessor::StopReason::Cycles);
 
-    if (vsrtl_proc) {
-      vsrtl_proc->setEnableSignals(false);
-    }
+    emit runFinished();
+  }));
+}
 
-    while (!(_checkBreakpoint() || m_currentProcessor->finished() ||
-             m_stopRunningFlag)) {
-      m_currentProcessor->clock();
-    }
+void ProcessorHandler::_setSnapshotMemoryRange(const void *owner,
+                                               AInt address, unsigned bytes) {
+  std::lock_guard lock(m_snapshotMemoryLock);
+  if (bytes == 0)
+    m_snapshotMemoryRanges.erase(owner);
+  else
+    m_snapshotMemoryRanges[owner] = {address, bytes};
+}
 
-    if (vsrtl_proc) {
-      vsrtl_proc->setEnableSignals(true);
+void ProcessorHandler::_publishSnapshot() {
+  {
+    // Never block the run thread on the GUI; if the requested ranges are being
+    // updated, the pages of the previous snapshot are captured.
+    std::unique_lock lock(m_snapshotMemoryLock, std::try_to_lock);
+    if (lock.owns_lock()) {
+      m_snapshotPages.clear();
+      for (const auto &[owner, range] : m_snapshotMemoryRanges)
+        ProcessorSnapshot::pagesFor(range.first, range.second, m_snapshotPages);
     }
-    emit runFinished();
-  }));
+  }
+  m_snapshots.back().capture(*m_currentProcessor, m_snapshotPages);
+  m_snapshots.publish();
 }
 
 void ProcessorHandler::_setBreakpoint(const AInt address, bool enabled) {
+  std::lock_guard lock(m_debugLock);
   if (enabled && _isExecutableAddress(address)) {
     m_breakpoints.insert(address);
   } else {
     m_breakpoints.erase(address);
+    m_breakpointConditions.erase(address);
+    m_breakpointHits.erase(address);
   }
 }
 
@@ -253,10 +382,37 @@ bool ProcessorHandler::_hasBreakpoint(const AInt address) const {
 }
 
 bool ProcessorHandler::_checkBreakpoint() {
+  std::lock_guard lock(m_debugLock);
+  return _breakpointReached(m_watchpoints);
+}
+
+bool ProcessorHandler::_breakpointReached(WatchpointMonitor &watchpoints) {
+  const long long cycle = m_currentProcessor->getCycleCount();
   for (const auto &stage : m_currentProcessor->breakpointTriggeringStages()) {
-    const auto it =
-        m_breakpoints.find(m_currentProcessor->getPcForStage(stage));
-    if (it != m_breakpoints.end()) {
+    const AInt pc = m_currentProcessor->getPcForStage(stage);
+    if (m_breakpoints.count(pc) == 0)
+      continue;
+
+    auto &hits = m_breakpointHits[pc];
+    if (hits.cycle != cycle) {
+      hits.cycle = cycle;
+      ++hits.count;
+    }
+    const auto condition = m_breakpointConditions.find(pc);
+    if (condition == m_breakpointConditions.end()) {
+      m_stopMessage = "Breakpoint at 0x" + QString::number(pc, 16);
+      return true;
+    }
+    if (condition->second.evaluate(*m_currentProcessor, pc, hits.count)) {
+      m_stopMessage = "Breakpoint at 0x" + QString::number(pc, 16) + " (" +
+                      condition->second.expression() + ")";
+      return true;
+    }
+  }
+
+  if (!watchpoints.empty()) {
+    if (const auto *watchpoint = watchpoints.check(*m_currentProcessor)) {
+      m_stopMessage = "Watchpoint " + watchpoint->spec + " triggered";
       return true;
     }
   }
@@ -267,7 +423,96 @@ void ProcessorHandler::_toggleBreakpoint(const AInt address) {
   _setBreakpoint(address, !hasBreakpoint(address));
 }
 
-void ProcessorHandler::_clearBreakpoints() { m_breakpoints.clear(); }
+void ProcessorHandler::_clearBreakpoints() {
+  std::lock_guard lock(m_debugLock);
+  m_breakpoints.clear();
+  m_breakpointConditions.clear();
+  m_breakpointHits.clear();
+}
+
+bool ProcessorHandler::_setBreakpointCondition(const AInt address,
+                                               const QString &expression,
+                                               QString &errorMessage) {
+  BreakpointCondition condition;
+  if (!expression.trimmed().isEmpty() &&
+      !BreakpointCondition::compile(
+          expression, *m_currentProcessor->implementsISA(), condition,
+          errorMessage))
+    return false;
+
+  std::lock_guard lock(m_debugLock);
+  if (m_breakpoints.count(address) == 0) {
+    errorMessage = "No breakpoint at address 0x" + QString::number(address, 16);
+    return false;
+  }
+  if (condition.expression().isEmpty())
+    m_breakpointConditions.erase(address);
+  else
+    m_breakpointConditions[address] = condition;
+  return true;
+}
+
+QString ProcessorHandler::_breakpointCondition(const AInt address) {
+  std::lock_guard lock(m_debugLock);
+  const auto it = m_breakpointConditions.find(address);
+  return it == m_breakpointConditions.end() ? QString()
+                                            : it->second.expression();
+}
+
+bool ProcessorHandler::_addWatchpoint(const QString &spec,
+                                      QString &errorMessage) {
+  Watchpoint watchpoint;
+  if (!Watchpoint::parse(spec, *m_currentProcessor->implementsISA(),
+                         watchpoint, errorMessage))
+    return false;
+
+  std::lock_guard lock(m_debugLock);
+  m_watchpoints.add(watchpoint);
+  ++m_watchpointsVersion;
+  return true;
+}
+
+std::vector<Watchpoint> ProcessorHandler::_watchpoints() {
+  std::lock_guard lock(m_debugLock);
+  return m_watchpoints.watchpoints();
+}
+
+void ProcessorHandler::_clearWatchpoints() {
+  std::lock_guard lock(m_debugLock);
+  m_watchpoints.clear();
+  ++m_watchpointsVersion;
+}
+
+QString ProcessorHandler::_stopMessage() {
+  std::lock_guard lock(m_debugLock);
+  return m_stopMessage;
+}
+
+void ProcessorHandler::_recompileDebugConditions() {
+  const auto isa = m_currentProcessor->implementsISA();
+  QString errorMessage;
+  std::lock_guard lock(m_debugLock);
+  for (auto it = m_breakpointConditions.begin();
+       it != m_breakpointConditions.end();) {
+    BreakpointCondition condition;
+    if (BreakpointCondition::compile(it->second.expression(), *isa, condition,
+                                     errorMessage)) {
+      it->second = condition;
+      ++it;
+    } else {
+      it = m_breakpointConditions.erase(it);
+    }
+  }
+
+  const auto watchpoints = m_watchpoints.watchpoints();
+  m_watchpoints.clear();
+  for (const auto &watchpoint : watchpoints) {
+    Watchpoint recompiled;
+    if (Watchpoint::parse(watchpoint.spec, *isa, recompiled, errorMessage))
+      m_watchpoints.add(recompiled);
+  }
+  ++m_watchpointsVersion;
+}
 
 void ProcessorHandler::createAssemblerForCurrentISA() {
   m_currentAssembler =
@@ -292,6 +537,13 @@ void ProcessorHandler::_reset() {
   // Reset IO devices.
   IOManager::get().reset();
 
+  {
+    std::lock_guard lock(m_debugLock);
+    m_breakpointHits.clear();
+    m_stopMessage.clear();
+    m_watchpoints.arm(*m_currentProcessor);
+  }
+
   // Forcing memory values doesn't necessarily mean that the processor will
   // notify that its state changed. Manually trigger a state change signal, to
   // ensure this.
@@ -314,8 +566,8 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
           extensions));
 
   // Processor initializations
-  m_currentProcessor =
-      ProcessorRegistry::constructProcessor(m_currentID, extensions);
+  m_currentProcessor = ProcessorRegistry::constructProcessor(
+      m_currentID, extensions, m_preferInterpreter);
   m_currentProcessor->isExecutableAddress = [=](AInt address) {
     return _isExecutableAddress(address);
   };
@@ -325,6 +577,8 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
 
   m_currentProcessor->postConstruct();
   createAssemblerForCurrentISA();
+  m_disassemblyCache.clear();
+  _recompileDebugConditions();
 
   if (keepProgram && m_program) {
     loadProgram(m_program);
@@ -376,6 +630,31 @@ void ProcessorHandler::_selectProcessor(const ProcessorID &id,
   RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
 }
 
+bool ProcessorHandler::_switchProcessor(const ProcessorID &id,
+                                        const QStringList &extensions) {
+  // The program is only retained across processors of identical ISAs.
+  if (!m_program ||
+      !m_currentProcessor->implementsISA()->eq(
+          ProcessorRegistry::getDescription(id).isaInfo().isa.get(),
+          extensions))
+    return false;
+
+  ArchitecturalState state;
+  if (!ArchitecturalState::capture(*m_currentProcessor, state))
+    return false;
+
+  // Selecting the processor reloads the program and resets the processor,
+  // after which the captured state is restored on top.
+  _selectProcessor(id, extensions, m_currentRegInits);
+  state.restore(*m_currentProcessor);
+
+  // Observers consider the transferred state the initial state of the
+  // processor.
+  emit processorReset();
+  _triggerProcStateChangeTimer();
+  return true;
+}
+
 int ProcessorHandler::_getCurrentProgramSize() const {
   if (m_program) {
     const auto *textSection = m_program->getSection(TEXT_SECTION_NAME);
@@ -396,16 +675,33 @@ AInt ProcessorHandler::_getTextStart() const {
   return 0;
 }
 
-QString ProcessorHandler::_disassembleInstr(const AInt addr) const {
-  if (m_program) {
-    const unsigned instrBytes = _currentISA()->instrBytes();
-    auto disRes = m_currentAssembler->disassemble(
-        m_currentProcessor->getMemory().readMem(addr, instrBytes),
-        m_program.get()->symbols, addr);
-    return disRes.repr;
+QString ProcessorHandler::_disassembleInstr(const AInt addr) {
+  return _disassemble(addr).repr;
+}
+
+Assembler::OpDisassembleResult
+ProcessorHandler::_disassemble(const AInt addr) {
+  if (!m_program)
+    return {};
+
+  const unsigned instrBytes = _currentISA()->instrBytes();
+  VInt word = 0;
+  if (_isRunning()) {
+    // Memory is owned by the run thread while running; read the instruction
+    // from the loaded program instead.
+    const auto *text = m_program->getSection(TEXT_SECTION_NAME);
+    if (!text || addr < text->address ||
+        addr + instrBytes > text->address + text->data.size())
+      return {};
+    for (unsigned i = 0; i < instrBytes; ++i)
+      word |= static_cast<VInt>(static_cast<uint8_t>(
+                  text->data.at(addr - text->address + i)))
+              << (i * CHAR_BIT);
   } else {
-    return QString();
+    word = m_currentProcessor->getMemory().readMem(addr, instrBytes);
   }
+  return m_disassemblyCache.disassemble(addr, word, *m_currentAssembler,
+                                        m_program->symbols);
 }
 
 void ProcessorHandler::syscallTrap() {
@@ -463,11 +759,11 @@ bool ProcessorHandler::_isExecutableAddress(AInt address) const {
 
 void ProcessorHandler::_setRegisterValue(const std::string_view &rfid,
                                          const unsigned idx, VInt value) {
-  m_currentProcessor->setRegister(rfid, idx, value);
+  _getProcessor()->setRegister(rfid, idx, value);
 }
 
 VInt ProcessorHandler::_getRegisterValue(const std::string_view &rfid,
                                          const unsigned idx) const {
-  return m_currentProcessor->getRegister(rfid, idx);
+  return _getProcessor()->getRegister(rfid, idx);
 }
 } // namespace Ripes
@@ -7,10 +7,14 @@
 
 #include "VSRTL/graphics/gallantsignalwrapper.h"
 #include "assembler/assembler.h"
+#include "assembler/disassemblycache.h"
 #include "assembler/program.h"
+#include "debugconditions.h"
 #include "processorregistry.h"
+#include "processors/interface/processorsnapshot.h"
 #include "processors/interface/ripesprocessor.h"
 #include "syscall/ripes_syscall.h"
+#include "triplebuffer.h"
 
 #include "VSRTL/graphics/vsrtl_widget.h"
 #include "processors/RISC-V/rvss_trap/trap_checker.h"
@@ -33,6 +37,22 @@ public:
     return handler;
   }
 
+  /**
+   * @brief The HartScope class
+   * Redirects the processor accessors of the ProcessorHandler (getProcessor,
+   * getMemory and the register and memory accessors) to @p hart for the
+   * calling thread, for the lifetime of the scope. This allows the system
+   * calls of a hart of a multi-hart simulation to execute on its own state.
+   */
+  class HartScope {
+  public:
+    HartScope(RipesProcessor *hart) : m_previous(s_hart) { s_hart = hart; }
+    ~HartScope() { s_hart = m_previous; }
+
+  private:
+    RipesProcessor *m_previous;
+  };
+
   /// Returns a non-const pointer to the currently instantiated processor.
   static RipesProcessor *getProcessorNonConst() {
     return get()->_getProcessor();
@@ -105,6 +125,33 @@ public:
     get()->_selectProcessor(id, extensions, setup);
   }
 
+  /**
+   * @brief switchProcessor
+   * Selects the processor identified by @param id, and transfers the
+   * architectural state of the current processor into it, such that the
+   * current program continues executing on the new processor from where the
+   * current processor left off. The current processor must be in a precise
+   * state and track writes to its memory (see ArchitecturalState::capture),
+   * and both processors must implement the same ISA. @returns false if the
+   * state could not be transferred, in which case the current processor is
+   * retained.
+   */
+  static bool switchProcessor(const ProcessorID &id,
+                              const QStringList &extensions = {}) {
+    return get()->_switchProcessor(id, extensions);
+  }
+
+  /**
+   * @brief setPreferInterpreter
+   * If set, processors which provide an instruction-level interpreter are
+   * constructed as such rather than as their VSRTL model, upon the next
+   * processor selection. Intended for simulations without a GUI, since the
+   * interpreter cannot be visualized or reversed.
+   */
+  static void setPreferInterpreter(bool prefer) {
+    get()->m_preferInterpreter = prefer;
+  }
+
   /**
    * @brief isExecutableAddress
    * @returns whether @param address is within the executable section of the
@@ -135,6 +182,16 @@ public:
     return get()->_disassembleInstr(address);
   }
 
+  /**
+   * @brief disassemble
+   * @return the disassembly of the instruction at @param address in the
+   * current program. Disassembly is memoized across all callers; see
+   * DisassemblyCache.
+   */
+  static Assembler::OpDisassembleResult disassemble(const AInt address) {
+    return get()->_disassemble(address);
+  }
+
   /**
    * @brief getMemory
    * returns const-wrapped references to the current process memory
@@ -175,7 +232,8 @@ public:
   /// Returns true if the processor is currently at a breakpoint. This is done
   /// through comparing the breakpoint-triggering stages of the current
   /// processor, fetching the PC of those stages, and comparing them against the
-  /// current set of breakpoint addresses.
+  /// current set of breakpoint addresses. Breakpoints only trigger if their
+  /// condition (if any) holds. Also returns true if a watchpoint triggers.
   static bool checkBreakpoint() { return get()->_checkBreakpoint(); }
 
   /// Set/unset the provided address as a breakpoint.
@@ -196,6 +254,40 @@ public:
   /// Removes all currently set breakpoints.
   static void clearBreakpoints() { get()->_clearBreakpoints(); }
 
+  /// Sets the condition of the breakpoint at the provided address (see
+  /// BreakpointCondition). An empty @p expression makes the breakpoint
+  /// unconditional. Returns false if @p expression is invalid for the current
+  /// ISA, with the reason in @p errorMessage.
+  static bool setBreakpointCondition(const AInt address,
+                                     const QString &expression,
+                                     QString &errorMessage) {
+    return get()->_setBreakpointCondition(address, expression, errorMessage);
+  }
+
+  /// Returns the condition of the breakpoint at the provided address, or an
+  /// empty string if the breakpoint is unconditional.
+  static QString breakpointCondition(const AInt address) {
+    return get()->_breakpointCondition(address);
+  }
+
+  /// Adds a watchpoint from its specification (see Watchpoint::parse). Returns
+  /// false if @p spec is invalid, with the reason in @p errorMessage.
+  static bool addWatchpoint(const QString &spec, QString &errorMessage) {
+    return get()->_addWatchpoint(spec, errorMessage);
+  }
+
+  /// Returns the currently set watchpoints.
+  static std::vector<Watchpoint> watchpoints() {
+    return get()->_watchpoints();
+  }
+
+  /// Removes all currently set watchpoints.
+  static void clearWatchpoints() { get()->_clearWatchpoints(); }
+
+  /// Returns a description of the breakpoint or watchpoint which last stopped
+  /// execution.
+  static QString stopMessage() { return get()->_stopMessage(); }
+
   /// Trigger a processor finished check. This inspect the current processor run
   /// state, and if finished, emit a finish signal.
   static void checkProcessorFinished() { get()->_checkProcessorFinished(); }
@@ -225,6 +317,30 @@ public:
    */
   static void stopRun() { get()->_stopRun(); }
 
+  /**
+   * @brief runSnapshot
+   * While running, the processor must not be accessed from the GUI thread.
+   * Instead, the run thread publishes snapshots of the processor at the UI
+   * update rate, and runSnapshotUpdated is emitted whenever a new snapshot is
+   * available. Only valid while running, and only accessible from the GUI
+   * thread.
+   */
+  static const ProcessorSnapshot &runSnapshot() {
+    return get()->m_snapshots.front();
+  }
+
+  /**
+   * @brief setSnapshotMemoryRange
+   * Requests the memory range [@p address, @p address + @p bytes[ to be
+   * included in run snapshots on behalf of @p owner (e.g., a memory view),
+   * replacing any range previously requested by @p owner. A range of 0 bytes
+   * withdraws the request.
+   */
+  static void setSnapshotMemoryRange(const void *owner, AInt address,
+                                     unsigned bytes) {
+    get()->_setSnapshotMemoryRange(owner, address, bytes);
+  }
+
 signals:
 
   /**
@@ -254,6 +370,12 @@ signals:
   void runStarted();
   void runFinished();
 
+  /**
+   * @brief runSnapshotUpdated
+   * Emitted (in the GUI thread) when a new run snapshot is available.
+   */
+  void runSnapshotUpdated();
+
   /**
    * @brief Various signals wrapping around the direct VSRTL model emission
    * signals. This is done to avoid relying component to having to reconnect to
@@ -289,9 +411,11 @@ private:
   /// documentation, refer to their static counterparts above.
 
   void _loadProgram(const std::shared_ptr<Program> &p);
-  RipesProcessor *_getProcessor() { return m_currentProcessor.get(); }
+  RipesProcessor *_getProcessor() {
+    return s_hart ? s_hart : m_currentProcessor.get();
+  }
   const RipesProcessor *_getProcessor() const {
-    return m_currentProcessor.get();
+    return s_hart ? s_hart : m_currentProcessor.get();
   }
   const std::shared_ptr<Assembler::AssemblerBase> _getAssembler() {
     return m_currentAssembler;
@@ -313,10 +437,12 @@ private:
   void _selectProcessor(
       const ProcessorID &id, const QStringList &extensions = {},
       const RegisterInitialization &setup = RegisterInitialization());
+  bool _switchProcessor(const ProcessorID &id, const QStringList &extensions);
   bool _isExecutableAddress(AInt address) const;
   int _getCurrentProgramSize() const;
   AInt _getTextStart() const;
-  QString _disassembleInstr(const AInt address) const;
+  QString _disassembleInstr(const AInt address);
+  Assembler::OpDisassembleResult _disassemble(const AInt address);
   vsrtl::core::AddressSpaceMM &_getMemory();
   const vsrtl::core::AddressSpace &_getRegisters() const;
   void _setRegisterValue(const std::string_view &rfid, const unsigned idx,
@@ -329,6 +455,19 @@ private:
   void _toggleBreakpoint(const AInt address);
   bool _hasBreakpoint(const AInt address) const;
   void _clearBreakpoints();
+  bool _setBreakpointCondition(const AInt address, const QString &expression,
+                               QString &errorMessage);
+  QString _breakpointCondition(const AInt address);
+  bool _addWatchpoint(const QString &spec, QString &errorMessage);
+  std::vector<Watchpoint> _watchpoints();
+  void _clearWatchpoints();
+  QString _stopMessage();
+  /// Checks breakpoints and @p watchpoints against the current cycle of the
+  /// processor. m_debugLock must be held.
+  bool _breakpointReached(WatchpointMonitor &watchpoints);
+  /// Recompiles breakpoint conditions and watchpoints for the ISA of the
+  /// current processor, dropping those which are invalid for it.
+  void _recompileDebugConditions();
   void _checkProcessorFinished();
   bool _isRunning();
   void _run();
@@ -336,6 +475,11 @@ private:
   void _reset();
   void _stopRun();
   void _triggerProcStateChangeTimer();
+  void _setSnapshotMemoryRange(const void *owner, AInt address,
+                               unsigned bytes);
+  /// Captures and publishes a snapshot of the current processor. Called by
+  /// the thread running the processor.
+  void _publishSnapshot();
 
   void createAssemblerForCurrentISA();
   void setStopRunFlag();
@@ -344,11 +488,16 @@ private:
   // Flag used during construction to avoid calling ProcessorHandler::get() to
   // retrieve the singleton while it is being constructed.
   bool m_constructing = false;
+  bool m_preferInterpreter = false;
   ProcessorID m_currentID;
   RegisterInitialization m_currentRegInits;
   std::unique_ptr<RipesProcessor> m_currentProcessor;
+  // The hart which the processor accessors are redirected to by a HartScope
+  // of the calling thread, if any.
+  static thread_local RipesProcessor *s_hart;
   std::unique_ptr<SyscallManager> m_syscallManager;
   std::shared_ptr<Assembler::AssemblerBase> m_currentAssembler;
+  Assembler::DisassemblyCache m_disassemblyCache;
 
   /**
    * @brief m_vsrtlWidget
@@ -357,10 +506,26 @@ private:
   vsrtl::VSRTLWidget *m_vsrtlWidget = nullptr;
 
   std::set<AInt> m_breakpoints;
+  std::map<AInt, BreakpointCondition> m_breakpointConditions;
+  struct BreakpointHits {
+    unsigned long long count = 0;
+    // The cycle in which the breakpoint was last reached, such that checking
+    // it repeatedly within a cycle counts as a single hit.
+    long long cycle = -1;
+  };
+  std::map<AInt, BreakpointHits> m_breakpointHits;
+  WatchpointMonitor m_watchpoints;
+  // Incremented whenever m_watchpoints changes, such that the run thread knows
+  // to refresh its copy of them.
+  unsigned m_watchpointsVersion = 0;
+  QString m_stopMessage;
+  // Guards breakpoints and watchpoints, which are checked by the run thread
+  // while running.
+  std::mutex m_debugLock;
   std::shared_ptr<Program> m_program;
 
   QFutureWatcher<void> m_runWatcher;
-  bool m_stopRunningFlag = false;
+  std::atomic<bool> m_stopRunningFlag = false;
   std::mutex m_clockLock;
 
   /**
@@ -373,6 +538,20 @@ private:
   bool m_enqueueStateChangeSignal;
   std::mutex m_enqueueStateChangeLock;
 
+  /**
+   * @brief Snapshots of the running processor are published by the run thread
+   * into m_snapshots, and fetched by the GUI thread when m_snapshotTimer times
+   * out (at the UI update rate).
+   */
+  TripleBuffer<ProcessorSnapshot> m_snapshots;
+  QTimer m_snapshotTimer;
+  // Memory ranges requested by views, guarded by m_snapshotMemoryLock. The run
+  // thread never waits for the lock.
+  std::map<const void *, std::pair<AInt, unsigned>> m_snapshotMemoryRanges;
+  std::mutex m_snapshotMemoryLock;
+  // Pages captured by the run thread; only accessed by the run thread.
+  std::set<AInt> m_snapshotPages;
+
   /**
    * @brief m_sem
    * Semaphore handling locking simulator thread execution whilst trapping to
@@ -8,6 +8,7 @@
 #include "processors/RISC-V/rv5s_no_hz/rv5s_no_hz.h"
 #include "processors/RISC-V/rv6s_dual/rv6s_dual.h"
 #include "processors/RISC-V/rvss/rvss.h"
+#include "processors/RISC-V/rvss/rvss_interpreter.h"
 #include "processors/RISC-V/rvss_trap/rvss_trap.h"
 
 namespace Ripes {
@@ -55,10 +56,10 @@ ProcessorRegistry::ProcessorRegistry() {
               ":/layouts/RISC-V/rvss/rv_ss_extended_layout.json",
               {{{0, 0}, QPointF{0.5, 0}}}}};
   defRegVals = {{RVISA::GPR, {{2, 0x7ffffff0}, {3, 0x10000000}}}};
-  addProcessor(ProcInfo<vsrtl::core::RVSS<uint32_t>>(
+  addProcessor(ProcInfo<vsrtl::core::RVSS<uint32_t>, RVSSInterpreter<uint32_t>>(
       ProcessorID::RV32_SS, "Single-cycle processor",
       "A single cycle processor", layouts, defRegVals));
-  addProcessor(ProcInfo<vsrtl::core::RVSS<uint64_t>>(
+  addProcessor(ProcInfo<vsrtl::core::RVSS<uint64_t>, RVSSInterpreter<uint64_t>>(
       ProcessorID::RV64_SS, "Single-cycle processor",
       "A single cycle processor", layouts, defRegVals));
 
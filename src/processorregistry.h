@@ -77,15 +77,35 @@ public:
   virtual ProcessorISAInfo isaInfo() const = 0;
   virtual std::unique_ptr<RipesProcessor>
   construct(const QStringList &extensions) = 0;
+
+  /**
+   * @brief hasInterpreter
+   * @returns true if the processor provides an instruction-level interpreter,
+   * which may be constructed in place of the processor model to simulate the
+   * processor at a higher speed, but without a circuit to visualize.
+   */
+  virtual bool hasInterpreter() const = 0;
+  virtual std::unique_ptr<RipesProcessor>
+  constructInterpreter(const QStringList &extensions) = 0;
 };
 
-template <typename T>
+/// A processor of type T. If InterpreterT is not void, it is an
+/// instruction-level interpreter of the processor.
+template <typename T, typename InterpreterT = void>
 class ProcInfo : public ProcInfoBase {
 public:
   using ProcInfoBase::ProcInfoBase;
   std::unique_ptr<RipesProcessor> construct(const QStringList &extensions) {
     return std::make_unique<T>(extensions);
   }
+  bool hasInterpreter() const { return !std::is_void_v<InterpreterT>; }
+  std::unique_ptr<RipesProcessor>
+  constructInterpreter(const QStringList &extensions) {
+    if constexpr (std::is_void_v<InterpreterT>)
+      return nullptr;
+    else
+      return std::make_unique<InterpreterT>(extensions);
+  }
   // At this point we force the processor type T to implement a static function
   // identifying its supported ISA.
   ProcessorISAInfo isaInfo() const { return T::supportsISA(); }
@@ -104,19 +124,26 @@ public:
     }
     return *desc->second;
   }
+  /// Constructs the processor identified by @p id. If @p interpreter is set
+  /// and the processor provides an instruction-level interpreter, the
+  /// interpreter is constructed instead of the processor model.
   static std::unique_ptr<RipesProcessor>
-  constructProcessor(ProcessorID id, const QStringList &extensions) {
+  constructProcessor(ProcessorID id, const QStringList &extensions,
+                     bool interpreter = false) {
     auto &_this = instance();
     auto it = _this.m_descriptions.find(id);
     Q_ASSERT(it != _this.m_descriptions.end());
+    if (interpreter && it->second->hasInterpreter())
+      return it->second->constructInterpreter(extensions);
     return it->second->construct(extensions);
   }
 
 private:
-  template <typename T>
-  void addProcessor(const ProcInfo<T> &pinfo) {
+  template <typename T, typename InterpreterT>
+  void addProcessor(const ProcInfo<T, InterpreterT> &pinfo) {
     Q_ASSERT(m_descriptions.count(pinfo.id) == 0);
-    m_descriptions[pinfo.id] = std::make_unique<ProcInfo<T>>(pinfo);
+    m_descriptions[pinfo.id] =
+        std::make_unique<ProcInfo<T, InterpreterT>>(pinfo);
   }
 
   ProcessorRegistry();
@@ -46,6 +46,10 @@ public:
   RV5S(const QStringList &extensions)
       : RipesVSRTLProcessor("5-Stage RISC-V Processor") {
     m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_countedPipelineEvents =
+        pipelineEventBit(PipelineEvent::DataHazardStall) |
+        pipelineEventBit(PipelineEvent::ControlFlush) |
+        pipelineEventBit(PipelineEvent::Forward);
     decode->setISA(m_enabledISA);
     uncompress->setISA(m_enabledISA);
 
@@ -456,7 +460,9 @@ public:
   }
 
   MemoryAccess dataMemAccess() const override {
-    return memToAccessInfo(data_mem);
+    auto dataAccess = memToAccessInfo(data_mem);
+    dataAccess.pc = getPcForStage(StageIndex{0, MEM});
+    return dataAccess;
   }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
@@ -487,6 +493,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired++;
     }
+    countPipelineEvents(1);
 
     Design::clock();
   }
@@ -503,6 +510,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired--;
     }
+    countPipelineEvents(-1);
   }
 
   void reset() override {
@@ -530,6 +538,22 @@ public:
   }
 
 private:
+  /**
+   * @brief countPipelineEvents
+   * Counts the pipeline events of the current cycle, as signalled by the
+   * control signals which take effect on the next clock edge.
+   */
+  void countPipelineEvents(int delta) {
+    countPipelineEvent(PipelineEvent::DataHazardStall,
+                       hzunit->hazardIDEXClear.uValue(), delta);
+    countPipelineEvent(PipelineEvent::ControlFlush,
+                       controlflow_or->out.uValue(), delta);
+    if (idex_reg->valid_out.uValue() && hzunit->hazardIDEXEnable.uValue()) {
+      countPipelineEvent(PipelineEvent::Forward,
+                         funit->forwardedOperands(*idex_reg), delta);
+    }
+  }
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
@@ -43,6 +43,26 @@ public:
     };
   }
 
+  /**
+   * @brief forwardedOperands
+   * Returns the # of register operands of the instruction held by @p idex
+   * which are forwarded to the EX stage. Operands which the instruction does
+   * not use are not counted.
+   */
+  template <typename IDEX>
+  unsigned forwardedOperands(IDEX &idex) {
+    const bool doBranch = idex.do_br_out.uValue();
+    const auto op1 = idex.alu_op1_ctrl_out.template eValue<AluSrc1>();
+    const auto op2 = idex.alu_op2_ctrl_out.template eValue<AluSrc2>();
+    const bool usesReg1 = doBranch || op1 == AluSrc1::REG1;
+    const bool usesReg2 =
+        doBranch || op2 == AluSrc2::REG2 || idex.mem_do_write_out.uValue();
+    const auto fw1 = alu_reg1_forwarding_ctrl.eValue<ForwardingSrc>();
+    const auto fw2 = alu_reg2_forwarding_ctrl.eValue<ForwardingSrc>();
+    return (usesReg1 && fw1 != ForwardingSrc::IdStage) +
+           (usesReg2 && fw2 != ForwardingSrc::IdStage);
+  }
+
   INPUTPORT(id_reg1_idx, c_RVRegsBits);
   INPUTPORT(id_reg2_idx, c_RVRegsBits);
 
@@ -46,6 +46,9 @@ public:
       : RipesVSRTLProcessor(
             "5-Stage RISC-V Processor without forwarding unit") {
     m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_countedPipelineEvents =
+        pipelineEventBit(PipelineEvent::DataHazardStall) |
+        pipelineEventBit(PipelineEvent::ControlFlush);
     decode->setISA(m_enabledISA);
     uncompress->setISA(m_enabledISA);
 
@@ -430,7 +433,9 @@ public:
   }
 
   MemoryAccess dataMemAccess() const override {
-    return memToAccessInfo(data_mem);
+    auto dataAccess = memToAccessInfo(data_mem);
+    dataAccess.pc = getPcForStage(StageIndex{0, MEM});
+    return dataAccess;
   }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
@@ -461,6 +466,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired++;
     }
+    countPipelineEvents(1);
 
     Design::clock();
   }
@@ -477,6 +483,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired--;
     }
+    countPipelineEvents(-1);
   }
 
   void reset() override {
@@ -504,6 +511,18 @@ public:
   }
 
 private:
+  /**
+   * @brief countPipelineEvents
+   * Counts the pipeline events of the current cycle, as signalled by the
+   * control signals which take effect on the next clock edge.
+   */
+  void countPipelineEvents(int delta) {
+    countPipelineEvent(PipelineEvent::DataHazardStall,
+                       hzunit->hazardIDEXClear.uValue(), delta);
+    countPipelineEvent(PipelineEvent::ControlFlush,
+                       controlflow_or->out.uValue(), delta);
+  }
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
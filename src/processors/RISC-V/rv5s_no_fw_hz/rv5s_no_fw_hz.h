@@ -43,6 +43,7 @@ public:
       : RipesVSRTLProcessor(
             "5-Stage RISC-V Processor without forwarding or hazard detection") {
     m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_countedPipelineEvents = pipelineEventBit(PipelineEvent::ControlFlush);
     decode->setISA(m_enabledISA);
     uncompress->setISA(m_enabledISA);
 
@@ -381,7 +382,9 @@ public:
   };
 
   MemoryAccess dataMemAccess() const override {
-    return memToAccessInfo(data_mem);
+    auto dataAccess = memToAccessInfo(data_mem);
+    dataAccess.pc = getPcForStage(StageIndex{0, MEM});
+    return dataAccess;
   }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
@@ -411,6 +414,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired++;
     }
+    countPipelineEvents(1);
 
     Design::clock();
   }
@@ -427,6 +431,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired--;
     }
+    countPipelineEvents(-1);
   }
 
   void reset() override {
@@ -454,6 +459,16 @@ public:
   }
 
 private:
+  /**
+   * @brief countPipelineEvents
+   * Counts the pipeline events of the current cycle, as signalled by the
+   * control signals which take effect on the next clock edge.
+   */
+  void countPipelineEvents(int delta) {
+    countPipelineEvent(PipelineEvent::ControlFlush,
+                       controlflow_or->out.uValue(), delta);
+  }
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
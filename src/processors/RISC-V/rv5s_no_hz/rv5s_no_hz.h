@@ -43,6 +43,9 @@ public:
   RV5S_NO_HZ(const QStringList &extensions)
       : RipesVSRTLProcessor("5-Stage RISC-V Processor without forwarding") {
     m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_countedPipelineEvents =
+        pipelineEventBit(PipelineEvent::ControlFlush) |
+        pipelineEventBit(PipelineEvent::Forward);
     decode->setISA(m_enabledISA);
     uncompress->setISA(m_enabledISA);
 
@@ -416,7 +419,9 @@ public:
   };
 
   MemoryAccess dataMemAccess() const override {
-    return memToAccessInfo(data_mem);
+    auto dataAccess = memToAccessInfo(data_mem);
+    dataAccess.pc = getPcForStage(StageIndex{0, MEM});
+    return dataAccess;
   }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
@@ -446,6 +451,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired++;
     }
+    countPipelineEvents(1);
 
     Design::clock();
   }
@@ -462,6 +468,7 @@ public:
         isExecutableAddress(memwb_reg->pc_out.uValue())) {
       m_instructionsRetired--;
     }
+    countPipelineEvents(-1);
   }
 
   void reset() override {
@@ -489,6 +496,20 @@ public:
   }
 
 private:
+  /**
+   * @brief countPipelineEvents
+   * Counts the pipeline events of the current cycle, as signalled by the
+   * control signals which take effect on the next clock edge.
+   */
+  void countPipelineEvents(int delta) {
+    countPipelineEvent(PipelineEvent::ControlFlush,
+                       controlflow_or->out.uValue(), delta);
+    if (idex_reg->valid_out.uValue()) {
+      countPipelineEvent(PipelineEvent::Forward,
+                         funit->forwardedOperands(*idex_reg), delta);
+    }
+  }
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
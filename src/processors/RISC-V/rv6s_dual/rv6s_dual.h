@@ -52,6 +52,12 @@ public:
   RV6S_DUAL(const QStringList &extensions)
       : RipesVSRTLProcessor("6-Stage dual-issue RISC-V Processor") {
     m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_countedPipelineEvents =
+        pipelineEventBit(PipelineEvent::DataHazardStall) |
+        pipelineEventBit(PipelineEvent::ControlFlush) |
+        pipelineEventBit(PipelineEvent::Forward) |
+        pipelineEventBit(PipelineEvent::DualIssue) |
+        pipelineEventBit(PipelineEvent::WayHazard);
     decode_way2->setISA(m_enabledISA);
     decode_way1->setISA(m_enabledISA);
     uncompress_dual->setISA(m_enabledISA);
@@ -810,7 +816,9 @@ public:
   }
 
   MemoryAccess dataMemAccess() const override {
-    return memToAccessInfo(data_mem);
+    auto dataAccess = memToAccessInfo(data_mem);
+    dataAccess.pc = getPcForStage(StageIndex{DATA, MEM});
+    return dataAccess;
   }
   MemoryAccess instrMemAccess() const override {
     auto instrAccess = memToAccessInfo(instr_mem);
@@ -858,6 +866,7 @@ public:
     // An instruction has been retired if the instruction in the WB stage is
     // valid and the PC is within the executable range of the program
     m_instructionsRetired += instructionsRetired();
+    countPipelineEvents(1);
 
     Design::clock();
   }
@@ -871,6 +880,7 @@ public:
     }
     Design::reverse();
     m_instructionsRetired -= instructionsRetired();
+    countPipelineEvents(-1);
   }
 
   void reset() override {
@@ -898,6 +908,68 @@ public:
   }
 
 private:
+  /**
+   * @brief countPipelineEvents
+   * Counts the pipeline events of the current cycle, as signalled by the
+   * control signals which take effect on the next clock edge.
+   */
+  void countPipelineEvents(int delta) {
+    const bool controlflow = branch->did_controlflow.uValue();
+    countPipelineEvent(PipelineEvent::DataHazardStall,
+                       hzunit->hazardIDEXClear.uValue(), delta);
+    countPipelineEvent(PipelineEvent::ControlFlush, controlflow, delta);
+
+    // A fetched pair of instructions is split if the way control unit stalls
+    // the second instruction, while the front end otherwise proceeds. Pairs
+    // fetched beyond the program are not counted.
+    countPipelineEvent(PipelineEvent::WayHazard,
+                       ifid_reg->valid_out.uValue() &&
+                           isExecutableAddress(ifid_reg->pc_out.uValue()) &&
+                           isExecutableAddress(ifid_reg->pc4_out.uValue()) &&
+                           waycontrol->stall_out.uValue() &&
+                           hzunit->hazardFEEnable.uValue() && !controlflow,
+                       delta);
+
+    if (!iiex_reg->valid_out.uValue() || !hzunit->hazardIDEXEnable.uValue())
+      return;
+    const bool execValid = iiex_reg->exec_valid_out.uValue();
+    const bool dataValid = iiex_reg->data_valid_out.uValue();
+    countPipelineEvent(PipelineEvent::DualIssue,
+                       execValid && dataValid &&
+                           isExecutableAddress(iiex_reg->pc_out.uValue()) &&
+                           isExecutableAddress(iiex_reg->pc_data_out.uValue()),
+                       delta);
+
+    // Only operands which are used by the instructions leaving EX are
+    // forwarded. The data way only executes loads and stores, which use reg1 as
+    // their base address, and stores use reg2 as the stored value.
+    const auto forwarded = [](auto &fwCtrl) {
+      return fwCtrl.template eValue<ForwardingSrcDual>() !=
+             ForwardingSrcDual::IdStage;
+    };
+    if (execValid) {
+      const bool doBranch = iiex_reg->do_br_out.uValue();
+      const auto op1 = iiex_reg->alu_op1_ctrl_out.template eValue<AluSrc1>();
+      const auto op2 = iiex_reg->alu_op2_ctrl_out.template eValue<AluSrc2>();
+      countPipelineEvent(PipelineEvent::Forward,
+                         (doBranch || op1 == AluSrc1::REG1) &&
+                             forwarded(funit->alu_reg1_fw_ctrl_exec),
+                         delta);
+      countPipelineEvent(PipelineEvent::Forward,
+                         (doBranch || op2 == AluSrc2::REG2) &&
+                             forwarded(funit->alu_reg2_fw_ctrl_exec),
+                         delta);
+    }
+    if (dataValid) {
+      countPipelineEvent(PipelineEvent::Forward,
+                         forwarded(funit->alu_reg1_fw_ctrl_data), delta);
+      countPipelineEvent(PipelineEvent::Forward,
+                         iiex_reg->mem_do_write_out.uValue() &&
+                             forwarded(funit->alu_reg2_fw_ctrl_data),
+                         delta);
+    }
+  }
+
   /**
    * @brief m_syscallExitCycle
    * The variable will contain the cycle of which an exit system call was
@@ -54,6 +54,28 @@ public:
             case RVInstr::LBU: return MemOp::LBU;
             case RVInstr::LHU: return MemOp::LHU;
             case RVInstr::LWU: return MemOp::LWU;
+            case RVInstr::LR_W: return MemOp::LR_W;
+            case RVInstr::SC_W: return MemOp::SC_W;
+            case RVInstr::AMOSWAP_W: return MemOp::AMOSWAP_W;
+            case RVInstr::AMOADD_W: return MemOp::AMOADD_W;
+            case RVInstr::AMOXOR_W: return MemOp::AMOXOR_W;
+            case RVInstr::AMOAND_W: return MemOp::AMOAND_W;
+            case RVInstr::AMOOR_W: return MemOp::AMOOR_W;
+            case RVInstr::AMOMIN_W: return MemOp::AMOMIN_W;
+            case RVInstr::AMOMAX_W: return MemOp::AMOMAX_W;
+            case RVInstr::AMOMINU_W: return MemOp::AMOMINU_W;
+            case RVInstr::AMOMAXU_W: return MemOp::AMOMAXU_W;
+            case RVInstr::LR_D: return MemOp::LR_D;
+            case RVInstr::SC_D: return MemOp::SC_D;
+            case RVInstr::AMOSWAP_D: return MemOp::AMOSWAP_D;
+            case RVInstr::AMOADD_D: return MemOp::AMOADD_D;
+            case RVInstr::AMOXOR_D: return MemOp::AMOXOR_D;
+            case RVInstr::AMOAND_D: return MemOp::AMOAND_D;
+            case RVInstr::AMOOR_D: return MemOp::AMOOR_D;
+            case RVInstr::AMOMIN_D: return MemOp::AMOMIN_D;
+            case RVInstr::AMOMAX_D: return MemOp::AMOMAX_D;
+            case RVInstr::AMOMINU_D: return MemOp::AMOMINU_D;
+            case RVInstr::AMOMAXU_D: return MemOp::AMOMAXU_D;
             default:
                 return MemOp::NOP;
         }
@@ -83,6 +105,14 @@ public:
             case RVInstr::LB: case RVInstr::LH: case RVInstr::LW: case RVInstr::LBU: case RVInstr::LHU:
             case RVInstr::LWU: case RVInstr::LD:
 
+            // Atomic instructions
+            case RVInstr::LR_W: case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W:
+            case RVInstr::AMOXOR_W: case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W:
+            case RVInstr::AMOMAX_W: case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::LR_D:
+            case RVInstr::SC_D: case RVInstr::AMOSWAP_D: case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D:
+            case RVInstr::AMOAND_D: case RVInstr::AMOOR_D: case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D:
+            case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+
             // Jump instructions
             case RVInstr::JALR:
             case RVInstr::JAL:
@@ -98,6 +128,15 @@ public:
             case RVInstr::LHU: case RVInstr::LWU: case RVInstr::LD:
                 return RegWrSrc::MEMREAD;
 
+            // Atomic instructions
+            case RVInstr::LR_W: case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W:
+            case RVInstr::AMOXOR_W: case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W:
+            case RVInstr::AMOMAX_W: case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::LR_D:
+            case RVInstr::SC_D: case RVInstr::AMOSWAP_D: case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D:
+            case RVInstr::AMOAND_D: case RVInstr::AMOOR_D: case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D:
+            case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+                return RegWrSrc::MEMREAD;
+
             // Jump instructions
             case RVInstr::JALR:
             case RVInstr::JAL:
@@ -148,6 +187,15 @@ public:
         case RVInstr::SD:
             return AluSrc2::IMM;
 
+        // Atomic instructions
+        case RVInstr::LR_W: case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W:
+        case RVInstr::AMOXOR_W: case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W:
+        case RVInstr::AMOMAX_W: case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::LR_D:
+        case RVInstr::SC_D: case RVInstr::AMOSWAP_D: case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D:
+        case RVInstr::AMOAND_D: case RVInstr::AMOOR_D: case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D:
+        case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+            return AluSrc2::IMM;
+
         // Branch instructions
         case RVInstr::BEQ: case RVInstr::BNE: case RVInstr::BLT:
         case RVInstr::BGE: case RVInstr::BLTU: case RVInstr::BGEU:
@@ -169,6 +217,13 @@ public:
             case RVInstr::SB: case RVInstr::SH: case RVInstr::SW: case RVInstr::LWU: case RVInstr::LD:
             case RVInstr::SD:
                 return ALUOp::ADD;
+            case RVInstr::LR_W: case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W:
+            case RVInstr::AMOXOR_W: case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W:
+            case RVInstr::AMOMAX_W: case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::LR_D:
+            case RVInstr::SC_D: case RVInstr::AMOSWAP_D: case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D:
+            case RVInstr::AMOAND_D: case RVInstr::AMOOR_D: case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D:
+            case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+                return ALUOp::ADD;
             case RVInstr::LUI:
                 return ALUOp::LUI;
             case RVInstr::JAL: case RVInstr::JALR: case RVInstr::AUIPC:
@@ -224,6 +279,14 @@ public:
         switch(opc) {
             case RVInstr::SB: case RVInstr::SH: case RVInstr::SW: case RVInstr::SD:
                 return 1;
+            // Store-conditionals are only performed if a reservation is held,
+            // which is checked by the data memory.
+            case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W: case RVInstr::AMOXOR_W:
+            case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W: case RVInstr::AMOMAX_W:
+            case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::SC_D: case RVInstr::AMOSWAP_D:
+            case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D: case RVInstr::AMOAND_D: case RVInstr::AMOOR_D:
+            case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D: case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+                return 1;
             default: return 0;
         }
     }
@@ -233,6 +296,15 @@ public:
             case RVInstr::LB: case RVInstr::LH: case RVInstr::LW: case RVInstr::LBU:
             case RVInstr::LHU: case RVInstr::LWU: case RVInstr::LD:
                 return 1;
+            // Atomic instructions read memory (store-conditionals produce their
+            // result in the memory stage), and are subject to load-use hazards.
+            case RVInstr::LR_W: case RVInstr::SC_W: case RVInstr::AMOSWAP_W: case RVInstr::AMOADD_W:
+            case RVInstr::AMOXOR_W: case RVInstr::AMOAND_W: case RVInstr::AMOOR_W: case RVInstr::AMOMIN_W:
+            case RVInstr::AMOMAX_W: case RVInstr::AMOMINU_W: case RVInstr::AMOMAXU_W: case RVInstr::LR_D:
+            case RVInstr::SC_D: case RVInstr::AMOSWAP_D: case RVInstr::AMOADD_D: case RVInstr::AMOXOR_D:
+            case RVInstr::AMOAND_D: case RVInstr::AMOOR_D: case RVInstr::AMOMIN_D: case RVInstr::AMOMAX_D:
+            case RVInstr::AMOMINU_D: case RVInstr::AMOMAXU_D:
+                return 1;
             default: return 0;
         }
     }
@@ -15,11 +15,26 @@ public:
   Decode(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
     opcode << [=] {
-      const auto instrValue = instr.uValue();
+      return decodeOpcode(instr.uValue(),
+                          m_isa && m_isa->extensionEnabled("M"),
+                          m_isa && m_isa->extensionEnabled("A"));
+    };
 
-      const unsigned l7 = instrValue & 0b1111111;
+    wr_reg_idx << [=] { return (instr.uValue() >> 7) & 0b11111; };
+    r1_reg_idx << [=] { return (instr.uValue() >> 15) & 0b11111; };
+    r2_reg_idx << [=] { return (instr.uValue() >> 20) & 0b11111; };
+  }
+
+  /**
+   * @brief decodeOpcode
+   * Decodes the (uncompressed) instruction @p instrValue. M and A extension
+   * instructions are only decoded if @p extM and @p extA are set. Unknown
+   * instructions decode to RVInstr::NOP.
+   */
+  static RVInstr decodeOpcode(VInt instrValue, bool extM, bool extA) {
+    const unsigned l7 = instrValue & 0b1111111;
 
-      // clang-format off
+    // clang-format off
             switch(l7) {
             case RVISA::OpcodeID::LUI: return RVInstr::LUI;
             case RVISA::OpcodeID::AUIPC: return RVInstr::AUIPC;
@@ -70,7 +85,7 @@ public:
                 // R-Type
                 const auto fields = RVInstrParser::getParser()->decodeR32Instr(instrValue);
                 if (fields[0] == 0b0000001) {
-                    if(m_isa && m_isa->extensionEnabled("M")) {
+                    if(extM) {
                         // RV32M Standard extension
                         switch (fields[3]) {
                             case 0b000: return RVInstr::MUL;
@@ -117,7 +132,7 @@ public:
                 // R-Type (32-bit, in 64-bit ISA)
                 const auto fields = RVInstrParser::getParser()->decodeR32Instr(instrValue);
                 if (fields[0] == 0b0000001) {
-                    if(m_isa && m_isa->extensionEnabled("M")) {
+                    if(extM) {
                         // RV64M Standard extension
                         switch (fields[3]) {
                             case 0b000: return RVInstr::MULW;
@@ -181,6 +196,37 @@ public:
                 break;
             }
 
+            case RVISA::OpcodeID::AMO: {
+                // Atomic instructions; the aq/rl bits are ignored, as memory
+                // accesses are performed in order.
+                if (!extA)
+                    break;
+                const unsigned funct3 = (instrValue >> 12) & 0b111;
+                const bool dword = funct3 == 0b011;
+                if (funct3 != 0b010 && !(XLEN == 64 && dword))
+                    break;
+                switch ((instrValue >> 27) & 0b11111) {
+                    case 0b00010: {
+                        // lr has no rs2 operand
+                        if (((instrValue >> 20) & 0b11111) != 0)
+                            break;
+                        return dword ? RVInstr::LR_D : RVInstr::LR_W;
+                    }
+                    case 0b00011: return dword ? RVInstr::SC_D : RVInstr::SC_W;
+                    case 0b00001: return dword ? RVInstr::AMOSWAP_D : RVInstr::AMOSWAP_W;
+                    case 0b00000: return dword ? RVInstr::AMOADD_D : RVInstr::AMOADD_W;
+                    case 0b00100: return dword ? RVInstr::AMOXOR_D : RVInstr::AMOXOR_W;
+                    case 0b01100: return dword ? RVInstr::AMOAND_D : RVInstr::AMOAND_W;
+                    case 0b01000: return dword ? RVInstr::AMOOR_D : RVInstr::AMOOR_W;
+                    case 0b10000: return dword ? RVInstr::AMOMIN_D : RVInstr::AMOMIN_W;
+                    case 0b10100: return dword ? RVInstr::AMOMAX_D : RVInstr::AMOMAX_W;
+                    case 0b11000: return dword ? RVInstr::AMOMINU_D : RVInstr::AMOMINU_W;
+                    case 0b11100: return dword ? RVInstr::AMOMAXU_D : RVInstr::AMOMAXU_W;
+                    default: break;
+                }
+                break;
+            }
+
             case RVISA::OpcodeID::BRANCH: {
                 // Branch instruction
                 const auto fields = RVInstrParser::getParser()->decodeB32Instr(instrValue);
@@ -203,20 +249,6 @@ public:
 
             // Fallthrough - unknown instruction.
             return RVInstr::NOP;
-        };
-
-        wr_reg_idx << [=] {
-          return (instr.uValue() >> 7) & 0b11111;
-        };
-
-        r1_reg_idx << [=] {
-          return (instr.uValue() >> 15) & 0b11111;
-        };
-
-        r2_reg_idx << [=] {
-          return (instr.uValue() >> 20) & 0b11111;
-        };
-
     // clang-format on
   }
 
@@ -76,6 +76,30 @@ public:
         return VT_U(signextend<12>(((instr.uValue() & 0xfe000000)) >> 20) |
                     ((instr.uValue() & 0xf80) >> 7));
       }
+      case RVInstr::LR_W:
+      case RVInstr::SC_W:
+      case RVInstr::AMOSWAP_W:
+      case RVInstr::AMOADD_W:
+      case RVInstr::AMOXOR_W:
+      case RVInstr::AMOAND_W:
+      case RVInstr::AMOOR_W:
+      case RVInstr::AMOMIN_W:
+      case RVInstr::AMOMAX_W:
+      case RVInstr::AMOMINU_W:
+      case RVInstr::AMOMAXU_W:
+      case RVInstr::LR_D:
+      case RVInstr::SC_D:
+      case RVInstr::AMOSWAP_D:
+      case RVInstr::AMOADD_D:
+      case RVInstr::AMOXOR_D:
+      case RVInstr::AMOAND_D:
+      case RVInstr::AMOOR_D:
+      case RVInstr::AMOMIN_D:
+      case RVInstr::AMOMAX_D:
+      case RVInstr::AMOMINU_D:
+      case RVInstr::AMOMAXU_D:
+        // Atomic instructions address memory at rs1 + 0
+        return VT_U(0);
       default:
         return VT_U(0xDEADBEEF);
       }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VSRTL/core/vsrtl_memory.h"
+#include "VSRTL/core/vsrtl_register.h"
 #include "VSRTL/core/vsrtl_wire.h"
 #include "riscv.h"
 
@@ -15,8 +16,30 @@ public:
   RVMemory(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
     addr >> mem->addr;
-    wr_en >> mem->wr_en;
-    data_in >> mem->data_in;
+
+    // Store-conditionals only write if the reservation is held.
+    wr_en_sc->setSensitiveTo(&wr_en);
+    wr_en_sc->setSensitiveTo(&op);
+    wr_en_sc->setSensitiveTo(&addr);
+    wr_en_sc->setSensitiveTo(&res_valid->out);
+    wr_en_sc->setSensitiveTo(&res_addr->out);
+    wr_en_sc->setSensitiveTo(&res_bytes->out);
+    wr_en_sc->out << [=] {
+      return wr_en.uValue() &&
+             (!isStoreConditional(op.eValue<MemOp>()) || scSucceeds());
+    };
+    wr_en_sc->out >> mem->wr_en;
+
+    // AMOs write the result of their operation on the value read from memory,
+    // within the same cycle.
+    amo_data->setSensitiveTo(&data_in);
+    amo_data->setSensitiveTo(&op);
+    amo_data->setSensitiveTo(&mem->data_out);
+    amo_data->out << [=] {
+      return amoResult(op.eValue<MemOp>(), mem->data_out.uValue(),
+                       data_in.uValue());
+    };
+    amo_data->out >> mem->data_in;
 
     wr_width->setSensitiveTo(&op);
     wr_width->out << [=] {
@@ -29,12 +52,56 @@ public:
         return 4;
       case MemOp::SD:
         return 8;
-      default:
-        return 0;
+      default: {
+        // Store-conditionals and AMOs write their full operand.
+        const MemOp memOp = op.eValue<MemOp>();
+        return isLoadReserved(memOp) ? 0 : static_cast<int>(atomicBytes(memOp));
+      }
       }
     };
     wr_width->out >> mem->wr_width;
 
+    // The reservation of a load-reserved. It is released by a
+    // store-conditional, and invalidated by any write which overlaps it.
+    res_valid_next->setSensitiveTo(&op);
+    res_valid_next->setSensitiveTo(&addr);
+    res_valid_next->setSensitiveTo(&res_valid->out);
+    res_valid_next->setSensitiveTo(&res_addr->out);
+    res_valid_next->setSensitiveTo(&res_bytes->out);
+    res_valid_next->setSensitiveTo(&wr_en_sc->out);
+    res_valid_next->setSensitiveTo(&wr_width->out);
+    res_valid_next->out << [=] {
+      const MemOp memOp = op.eValue<MemOp>();
+      if (isLoadReserved(memOp))
+        return true;
+      if (isStoreConditional(memOp))
+        return false;
+      const VSRTL_VT_U resAddr = res_addr->out.uValue();
+      const bool overlaps =
+          addr.uValue() < resAddr + res_bytes->out.uValue() &&
+          resAddr < addr.uValue() + wr_width->out.uValue();
+      return res_valid->out.uValue() && !(wr_en_sc->out.uValue() && overlaps);
+    };
+    res_valid_next->out >> res_valid->in;
+
+    res_addr_next->setSensitiveTo(&op);
+    res_addr_next->setSensitiveTo(&addr);
+    res_addr_next->setSensitiveTo(&res_addr->out);
+    res_addr_next->out << [=] {
+      return isLoadReserved(op.eValue<MemOp>()) ? addr.uValue()
+                                                : res_addr->out.uValue();
+    };
+    res_addr_next->out >> res_addr->in;
+
+    res_bytes_next->setSensitiveTo(&op);
+    res_bytes_next->setSensitiveTo(&res_bytes->out);
+    res_bytes_next->out << [=] {
+      return isLoadReserved(op.eValue<MemOp>())
+                 ? atomicBytes(op.eValue<MemOp>())
+                 : res_bytes->out.uValue();
+    };
+    res_bytes_next->out >> res_bytes->in;
+
     data_out << [=] {
       switch (op.eValue<MemOp>()) {
       case MemOp::LB:
@@ -51,12 +118,90 @@ public:
         return VT_U(signextend<32>(mem->data_out.uValue()));
       case MemOp::LD:
         return mem->data_out.uValue();
+      case MemOp::SC_W:
+      case MemOp::SC_D:
+        return scSucceeds() ? VT_U(0) : VT_U(1);
       default:
-        return static_cast<VSRTL_VT_U>(0xDEADBEEF);
+        // Atomics return the (sign-extended) value prior to the operation.
+        switch (atomicBytes(op.eValue<MemOp>())) {
+        case 4:
+          return VT_U(signextend<32>(mem->data_out.uValue()));
+        case 8:
+          return mem->data_out.uValue();
+        default:
+          return static_cast<VSRTL_VT_U>(0xDEADBEEF);
+        }
       }
     };
   }
 
+  /// Bytes accessed by the atomic operation @p op; 0 if @p op is not atomic.
+  static unsigned atomicBytes(MemOp op) {
+    if (op >= MemOp::LR_W && op <= MemOp::AMOMAXU_W)
+      return 4;
+    if (op >= MemOp::LR_D && op <= MemOp::AMOMAXU_D)
+      return 8;
+    return 0;
+  }
+  static bool isLoadReserved(MemOp op) {
+    return op == MemOp::LR_W || op == MemOp::LR_D;
+  }
+  static bool isStoreConditional(MemOp op) {
+    return op == MemOp::SC_W || op == MemOp::SC_D;
+  }
+
+  /**
+   * @brief amoResult
+   * @returns the value written by memory operation @p op, given the value
+   * @p old in memory and the operand @p value. Only AMOs modify @p value.
+   */
+  static VSRTL_VT_U amoResult(MemOp op, VSRTL_VT_U old, VSRTL_VT_U value) {
+    // Word operations compare the lower 32 bits of their operands.
+    const bool word = atomicBytes(op) == 4;
+    const auto sext = [word](VSRTL_VT_U v) {
+      return word ? static_cast<int64_t>(static_cast<int32_t>(v))
+                  : static_cast<int64_t>(v);
+    };
+    const auto zext = [word](VSRTL_VT_U v) {
+      return word ? v & 0xFFFFFFFFUL : v;
+    };
+    switch (op) {
+    case MemOp::AMOADD_W:
+    case MemOp::AMOADD_D:
+      return old + value;
+    case MemOp::AMOXOR_W:
+    case MemOp::AMOXOR_D:
+      return old ^ value;
+    case MemOp::AMOAND_W:
+    case MemOp::AMOAND_D:
+      return old & value;
+    case MemOp::AMOOR_W:
+    case MemOp::AMOOR_D:
+      return old | value;
+    case MemOp::AMOMIN_W:
+    case MemOp::AMOMIN_D:
+      return sext(old) < sext(value) ? old : value;
+    case MemOp::AMOMAX_W:
+    case MemOp::AMOMAX_D:
+      return sext(old) > sext(value) ? old : value;
+    case MemOp::AMOMINU_W:
+    case MemOp::AMOMINU_D:
+      return zext(old) < zext(value) ? old : value;
+    case MemOp::AMOMAXU_W:
+    case MemOp::AMOMAXU_D:
+      return zext(old) > zext(value) ? old : value;
+    default:
+      // Stores, store-conditionals and swaps write the operand.
+      return value;
+    }
+  }
+
+  /// Whether the store-conditional being performed holds the reservation.
+  bool scSucceeds() const {
+    return res_valid->out.uValue() && res_addr->out.uValue() == addr.uValue() &&
+           res_bytes->out.uValue() == atomicBytes(op.eValue<MemOp>());
+  }
+
   void setMemory(AddressSpace *addressSpace) {
     setMemory(addressSpace);
     mem->setMemory(addressSpace);
@@ -66,7 +211,7 @@ public:
   // of the memory operation that is happening, while the underlying
   // MemoryAsyncRd does not.
   VSRTL_VT_U addressSig() const override { return addr.uValue(); };
-  VSRTL_VT_U wrEnSig() const override { return wr_en.uValue(); };
+  VSRTL_VT_U wrEnSig() const override { return wr_en_sc->out.uValue(); };
   VSRTL_VT_U opSig() const override { return op.uValue(); };
   AddressSpace::RegionType accessRegion() const override {
     return mem->accessRegion();
@@ -74,7 +219,17 @@ public:
 
   SUBCOMPONENT(mem, TYPE(MemoryAsyncRd<addrWidth, dataWidth>));
 
+  // Reservation of the last load-reserved
+  SUBCOMPONENT(res_valid, Register<1>);
+  SUBCOMPONENT(res_addr, Register<addrWidth>);
+  SUBCOMPONENT(res_bytes, Register<ceillog2(dataWidth / 8 + 1)>);
+
   WIRE(wr_width, ceillog2(dataWidth / 8 + 1)); // Write width, in bytes
+  WIRE(wr_en_sc, 1);
+  WIRE(amo_data, dataWidth);
+  WIRE(res_valid_next, 1);
+  WIRE(res_addr_next, addrWidth);
+  WIRE(res_bytes_next, ceillog2(dataWidth / 8 + 1));
 
   INPUTPORT(addr, addrWidth);
   INPUTPORT(data_in, dataWidth);
@@ -0,0 +1,764 @@
+#pragma once
+
+#include <array>
+#include <climits>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "processors/RISC-V/riscv.h"
+#include "processors/RISC-V/rv_decode.h"
+#include "processors/RISC-V/rv_uncompress.h"
+#include "processors/interface/ripesprocessor.h"
+#include "processors/interface/sharedaddressspace.h"
+
+namespace Ripes {
+
+/**
+ * @brief The RVSSInterpreter class
+ * An instruction-level implementation of the single-cycle RISC-V processor
+ * (RVSS). Rather than evaluating the VSRTL circuit of the processor each cycle,
+ * instructions are decoded once into a handler of a dispatch table and their
+ * operands, and executed directly on the architectural state of the processor.
+ * Decoded instructions are kept in a direct-mapped cache indexed by the
+ * program counter.
+ *
+ * The interpreter retires one instruction per cycle, as RVSS, and reports the
+ * same memory accesses, but has no circuit to visualize and is not reversible.
+ * It is intended for long-running simulations without a GUI attached.
+ *
+ * Multiple interpreters may share their memory as the harts of a multi-hart
+ * system (see joinHarts). Decoded instructions are private to each hart, such
+ * that code modified by another hart is not observed.
+ */
+template <typename XLEN_T>
+class RVSSInterpreter : public RipesProcessor {
+  static_assert(std::is_same<uint32_t, XLEN_T>::value ||
+                    std::is_same<uint64_t, XLEN_T>::value,
+                "Only supports 32- and 64-bit variants");
+  static constexpr unsigned XLEN = sizeof(XLEN_T) * CHAR_BIT;
+  using SXLEN_T = std::make_signed_t<XLEN_T>;
+
+  struct DecodedInstr;
+  using Handler = void (*)(RVSSInterpreter &, const DecodedInstr &);
+
+  /**
+   * @brief The DecodedInstr struct
+   * An entry of the decode cache. An entry is valid if its generation matches
+   * the current generation of the cache.
+   */
+  struct DecodedInstr {
+    XLEN_T pc = 0;
+    unsigned generation = 0;
+    RVInstr opcode = RVInstr::NOP;
+    Handler handler = nullptr;
+    XLEN_T imm = 0;
+    uint8_t rd = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+    // Size of the instruction in bytes; 2 for compressed instructions.
+    uint8_t bytes = 0;
+    // Size of the data memory access of the instruction in bytes; 0 if the
+    // instruction does not access data memory.
+    uint8_t memBytes = 0;
+    bool memWrite = false;
+  };
+
+  static constexpr unsigned s_decodeCacheSize = 1 << 14;
+  static constexpr unsigned s_numInstrs =
+      static_cast<unsigned>(RVInstr::UNK) + 1;
+
+public:
+  RVSSInterpreter(const QStringList &extensions) {
+    m_enabledISA = ISAInfoRegistry::getISA<XLenToRVISA<XLEN>()>(extensions);
+    m_extM = m_enabledISA->extensionEnabled("M");
+    m_extA = m_enabledISA->extensionEnabled("A");
+    m_extC = m_enabledISA->extensionEnabled("C");
+    m_features = Features::hasDCacheInterface | Features::hasICacheInterface;
+    m_decodeCache.resize(s_decodeCacheSize);
+  }
+
+  // Ripes interface compliance
+  const ProcessorStructure &structure() const override { return m_structure; }
+  unsigned int getPcForStage(StageIndex) const override { return m_pc; }
+  AInt nextFetchedAddress() const override {
+    const DecodedInstr &d = decode(m_pc);
+    switch (d.opcode) {
+    case RVInstr::JAL:
+      return static_cast<XLEN_T>(d.pc + d.imm);
+    case RVInstr::JALR:
+      return static_cast<XLEN_T>((m_regs[d.rs1] + d.imm) & ~XLEN_T(1));
+    case RVInstr::BEQ:
+    case RVInstr::BNE:
+    case RVInstr::BLT:
+    case RVInstr::BGE:
+    case RVInstr::BLTU:
+    case RVInstr::BGEU:
+      if (branchTaken(d.opcode, m_regs[d.rs1], m_regs[d.rs2]))
+        return static_cast<XLEN_T>(d.pc + d.imm);
+      break;
+    default:
+      break;
+    }
+    return static_cast<XLEN_T>(d.pc + d.bytes);
+  }
+  QString stageName(StageIndex) const override { return "•"; }
+  StageInfo stageInfo(StageIndex) const override {
+    return StageInfo({m_pc, isExecutableAddress(m_pc), StageInfo::State::None});
+  }
+  void setProgramCounter(AInt address) override {
+    m_pc = static_cast<XLEN_T>(address);
+  }
+  void setPCInitialValue(AInt address) override {
+    m_pcInitialValue = static_cast<XLEN_T>(address);
+  }
+  vsrtl::core::AddressSpaceMM &getMemory() override { return *m_memory; }
+  std::shared_ptr<SharedAddressSpace> sharedMemory() override {
+    return m_memory;
+  }
+  bool joinHarts(const std::shared_ptr<SharedAddressSpace> &memory,
+                 unsigned hartId) override {
+    m_memory = memory;
+    m_hartId = hartId;
+    invalidateDecodeCache();
+    return true;
+  }
+  VInt getRegister(const std::string_view &, unsigned i) const override {
+    return m_regs[i];
+  }
+  void setRegister(const std::string_view &, unsigned i, VInt v) override {
+    if (i != 0)
+      m_regs[i] = static_cast<XLEN_T>(v);
+  }
+  void finalize(FinalizeReason fr) override {
+    if (fr == FinalizeReason::exitSyscall) {
+      // Finalization is requested while the exit syscall is executed; finish
+      // once the current instruction has retired.
+      m_finishAfterThisInstr = true;
+    }
+  }
+  bool finished() const override {
+    return m_finished || !isExecutableAddress(m_pc);
+  }
+  const std::vector<StageIndex> breakpointTriggeringStages() const override {
+    return {{0, 0}};
+  }
+
+  /// Specialized for the single stage of the interpreter, and dispatches
+  /// directly to its (non-virtual) clock implementation.
+  StopReason clockN(unsigned long long n,
+                    const StopConditions &conditions) override {
+    const auto *breakpoints =
+        conditions.breakpoints && !conditions.breakpoints->empty()
+            ? conditions.breakpoints
+            : nullptr;
+    for (; n > 0; --n) {
+      if (RVSSInterpreter::finished())
+        return StopReason::Finished;
+      if (breakpoints && breakpoints->count(m_pc))
+        return StopReason::Breakpoint;
+      if (conditions.stop && conditions.stop->load(std::memory_order_relaxed))
+        return StopReason::Stopped;
+      if (conditions.trigger && (*conditions.trigger)())
+        return StopReason::Triggered;
+      RVSSInterpreter::clockProcessor();
+    }
+    return StopReason::Cycles;
+  }
+
+  /// As for RVSS, memory accesses are reported for the instruction which is
+  /// about to be executed.
+  MemoryAccess dataMemAccess() const override {
+    const DecodedInstr &d = decode(m_pc);
+    MemoryAccess access;
+    if (d.memBytes != 0) {
+      access.type = d.memWrite ? MemoryAccess::Write : MemoryAccess::Read;
+      access.bytes = d.memBytes;
+      access.address = static_cast<XLEN_T>(m_regs[d.rs1] + d.imm);
+      access.pc = d.pc;
+    }
+    return access;
+  }
+  MemoryAccess instrMemAccess() const override {
+    MemoryAccess access;
+    access.type = MemoryAccess::Read;
+    access.address = m_pc;
+    access.bytes = c_RVInstrWidth / CHAR_BIT;
+    return access;
+  }
+
+  void resetProcessor() override {
+    if (m_hartId == 0) {
+      m_memory->reset();
+      m_memory->clearWrittenBlocks();
+    } else {
+      m_memory->clearReservation(m_hartId);
+    }
+    m_regs.fill(0);
+    m_pc = m_pcInitialValue;
+    m_cycleCount = 0;
+    m_instructionsRetired = 0;
+    m_finishAfterThisInstr = false;
+    m_finished = false;
+    invalidateDecodeCache();
+    if (m_emitsSignals)
+      processorWasReset.Emit();
+  }
+
+  long long getInstructionsRetired() const override {
+    return m_instructionsRetired;
+  }
+  long long getCycleCount() const override { return m_cycleCount; }
+
+  static ProcessorISAInfo supportsISA() { return RVISA::supportsISA<XLEN>(); }
+  std::shared_ptr<ISAInfoBase> implementsISA() const override {
+    return m_enabledISA;
+  }
+  std::shared_ptr<const ISAInfoBase> fullISA() const override {
+    return RVISA::fullISA<XLEN>();
+  }
+
+  const std::set<std::string_view> registerFiles() const override {
+    std::set<std::string_view> rfs;
+    rfs.insert(RVISA::GPR);
+
+    if (implementsISA()->extensionEnabled("F")) {
+      rfs.insert(RVISA::FPR);
+    }
+    return rfs;
+  }
+
+protected:
+  void clockProcessor() override {
+    const DecodedInstr &d = decode(m_pc);
+    m_nextPc = static_cast<XLEN_T>(d.pc + d.bytes);
+    d.handler(*this, d);
+    m_regs[0] = 0;
+    m_pc = m_nextPc;
+
+    // Single cycle processor; 1 instruction retired per cycle!
+    m_cycleCount++;
+    m_instructionsRetired++;
+    if (m_finishAfterThisInstr)
+      m_finished = true;
+
+    if (m_emitsSignals)
+      processorWasClocked.Emit();
+  }
+
+private:
+  static unsigned decodeCacheIndex(XLEN_T pc) {
+    return (pc >> 1) & (s_decodeCacheSize - 1);
+  }
+
+  /**
+   * @brief decode
+   * @returns the decoded instruction at @p pc, decoding it on a miss in the
+   * decode cache.
+   */
+  const DecodedInstr &decode(XLEN_T pc) const {
+    DecodedInstr &d = m_decodeCache[decodeCacheIndex(pc)];
+    if (d.generation == m_generation && d.pc == pc)
+      return d;
+
+    // Instructions are fetched as a full word, as is done by the instruction
+    // memory of RVSS.
+    const VInt word = m_memory->readMem(pc, c_RVInstrWidth / CHAR_BIT);
+    VInt instr = word;
+    d.bytes = 4;
+    if (m_extC) {
+      instr = vsrtl::core::Uncompress<XLEN>::uncompress(word);
+      if ((word & 0b11) != 0b11 && word != 0)
+        d.bytes = 2;
+    }
+
+    d.pc = pc;
+    d.generation = m_generation;
+    d.opcode =
+        vsrtl::core::Decode<XLEN>::decodeOpcode(instr, m_extM, m_extA);
+    d.handler = dispatchTable()[static_cast<unsigned>(d.opcode)];
+    d.rd = (instr >> 7) & 0b11111;
+    d.rs1 = (instr >> 15) & 0b11111;
+    d.rs2 = (instr >> 20) & 0b11111;
+    d.imm = immediate(instr);
+    d.memBytes = 0;
+    d.memWrite = false;
+    switch (d.opcode) {
+    case RVInstr::LB:
+    case RVInstr::LBU:
+      d.memBytes = 1;
+      break;
+    case RVInstr::LH:
+    case RVInstr::LHU:
+      d.memBytes = 2;
+      break;
+    case RVInstr::LW:
+    case RVInstr::LWU:
+      d.memBytes = 4;
+      break;
+    case RVInstr::LD:
+      d.memBytes = 8;
+      break;
+    case RVInstr::SB:
+      d.memBytes = 1;
+      d.memWrite = true;
+      break;
+    case RVInstr::SH:
+      d.memBytes = 2;
+      d.memWrite = true;
+      break;
+    case RVInstr::SW:
+      d.memBytes = 4;
+      d.memWrite = true;
+      break;
+    case RVInstr::SD:
+      d.memBytes = 8;
+      d.memWrite = true;
+      break;
+    default:
+      // Store-conditionals and AMOs are accounted as writes, as in RVSS.
+      if (const auto atomic = atomicOp(d.opcode)) {
+        d.memBytes = atomic->bytes;
+        d.memWrite = atomic->kind != AtomicKind::LoadReserved;
+      }
+      break;
+    }
+    return d;
+  }
+
+  /// Invalidates all entries of the decode cache.
+  void invalidateDecodeCache() {
+    if (++m_generation == 0) {
+      // Generation counter wrapped around; entries of old generations could
+      // alias the new generation.
+      for (auto &d : m_decodeCache)
+        d.generation = 0;
+      m_generation = 1;
+    }
+  }
+
+  /// Invalidates any decoded instruction overlapping the bytes [address,
+  /// address + bytes[. Instructions are 2-byte aligned, and span the 4 bytes
+  /// which are fetched.
+  void invalidateDecoded(XLEN_T address, unsigned bytes) {
+    const XLEN_T first = address >= 3 ? (address - 3) & ~XLEN_T(1) : 0;
+    for (XLEN_T pc = first; pc < address + bytes; pc += 2) {
+      DecodedInstr &d = m_decodeCache[decodeCacheIndex(pc)];
+      if (d.pc == pc)
+        d.generation = 0;
+    }
+  }
+
+  /// Returns the sign-extended immediate of the (uncompressed) instruction
+  /// @p instr, based on the instruction format of its opcode.
+  static XLEN_T immediate(VInt instr) {
+    const auto sext = [](VInt value, unsigned bits) {
+      const VInt signBit = VInt(1) << (bits - 1);
+      return static_cast<XLEN_T>((value ^ signBit) - signBit);
+    };
+    switch (instr & 0b1111111) {
+    case RVISA::OpcodeID::LUI:
+    case RVISA::OpcodeID::AUIPC:
+      return sext(instr & 0xFFFFF000, 32);
+    case RVISA::OpcodeID::JAL:
+      return sext(((instr >> 31) & 0x1) << 20 | ((instr >> 12) & 0xFF) << 12 |
+                      ((instr >> 20) & 0x1) << 11 |
+                      ((instr >> 21) & 0x3FF) << 1,
+                  21);
+    case RVISA::OpcodeID::BRANCH:
+      return sext(((instr >> 31) & 0x1) << 12 | ((instr >> 7) & 0x1) << 11 |
+                      ((instr >> 25) & 0x3F) << 5 | ((instr >> 8) & 0xF) << 1,
+                  13);
+    case RVISA::OpcodeID::STORE:
+      return sext(((instr >> 25) & 0x7F) << 5 | ((instr >> 7) & 0x1F), 12);
+    case RVISA::OpcodeID::AMO:
+      // Atomic instructions address memory at rs1 + 0; the immediate bits
+      // hold funct5, aq/rl and rs2.
+      return 0;
+    default:
+      return sext((instr >> 20) & 0xFFF, 12);
+    }
+  }
+
+  static XLEN_T sext32(uint32_t value) {
+    return static_cast<XLEN_T>(
+        static_cast<SXLEN_T>(static_cast<int32_t>(value)));
+  }
+
+  static bool branchTaken(RVInstr opcode, XLEN_T a, XLEN_T b) {
+    switch (opcode) {
+    case RVInstr::BEQ:
+      return a == b;
+    case RVInstr::BNE:
+      return a != b;
+    case RVInstr::BLT:
+      return static_cast<SXLEN_T>(a) < static_cast<SXLEN_T>(b);
+    case RVInstr::BGE:
+      return static_cast<SXLEN_T>(a) >= static_cast<SXLEN_T>(b);
+    case RVInstr::BLTU:
+      return a < b;
+    case RVInstr::BGEU:
+      return a >= b;
+    default:
+      return false;
+    }
+  }
+
+  /// Returns the upper XLEN bits of the unsigned product of @p a and @p b.
+  static XLEN_T mulhu(XLEN_T a, XLEN_T b) {
+    if constexpr (XLEN == 32) {
+      return static_cast<XLEN_T>((uint64_t(a) * uint64_t(b)) >> 32);
+    } else {
+      const uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+      const uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+      const uint64_t loLo = aLo * bLo;
+      const uint64_t hiLo = aHi * bLo;
+      const uint64_t loHi = aLo * bHi;
+      const uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+      return aHi * bHi + (hiLo >> 32) + (cross >> 32);
+    }
+  }
+
+  template <typename T>
+  static void execLoad(RVSSInterpreter &p, const DecodedInstr &d) {
+    const XLEN_T address = p.m_regs[d.rs1] + d.imm;
+    const VInt value = p.m_memory->readMem(address, sizeof(T));
+    // Narrow to the accessed type, and sign- or zero-extend to XLEN.
+    p.m_regs[d.rd] = static_cast<XLEN_T>(static_cast<T>(value));
+  }
+
+  template <typename T>
+  static void execStore(RVSSInterpreter &p, const DecodedInstr &d) {
+    const XLEN_T address = p.m_regs[d.rs1] + d.imm;
+    p.m_memory->writeMem(address, static_cast<T>(p.m_regs[d.rs2]), sizeof(T));
+    p.invalidateDecoded(address, sizeof(T));
+  }
+
+  template <typename T>
+  static void execLoadReserved(RVSSInterpreter &p, const DecodedInstr &d) {
+    const VInt value =
+        p.m_memory->loadReserved(p.m_hartId, p.m_regs[d.rs1], sizeof(T));
+    p.m_regs[d.rd] = static_cast<XLEN_T>(static_cast<T>(value));
+  }
+
+  template <typename T>
+  static void execStoreConditional(RVSSInterpreter &p, const DecodedInstr &d) {
+    const XLEN_T address = p.m_regs[d.rs1];
+    const bool stored = p.m_memory->storeConditional(
+        p.m_hartId, address, static_cast<T>(p.m_regs[d.rs2]), sizeof(T));
+    if (stored)
+      p.invalidateDecoded(address, sizeof(T));
+    p.m_regs[d.rd] = stored ? 0 : 1;
+  }
+
+  /// Executes an AMO on a T; the (sign-extended) prior value is written to rd.
+  template <typename T, SharedAddressSpace::AtomicOp op>
+  static void execAtomic(RVSSInterpreter &p, const DecodedInstr &d) {
+    const XLEN_T address = p.m_regs[d.rs1];
+    const VInt old = p.m_memory->atomic(
+        op, address, static_cast<T>(p.m_regs[d.rs2]), sizeof(T));
+    p.invalidateDecoded(address, sizeof(T));
+    p.m_regs[d.rd] = static_cast<XLEN_T>(static_cast<T>(old));
+  }
+
+  enum class AtomicKind { LoadReserved, StoreConditional, AMO };
+  struct AtomicInfo {
+    AtomicKind kind;
+    unsigned bytes;
+  };
+  /// @returns the kind and width of atomic instruction @p opcode, if atomic.
+  static std::optional<AtomicInfo> atomicOp(RVInstr opcode) {
+    if (opcode == RVInstr::LR_W || opcode == RVInstr::LR_D)
+      return AtomicInfo{AtomicKind::LoadReserved,
+                        opcode == RVInstr::LR_W ? 4u : 8u};
+    if (opcode == RVInstr::SC_W || opcode == RVInstr::SC_D)
+      return AtomicInfo{AtomicKind::StoreConditional,
+                        opcode == RVInstr::SC_W ? 4u : 8u};
+    if (opcode >= RVInstr::AMOSWAP_W && opcode <= RVInstr::AMOMAXU_W)
+      return AtomicInfo{AtomicKind::AMO, 4};
+    if (opcode >= RVInstr::AMOSWAP_D && opcode <= RVInstr::AMOMAXU_D)
+      return AtomicInfo{AtomicKind::AMO, 8};
+    return std::nullopt;
+  }
+
+  static void execBranch(RVSSInterpreter &p, const DecodedInstr &d) {
+    if (branchTaken(d.opcode, p.m_regs[d.rs1], p.m_regs[d.rs2]))
+      p.m_nextPc = d.pc + d.imm;
+  }
+
+  /**
+   * @brief dispatchTable
+   * @returns the handlers of all instructions, indexed by RVInstr. Unknown
+   * instructions are executed as NOPs.
+   */
+  static const std::array<Handler, s_numInstrs> &dispatchTable() {
+    static const std::array<Handler, s_numInstrs> table = [] {
+      using P = RVSSInterpreter;
+      using D = DecodedInstr;
+      std::array<Handler, s_numInstrs> t;
+      const auto op = [&t](RVInstr instr) -> Handler & {
+        return t[static_cast<unsigned>(instr)];
+      };
+      t.fill([](P &, const D &) {});
+
+      // Control flow
+      op(RVInstr::LUI) = [](P &p, const D &d) { p.m_regs[d.rd] = d.imm; };
+      op(RVInstr::AUIPC) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = d.pc + d.imm;
+      };
+      op(RVInstr::JAL) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = d.pc + d.bytes;
+        p.m_nextPc = d.pc + d.imm;
+      };
+      op(RVInstr::JALR) = [](P &p, const D &d) {
+        const XLEN_T target = (p.m_regs[d.rs1] + d.imm) & ~XLEN_T(1);
+        p.m_regs[d.rd] = d.pc + d.bytes;
+        p.m_nextPc = target;
+      };
+      for (auto instr : {RVInstr::BEQ, RVInstr::BNE, RVInstr::BLT,
+                         RVInstr::BGE, RVInstr::BLTU, RVInstr::BGEU})
+        op(instr) = &P::execBranch;
+      op(RVInstr::ECALL) = [](P &p, const D &) { p.trapHandler(); };
+
+      // Memory
+      op(RVInstr::LB) = &execLoad<int8_t>;
+      op(RVInstr::LH) = &execLoad<int16_t>;
+      op(RVInstr::LW) = &execLoad<int32_t>;
+      op(RVInstr::LD) = &execLoad<int64_t>;
+      op(RVInstr::LBU) = &execLoad<uint8_t>;
+      op(RVInstr::LHU) = &execLoad<uint16_t>;
+      op(RVInstr::LWU) = &execLoad<uint32_t>;
+      op(RVInstr::SB) = &execStore<uint8_t>;
+      op(RVInstr::SH) = &execStore<uint16_t>;
+      op(RVInstr::SW) = &execStore<uint32_t>;
+      op(RVInstr::SD) = &execStore<uint64_t>;
+
+      // Atomics
+      using A = SharedAddressSpace::AtomicOp;
+      op(RVInstr::LR_W) = &execLoadReserved<int32_t>;
+      op(RVInstr::SC_W) = &execStoreConditional<int32_t>;
+      op(RVInstr::AMOSWAP_W) = &execAtomic<int32_t, A::Swap>;
+      op(RVInstr::AMOADD_W) = &execAtomic<int32_t, A::Add>;
+      op(RVInstr::AMOXOR_W) = &execAtomic<int32_t, A::Xor>;
+      op(RVInstr::AMOAND_W) = &execAtomic<int32_t, A::And>;
+      op(RVInstr::AMOOR_W) = &execAtomic<int32_t, A::Or>;
+      op(RVInstr::AMOMIN_W) = &execAtomic<int32_t, A::Min>;
+      op(RVInstr::AMOMAX_W) = &execAtomic<int32_t, A::Max>;
+      op(RVInstr::AMOMINU_W) = &execAtomic<int32_t, A::MinU>;
+      op(RVInstr::AMOMAXU_W) = &execAtomic<int32_t, A::MaxU>;
+      if constexpr (XLEN == 64) {
+        op(RVInstr::LR_D) = &execLoadReserved<int64_t>;
+        op(RVInstr::SC_D) = &execStoreConditional<int64_t>;
+        op(RVInstr::AMOSWAP_D) = &execAtomic<int64_t, A::Swap>;
+        op(RVInstr::AMOADD_D) = &execAtomic<int64_t, A::Add>;
+        op(RVInstr::AMOXOR_D) = &execAtomic<int64_t, A::Xor>;
+        op(RVInstr::AMOAND_D) = &execAtomic<int64_t, A::And>;
+        op(RVInstr::AMOOR_D) = &execAtomic<int64_t, A::Or>;
+        op(RVInstr::AMOMIN_D) = &execAtomic<int64_t, A::Min>;
+        op(RVInstr::AMOMAX_D) = &execAtomic<int64_t, A::Max>;
+        op(RVInstr::AMOMINU_D) = &execAtomic<int64_t, A::MinU>;
+        op(RVInstr::AMOMAXU_D) = &execAtomic<int64_t, A::MaxU>;
+      }
+
+      // Register-immediate
+      op(RVInstr::ADDI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] + d.imm;
+      };
+      op(RVInstr::SLTI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = static_cast<SXLEN_T>(p.m_regs[d.rs1]) <
+                         static_cast<SXLEN_T>(d.imm);
+      };
+      op(RVInstr::SLTIU) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] < d.imm;
+      };
+      op(RVInstr::XORI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] ^ d.imm;
+      };
+      op(RVInstr::ORI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] | d.imm;
+      };
+      op(RVInstr::ANDI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] & d.imm;
+      };
+      op(RVInstr::SLLI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] << (d.imm & (XLEN - 1));
+      };
+      op(RVInstr::SRLI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] >> (d.imm & (XLEN - 1));
+      };
+      op(RVInstr::SRAI) = [](P &p, const D &d) {
+        p.m_regs[d.rd] =
+            static_cast<SXLEN_T>(p.m_regs[d.rs1]) >> (d.imm & (XLEN - 1));
+      };
+
+      // Register-register
+      op(RVInstr::ADD) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] + p.m_regs[d.rs2];
+      };
+      op(RVInstr::SUB) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] - p.m_regs[d.rs2];
+      };
+      op(RVInstr::SLL) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] << (p.m_regs[d.rs2] & (XLEN - 1));
+      };
+      op(RVInstr::SLT) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = static_cast<SXLEN_T>(p.m_regs[d.rs1]) <
+                         static_cast<SXLEN_T>(p.m_regs[d.rs2]);
+      };
+      op(RVInstr::SLTU) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] < p.m_regs[d.rs2];
+      };
+      op(RVInstr::XOR) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] ^ p.m_regs[d.rs2];
+      };
+      op(RVInstr::SRL) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] >> (p.m_regs[d.rs2] & (XLEN - 1));
+      };
+      op(RVInstr::SRA) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = static_cast<SXLEN_T>(p.m_regs[d.rs1]) >>
+                         (p.m_regs[d.rs2] & (XLEN - 1));
+      };
+      op(RVInstr::OR) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] | p.m_regs[d.rs2];
+      };
+      op(RVInstr::AND) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] & p.m_regs[d.rs2];
+      };
+
+      // M extension
+      op(RVInstr::MUL) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = p.m_regs[d.rs1] * p.m_regs[d.rs2];
+      };
+      op(RVInstr::MULHU) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = mulhu(p.m_regs[d.rs1], p.m_regs[d.rs2]);
+      };
+      op(RVInstr::MULH) = [](P &p, const D &d) {
+        const XLEN_T a = p.m_regs[d.rs1], b = p.m_regs[d.rs2];
+        p.m_regs[d.rd] = mulhu(a, b) - (static_cast<SXLEN_T>(a) < 0 ? b : 0) -
+                         (static_cast<SXLEN_T>(b) < 0 ? a : 0);
+      };
+      op(RVInstr::MULHSU) = [](P &p, const D &d) {
+        const XLEN_T a = p.m_regs[d.rs1], b = p.m_regs[d.rs2];
+        p.m_regs[d.rd] = mulhu(a, b) - (static_cast<SXLEN_T>(a) < 0 ? b : 0);
+      };
+      op(RVInstr::DIV) = [](P &p, const D &d) {
+        const auto a = static_cast<SXLEN_T>(p.m_regs[d.rs1]);
+        const auto b = static_cast<SXLEN_T>(p.m_regs[d.rs2]);
+        if (b == 0)
+          p.m_regs[d.rd] = ~XLEN_T(0);
+        else if (a == std::numeric_limits<SXLEN_T>::min() && b == -1)
+          p.m_regs[d.rd] = a; // Overflow
+        else
+          p.m_regs[d.rd] = a / b;
+      };
+      op(RVInstr::DIVU) = [](P &p, const D &d) {
+        const XLEN_T a = p.m_regs[d.rs1], b = p.m_regs[d.rs2];
+        p.m_regs[d.rd] = b == 0 ? ~XLEN_T(0) : a / b;
+      };
+      op(RVInstr::REM) = [](P &p, const D &d) {
+        const auto a = static_cast<SXLEN_T>(p.m_regs[d.rs1]);
+        const auto b = static_cast<SXLEN_T>(p.m_regs[d.rs2]);
+        if (b == 0)
+          p.m_regs[d.rd] = a;
+        else if (a == std::numeric_limits<SXLEN_T>::min() && b == -1)
+          p.m_regs[d.rd] = 0; // Overflow
+        else
+          p.m_regs[d.rd] = a % b;
+      };
+      op(RVInstr::REMU) = [](P &p, const D &d) {
+        const XLEN_T a = p.m_regs[d.rs1], b = p.m_regs[d.rs2];
+        p.m_regs[d.rd] = b == 0 ? a : a % b;
+      };
+
+      // 32-bit operations of the 64-bit ISA. Results are sign-extended from
+      // 32 bits.
+      op(RVInstr::ADDIW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(p.m_regs[d.rs1] + d.imm);
+      };
+      op(RVInstr::SLLIW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(uint32_t(p.m_regs[d.rs1]) << (d.imm & 31));
+      };
+      op(RVInstr::SRLIW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(uint32_t(p.m_regs[d.rs1]) >> (d.imm & 31));
+      };
+      op(RVInstr::SRAIW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(int32_t(p.m_regs[d.rs1]) >> (d.imm & 31));
+      };
+      op(RVInstr::ADDW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(p.m_regs[d.rs1] + p.m_regs[d.rs2]);
+      };
+      op(RVInstr::SUBW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] = sext32(p.m_regs[d.rs1] - p.m_regs[d.rs2]);
+      };
+      op(RVInstr::SLLW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] =
+            sext32(uint32_t(p.m_regs[d.rs1]) << (p.m_regs[d.rs2] & 31));
+      };
+      op(RVInstr::SRLW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] =
+            sext32(uint32_t(p.m_regs[d.rs1]) >> (p.m_regs[d.rs2] & 31));
+      };
+      op(RVInstr::SRAW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] =
+            sext32(int32_t(p.m_regs[d.rs1]) >> (p.m_regs[d.rs2] & 31));
+      };
+      op(RVInstr::MULW) = [](P &p, const D &d) {
+        p.m_regs[d.rd] =
+            sext32(uint32_t(p.m_regs[d.rs1]) * uint32_t(p.m_regs[d.rs2]));
+      };
+      op(RVInstr::DIVW) = [](P &p, const D &d) {
+        const auto a = int32_t(p.m_regs[d.rs1]), b = int32_t(p.m_regs[d.rs2]);
+        if (b == 0)
+          p.m_regs[d.rd] = ~XLEN_T(0);
+        else if (a == std::numeric_limits<int32_t>::min() && b == -1)
+          p.m_regs[d.rd] = sext32(a); // Overflow
+        else
+          p.m_regs[d.rd] = sext32(a / b);
+      };
+      op(RVInstr::DIVUW) = [](P &p, const D &d) {
+        const auto a = uint32_t(p.m_regs[d.rs1]), b = uint32_t(p.m_regs[d.rs2]);
+        p.m_regs[d.rd] = b == 0 ? ~XLEN_T(0) : sext32(a / b);
+      };
+      op(RVInstr::REMW) = [](P &p, const D &d) {
+        const auto a = int32_t(p.m_regs[d.rs1]), b = int32_t(p.m_regs[d.rs2]);
+        if (b == 0)
+          p.m_regs[d.rd] = sext32(a);
+        else if (a == std::numeric_limits<int32_t>::min() && b == -1)
+          p.m_regs[d.rd] = 0; // Overflow
+        else
+          p.m_regs[d.rd] = sext32(a % b);
+      };
+      op(RVInstr::REMUW) = [](P &p, const D &d) {
+        const auto a = uint32_t(p.m_regs[d.rs1]), b = uint32_t(p.m_regs[d.rs2]);
+        p.m_regs[d.rd] = sext32(b == 0 ? a : a % b);
+      };
+      return t;
+    }();
+    return table;
+  }
+
+  // Writes are tracked, such that the state of the interpreter may be
+  // transferred to another processor (see ArchitecturalState).
+  std::shared_ptr<SharedAddressSpace> m_memory =
+      std::make_shared<SharedAddressSpace>();
+  unsigned m_hartId = 0;
+  std::array<XLEN_T, c_RVRegs> m_regs{};
+  XLEN_T m_pc = 0;
+  XLEN_T m_nextPc = 0;
+  XLEN_T m_pcInitialValue = 0;
+  long long m_cycleCount = 0;
+  long long m_instructionsRetired = 0;
+
+  mutable std::vector<DecodedInstr> m_decodeCache;
+  unsigned m_generation = 1;
+
+  bool m_extM = false;
+  bool m_extA = false;
+  bool m_extC = false;
+  bool m_finishAfterThisInstr = false;
+  bool m_finished = false;
+  std::shared_ptr<ISAInfoBase> m_enabledISA;
+  ProcessorStructure m_structure = {{0, 1}};
+};
+
+} // namespace Ripes
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include "ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The WriteTrackingAddressSpace class
+ * An address space which records the blocks of memory that have been written
+ * since the written blocks were last cleared. Together with the initialization
+ * memories of the address space, the written blocks describe the full memory
+ * state of a program, which allows for transferring it to another processor.
+ */
+class WriteTrackingAddressSpace : public vsrtl::core::AddressSpaceMM {
+public:
+  static constexpr unsigned s_blockBytes = 64;
+
+  void writeMem(VInt address, VInt value, int size = sizeof(VInt)) override {
+    const AInt lastBlock = (address + size - 1) / s_blockBytes;
+    for (AInt block = address / s_blockBytes; block <= lastBlock; ++block) {
+      // Stores tend to hit the same block repeatedly; avoid hashing these.
+      if (block != m_lastWrittenBlock)
+        m_writtenBlocks.insert(block);
+      m_lastWrittenBlock = block;
+    }
+    vsrtl::core::AddressSpaceMM::writeMem(address, value, size);
+  }
+
+  /// Indices (address / s_blockBytes) of the blocks which have been written.
+  const std::unordered_set<AInt> &writtenBlocks() const {
+    return m_writtenBlocks;
+  }
+
+  /// Clears the set of written blocks, such that the current contents of the
+  /// address space are considered its initial state. Should be called after
+  /// the address space has been reset.
+  void clearWrittenBlocks() {
+    m_writtenBlocks.clear();
+    m_lastWrittenBlock = ~AInt(0);
+  }
+
+protected:
+  /// @returns true if all blocks spanned by the @p size bytes at @p address
+  /// have been written.
+  bool written(AInt address, unsigned size) const {
+    const AInt lastBlock = (address + size - 1) / s_blockBytes;
+    for (AInt block = address / s_blockBytes; block <= lastBlock; ++block)
+      if (!m_writtenBlocks.count(block))
+        return false;
+    return true;
+  }
+
+private:
+  std::unordered_set<AInt> m_writtenBlocks;
+  AInt m_lastWrittenBlock = ~AInt(0);
+};
+
+/**
+ * @brief The ArchitecturalState struct
+ * The architectural state of a processor executing a program; its registers,
+ * program counter and the memory which the program has written. Memory is
+ * captured relative to the initialization memories of the program, and may
+ * thus only be restored into a processor which has been reset with the same
+ * program loaded. The state of memory mapped IO devices is not captured.
+ */
+struct ArchitecturalState {
+  using Block = std::array<uint8_t, WriteTrackingAddressSpace::s_blockBytes>;
+
+  AInt pc = 0;
+  std::map<std::string_view, std::vector<VInt>> registers;
+  std::map<AInt, Block> memory;
+
+  /**
+   * @brief capture
+   * Captures the state of @p processor into @p state. The processor must be in
+   * a precise state, i.e., have no instructions in flight (as is the case for
+   * the single-cycle processors), such that the instruction in its first stage
+   * is the next instruction to execute. @returns false if the memory of
+   * @p processor does not track writes, in which case the state of its memory
+   * cannot be captured.
+   */
+  static bool capture(RipesProcessor &processor, ArchitecturalState &state) {
+    const auto *memory =
+        dynamic_cast<const WriteTrackingAddressSpace *>(&processor.getMemory());
+    if (!memory)
+      return false;
+
+    state.pc = processor.getPcForStage({0, 0});
+
+    state.registers.clear();
+    const auto isa = processor.implementsISA();
+    for (const auto &regFile : processor.registerFiles()) {
+      auto &values = state.registers[regFile];
+      const unsigned regCnt = isa->regInfo(regFile).value()->regCnt();
+      values.resize(regCnt);
+      for (unsigned i = 0; i < regCnt; ++i)
+        values[i] = processor.getRegister(regFile, i);
+    }
+
+    state.memory.clear();
+    for (const AInt block : memory->writtenBlocks()) {
+      auto &data = state.memory[block];
+      const AInt base = block * WriteTrackingAddressSpace::s_blockBytes;
+      for (unsigned i = 0; i < data.size(); ++i)
+        data[i] = memory->readMemConst(base + i, 1) & 0xFF;
+    }
+    return true;
+  }
+
+  /**
+   * @brief restore
+   * Restores this state into @p processor, which must have been reset with the
+   * program of the captured processor loaded. Execution of @p processor
+   * continues at the captured program counter.
+   */
+  void restore(RipesProcessor &processor) const {
+    for (const auto &[regFile, values] : registers)
+      for (unsigned i = 0; i < values.size(); ++i)
+        processor.setRegister(regFile, i, values[i]);
+
+    auto &mem = processor.getMemory();
+    for (const auto &[block, data] : memory) {
+      const AInt base = block * WriteTrackingAddressSpace::s_blockBytes;
+      for (unsigned i = 0; i < data.size(); i += sizeof(VInt)) {
+        VInt value = 0;
+        for (unsigned j = 0; j < sizeof(VInt); ++j)
+          value |= static_cast<VInt>(data[i + j]) << (j * CHAR_BIT);
+        mem.writeMem(base + i, value, sizeof(VInt));
+      }
+    }
+
+    processor.setProgramCounter(pc);
+  }
+};
+
+} // namespace Ripes
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * @brief The ProcessorSnapshot struct
+ * A snapshot of the state of a processor which is displayed by the GUI; its
+ * statistics, registers, stages and a set of memory pages. Snapshots are
+ * captured by the thread running the processor, such that the GUI may display
+ * the state of the processor while it is running without accessing it.
+ */
+struct ProcessorSnapshot {
+  static constexpr unsigned s_pageBytes = 256;
+  struct Page {
+    std::array<uint8_t, s_pageBytes> data;
+    // Bytes which are present in the memory of the processor.
+    std::bitset<s_pageBytes> present;
+  };
+
+  long long cycleCount = 0;
+  long long instructionsRetired = 0;
+  std::array<std::optional<long long>,
+             static_cast<unsigned>(RipesProcessor::PipelineEvent::NEvents)>
+      pipelineEvents;
+  std::map<std::string_view, std::vector<VInt>> registers;
+  std::map<StageIndex, StageInfo> stages;
+  // Indexed by address / s_pageBytes.
+  std::map<AInt, Page> pages;
+
+  /**
+   * @brief capture
+   * Captures the state of @p processor, including the memory pages with
+   * indices @p pageIndices. Storage of a previous capture is reused.
+   */
+  void capture(RipesProcessor &processor, const std::set<AInt> &pageIndices) {
+    cycleCount = processor.getCycleCount();
+    instructionsRetired = processor.getInstructionsRetired();
+    for (unsigned i = 0; i < pipelineEvents.size(); ++i)
+      pipelineEvents[i] = processor.pipelineEventCount(
+          static_cast<RipesProcessor::PipelineEvent>(i));
+
+    const auto isa = processor.implementsISA();
+    for (const auto &regFile : processor.registerFiles()) {
+      auto &values = registers[regFile];
+      values.resize(isa->regInfo(regFile).value()->regCnt());
+      for (unsigned i = 0; i < values.size(); ++i)
+        values[i] = processor.getRegister(regFile, i);
+    }
+
+    for (auto idx : processor.structure().stageIt())
+      stages[idx] = processor.stageInfo(idx);
+
+    // Drop pages which are no longer requested, and (re)capture the others.
+    for (auto it = pages.begin(); it != pages.end();)
+      it = pageIndices.count(it->first) ? std::next(it) : pages.erase(it);
+    auto &memory = processor.getMemory();
+    for (const AInt index : pageIndices) {
+      auto &page = pages[index];
+      const AInt base = index * s_pageBytes;
+      for (unsigned i = 0; i < s_pageBytes; ++i) {
+        // Only read present bytes; reading others would allocate them.
+        page.present[i] = memory.contains(base + i);
+        page.data[i] =
+            page.present[i] ? memory.readMemConst(base + i, 1) & 0xFF : 0;
+      }
+    }
+  }
+
+  /// Reads the byte at @p address into @p value. Returns false if the byte is
+  /// not part of a captured page, or is not present in memory.
+  bool readByte(AInt address, uint8_t &value) const {
+    const auto it = pages.find(address / s_pageBytes);
+    if (it == pages.end() || !it->second.present[address % s_pageBytes])
+      return false;
+    value = it->second.data[address % s_pageBytes];
+    return true;
+  }
+
+  /// Adds the indices of the pages covering [@p address, @p address +
+  /// @p bytes[ to @p indices.
+  static void pagesFor(AInt address, unsigned bytes, std::set<AInt> &indices) {
+    if (bytes == 0)
+      return;
+    const AInt last = (address + bytes - 1) / s_pageBytes;
+    for (AInt index = address / s_pageBytes; index <= last; ++index)
+      indices.insert(index);
+  }
+};
+
+} // namespace Ripes
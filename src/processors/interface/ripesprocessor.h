@@ -4,7 +4,11 @@
 
 #include "Signal.h"
 #include "VSRTL/core/vsrtl_design.h"
+#include <atomic>
+#include <functional>
 #include <map>
+#include <optional>
+#include <unordered_set>
 
 #include "../isa/isa_types.h"
 #include "../isa/isainfo.h"
@@ -12,6 +16,8 @@
 
 namespace Ripes {
 
+class SharedAddressSpace;
+
 /**
  * @brief The StageInfo struct
  * Contains information regarding the state of the instruction currently present
@@ -37,7 +43,9 @@ struct MemoryAccess {
   enum Type { None, Read, Write };
   Type type = None;
   AInt address;
-  unsigned bytes;
+  unsigned bytes = 0;
+  // The address of the instruction performing the access, if known.
+  AInt pc = 0;
 };
 
 /// A StageIndex denotes a unique stage within a processor.
@@ -226,6 +234,28 @@ public:
    */
   virtual vsrtl::core::AddressSpaceMM &getMemory() = 0;
 
+  /**
+   * @brief sharedMemory
+   * @returns the memory of the processor if it may be shared with other harts
+   * (see joinHarts), else nullptr.
+   */
+  virtual std::shared_ptr<SharedAddressSpace> sharedMemory() {
+    return nullptr;
+  }
+
+  /**
+   * @brief joinHarts
+   * Makes the processor hart @p hartId of a multi-hart system, replacing its
+   * memory by @p memory, which is shared by all harts. Memory is only reset by
+   * hart 0. @returns false if the processor cannot share its memory.
+   */
+  virtual bool joinHarts(const std::shared_ptr<SharedAddressSpace> &memory,
+                         unsigned hartId) {
+    Q_UNUSED(memory);
+    Q_UNUSED(hartId);
+    return false;
+  }
+
 
   virtual vsrtl::core::TrapChecker* getTrapChecker() { return nullptr; }
 
@@ -288,6 +318,54 @@ public:
       clockProcessor();
   }
 
+  /**
+   * @brief The StopConditions struct
+   * Conditions upon which clockN stops before having executed all cycles.
+   */
+  struct StopConditions {
+    // Clocking stops when the PC of a breakpoint triggering stage (see
+    // breakpointTriggeringStages) is in this set.
+    const std::unordered_set<AInt> *breakpoints = nullptr;
+    // Clocking stops when this flag is set.
+    const std::atomic<bool> *stop = nullptr;
+    // Clocking stops when this predicate returns true. Evaluated before each
+    // cycle, and should thus be cheap to evaluate.
+    const std::function<bool()> *trigger = nullptr;
+  };
+
+  enum class StopReason { Cycles, Finished, Breakpoint, Stopped, Triggered };
+
+  /**
+   * @brief clockN
+   * Clocks the processor for up to @p n cycles. Before each cycle, clocking
+   * stops if the processor has finished, or if one of @p conditions is met.
+   * Intended for running the processor without stepping through each cycle
+   * individually. @returns the reason for returning; StopReason::Cycles if all
+   * @p n cycles were executed.
+   */
+  virtual StopReason clockN(unsigned long long n,
+                            const StopConditions &conditions) {
+    const auto stages = breakpointTriggeringStages();
+    const auto *breakpoints =
+        conditions.breakpoints && !conditions.breakpoints->empty()
+            ? conditions.breakpoints
+            : nullptr;
+    for (; n > 0; --n) {
+      if (finished())
+        return StopReason::Finished;
+      if (breakpoints)
+        for (const auto &stage : stages)
+          if (breakpoints->count(getPcForStage(stage)))
+            return StopReason::Breakpoint;
+      if (conditions.stop && conditions.stop->load(std::memory_order_relaxed))
+        return StopReason::Stopped;
+      if (conditions.trigger && (*conditions.trigger)())
+        return StopReason::Triggered;
+      clockProcessor();
+    }
+    return StopReason::Cycles;
+  }
+
   /**
    * @brief finalize
    * Called from Ripes to indicate that the processor should start or stop its
@@ -321,6 +399,37 @@ public:
    */
   virtual long long getCycleCount() const = 0;
 
+  /**
+   * @brief The PipelineEvent enum
+   * Microarchitectural events counted by pipelined processors.
+   *  - DataHazardStall: cycles in which the hazard unit stalled the front end
+   *    due to a data (e.g., load-use) hazard.
+   *  - ControlFlush: control flow changes in the execute stage, flushing the
+   *    instructions fetched after the branch or jump.
+   *  - Forward: operands of instructions in the execute stage which were
+   *    forwarded from a later stage instead of being read in the decode stage.
+   *  - DualIssue: cycles in which both ways of a dual-issue processor execute
+   *    an instruction.
+   *  - WayHazard: cycles in which only one of a pair of fetched instructions
+   *    could be issued, due to a hazard between the two ways.
+   */
+  enum class PipelineEvent {
+    DataHazardStall,
+    ControlFlush,
+    Forward,
+    DualIssue,
+    WayHazard,
+    NEvents
+  };
+  /**
+   * @brief pipelineEventCount
+   * @returns the number of times that @p event has occurred during execution,
+   * or no value if the processor does not count the event.
+   */
+  virtual std::optional<long long> pipelineEventCount(PipelineEvent) const {
+    return {};
+  }
+
   /** ======================= Signals and callbacks ======================= */
   /**
    * @brief clocked, reversed & reset signals
@@ -331,6 +440,13 @@ public:
   Gallant::Signal0<> processorWasReversed;
   Gallant::Signal0<> processorWasReset;
 
+  /**
+   * @brief setEmitsSignals
+   * Enables or disables the emission of the above signals, i.e., for executing
+   * the processor without notifying any observers of its state.
+   */
+  void setEmitsSignals(bool enabled) { m_emitsSignals = enabled; }
+
   /**
    * @brief isExecutableAddress
    * Callback that the processor can use to query the Ripes environment. Returns
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "architecturalstate.h"
+
+namespace Ripes {
+
+/**
+ * @brief The SharedAddressSpace class
+ * An address space which may be shared by the harts of a multi-hart system,
+ * each of which runs on its own thread. Once made concurrent, an access to
+ * allocated memory only locks the stripes of the address space which it
+ * accesses, such that harts access unrelated addresses in parallel, while
+ * every access is atomic with respect to the accesses of other harts to the
+ * same address. Accesses which allocate memory, or which write a block for the
+ * first time, lock the address space exclusively.
+ *
+ * The address space also provides the memory side of the RISC-V A extension;
+ * atomic read-modify-write operations (AMOs) and load-reserved/
+ * store-conditional (LR/SC) pairs. A hart holds at most one reservation, which
+ * is invalidated by any write to the stripe of the reserved address.
+ */
+class SharedAddressSpace : public WriteTrackingAddressSpace {
+public:
+  enum class AtomicOp { Swap, Add, Xor, And, Or, Min, Max, MinU, MaxU };
+
+  /// Sets whether the address space is accessed by multiple threads, on behalf
+  /// of @p harts harts. Must not be changed while any hart is running.
+  void setConcurrent(bool concurrent, unsigned harts = 1) {
+    m_concurrent = concurrent;
+    if (m_reservations.size() < harts)
+      m_reservations.resize(harts);
+  }
+  bool concurrent() const { return m_concurrent; }
+
+  void writeMem(VInt address, VInt value, int size = sizeof(VInt)) override {
+    const AccessLock lock(*this, address, size, /*write=*/true);
+    write(lock, address, value, size);
+  }
+  VInt readMem(VInt address, unsigned width = sizeof(VInt)) override {
+    const AccessLock lock(*this, address, width, /*write=*/false);
+    return read(lock, address, width);
+  }
+  VInt readMemConst(VInt address,
+                    unsigned width = sizeof(VInt)) const override {
+    const AccessLock lock(*this, address, width, /*write=*/false);
+    return WriteTrackingAddressSpace::readMemConst(address, width);
+  }
+  /// Must not be called while any hart is running.
+  void reset() override {
+    for (auto &reservation : m_reservations)
+      reservation.valid = false;
+    WriteTrackingAddressSpace::reset();
+  }
+
+  /**
+   * @brief atomic
+   * Atomically applies @p op with @p operand to the @p bytes wide value at
+   * @p address. @returns the (zero-extended) value prior to the operation.
+   */
+  VInt atomic(AtomicOp op, AInt address, VInt operand, unsigned bytes) {
+    const AccessLock lock(*this, address, bytes, /*write=*/true);
+    const VInt old = read(lock, address, bytes);
+    VInt result = operand;
+    switch (op) {
+    case AtomicOp::Swap:
+      break;
+    case AtomicOp::Add:
+      result = old + operand;
+      break;
+    case AtomicOp::Xor:
+      result = old ^ operand;
+      break;
+    case AtomicOp::And:
+      result = old & operand;
+      break;
+    case AtomicOp::Or:
+      result = old | operand;
+      break;
+    case AtomicOp::Min:
+    case AtomicOp::Max: {
+      const bool less = signExtend(old, bytes) < signExtend(operand, bytes);
+      result = less == (op == AtomicOp::Min) ? old : operand;
+      break;
+    }
+    case AtomicOp::MinU:
+    case AtomicOp::MaxU: {
+      const bool less = truncate(old, bytes) < truncate(operand, bytes);
+      result = less == (op == AtomicOp::MinU) ? old : operand;
+      break;
+    }
+    }
+    write(lock, address, result, bytes);
+    return old;
+  }
+
+  /// Loads the @p bytes wide value at @p address, and registers a reservation
+  /// of it for @p hart.
+  VInt loadReserved(unsigned hart, AInt address, unsigned bytes) {
+    const AccessLock lock(*this, address, bytes, /*write=*/false);
+    if (m_reservations.size() <= hart)
+      m_reservations.resize(hart + 1);
+    m_reservations[hart] = {true, address, bytes,
+                            m_stripes[stripeIndex(address)].version};
+    return read(lock, address, bytes);
+  }
+
+  /// Stores @p value at @p address if @p hart holds a valid reservation of
+  /// it. The reservation of @p hart is released in either case. @returns true
+  /// if the store was performed.
+  bool storeConditional(unsigned hart, AInt address, VInt value,
+                        unsigned bytes) {
+    const AccessLock lock(*this, address, bytes, /*write=*/true);
+    if (hart >= m_reservations.size())
+      return false;
+    const Reservation reservation = m_reservations[hart];
+    m_reservations[hart].valid = false;
+    if (!reservation.valid || reservation.address != address ||
+        reservation.bytes != bytes ||
+        reservation.version != m_stripes[stripeIndex(address)].version)
+      return false;
+    write(lock, address, value, bytes);
+    return true;
+  }
+
+  /// Releases the reservation of @p hart, if any. Must only be called by
+  /// @p hart itself while harts are running.
+  void clearReservation(unsigned hart) {
+    if (hart < m_reservations.size())
+      m_reservations[hart].valid = false;
+  }
+
+private:
+  // Reservations and stripes are tracked at the granularity of the widest
+  // access.
+  static constexpr unsigned s_granuleBytes = sizeof(VInt);
+  static constexpr unsigned s_stripeBits = 8;
+
+  struct alignas(64) Stripe {
+    std::mutex mutex;
+    // Incremented by every write to the stripe. A reservation is valid while
+    // the version of its stripe is unchanged.
+    uint64_t version = 0;
+  };
+
+  struct Reservation {
+    bool valid = false;
+    AInt address = 0;
+    unsigned bytes = 0;
+    uint64_t version = 0;
+  };
+
+  /// Locks the address space for an access of @p bytes at @p address, if it is
+  /// accessed concurrently. Accesses of allocated memory (and for writes, of
+  /// written blocks) share the address space, and lock the stripes of the
+  /// accessed granules. Other accesses modify the memory and written blocks
+  /// maps, and lock the address space exclusively.
+  class AccessLock {
+  public:
+    AccessLock(const SharedAddressSpace &memory, AInt address, unsigned bytes,
+               bool write) {
+      if (!memory.m_concurrent)
+        return;
+      m_shared = std::shared_lock(memory.m_mapMutex);
+      if (!memory.allocated(address, bytes, write)) {
+        m_shared.unlock();
+        m_exclusive = std::unique_lock(memory.m_mapMutex);
+        return;
+      }
+      // Stripes are locked in order, as an access may span two granules.
+      unsigned first = stripeIndex(address);
+      unsigned second = stripeIndex(address + bytes - 1);
+      if (second < first)
+        std::swap(first, second);
+      m_first = std::unique_lock(memory.m_stripes[first].mutex);
+      if (second != first)
+        m_second = std::unique_lock(memory.m_stripes[second].mutex);
+    }
+
+    /// @returns true if other accesses may run in parallel with the access.
+    bool shared() const { return m_shared.owns_lock(); }
+
+  private:
+    // Released in reverse order of declaration; stripes before the maps.
+    std::shared_lock<std::shared_mutex> m_shared;
+    std::unique_lock<std::shared_mutex> m_exclusive;
+    std::unique_lock<std::mutex> m_first;
+    std::unique_lock<std::mutex> m_second;
+  };
+
+  /// Fibonacci hashing of the granule of @p address, such that the equally
+  /// spaced stacks of the harts map to different stripes.
+  static unsigned stripeIndex(AInt address) {
+    const uint64_t granule = address / s_granuleBytes;
+    return static_cast<unsigned>((granule * 0x9E3779B97F4A7C15ull) >>
+                                 (64 - s_stripeBits));
+  }
+
+  /// @returns true if all bytes of the access are allocated, and for writes,
+  /// if all blocks of the access have been written before.
+  bool allocated(AInt address, unsigned bytes, bool write) const {
+    for (unsigned i = 0; i < bytes; ++i)
+      if (!contains(address + i))
+        return false;
+    return !write || written(address, bytes);
+  }
+
+  /// Reads the @p bytes at @p address under @p lock.
+  VInt read(const AccessLock &lock, AInt address, unsigned bytes) {
+    // The bytes of shared accesses are allocated, such that they may be read
+    // without the (non-const) lookups which would otherwise allocate them.
+    return lock.shared()
+               ? WriteTrackingAddressSpace::readMemConst(address, bytes)
+               : WriteTrackingAddressSpace::readMem(address, bytes);
+  }
+
+  /// Writes @p value under @p lock, invalidating the reservations of the
+  /// written stripes.
+  void write(const AccessLock &lock, AInt address, VInt value, int size) {
+    m_stripes[stripeIndex(address)].version++;
+    m_stripes[stripeIndex(address + size - 1)].version++;
+    if (lock.shared()) {
+      // The written blocks are already tracked, and the set of written blocks
+      // must not be modified while shared.
+      vsrtl::core::AddressSpaceMM::writeMem(address, value, size);
+    } else {
+      WriteTrackingAddressSpace::writeMem(address, value, size);
+    }
+  }
+
+  static VInt truncate(VInt value, unsigned bytes) {
+    if (bytes >= sizeof(VInt))
+      return value;
+    return value & ((VInt(1) << (bytes * CHAR_BIT)) - 1);
+  }
+  static int64_t signExtend(VInt value, unsigned bytes) {
+    const unsigned shift = (sizeof(VInt) - bytes) * CHAR_BIT;
+    return static_cast<int64_t>(value << shift) >> shift;
+  }
+
+  bool m_concurrent = false;
+  // Guards the structure of the memory and written blocks maps, which are
+  // modified when allocating memory and when writing a block for the first
+  // time.
+  mutable std::shared_mutex m_mapMutex;
+  mutable std::array<Stripe, 1 << s_stripeBits> m_stripes;
+  // Indexed by hart. Each hart only accesses its own reservation while harts
+  // are running.
+  std::vector<Reservation> m_reservations;
+};
+
+} // namespace Ripes
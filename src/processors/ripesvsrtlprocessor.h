@@ -8,6 +8,8 @@
 #include "VSRTL/core/vsrtl_design.h"
 #include "interface/ripesprocessor.h"
 
+#include <array>
+
 namespace Ripes {
 
 class RipesVSRTLProcessor : public RipesProcessor, public vsrtl::core::Design {
@@ -25,11 +27,22 @@ public:
 
   virtual void resetProcessor() override {
     m_instructionsRetired = 0;
+    m_pipelineEvents.fill(0);
     reset();
   }
 
   virtual void reverseProcessor() override { reverse(); }
 
+  /// The VSRTL signals of the design, which notify the circuit view of changes
+  /// to its components, are disabled for the duration of the batch.
+  StopReason clockN(unsigned long long n,
+                    const StopConditions &conditions) override {
+    setEnableSignals(false);
+    const auto reason = RipesProcessor::clockN(n, conditions);
+    setEnableSignals(true);
+    return reason;
+  }
+
   virtual void vcdTrace(bool enable, const QString &filename) override {
     vsrtl::core::Design::vcdTrace(enable, filename.toStdString());
   }
@@ -38,6 +51,12 @@ public:
     return m_instructionsRetired;
   }
   long long getCycleCount() const override { return m_cycleCount; }
+  std::optional<long long>
+  pipelineEventCount(PipelineEvent event) const override {
+    if (!(m_countedPipelineEvents & pipelineEventBit(event)))
+      return {};
+    return m_pipelineEvents.at(static_cast<unsigned>(event));
+  }
   void setMaxReverseCycles(unsigned cycles) override {
     setReverseStackSize(cycles);
   }
@@ -97,6 +116,45 @@ protected:
       access.type = MemoryAccess::Read;
       break;
     }
+    case MemOp::LR_W: {
+      access.bytes = 4;
+      access.type = MemoryAccess::Read;
+      break;
+    }
+    case MemOp::LR_D: {
+      access.bytes = 8;
+      access.type = MemoryAccess::Read;
+      break;
+    }
+    // Store-conditionals and AMOs are accounted as writes.
+    case MemOp::SC_W:
+    case MemOp::AMOSWAP_W:
+    case MemOp::AMOADD_W:
+    case MemOp::AMOXOR_W:
+    case MemOp::AMOAND_W:
+    case MemOp::AMOOR_W:
+    case MemOp::AMOMIN_W:
+    case MemOp::AMOMAX_W:
+    case MemOp::AMOMINU_W:
+    case MemOp::AMOMAXU_W: {
+      access.bytes = 4;
+      access.type = MemoryAccess::Write;
+      break;
+    }
+    case MemOp::SC_D:
+    case MemOp::AMOSWAP_D:
+    case MemOp::AMOADD_D:
+    case MemOp::AMOXOR_D:
+    case MemOp::AMOAND_D:
+    case MemOp::AMOOR_D:
+    case MemOp::AMOMIN_D:
+    case MemOp::AMOMAX_D:
+    case MemOp::AMOMINU_D:
+    case MemOp::AMOMAXU_D: {
+      access.bytes = 8;
+      access.type = MemoryAccess::Write;
+      break;
+    }
     case MemOp::NOP:
       access.type = MemoryAccess::None;
       break;
@@ -108,9 +166,28 @@ protected:
     return access;
   }
 
+  static constexpr unsigned pipelineEventBit(PipelineEvent event) {
+    return 1 << static_cast<unsigned>(event);
+  }
+
+  /// Adds @p delta to the count of @p event for each of its @p occurrences.
+  /// Processors count events from the state of the circuit before each clock
+  /// edge, with a @p delta of 1 when clocking and -1 when reversing.
+  void countPipelineEvent(PipelineEvent event, unsigned occurrences,
+                          int delta) {
+    m_pipelineEvents[static_cast<unsigned>(event)] +=
+        static_cast<long long>(occurrences) * delta;
+  }
+
   // m_instructionsRetired should be modified by the processor when it retires
   // (or "un-retires", while reversing) an instruction
   long long m_instructionsRetired = 0;
+
+  // m_countedPipelineEvents is a mask of the pipeline events counted by the
+  // processor, and should be set during processor construction.
+  unsigned m_countedPipelineEvents = 0;
+  std::array<long long, static_cast<unsigned>(PipelineEvent::NEvents)>
+      m_pipelineEvents{};
 };
 
 } // namespace Ripes
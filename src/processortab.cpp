@@ -8,6 +8,7 @@
 #include <QScrollBar>
 #include <QSpinBox>
 #include <QTemporaryFile>
+#include <tuple>
 
 #include "consolewidget.h"
 #include "instructionmodel.h"
@@ -108,20 +109,12 @@ ProcessorTab::ProcessorTab(QToolBar *controlToolbar,
 
   setupSimulatorActions(controlToolbar);
 
-  // Setup statistics update timer - this timer is distinct from the
-  // ProcessorHandler's update timer, given that it needs to run during
-  // 'running' the processor.
-  m_statUpdateTimer = new QTimer(this);
-  m_statUpdateTimer->setInterval(
-      1000.0 / RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
-  connect(m_statUpdateTimer, &QTimer::timeout, this,
+  // While running, statistics and stage labels are updated from the snapshots
+  // published by the running processor.
+  connect(ProcessorHandler::get(), &ProcessorHandler::runSnapshotUpdated, this,
           &ProcessorTab::updateStatistics);
-  connect(RipesSettings::getObserver(RIPES_SETTING_UIUPDATEPS),
-          &SettingObserver::modified, m_statUpdateTimer, [=] {
-            m_statUpdateTimer->setInterval(
-                1000.0 /
-                RipesSettings::value(RIPES_SETTING_UIUPDATEPS).toInt());
-          });
+  connect(ProcessorHandler::get(), &ProcessorHandler::runSnapshotUpdated, this,
+          &ProcessorTab::updateInstructionLabels);
 
   // Connect changes in VSRTL reversible stack size to checking whether the
   // simulator is reversible
@@ -303,10 +296,16 @@ void ProcessorTab::updateStatistics() {
   static long long lastCycleCount =
       ProcessorHandler::getProcessor()->getCycleCount();
 
+  // While running, the processor is only observed through its snapshots.
+  const bool running = ProcessorHandler::isRunning();
+  const auto &snapshot = ProcessorHandler::runSnapshot();
   const auto timeNow = std::chrono::system_clock::now();
-  const auto cycleCount = ProcessorHandler::getProcessor()->getCycleCount();
+  const auto cycleCount =
+      running ? snapshot.cycleCount
+              : ProcessorHandler::getProcessor()->getCycleCount();
   const auto instrsRetired =
-      ProcessorHandler::getProcessor()->getInstructionsRetired();
+      running ? snapshot.instructionsRetired
+              : ProcessorHandler::getProcessor()->getInstructionsRetired();
   const auto timeDiff = std::chrono::duration_cast<std::chrono::milliseconds>(
                             timeNow - lastUpdateTime)
                             .count() /
@@ -329,6 +328,25 @@ void ProcessorTab::updateStatistics() {
   m_ui->cpi->setText(cpiText);
   m_ui->ipc->setText(ipcText);
 
+  // Pipeline events; only the events counted by the processor are shown.
+  using PipelineEvent = RipesProcessor::PipelineEvent;
+  const std::vector<std::tuple<PipelineEvent, QLabel *, QLineEdit *>>
+      pipelineEvents = {
+          {PipelineEvent::DataHazardStall, m_ui->stallsLabel, m_ui->stalls},
+          {PipelineEvent::ControlFlush, m_ui->flushesLabel, m_ui->flushes},
+          {PipelineEvent::Forward, m_ui->forwardsLabel, m_ui->forwards},
+          {PipelineEvent::DualIssue, m_ui->dualIssueLabel, m_ui->dualIssue},
+          {PipelineEvent::WayHazard, m_ui->wayHazardsLabel, m_ui->wayHazards}};
+  for (const auto &[event, label, count] : pipelineEvents) {
+    const auto eventCount =
+        running ? snapshot.pipelineEvents.at(static_cast<unsigned>(event))
+                : ProcessorHandler::getProcessor()->pipelineEventCount(event);
+    label->setVisible(eventCount.has_value());
+    count->setVisible(eventCount.has_value());
+    if (eventCount)
+      count->setText(QString::number(*eventCount));
+  }
+
   // Clock rate
   const double clockRate = static_cast<double>(cycleDiff) / timeDiff;
   m_ui->clockRate->setText(convertToSIUnits(clockRate) + "Hz");
@@ -469,10 +487,14 @@ void ProcessorTab::enableSimulatorControls() {
 
 void ProcessorTab::updateInstructionLabels() {
   const auto &proc = ProcessorHandler::getProcessor();
+  const bool running = ProcessorHandler::isRunning();
+  const auto &stages = ProcessorHandler::runSnapshot().stages;
   for (auto sid : ProcessorHandler::getProcessor()->structure().stageIt()) {
     if (!m_stageInstructionLabels.count(sid))
       continue;
-    const auto stageInfo = proc->stageInfo(sid);
+    if (running && !stages.count(sid))
+      continue;
+    const auto stageInfo = running ? stages.at(sid) : proc->stageInfo(sid);
     auto &instrLabel = m_stageInstructionLabels.at(sid);
     QString instrString;
     if (stageInfo.state != StageInfo::State::None) {
@@ -520,7 +542,6 @@ void ProcessorTab::runFinished() {
   pause();
   ProcessorHandler::checkProcessorFinished();
   m_vsrtlWidget->sync();
-  m_statUpdateTimer->stop();
 }
 
 void ProcessorTab::autoClockTimeout() {
@@ -562,10 +583,8 @@ void ProcessorTab::run(bool state) {
   }
   if (state) {
     ProcessorHandler::run();
-    m_statUpdateTimer->start();
   } else {
     ProcessorHandler::stopRun();
-    m_statUpdateTimer->stop();
   }
 
   // Enable/Disable all actions based on whether the processor is running.
@@ -4,9 +4,14 @@
 #include <QApplication>
 #include <QEvent>
 #include <QFontMetricsF>
+#include <QHelpEvent>
+#include <QInputDialog>
 #include <QMenu>
+#include <QMessageBox>
 #include <QTextBlock>
+#include <QToolTip>
 
+#include "cachesim/cachesim.h"
 #include "colors.h"
 #include "fonts.h"
 #include "ripessettings.h"
@@ -74,6 +79,39 @@ void ProgramViewer::updateSidebarWidth(int /* newBlockCount */) {
   setViewportMargins(m_sidebarWidth, 0, 0, 0);
 }
 
+void ProgramViewer::setMissAttributionCache(
+    const std::shared_ptr<CacheSim> &cache) {
+  m_missAttributionCache = cache;
+  m_breakpointArea->missColumnWidth =
+      cache ? QFontMetrics(m_font).horizontalAdvance("000000") +
+                  m_breakpointArea->padding
+            : 0;
+  updateSidebarWidth(0);
+  const QRect cr = contentsRect();
+  m_breakpointArea->setGeometry(cr.left(), cr.top(), m_breakpointArea->width(),
+                                cr.height());
+  m_breakpointArea->update();
+}
+
+QString ProgramViewer::missAttributionToolTip(const QPoint &pos) const {
+  auto cache = m_missAttributionCache.lock();
+  bool ok;
+  const AInt address = addressForPos(pos, ok);
+  if (!cache || !ok)
+    return QString();
+  const auto &pcCounters = cache->getPCAccessCounters();
+  auto it = pcCounters.find(address);
+  if (it == pcCounters.end())
+    return QString();
+  const auto &counters = it->second;
+  const unsigned totalMisses = cache->getMisses();
+  return QString("%1 misses / %2 accesses (%3% of all misses)")
+      .arg(counters.misses)
+      .arg(counters.accesses)
+      .arg(totalMisses == 0 ? 0.0 : 100.0 * counters.misses / totalMisses, 0,
+           'f', 1);
+}
+
 void ProgramViewer::setCenterAddress(const AInt address) {
   auto block = blockForAddress(address);
   if (block.isValid()) {
@@ -123,6 +161,10 @@ void ProgramViewer::updateHighlightedAddresses() {
   if (m_following) {
     updateCenterAddressFromProcessor();
   }
+
+  if (!m_missAttributionCache.expired()) {
+    m_breakpointArea->update();
+  }
 }
 
 void ProgramViewer::breakpointAreaPaintEvent(QPaintEvent *event) {
@@ -139,6 +181,19 @@ void ProgramViewer::breakpointAreaPaintEvent(QPaintEvent *event) {
 
   painter.fillRect(area, gradient);
 
+  // Misses are shaded relative to the instruction with the most misses.
+  auto cache = m_missAttributionCache.lock();
+  const PCAccessCounters *pcCounters = nullptr;
+  unsigned maxMisses = 0;
+  if (cache) {
+    pcCounters = &cache->getPCAccessCounters();
+    for (const auto &it : *pcCounters)
+      maxMisses = std::max(maxMisses, it.second.misses);
+  }
+  const QRect missColumn(m_breakpointArea->imageWidth +
+                             m_breakpointArea->padding * 2,
+                         0, m_breakpointArea->missColumnWidth, 0);
+
   QTextBlock block = firstVisibleBlock();
   if (block.isValid()) {
     int top, bottom;
@@ -156,6 +211,20 @@ void ProgramViewer::breakpointAreaPaintEvent(QPaintEvent *event) {
                 m_breakpointArea->padding, top, m_breakpointArea->imageWidth,
                 m_breakpointArea->imageHeight, m_breakpointArea->m_breakpoint);
           }
+          if (maxMisses > 0) {
+            auto it = pcCounters->find(address);
+            if (it != pcCounters->end() && it->second.misses > 0) {
+              const QRect rect(missColumn.left(), top, missColumn.width(),
+                               bottom - top);
+              QColor shade = QColorConstants::Red;
+              shade.setAlphaF(0.15 + 0.6 * it->second.misses / maxMisses);
+              painter.fillRect(rect, shade);
+              painter.drawText(
+                  rect.adjusted(0, 0, -m_breakpointArea->padding, 0),
+                  Qt::AlignRight | Qt::AlignVCenter,
+                  QString::number(it->second.misses));
+            }
+          }
         }
       }
 
@@ -324,6 +393,39 @@ void ProgramViewer::breakpointClick(const QPoint &pos) {
   }
 }
 
+void ProgramViewer::editBreakpointCondition(const QPoint &pos) {
+  bool ok;
+  const auto address = addressForPos(pos, ok);
+  if (!ok || !ProcessorHandler::hasBreakpoint(address))
+    return;
+
+  const QString text = QInputDialog::getText(
+      this, "Breakpoint condition",
+      "Condition (e.g. a0 == 5 && hits > 3), empty for none:",
+      QLineEdit::Normal, ProcessorHandler::breakpointCondition(address), &ok);
+  if (!ok)
+    return;
+
+  QString errorMessage;
+  if (!ProcessorHandler::setBreakpointCondition(address, text, errorMessage))
+    QMessageBox::warning(this, "Error", errorMessage);
+}
+
+void ProgramViewer::addWatchpoint() {
+  bool ok;
+  const QString text = QInputDialog::getText(
+      this, "Add watchpoint",
+      "Watchpoint (r|w|rw|c):(<address>[+<bytes>]|register), e.g. "
+      "w:0x10000000+4:",
+      QLineEdit::Normal, "", &ok);
+  if (!ok || text.isEmpty())
+    return;
+
+  QString errorMessage;
+  if (!ProcessorHandler::addWatchpoint(text, errorMessage))
+    QMessageBox::warning(this, "Error", errorMessage);
+}
+
 // -------------- breakpoint area ----------------------------------
 
 BreakpointArea::BreakpointArea(ProgramViewer *viewer) : QWidget(viewer) {
@@ -331,20 +433,51 @@ BreakpointArea::BreakpointArea(ProgramViewer *viewer) : QWidget(viewer) {
   setCursor(Qt::PointingHandCursor);
 }
 
+bool BreakpointArea::event(QEvent *event) {
+  if (event->type() == QEvent::ToolTip) {
+    auto *helpEvent = static_cast<QHelpEvent *>(event);
+    const QString toolTip =
+        m_programViewer->missAttributionToolTip(helpEvent->pos());
+    if (toolTip.isEmpty()) {
+      QToolTip::hideText();
+      event->ignore();
+    } else {
+      QToolTip::showText(helpEvent->globalPos(), toolTip);
+    }
+    return true;
+  }
+  return QWidget::event(event);
+}
+
 void BreakpointArea::contextMenuEvent(QContextMenuEvent *event) {
   // setup context menu
   QMenu contextMenu;
 
   // Create and connect actions for removing and setting breakpoints
   auto *toggleAction = contextMenu.addAction("Toggle breakpoint");
+  auto *conditionAction = contextMenu.addAction("Edit breakpoint condition...");
+  conditionAction->setEnabled(m_programViewer->hasBreakpoint(event->pos()));
   auto *removeAllAction = contextMenu.addAction("Remove all breakpoints");
 
+  // Create and connect actions for adding and removing watchpoints
+  contextMenu.addSeparator();
+  auto *addWatchpointAction = contextMenu.addAction("Add watchpoint...");
+  auto *removeWatchpointsAction =
+      contextMenu.addAction("Remove all watchpoints");
+  removeWatchpointsAction->setEnabled(!ProcessorHandler::watchpoints().empty());
+
   connect(toggleAction, &QAction::triggered, m_programViewer,
           [=] { m_programViewer->breakpointClick(event->pos()); });
+  connect(conditionAction, &QAction::triggered, m_programViewer,
+          [=] { m_programViewer->editBreakpointCondition(event->pos()); });
   connect(removeAllAction, &QAction::triggered, m_programViewer, [=] {
     m_programViewer->clearBreakpoints();
     repaint();
   });
+  connect(addWatchpointAction, &QAction::triggered, m_programViewer,
+          [=] { m_programViewer->addWatchpoint(); });
+  connect(removeWatchpointsAction, &QAction::triggered, m_programViewer,
+          [=] { ProcessorHandler::clearWatchpoints(); });
 
   contextMenu.exec(event->globalPos());
 }
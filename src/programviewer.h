@@ -14,6 +14,7 @@
 namespace Ripes {
 
 class BreakpointArea;
+class CacheSim;
 
 class ProgramViewer : public HighlightableTextEdit {
   Q_OBJECT
@@ -24,8 +25,30 @@ public:
   void breakpointClick(const QPoint &pos);
   bool hasBreakpoint(const QPoint &pos) const;
   void clearBreakpoints();
+
+  /**
+   * @brief editBreakpointCondition
+   * Prompts the user for the condition of the breakpoint at @p pos (see
+   * BreakpointCondition).
+   */
+  void editBreakpointCondition(const QPoint &pos);
+
+  /**
+   * @brief addWatchpoint
+   * Prompts the user for a watchpoint specification (see Watchpoint::parse).
+   */
+  void addWatchpoint();
   void setFollowEnabled(bool enabled);
 
+  /**
+   * @brief setMissAttributionCache
+   * Sets the cache whose misses are attributed to the instructions of the
+   * program, and shown in the sidebar. If @p cache is null, no misses are
+   * shown.
+   */
+  void setMissAttributionCache(const std::shared_ptr<CacheSim> &cache);
+  QString missAttributionToolTip(const QPoint &pos) const;
+
   AInt addressForPos(const QPoint &pos, bool &ok) const;
   AInt addressForBlock(QTextBlock block, bool &ok) const;
   QTextBlock blockForAddress(AInt) const;
@@ -73,6 +96,7 @@ private:
   int m_sidebarWidth;
 
   BreakpointArea *m_breakpointArea;
+  std::weak_ptr<CacheSim> m_missAttributionCache;
 
   /**
    * @brief m_labelAddrOffsetMap
@@ -91,12 +115,15 @@ public:
   BreakpointArea(ProgramViewer *viewer);
 
   QSize sizeHint() const override { return QSize(width(), 0); }
-  int width() const { return imageWidth + padding * 2; }
+  int width() const { return imageWidth + padding * 2 + missColumnWidth; }
   QSize breakpointSize() { return QSize(imageWidth, imageHeight); }
 
   int imageWidth = 16;
   int imageHeight = 16;
   int padding = 3; // padding on each side of the breakpoint
+  // Width of the column showing the # of cache misses of each instruction, to
+  // the right of the breakpoints.
+  int missColumnWidth = 0;
   QPixmap m_breakpoint =
       QPixmap(":/icons/breakpoint_enabled.png").scaled(imageWidth, imageHeight);
   QPixmap m_breakpoint_disabled =
@@ -110,6 +137,7 @@ protected:
   }
 
   void contextMenuEvent(QContextMenuEvent *event) override;
+  bool event(QEvent *event) override;
 
 private:
   ProgramViewer *m_programViewer;
@@ -18,7 +18,7 @@ RegisterModel::RegisterModel(const std::string_view &rft, QObject *parent)
 std::vector<VInt> RegisterModel::gatherRegisterValues() {
   std::vector<VInt> vals;
   for (int i = 0; i < rowCount(); ++i)
-    vals.push_back(ProcessorHandler::getRegisterValue(m_rft, i));
+    vals.push_back(registerData(i));
   return vals;
 }
 
@@ -159,6 +159,13 @@ QVariant RegisterModel::tooltipData(unsigned idx) const {
 }
 
 VInt RegisterModel::registerData(unsigned idx) const {
+  // While running, the processor is only observed through its snapshots.
+  if (ProcessorHandler::isRunning()) {
+    const auto &registers = ProcessorHandler::runSnapshot().registers;
+    const auto it = registers.find(m_rft);
+    return it != registers.end() && idx < it->second.size() ? it->second[idx]
+                                                             : 0;
+  }
   return ProcessorHandler::getRegisterValue(m_rft, idx);
 }
 
@@ -441,7 +441,9 @@ QWidget *SettingsDialog::createEnvironmentPage() {
   maxPipeDiagCycSb->setMaximum(INT_MAX);
   appendToLayout(
       {maxPipeDiagCycLabel, maxPipeDiagCycSb}, pageLayout,
-      "Maximum number of cycles to be recorded in the pipeline diagram.");
+      "Number of cycles to be recorded in the pipeline diagram. Once reached, "
+      "the oldest cycles are discarded as new cycles are recorded. Takes "
+      "effect when the processor is reset.");
 
   // Console settings
   auto *consoleGroupBox = new QGroupBox("Console");
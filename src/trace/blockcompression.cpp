@@ -0,0 +1,129 @@
+#include "blockcompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Ripes {
+namespace BlockCompression {
+
+namespace {
+
+constexpr unsigned s_minMatch = 4;
+constexpr unsigned s_hashBits = 12;
+constexpr size_t s_maxOffset = 0xFFFF;
+constexpr uint32_t s_noPosition = UINT32_MAX;
+
+uint32_t load32(const uint8_t *p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - s_hashBits);
+}
+
+void putLength(std::vector<uint8_t> &out, size_t length) {
+  for (; length >= 0xFF; length -= 0xFF)
+    out.push_back(0xFF);
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+bool getLength(const uint8_t *&src, const uint8_t *end, size_t &length) {
+  uint8_t byte;
+  do {
+    if (src == end)
+      return false;
+    byte = *src++;
+    length += byte;
+  } while (byte == 0xFF);
+  return true;
+}
+
+/// Appends a sequence of @p literals followed by a match of @p matchLength
+/// bytes at @p offset bytes back. A @p matchLength of 0 denotes the final,
+/// literal-only sequence.
+void putSequence(std::vector<uint8_t> &out, const uint8_t *literals,
+                 size_t literalLength, size_t offset, size_t matchLength) {
+  const size_t matchCode = matchLength ? matchLength - s_minMatch : 0;
+  out.push_back(
+      static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) |
+                           std::min<size_t>(matchCode, 15)));
+  if (literalLength >= 15)
+    putLength(out, literalLength - 15);
+  out.insert(out.end(), literals, literals + literalLength);
+  if (matchLength == 0)
+    return;
+  out.push_back(static_cast<uint8_t>(offset));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (matchCode >= 15)
+    putLength(out, matchCode - 15);
+}
+
+} // namespace
+
+void compress(const uint8_t *src, size_t size, std::vector<uint8_t> &out) {
+  std::array<uint32_t, 1 << s_hashBits> table;
+  table.fill(s_noPosition);
+
+  size_t anchor = 0;
+  size_t i = 0;
+  while (i + s_minMatch <= size) {
+    const uint32_t sequence = load32(src + i);
+    uint32_t &entry = table[hash(sequence)];
+    const uint32_t candidate = entry;
+    entry = static_cast<uint32_t>(i);
+    if (candidate == s_noPosition || i - candidate > s_maxOffset ||
+        load32(src + candidate) != sequence) {
+      ++i;
+      continue;
+    }
+
+    size_t length = s_minMatch;
+    while (i + length < size && src[candidate + length] == src[i + length])
+      ++length;
+    putSequence(out, src + anchor, i - anchor, i - candidate, length);
+    i += length;
+    anchor = i;
+  }
+  putSequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+bool decompress(const uint8_t *src, size_t size, uint8_t *dst,
+                size_t rawSize) {
+  const uint8_t *end = src + size;
+  size_t out = 0;
+  while (src < end) {
+    const uint8_t token = *src++;
+
+    size_t literals = token >> 4;
+    if (literals == 15 && !getLength(src, end, literals))
+      return false;
+    if (static_cast<size_t>(end - src) < literals || rawSize - out < literals)
+      return false;
+    std::memcpy(dst + out, src, literals);
+    src += literals;
+    out += literals;
+    if (src == end)
+      break;
+
+    if (end - src < 2)
+      return false;
+    const size_t offset = src[0] | (src[1] << 8);
+    src += 2;
+    size_t length = token & 0xF;
+    if (length == 15 && !getLength(src, end, length))
+      return false;
+    length += s_minMatch;
+    if (offset == 0 || offset > out || rawSize - out < length)
+      return false;
+    // Matches may overlap the bytes they produce, so copy byte by byte.
+    for (size_t j = 0; j < length; ++j, ++out)
+      dst[out] = dst[out - offset];
+  }
+  return out == rawSize;
+}
+
+} // namespace BlockCompression
+} // namespace Ripes
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Ripes {
+
+/**
+ * @brief BlockCompression
+ * A small, fast LZ77 compressor for independent blocks of at most 4 GiB,
+ * intended for compressing execution trace blocks on the fly. The compressed
+ * stream is a sequence of
+ *   token:u8 [literal length:u8*] literals [offset:u16 [match length:u8*]]
+ * where the upper and lower nibble of the token are the literal length and
+ * the match length - 4, both extended by additional bytes when saturated (15),
+ * as in LZ4. The last sequence of a block consists of literals only. Matches
+ * are found through a hash table of 4-byte sequences, trading some ratio for
+ * speed.
+ */
+namespace BlockCompression {
+
+/// Appends the compressed representation of the @p size bytes at @p src to
+/// @p out.
+void compress(const uint8_t *src, size_t size, std::vector<uint8_t> &out);
+
+/// Decompresses the @p size bytes at @p src into the @p rawSize bytes at
+/// @p dst. Returns false if @p src is not a valid compressed block of
+/// @p rawSize bytes.
+bool decompress(const uint8_t *src, size_t size, uint8_t *dst,
+                size_t rawSize);
+
+} // namespace BlockCompression
+
+} // namespace Ripes
@@ -0,0 +1,68 @@
+#include "branchpredictor.h"
+
+namespace Ripes {
+
+QString BranchPredictorConfig::name() const {
+  switch (type) {
+  case BranchPredictorType::NotTaken:
+    return "not-taken";
+  case BranchPredictorType::Taken:
+    return "taken";
+  case BranchPredictorType::Bimodal:
+    return QString("bimodal-T%1").arg(tableBits);
+  case BranchPredictorType::GShare:
+    return QString("gshare-T%1H%2").arg(tableBits).arg(historyBits);
+  }
+  Q_UNREACHABLE();
+}
+
+BranchPredictor::BranchPredictor(const BranchPredictorConfig &config)
+    : m_config(config) {
+  if (config.type == BranchPredictorType::Bimodal ||
+      config.type == BranchPredictorType::GShare) {
+    // Counters start out weakly not taken.
+    m_counters.assign(1ull << config.tableBits, 1);
+    m_tableMask = (1ull << config.tableBits) - 1;
+  }
+  if (config.type == BranchPredictorType::GShare)
+    m_historyMask = (1ull << config.historyBits) - 1;
+}
+
+bool BranchPredictor::predict(AInt pc, bool taken) {
+  ++m_branches;
+  bool prediction = false;
+  switch (m_config.type) {
+  case BranchPredictorType::NotTaken:
+    prediction = false;
+    break;
+  case BranchPredictorType::Taken:
+    prediction = true;
+    break;
+  case BranchPredictorType::Bimodal:
+  case BranchPredictorType::GShare: {
+    // Instructions are at least 2-byte aligned; the lowest bit of the PC
+    // carries no information.
+    const uint64_t index = ((pc >> 1) ^ m_history) & m_tableMask;
+    uint8_t &counter = m_counters[index];
+    prediction = counter >= 2;
+    if (taken && counter < 3)
+      ++counter;
+    else if (!taken && counter > 0)
+      --counter;
+    m_history = ((m_history << 1) | taken) & m_historyMask;
+    break;
+  }
+  }
+
+  if (prediction != taken)
+    ++m_mispredictions;
+  return prediction == taken;
+}
+
+double BranchPredictor::accuracy() const {
+  return m_branches == 0
+             ? 0.0
+             : 1.0 - static_cast<double>(m_mispredictions) / m_branches;
+}
+
+} // namespace Ripes
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "isa/isa_types.h"
+
+namespace Ripes {
+
+enum class BranchPredictorType { NotTaken, Taken, Bimodal, GShare };
+
+struct BranchPredictorConfig {
+  BranchPredictorType type = BranchPredictorType::Bimodal;
+  /// log2 of the number of 2-bit counters of the bimodal and gshare
+  /// predictors.
+  unsigned tableBits = 10;
+  /// Bits of global branch history of the gshare predictor.
+  unsigned historyBits = 8;
+
+  QString name() const;
+};
+
+/**
+ * @brief The BranchPredictor class
+ * A model of a direction predictor for conditional branches. The processor
+ * models of Ripes resolve branches without prediction; the predictor is
+ * instead driven by the branches of a recorded execution (see TraceReplayer),
+ * such that the accuracy of different predictors can be compared for a
+ * program.
+ */
+class BranchPredictor {
+public:
+  explicit BranchPredictor(const BranchPredictorConfig &config);
+
+  /**
+   * @brief predict
+   * Predicts the direction of the conditional branch at @p pc, after which the
+   * predictor is trained with the actual direction, @p taken. Returns true if
+   * the prediction was correct.
+   */
+  bool predict(AInt pc, bool taken);
+
+  const BranchPredictorConfig &config() const { return m_config; }
+  uint64_t branches() const { return m_branches; }
+  uint64_t mispredictions() const { return m_mispredictions; }
+  double accuracy() const;
+
+private:
+  BranchPredictorConfig m_config;
+  /// Saturating 2-bit counters; values 2 and 3 predict taken.
+  std::vector<uint8_t> m_counters;
+  uint64_t m_tableMask = 0;
+  uint64_t m_history = 0;
+  uint64_t m_historyMask = 0;
+
+  uint64_t m_branches = 0;
+  uint64_t m_mispredictions = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,322 @@
+#include "traceformat.h"
+
+#include <cstring>
+#include <numeric>
+
+namespace Ripes {
+
+namespace {
+
+// Flags of a cycle record, denoting which fields follow the flags byte.
+enum RecordFlags : uint8_t {
+  CycleJump = 0b1, // The cycle does not directly follow the previous record.
+  Fetch = 0b10,
+  DataRead = 0b100,
+  DataWrite = 0b1000,
+  RegWrites = 0b10000,
+  Stages = 0b100000
+};
+
+// Layout of the byte encoding the state of a stage: the state (bits 0-2), the
+// valid flag (bit 3), and either the zigzag encoded PC delta (bits 4-6) or,
+// if bit 7 is set, nothing, in which case the delta follows as a varint.
+constexpr uint8_t s_stageStateMask = 0b111;
+constexpr uint8_t s_stageValid = 0b1000;
+constexpr uint8_t s_stageDeltaFollows = 0b10000000;
+constexpr uint64_t s_stageDeltaLimit = 0b1000;
+
+void putVarint(std::vector<uint8_t> &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool getVarint(const uint8_t *&data, const uint8_t *end,
+                      uint64_t &value) {
+  // Most values of a record are small deltas, which encode to a single byte.
+  if (data != end && *data < 0x80) {
+    value = *data++;
+    return true;
+  }
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (data == end)
+      return false;
+    const uint8_t byte = *data++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Deltas are zigzag encoded, such that small negative deltas also encode to
+// few bytes.
+uint64_t zigzag(uint64_t delta) {
+  const uint64_t sign = static_cast<int64_t>(delta) >> 63;
+  return (delta << 1) ^ sign;
+}
+
+uint64_t unzigzag(uint64_t value) { return (value >> 1) ^ (~(value & 1) + 1); }
+
+void putDelta(std::vector<uint8_t> &out, uint64_t value, uint64_t previous) {
+  putVarint(out, zigzag(value - previous));
+}
+
+inline bool getDelta(const uint8_t *&data, const uint8_t *end,
+                     uint64_t &value, uint64_t previous) {
+  uint64_t delta;
+  if (!getVarint(data, end, delta))
+    return false;
+  value = previous + unzigzag(delta);
+  return true;
+}
+
+void putString(std::vector<uint8_t> &out, const QString &string) {
+  const QByteArray bytes = string.toUtf8();
+  putVarint(out, bytes.size());
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+bool getString(const uint8_t *&data, const uint8_t *end, QString &string) {
+  uint64_t size;
+  if (!getVarint(data, end, size) ||
+      static_cast<uint64_t>(end - data) < size)
+    return false;
+  string = QString::fromUtf8(reinterpret_cast<const char *>(data), size);
+  data += size;
+  return true;
+}
+
+} // namespace
+
+unsigned TraceInfo::numStages() const {
+  return std::accumulate(lanes.begin(), lanes.end(), 0u);
+}
+
+void TraceDeltaState::reset(uint64_t firstCycle,
+                            const std::vector<unsigned> &lanes) {
+  // The cycle preceding the first record of the block.
+  cycle = firstCycle - 1;
+  fetchPC = 0;
+  dataAddress = 0;
+  dataPC = 0;
+  stagePredictors.clear();
+  for (const unsigned stages : lanes)
+    for (unsigned i = 0; i < stages; ++i) {
+      const unsigned stage = stagePredictors.size();
+      stagePredictors.push_back(i == 0 ? stage : stage - 1);
+    }
+  stagePCs.assign(stagePredictors.size(), 0);
+}
+
+namespace TraceFormat {
+
+void writeHeader(const TraceInfo &info, std::vector<uint8_t> &out) {
+  out.insert(out.end(), std::begin(s_magic), std::end(s_magic));
+  putLE(out, s_version, sizeof(uint32_t));
+  putLE(out, info.compressed ? s_compressedFlag : 0, sizeof(uint32_t));
+  putString(out, info.processor);
+  putVarint(out, info.bits);
+  putVarint(out, info.instrBytes);
+  putVarint(out, info.lanes.size());
+  for (const unsigned stages : info.lanes)
+    putVarint(out, stages);
+  putVarint(out, info.regFiles.size());
+  for (const auto &regFile : info.regFiles)
+    putString(out, regFile);
+}
+
+bool readHeader(const uint8_t *&data, const uint8_t *end, TraceInfo &info,
+                QString &errorMessage) {
+  uint64_t version = 0, flags = 0;
+  if (end - data < static_cast<std::ptrdiff_t>(sizeof(s_magic)) ||
+      std::memcmp(data, s_magic, sizeof(s_magic)) != 0) {
+    errorMessage = "Not a Ripes execution trace.";
+    return false;
+  }
+  data += sizeof(s_magic);
+  if (!getLE(data, end, version, sizeof(uint32_t)) ||
+      !getLE(data, end, flags, sizeof(uint32_t))) {
+    errorMessage = "Truncated trace header.";
+    return false;
+  }
+  if (version != s_version) {
+    errorMessage = "Unsupported trace version " + QString::number(version) +
+                   " (expected " + QString::number(s_version) + ").";
+    return false;
+  }
+  info.compressed = flags & s_compressedFlag;
+
+  uint64_t count = 0, value = 0, bits = 0, instrBytes = 0;
+  bool ok = getString(data, end, info.processor) &&
+            getVarint(data, end, bits) && getVarint(data, end, instrBytes) &&
+            getVarint(data, end, count);
+  info.bits = bits;
+  info.instrBytes = instrBytes;
+  info.lanes.clear();
+  for (uint64_t i = 0; ok && i < count; ++i) {
+    ok = getVarint(data, end, value);
+    info.lanes.push_back(value);
+  }
+  ok = ok && getVarint(data, end, count);
+  info.regFiles.clear();
+  for (uint64_t i = 0; ok && i < count; ++i) {
+    QString regFile;
+    ok = getString(data, end, regFile);
+    info.regFiles.push_back(regFile);
+  }
+  if (!ok)
+    errorMessage = "Truncated trace header.";
+  return ok;
+}
+
+void encodeCycle(const TraceCycle &cycle, TraceDeltaState &state,
+                 std::vector<uint8_t> &out) {
+  uint8_t flags = 0;
+  if (cycle.cycle != state.cycle + 1)
+    flags |= CycleJump;
+  if (cycle.fetched)
+    flags |= Fetch;
+  if (cycle.dataAccess.type == MemoryAccess::Read)
+    flags |= DataRead;
+  else if (cycle.dataAccess.type == MemoryAccess::Write)
+    flags |= DataWrite;
+  if (!cycle.regWrites.empty())
+    flags |= RegWrites;
+  if (!cycle.stages.empty())
+    flags |= Stages;
+  out.push_back(flags);
+
+  if (flags & CycleJump)
+    putDelta(out, cycle.cycle, state.cycle + 1);
+  state.cycle = cycle.cycle;
+
+  if (flags & Fetch) {
+    putDelta(out, cycle.fetchPC, state.fetchPC);
+    putLE(out, cycle.instruction, sizeof(uint32_t));
+    state.fetchPC = cycle.fetchPC;
+  }
+
+  if (flags & (DataRead | DataWrite)) {
+    const auto &access = cycle.dataAccess;
+    putDelta(out, access.address, state.dataAddress);
+    putVarint(out, access.bytes);
+    putDelta(out, access.pc, state.dataPC);
+    state.dataAddress = access.address;
+    state.dataPC = access.pc;
+  }
+
+  if (flags & RegWrites) {
+    putVarint(out, cycle.regWrites.size());
+    for (const auto &write : cycle.regWrites) {
+      out.push_back(write.regFile);
+      out.push_back(write.index);
+      // Zigzag encoded, such that small negative values are compact.
+      putDelta(out, write.value, 0);
+    }
+  }
+
+  if (flags & Stages) {
+    Q_ASSERT(cycle.stages.size() == state.stagePCs.size());
+    // Stages are encoded from the last to the first, such that the prediction
+    // of each stage is still the PC of the previous cycle when it is used.
+    for (unsigned i = cycle.stages.size(); i-- > 0;) {
+      const auto &stage = cycle.stages[i];
+      const uint64_t delta =
+          zigzag(stage.pc - state.stagePCs[state.stagePredictors[i]]);
+      // The state of the stage is packed with small PC deltas into a single
+      // byte; larger deltas follow the byte.
+      uint8_t packed = static_cast<uint8_t>(stage.state) |
+                       (stage.valid ? s_stageValid : 0);
+      if (delta < s_stageDeltaLimit) {
+        out.push_back(packed | static_cast<uint8_t>(delta << 4));
+      } else {
+        out.push_back(packed | s_stageDeltaFollows);
+        putVarint(out, delta);
+      }
+      state.stagePCs[i] = stage.pc;
+    }
+  }
+}
+
+bool decodeCycle(const uint8_t *&data, const uint8_t *end,
+                 TraceDeltaState &state, TraceCycle &cycle) {
+  if (data == end)
+    return false;
+  const uint8_t flags = *data++;
+
+  uint64_t value = state.cycle + 1;
+  if ((flags & CycleJump) && !getDelta(data, end, value, state.cycle + 1))
+    return false;
+  cycle.cycle = state.cycle = value;
+
+  cycle.fetched = flags & Fetch;
+  if (cycle.fetched) {
+    if (!getDelta(data, end, cycle.fetchPC, state.fetchPC) ||
+        !getLE(data, end, value, sizeof(uint32_t)))
+      return false;
+    cycle.instruction = value;
+    state.fetchPC = cycle.fetchPC;
+  }
+
+  auto &access = cycle.dataAccess;
+  access.type = flags & DataRead    ? MemoryAccess::Read
+                : flags & DataWrite ? MemoryAccess::Write
+                                    : MemoryAccess::None;
+  if (access.type != MemoryAccess::None) {
+    if (!getDelta(data, end, access.address, state.dataAddress) ||
+        !getVarint(data, end, value) ||
+        !getDelta(data, end, access.pc, state.dataPC))
+      return false;
+    access.bytes = value;
+    state.dataAddress = access.address;
+    state.dataPC = access.pc;
+  }
+
+  cycle.regWrites.clear();
+  if (flags & RegWrites) {
+    if (!getVarint(data, end, value))
+      return false;
+    cycle.regWrites.resize(value);
+    for (auto &write : cycle.regWrites) {
+      if (end - data < 2)
+        return false;
+      write.regFile = *data++;
+      write.index = *data++;
+      if (!getDelta(data, end, write.value, 0))
+        return false;
+    }
+  }
+
+  if (!(flags & Stages)) {
+    cycle.stages.clear();
+  } else {
+    // Stages are decoded in place, such that decoding consecutive records
+    // into the same cycle does not reallocate them.
+    cycle.stages.resize(state.stagePCs.size());
+    for (unsigned i = cycle.stages.size(); i-- > 0;) {
+      auto &stage = cycle.stages[i];
+      if (data == end)
+        return false;
+      const uint8_t packed = *data++;
+      if ((packed & s_stageStateMask) >
+          static_cast<uint8_t>(StageInfo::State::Unused))
+        return false;
+      stage.state = static_cast<StageInfo::State>(packed & s_stageStateMask);
+      stage.valid = packed & s_stageValid;
+      uint64_t delta = (packed >> 4) & (s_stageDeltaLimit - 1);
+      if ((packed & s_stageDeltaFollows) && !getVarint(data, end, delta))
+        return false;
+      stage.pc = state.stagePCs[state.stagePredictors[i]] + unzigzag(delta);
+      state.stagePCs[i] = stage.pc;
+    }
+  }
+  return true;
+}
+
+} // namespace TraceFormat
+
+} // namespace Ripes
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "isa/isa_types.h"
+#include "processors/interface/ripesprocessor.h"
+
+namespace Ripes {
+
+/**
+ * Execution traces
+ *
+ * An execution trace records, for each cycle of a processor, the instruction
+ * fetch (PC and instruction word), the data memory access, the registers
+ * written and the occupancy of each pipeline stage. Traces are stored in a
+ * compact binary format:
+ *
+ *   file    := header block*
+ *   header  := magic[8] version:u32 flags:u32 info
+ *   block   := rawBytes:u32 storedBytes:u32 cycles:u32 firstCycle:u64
+ *              payload[storedBytes]
+ *
+ * All integers are little endian. A block holds the records of 'cycles'
+ * cycles, the first of which is 'firstCycle'; its payload is compressed (see
+ * BlockCompression) if storedBytes < rawBytes, and stored as-is otherwise.
+ * Records are delta encoded against the previous record of the same block,
+ * such that each block can be decoded independently of all others.
+ */
+
+/// Static information about the processor which a trace was recorded from.
+struct TraceInfo {
+  QString processor;
+  /// Number of stages of each lane of the processor (see ProcessorStructure).
+  std::vector<unsigned> lanes;
+  /// Register files; register writes refer to these by index.
+  std::vector<QString> regFiles;
+  /// Register width of the ISA, in bits.
+  unsigned bits = 32;
+  /// Bytes read by each instruction fetch.
+  unsigned instrBytes = 4;
+  /// Whether the blocks of the trace may be compressed.
+  bool compressed = false;
+
+  unsigned numStages() const;
+};
+
+struct TraceRegisterWrite {
+  uint8_t regFile = 0;
+  uint8_t index = 0;
+  VInt value = 0;
+};
+
+struct TraceStage {
+  AInt pc = 0;
+  bool valid = false;
+  StageInfo::State state = StageInfo::State::None;
+};
+
+/// The record of a single cycle.
+struct TraceCycle {
+  uint64_t cycle = 0;
+  /// Set if an instruction was fetched in the cycle.
+  bool fetched = false;
+  AInt fetchPC = 0;
+  uint32_t instruction = 0;
+  /// The data memory access of the cycle; MemoryAccess::None if none.
+  MemoryAccess dataAccess;
+  /// Registers whose value changed by the clock edge into the cycle.
+  std::vector<TraceRegisterWrite> regWrites;
+  /// Occupancy of each stage, ordered by lane and then by stage index. Empty
+  /// if stage occupancy was not recorded.
+  std::vector<TraceStage> stages;
+};
+
+/// The state which records of a block are delta encoded against.
+struct TraceDeltaState {
+  uint64_t cycle = 0;
+  AInt fetchPC = 0;
+  AInt dataAddress = 0;
+  AInt dataPC = 0;
+  /// The PC of each stage in the previous cycle.
+  std::vector<AInt> stagePCs;
+  /// The stage whose PC in the previous cycle predicts the PC of each stage;
+  /// the preceding stage of the same lane, or the stage itself for the first
+  /// stage of a lane.
+  std::vector<unsigned> stagePredictors;
+
+  /// Resets the state for a block starting at @p firstCycle, of a processor
+  /// with @p lanes.
+  void reset(uint64_t firstCycle, const std::vector<unsigned> &lanes);
+};
+
+namespace TraceFormat {
+
+constexpr char s_magic[8] = {'R', 'I', 'P', 'E', 'S', 'T', 'R', 'C'};
+constexpr uint32_t s_version = 1;
+constexpr uint32_t s_compressedFlag = 0b1;
+/// Bytes of a block header.
+constexpr unsigned s_blockHeaderBytes =
+    3 * sizeof(uint32_t) + sizeof(uint64_t);
+
+/// Appends the header of a trace with @p info to @p out.
+void writeHeader(const TraceInfo &info, std::vector<uint8_t> &out);
+/// Parses the header at @p data into @p info, advancing @p data past it.
+/// Returns false if the header is malformed or of an unsupported version.
+bool readHeader(const uint8_t *&data, const uint8_t *end, TraceInfo &info,
+                QString &errorMessage);
+
+/// Appends the record of @p cycle to @p out, delta encoded against @p state,
+/// which is updated to the record.
+void encodeCycle(const TraceCycle &cycle, TraceDeltaState &state,
+                 std::vector<uint8_t> &out);
+/// Decodes the record at @p data into @p cycle, advancing @p data past it.
+/// Returns false if the record is malformed.
+bool decodeCycle(const uint8_t *&data, const uint8_t *end,
+                 TraceDeltaState &state, TraceCycle &cycle);
+
+inline void putLE(std::vector<uint8_t> &out, uint64_t value, unsigned bytes) {
+  for (unsigned i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+inline bool getLE(const uint8_t *&data, const uint8_t *end, uint64_t &value,
+                  unsigned bytes) {
+  if (end - data < static_cast<std::ptrdiff_t>(bytes))
+    return false;
+  value = 0;
+  for (unsigned i = 0; i < bytes; ++i)
+    value |= static_cast<uint64_t>(data[i]) << (i * 8);
+  data += bytes;
+  return true;
+}
+
+} // namespace TraceFormat
+
+} // namespace Ripes
@@ -0,0 +1,104 @@
+#include "tracereader.h"
+#include "blockcompression.h"
+
+namespace Ripes {
+
+bool TraceReader::open(const QString &path, QString &errorMessage) {
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    errorMessage = "Failed to open trace file '" + path +
+                   "': " + m_file.errorString();
+    return false;
+  }
+  const qint64 size = m_file.size();
+  uchar *data = size > 0 ? m_file.map(0, size) : nullptr;
+  if (!data) {
+    errorMessage = "Failed to map trace file '" + path + "'.";
+    m_file.close();
+    return false;
+  }
+
+  m_data = data;
+  m_end = data + size;
+  const uint8_t *blocks = m_data;
+  if (!TraceFormat::readHeader(blocks, m_end, m_info, errorMessage)) {
+    errorMessage = "Invalid trace file '" + path + "': " + errorMessage;
+    close();
+    return false;
+  }
+  m_firstBlock = blocks;
+  rewind();
+  return true;
+}
+
+void TraceReader::close() {
+  if (m_data)
+    m_file.unmap(const_cast<uchar *>(m_data));
+  m_file.close();
+  m_data = m_end = m_firstBlock = m_nextBlock = nullptr;
+  m_records = m_recordsEnd = nullptr;
+  m_blockCycles = 0;
+  m_decompressed.clear();
+  m_decompressed.shrink_to_fit();
+}
+
+void TraceReader::rewind() {
+  m_nextBlock = m_firstBlock;
+  m_blockCycles = 0;
+  m_error.clear();
+}
+
+bool TraceReader::next(TraceCycle &cycle) {
+  while (m_blockCycles == 0)
+    if (!nextBlock())
+      return false;
+
+  if (!TraceFormat::decodeCycle(m_records, m_recordsEnd, m_state, cycle)) {
+    m_error = "Malformed record following cycle " +
+              QString::number(m_state.cycle) + ".";
+    m_blockCycles = 0;
+    m_nextBlock = m_end;
+    return false;
+  }
+  --m_blockCycles;
+  return true;
+}
+
+bool TraceReader::nextBlock() {
+  if (m_nextBlock == m_end || !m_error.isEmpty())
+    return false;
+
+  const uint8_t *block = m_nextBlock;
+  uint64_t rawBytes = 0, storedBytes = 0, cycles = 0, firstCycle = 0;
+  if (!TraceFormat::getLE(block, m_end, rawBytes, sizeof(uint32_t)) ||
+      !TraceFormat::getLE(block, m_end, storedBytes, sizeof(uint32_t)) ||
+      !TraceFormat::getLE(block, m_end, cycles, sizeof(uint32_t)) ||
+      !TraceFormat::getLE(block, m_end, firstCycle, sizeof(uint64_t)) ||
+      static_cast<uint64_t>(m_end - block) < storedBytes) {
+    m_error = "Truncated trace block.";
+    m_nextBlock = m_end;
+    return false;
+  }
+
+  if (storedBytes == rawBytes) {
+    m_records = block;
+  } else {
+    m_decompressed.resize(rawBytes);
+    if (!m_info.compressed || storedBytes > rawBytes ||
+        !BlockCompression::decompress(block, storedBytes,
+                                      m_decompressed.data(), rawBytes)) {
+      m_error = "Malformed compressed trace block.";
+      m_nextBlock = m_end;
+      return false;
+    }
+    m_records = m_decompressed.data();
+  }
+  m_recordsEnd = m_records + rawBytes;
+  m_nextBlock = block + storedBytes;
+  m_blockCycles = cycles;
+  m_state.reset(firstCycle, m_info.lanes);
+  return true;
+}
+
+} // namespace Ripes
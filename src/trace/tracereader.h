@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QFile>
+
+#include "traceformat.h"
+
+namespace Ripes {
+
+/**
+ * @brief The TraceReader class
+ * Reads an execution trace written by a TraceWriter, one cycle at a time. The
+ * trace file is memory-mapped; blocks stored without compression are decoded
+ * in place, and compressed blocks are decompressed one at a time into a
+ * reused buffer, such that traces of any length are read in constant memory.
+ */
+class TraceReader {
+public:
+  TraceReader() = default;
+  TraceReader(const TraceReader &) = delete;
+  TraceReader &operator=(const TraceReader &) = delete;
+
+  /// Opens the trace at @p path, closing the currently open trace, if any.
+  /// Returns false if the file could not be mapped, or if its header is
+  /// malformed.
+  bool open(const QString &path, QString &errorMessage);
+  void close();
+  bool isOpen() const { return m_data != nullptr; }
+
+  const TraceInfo &info() const { return m_info; }
+
+  /// Decodes the next cycle of the trace into @p cycle. Returns false at the
+  /// end of the trace, or if the trace is malformed, in which case error() is
+  /// set.
+  bool next(TraceCycle &cycle);
+
+  /// Restarts reading from the first cycle of the trace.
+  void rewind();
+
+  /// The reason for which reading stopped before the end of the trace; empty
+  /// if no error occurred.
+  const QString &error() const { return m_error; }
+
+private:
+  /// Starts decoding the next block. Returns false at the end of the trace, or
+  /// if the block is malformed.
+  bool nextBlock();
+
+  QFile m_file;
+  TraceInfo m_info;
+  QString m_error;
+
+  // The mapped file.
+  const uint8_t *m_data = nullptr;
+  const uint8_t *m_end = nullptr;
+  const uint8_t *m_firstBlock = nullptr;
+  const uint8_t *m_nextBlock = nullptr;
+
+  // The records of the current block.
+  const uint8_t *m_records = nullptr;
+  const uint8_t *m_recordsEnd = nullptr;
+  uint64_t m_blockCycles = 0;
+  TraceDeltaState m_state;
+  std::vector<uint8_t> m_decompressed;
+};
+
+} // namespace Ripes
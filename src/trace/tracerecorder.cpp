@@ -0,0 +1,110 @@
+#include "tracerecorder.h"
+#include "processorhandler.h"
+
+namespace Ripes {
+
+TraceRecorder::TraceRecorder(const QString &path,
+                             const TraceWriter::Options &options,
+                             QObject *parent)
+    : QObject(parent), m_path(path), m_options(options) {
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorReset, this,
+          &TraceRecorder::processorReset);
+
+  // Cycles must be recorded in lockstep with the processor. Ensure that the
+  // handler is executed in the thread that the processor lives in (direct
+  // connection).
+  connect(ProcessorHandler::get(), &ProcessorHandler::processorClocked, this,
+          &TraceRecorder::processorWasClocked, Qt::DirectConnection);
+
+  processorReset();
+}
+
+bool TraceRecorder::finish(QString &errorMessage) {
+  QString closeError;
+  if (!m_writer.close(closeError) && m_error.isEmpty())
+    m_error = closeError;
+  errorMessage = m_error;
+  return m_error.isEmpty();
+}
+
+void TraceRecorder::processorReset() {
+  const auto *processor = ProcessorHandler::getProcessor();
+  const auto isa = processor->implementsISA();
+
+  TraceInfo info;
+  info.processor = enumToString<ProcessorID>(ProcessorHandler::getID());
+  info.bits = isa->bits();
+  info.instrBytes = isa->instrBytes();
+  for (const auto &[lane, stages] : processor->structure())
+    info.lanes.push_back(stages);
+  m_stages.clear();
+  for (const auto stage : processor->structure().stageIt())
+    m_stages.push_back(stage);
+
+  m_regFiles.clear();
+  m_regValues.clear();
+  for (const auto &regFile : processor->registerFiles()) {
+    const unsigned regCnt = isa->regInfo(regFile).value()->regCnt();
+    info.regFiles.push_back(QString::fromUtf8(regFile.data(), regFile.size()));
+    m_regFiles.push_back({regFile, regCnt});
+    for (unsigned i = 0; i < regCnt; ++i)
+      m_regValues.push_back(processor->getRegister(regFile, i));
+  }
+  m_instrBytes = info.instrBytes;
+
+  // Restarting the trace truncates the trace of the previous run.
+  QString errorMessage;
+  if (!m_writer.close(errorMessage) && m_error.isEmpty())
+    m_error = errorMessage;
+  if (!m_writer.open(m_path, info, m_options, errorMessage)) {
+    if (m_error.isEmpty())
+      m_error = errorMessage;
+    return;
+  }
+  processorWasClocked();
+}
+
+void TraceRecorder::processorWasClocked() {
+  if (!m_writer.isOpen())
+    return;
+
+  auto *processor = ProcessorHandler::getProcessorNonConst();
+  auto &cycle = m_cycle;
+  cycle.cycle = processor->getCycleCount();
+
+  const auto fetch = processor->instrMemAccess();
+  cycle.fetched = fetch.type == MemoryAccess::Read;
+  if (cycle.fetched) {
+    cycle.fetchPC = fetch.address;
+    cycle.instruction =
+        processor->getMemory().readMemConst(fetch.address, m_instrBytes);
+  }
+  cycle.dataAccess = processor->dataMemAccess();
+
+  cycle.regWrites.clear();
+  unsigned valueIdx = 0;
+  for (unsigned file = 0; file < m_regFiles.size(); ++file) {
+    const auto &[regFile, regCnt] = m_regFiles[file];
+    for (unsigned i = 0; i < regCnt; ++i, ++valueIdx) {
+      const VInt value = processor->getRegister(regFile, i);
+      if (value == m_regValues[valueIdx])
+        continue;
+      m_regValues[valueIdx] = value;
+      cycle.regWrites.push_back({static_cast<uint8_t>(file),
+                                 static_cast<uint8_t>(i), value});
+    }
+  }
+
+  cycle.stages.resize(m_stages.size());
+  for (unsigned i = 0; i < m_stages.size(); ++i) {
+    const auto info = processor->stageInfo(m_stages[i]);
+    auto &stage = cycle.stages[i];
+    stage.pc = processor->getPcForStage(m_stages[i]);
+    stage.valid = info.stage_valid;
+    stage.state = info.state;
+  }
+
+  m_writer.append(cycle);
+}
+
+} // namespace Ripes
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+
+#include "tracewriter.h"
+
+namespace Ripes {
+
+/**
+ * @brief The TraceRecorder class
+ * Records an execution trace of the current processor. Upon construction, the
+ * recorder connects to the ProcessorHandler and records every cycle of the
+ * processor, in lockstep with the processor itself. Whenever the processor is
+ * reset, the trace is restarted, such that it covers the execution since the
+ * most recent reset. The initial state after a reset is recorded as the first
+ * cycle.
+ */
+class TraceRecorder : public QObject {
+  Q_OBJECT
+public:
+  TraceRecorder(const QString &path, const TraceWriter::Options &options,
+                QObject *parent = nullptr);
+
+  /// Writes the remainder of the trace and closes the trace file. Returns
+  /// false if recording the trace failed at any point.
+  bool finish(QString &errorMessage);
+
+  TraceWriter::Stats stats() const { return m_writer.stats(); }
+  const QString &path() const { return m_path; }
+
+private:
+  void processorReset();
+  void processorWasClocked();
+
+  QString m_path;
+  TraceWriter::Options m_options;
+  TraceWriter m_writer;
+  // The first error of recording the trace, if any.
+  QString m_error;
+
+  // The stages and register files of the current processor, and the register
+  // values of the previous cycle, by which register writes are detected.
+  std::vector<StageIndex> m_stages;
+  std::vector<std::pair<std::string_view, unsigned>> m_regFiles;
+  std::vector<VInt> m_regValues;
+  unsigned m_instrBytes = 0;
+  // Reused across cycles to avoid allocating.
+  TraceCycle m_cycle;
+};
+
+} // namespace Ripes
@@ -0,0 +1,136 @@
+#include "tracereplayer.h"
+#include "isa/rvisainfo_common.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+namespace {
+
+// Cycles replayed between checks of the abort flag.
+constexpr uint64_t s_abortCheckInterval = 1 << 16;
+// log2 of the entries of the table of fetched instructions.
+constexpr unsigned s_fetchedTableBits = 16;
+
+unsigned fetchedIndex(AInt pc) {
+  // Instructions are at least 2-byte aligned.
+  return (pc >> 1) & ((1 << s_fetchedTableBits) - 1);
+}
+
+bool isCompressed(uint32_t instr) { return (instr & 0b11) != RVISA::QUADRANT3; }
+
+/// Returns true if @p instr is a conditional branch; a RISC-V branch, or
+/// c.beqz/c.bnez.
+bool isConditionalBranch(uint32_t instr) {
+  if (!isCompressed(instr))
+    return (instr & 0x7F) == RVISA::OpcodeID::BRANCH;
+  return (instr & 0b11) == RVISA::QUADRANT1 && ((instr >> 13) & 0b111) >= 0b110;
+}
+
+} // namespace
+
+bool TraceReplayer::replay(TraceReader &reader, const std::atomic<bool> &abort,
+                           QString &errorMessage) {
+  const auto &info = reader.info();
+  m_retireStages.clear();
+  unsigned laneEnd = 0;
+  for (const unsigned stages : info.lanes) {
+    laneEnd += stages;
+    if (stages > 0)
+      m_retireStages.push_back(laneEnd - 1);
+  }
+  const bool trackBranches = !m_predictors.empty();
+  m_pendingBranch = false;
+  if (trackBranches && m_fetched.empty())
+    m_fetched.resize(1 << s_fetchedTableBits);
+
+  TraceCycle cycle;
+  uint64_t previousCycle = 0;
+  while (reader.next(cycle)) {
+    if (++m_stats.cycles % s_abortCheckInterval == 0 && abort) {
+      errorMessage = "Replay of the trace was aborted.";
+      return false;
+    }
+
+    if (cycle.fetched) {
+      ++m_stats.instrAccesses;
+      for (auto *cache : m_instrCaches)
+        cache->access(cycle.fetchPC, MemoryAccess::Read, cycle.fetchPC,
+                      info.instrBytes);
+      if (trackBranches)
+        fetched(cycle.fetchPC, cycle.instruction);
+    }
+
+    const auto &access = cycle.dataAccess;
+    if (access.type != MemoryAccess::None) {
+      ++m_stats.dataAccesses;
+      for (auto *cache : m_dataCaches)
+        cache->access(access.address, access.type, access.pc, access.bytes);
+    }
+
+    if (cycle.stages.empty())
+      continue;
+    // Cycles are discontinuous if the processor was reversed, after which the
+    // direction of a pending branch is unknown.
+    if (cycle.cycle != previousCycle + 1)
+      m_pendingBranch = false;
+    previousCycle = cycle.cycle;
+
+    m_retiring.clear();
+    for (const unsigned retireStage : m_retireStages) {
+      const auto &stage = cycle.stages[retireStage];
+      if (stage.valid && stage.state == StageInfo::State::None)
+        m_retiring.push_back(stage.pc);
+    }
+    m_stats.retired += m_retiring.size();
+    if (!trackBranches)
+      continue;
+    // Instructions retired in the same cycle (by different lanes) are
+    // consecutive in program order.
+    std::sort(m_retiring.begin(), m_retiring.end());
+    for (const AInt pc : m_retiring)
+      retire(pc);
+  }
+
+  if (!reader.error().isEmpty()) {
+    errorMessage = reader.error();
+    return false;
+  }
+  return true;
+}
+
+void TraceReplayer::fetched(AInt pc, uint32_t instruction) {
+  auto &entry = m_fetched[fetchedIndex(pc)];
+  if (entry.valid && entry.pc != pc)
+    m_evicted[entry.pc] = entry.instruction;
+  entry = {pc, instruction, true};
+}
+
+void TraceReplayer::retire(AInt pc) {
+  if (m_pendingBranch) {
+    ++m_stats.branches;
+    const bool taken = pc != m_fallthroughPC;
+    for (auto *predictor : m_predictors)
+      predictor->predict(m_branchPC, taken);
+  }
+
+  const auto &entry = m_fetched[fetchedIndex(pc)];
+  uint32_t instruction = entry.instruction;
+  if (!entry.valid || entry.pc != pc) {
+    const auto it = m_evicted.find(pc);
+    if (it == m_evicted.end()) {
+      // The instruction was not fetched within the trace.
+      m_pendingBranch = false;
+      return;
+    }
+    instruction = it->second;
+  }
+
+  m_pendingBranch = isConditionalBranch(instruction);
+  if (m_pendingBranch) {
+    m_branchPC = pc;
+    m_fallthroughPC = pc + (isCompressed(instruction) ? 2 : 4);
+  }
+}
+
+} // namespace Ripes
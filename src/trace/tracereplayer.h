@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <unordered_map>
+
+#include "branchpredictor.h"
+#include "cachesim/cachesim.h"
+#include "tracereader.h"
+
+namespace Ripes {
+
+/**
+ * @brief The TraceReplayer class
+ * Drives cache and branch predictor models with a recorded execution trace,
+ * without simulating the processor which the trace was recorded from.
+ * Instruction caches are accessed by the instruction fetches of the trace,
+ * and data caches by its data memory accesses. Branch predictors are trained
+ * on the conditional branches retired by the processor, in program order.
+ * Retired instructions are those which leave the last stage of a lane of the
+ * processor; the direction of a branch is given by whether the next retired
+ * instruction follows it sequentially.
+ */
+class TraceReplayer {
+public:
+  struct Stats {
+    uint64_t cycles = 0;
+    uint64_t instrAccesses = 0;
+    uint64_t dataAccesses = 0;
+    uint64_t retired = 0;
+    uint64_t branches = 0;
+  };
+
+  void addInstrCache(CacheInterface *cache) {
+    m_instrCaches.push_back(cache);
+  }
+  void addDataCache(CacheInterface *cache) { m_dataCaches.push_back(cache); }
+  void addPredictor(BranchPredictor *predictor) {
+    m_predictors.push_back(predictor);
+  }
+
+  /// Replays the remaining cycles of @p reader through the models of the
+  /// replayer. Returns false if the trace is malformed, or if @p abort was
+  /// set.
+  bool replay(TraceReader &reader, const std::atomic<bool> &abort,
+              QString &errorMessage);
+
+  const Stats &stats() const { return m_stats; }
+
+private:
+  struct FetchedInstr {
+    AInt pc = 0;
+    uint32_t instruction = 0;
+    bool valid = false;
+  };
+
+  /// Records @p instruction as the instruction word at @p pc.
+  void fetched(AInt pc, uint32_t instruction);
+  /// Trains the predictors with the direction of the previously retired
+  /// instruction, if a conditional branch, given that @p pc is retired next.
+  void retire(AInt pc);
+
+  std::vector<CacheInterface *> m_instrCaches;
+  std::vector<CacheInterface *> m_dataCaches;
+  std::vector<BranchPredictor *> m_predictors;
+  Stats m_stats;
+
+  /// The instruction words of all fetched PCs, such that retired instructions
+  /// can be decoded. Instructions are held in a direct-mapped table indexed by
+  /// their PC, and are moved into a map when evicted from the table by a
+  /// conflicting PC. Lookups thus only hash if programs are large enough to
+  /// conflict.
+  std::vector<FetchedInstr> m_fetched;
+  std::unordered_map<AInt, uint32_t> m_evicted;
+  /// The last stage of each lane, by index into TraceCycle::stages.
+  std::vector<unsigned> m_retireStages;
+  /// PCs retired in the current cycle.
+  std::vector<AInt> m_retiring;
+  /// The previously retired instruction, if it was a conditional branch.
+  bool m_pendingBranch = false;
+  AInt m_branchPC = 0;
+  AInt m_fallthroughPC = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,175 @@
+#include "tracewriter.h"
+#include "blockcompression.h"
+
+#include <algorithm>
+
+namespace Ripes {
+
+TraceWriter::~TraceWriter() {
+  QString errorMessage;
+  close(errorMessage);
+}
+
+bool TraceWriter::open(const QString &path, const TraceInfo &info,
+                       const Options &options, QString &errorMessage) {
+  if (isOpen() && !close(errorMessage))
+    return false;
+
+  m_options = options;
+  m_info = info;
+  m_info.compressed = options.compress;
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    errorMessage = "Failed to open trace file '" + path +
+                   "': " + m_file.errorString();
+    return false;
+  }
+
+  std::vector<uint8_t> header;
+  TraceFormat::writeHeader(m_info, header);
+  if (m_file.write(reinterpret_cast<const char *>(header.data()),
+                   header.size()) != static_cast<qint64>(header.size())) {
+    errorMessage = "Failed to write trace file '" + path +
+                   "': " + m_file.errorString();
+    m_file.close();
+    return false;
+  }
+
+  m_ring.assign(std::max(m_options.ringBlocks, 1u), Block());
+  m_submitted = 0;
+  m_written = 0;
+  m_closing = false;
+  m_current = nullptr;
+  m_cycles = 0;
+  m_rawBytes = 0;
+  m_error.clear();
+  m_fileBytes = header.size();
+  m_thread = std::thread([this] { writeBlocks(); });
+  return true;
+}
+
+void TraceWriter::append(const TraceCycle &cycle) {
+  if (!m_current)
+    acquireBlock();
+  if (m_current->cycles == 0) {
+    m_current->firstCycle = cycle.cycle;
+    m_state.reset(cycle.cycle, m_info.lanes);
+  }
+  TraceFormat::encodeCycle(cycle, m_state, m_current->data);
+  ++m_current->cycles;
+  ++m_cycles;
+  if (m_current->data.size() >= m_options.blockBytes)
+    submitBlock();
+}
+
+bool TraceWriter::close(QString &errorMessage) {
+  if (!isOpen())
+    return true;
+
+  if (m_current && m_current->cycles != 0)
+    submitBlock();
+  m_current = nullptr;
+  {
+    std::lock_guard lock(m_ringMutex);
+    m_closing = true;
+  }
+  m_ringChanged.notify_all();
+  m_thread.join();
+  m_file.close();
+
+  // Release the memory of the ring until the writer is reopened.
+  m_ring.clear();
+  m_ring.shrink_to_fit();
+  if (!m_error.isEmpty()) {
+    errorMessage = m_error;
+    return false;
+  }
+  return true;
+}
+
+TraceWriter::Stats TraceWriter::stats() const {
+  Stats stats;
+  stats.cycles = m_cycles;
+  stats.rawBytes = m_rawBytes;
+  stats.fileBytes = m_fileBytes;
+  return stats;
+}
+
+void TraceWriter::acquireBlock() {
+  std::unique_lock lock(m_ringMutex);
+  m_ringChanged.wait(lock,
+                     [&] { return m_submitted - m_written < m_ring.size(); });
+  m_current = &m_ring[m_submitted % m_ring.size()];
+  m_current->data.clear();
+  m_current->cycles = 0;
+}
+
+void TraceWriter::submitBlock() {
+  m_rawBytes += m_current->data.size();
+  m_current = nullptr;
+  {
+    std::lock_guard lock(m_ringMutex);
+    ++m_submitted;
+  }
+  m_ringChanged.notify_all();
+}
+
+void TraceWriter::writeBlocks() {
+  while (true) {
+    const Block *block = nullptr;
+    {
+      std::unique_lock lock(m_ringMutex);
+      m_ringChanged.wait(lock,
+                         [&] { return m_written < m_submitted || m_closing; });
+      if (m_written == m_submitted)
+        return;
+      block = &m_ring[m_written % m_ring.size()];
+    }
+
+    // Once writing has failed, blocks are still consumed such that appending
+    // never blocks indefinitely.
+    if (m_error.isEmpty())
+      writeBlock(*block);
+
+    {
+      std::lock_guard lock(m_ringMutex);
+      ++m_written;
+    }
+    m_ringChanged.notify_all();
+  }
+}
+
+void TraceWriter::writeBlock(const Block &block) {
+  const uint8_t *payload = block.data.data();
+  size_t storedBytes = block.data.size();
+  if (m_options.compress) {
+    m_compressed.clear();
+    BlockCompression::compress(block.data.data(), block.data.size(),
+                               m_compressed);
+    // Blocks which do not compress are stored as-is.
+    if (m_compressed.size() < block.data.size()) {
+      payload = m_compressed.data();
+      storedBytes = m_compressed.size();
+    }
+  }
+
+  m_blockHeader.clear();
+  TraceFormat::putLE(m_blockHeader, block.data.size(), sizeof(uint32_t));
+  TraceFormat::putLE(m_blockHeader, storedBytes, sizeof(uint32_t));
+  TraceFormat::putLE(m_blockHeader, block.cycles, sizeof(uint32_t));
+  TraceFormat::putLE(m_blockHeader, block.firstCycle, sizeof(uint64_t));
+  const qint64 headerWritten =
+      m_file.write(reinterpret_cast<const char *>(m_blockHeader.data()),
+                   m_blockHeader.size());
+  const qint64 payloadWritten =
+      m_file.write(reinterpret_cast<const char *>(payload), storedBytes);
+  if (headerWritten != static_cast<qint64>(m_blockHeader.size()) ||
+      payloadWritten != static_cast<qint64>(storedBytes)) {
+    m_error = "Failed to write trace file '" + m_file.fileName() +
+              "': " + m_file.errorString();
+    return;
+  }
+  m_fileBytes += m_blockHeader.size() + storedBytes;
+}
+
+} // namespace Ripes
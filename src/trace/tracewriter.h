@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QFile>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "traceformat.h"
+
+namespace Ripes {
+
+/**
+ * @brief The TraceWriter class
+ * Writes an execution trace (see traceformat.h) to a file. Cycles are encoded
+ * into blocks on the thread appending them, and full blocks are passed through
+ * a bounded ring of blocks to a background thread, which compresses and writes
+ * them. The memory of the writer is thus bounded by the size of the ring,
+ * regardless of the length of the trace. If the background thread falls
+ * behind, appending waits until a block of the ring is free.
+ */
+class TraceWriter {
+public:
+  struct Options {
+    /// Compress the blocks of the trace (see BlockCompression).
+    bool compress = false;
+    /// Bytes of records after which a block is written.
+    unsigned blockBytes = 1 << 16;
+    /// Number of blocks in the ring between the appending thread and the
+    /// background thread.
+    unsigned ringBlocks = 8;
+  };
+
+  struct Stats {
+    uint64_t cycles = 0;
+    /// Bytes of records, prior to compression.
+    uint64_t rawBytes = 0;
+    /// Bytes of the trace file, including the header.
+    uint64_t fileBytes = 0;
+  };
+
+  TraceWriter() = default;
+  ~TraceWriter();
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+  /// Creates the trace file at @p path, truncating any existing file, and
+  /// starts the background thread. Closes the currently open trace, if any.
+  /// Returns false if the file could not be created.
+  bool open(const QString &path, const TraceInfo &info, const Options &options,
+            QString &errorMessage);
+
+  /// Appends the record of @p cycle to the trace. @p cycle must provide a
+  /// stage for each stage of the trace info, or no stages at all.
+  void append(const TraceCycle &cycle);
+
+  /// Writes all appended cycles, stops the background thread and closes the
+  /// file. Returns false if writing the trace failed at any point.
+  bool close(QString &errorMessage);
+
+  bool isOpen() const { return m_thread.joinable(); }
+  /// Statistics of the current (or most recently closed) trace. The file bytes
+  /// only cover blocks which have been written.
+  Stats stats() const;
+
+private:
+  struct Block {
+    std::vector<uint8_t> data;
+    uint64_t firstCycle = 0;
+    uint32_t cycles = 0;
+  };
+
+  /// Acquires a free block of the ring as the current block.
+  void acquireBlock();
+  /// Passes the current block to the background thread.
+  void submitBlock();
+  /// The loop of the background thread.
+  void writeBlocks();
+  void writeBlock(const Block &block);
+
+  Options m_options;
+  TraceInfo m_info;
+  QFile m_file;
+  std::thread m_thread;
+
+  std::vector<Block> m_ring;
+  std::mutex m_ringMutex;
+  std::condition_variable m_ringChanged;
+  // Blocks submitted by the appending thread and written by the background
+  // thread; guarded by m_ringMutex. Block i is at ring index i % ring size.
+  uint64_t m_submitted = 0;
+  uint64_t m_written = 0;
+  bool m_closing = false;
+
+  // Owned by the appending thread.
+  Block *m_current = nullptr;
+  TraceDeltaState m_state;
+  uint64_t m_cycles = 0;
+  uint64_t m_rawBytes = 0;
+
+  // Owned by the background thread.
+  std::vector<uint8_t> m_compressed;
+  std::vector<uint8_t> m_blockHeader;
+  QString m_error;
+  std::atomic<uint64_t> m_fileBytes = 0;
+};
+
+} // namespace Ripes
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Ripes {
+
+/**
+ * @brief The TripleBuffer class
+ * A lock-free single-producer/single-consumer triple buffer. The writer fills
+ * the back buffer and publishes it, while the reader fetches the most recently
+ * published buffer. Neither side ever waits for the other; the writer may
+ * publish faster than the reader fetches, in which case intermediate buffers
+ * are dropped. Buffers are reused, such that a T which retains its allocations
+ * (vectors, maps, ...) avoids allocating once warmed up.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  /// The buffer to be written by the writer. Only accessed by the writer.
+  T &back() { return m_buffers[m_back]; }
+
+  /// Publishes the back buffer, such that it is the next buffer to be fetched
+  /// by the reader. The writer continues with a new back buffer, whose
+  /// contents are stale.
+  void publish() {
+    const uint8_t previous =
+        m_latest.exchange(m_back | s_fresh, std::memory_order_acq_rel);
+    m_back = previous & s_indexMask;
+  }
+
+  /// Makes the most recently published buffer the front buffer. Returns false
+  /// if nothing was published since the last fetch, in which case the front
+  /// buffer is unchanged. Only called by the reader.
+  bool fetch() {
+    if (!(m_latest.load(std::memory_order_relaxed) & s_fresh))
+      return false;
+    const uint8_t previous =
+        m_latest.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & s_indexMask;
+    return true;
+  }
+
+  /// The buffer most recently fetched by the reader. Only accessed by the
+  /// reader.
+  const T &front() const { return m_buffers[m_front]; }
+
+private:
+  static constexpr uint8_t s_indexMask = 0b011;
+  // Set in m_latest when it holds a buffer which has not been fetched.
+  static constexpr uint8_t s_fresh = 0b100;
+
+  std::array<T, 3> m_buffers;
+  // Owned by the writer.
+  uint8_t m_back = 0;
+  // The buffer most recently published, exchanged between writer and reader.
+  alignas(64) std::atomic<uint8_t> m_latest = 1;
+  // Owned by the reader.
+  alignas(64) uint8_t m_front = 2;
+};
+
+} // namespace Ripes
@@ -0,0 +1,164 @@
+.text
+main:
+
+  #-------------------------------------------------------------
+  # AMO tests
+  #-------------------------------------------------------------
+
+test_2:
+ la a1, d1
+ li a2, 7
+ amoswap.d a0, a2, (a1)
+ li t2, 1
+ li gp, 2
+ bne a0, t2, fail
+ ld a0, 0(a1)
+ li t2, 7
+ bne a0, t2, fail
+
+test_3:
+ li a2, 0x100000000
+ amoadd.d a0, a2, (a1)
+ li t2, 7
+ li gp, 3
+ bne a0, t2, fail
+ ld a0, 0(a1)
+ li t2, 0x100000007
+ bne a0, t2, fail
+
+test_4:
+ li a2, -1
+ amoxor.d a0, a2, (a1)
+ li t2, 0x100000007
+ li gp, 4
+ bne a0, t2, fail
+ ld a0, 0(a1)
+ li t2, 0xfffffffefffffff8
+ bne a0, t2, fail
+
+test_5:
+ li a2, 0xff
+ amoand.d a0, a2, (a1)
+ li gp, 5
+ ld a0, 0(a1)
+ li t2, 0xf8
+ bne a0, t2, fail
+
+test_6:
+ li a2, 0x7
+ amoor.d a0, a2, (a1)
+ li gp, 6
+ ld a0, 0(a1)
+ li t2, 0xff
+ bne a0, t2, fail
+
+test_7:
+ la a1, d2
+ li a2, 5
+ amomin.d a0, a2, (a1)
+ li t2, 0x8000000000000000
+ li gp, 7
+ bne a0, t2, fail
+ ld a0, 0(a1)
+ bne a0, t2, fail
+
+test_8:
+ amomax.d a0, a2, (a1)
+ li gp, 8
+ ld a0, 0(a1)
+ li t2, 5
+ bne a0, t2, fail
+
+test_9:
+ li a2, -1
+ amominu.d a0, a2, (a1)
+ li gp, 9
+ ld a0, 0(a1)
+ li t2, 5
+ bne a0, t2, fail
+
+test_10:
+ amomaxu.d a0, a2, (a1)
+ li gp, 10
+ ld a0, 0(a1)
+ li t2, -1
+ bne a0, t2, fail
+
+  #-------------------------------------------------------------
+  # Word AMOs sign-extend their result, and compare 32-bit values
+  #-------------------------------------------------------------
+
+test_11:
+ la a1, d4
+ li a2, 1
+ amoadd.w a0, a2, (a1)
+ li t2, 0x7fffffff
+ li gp, 11
+ bne a0, t2, fail
+ amoadd.w a0, a2, (a1)
+ li t2, 0xffffffff80000000
+ bne a0, t2, fail
+
+test_12:
+ # 0x80000001 is the signed minimum of the two, but not the unsigned one
+ li a2, 0x100000005
+ amomin.w a0, a2, (a1)
+ li gp, 12
+ lw a0, 0(a1)
+ li t2, 0xffffffff80000001
+ bne a0, t2, fail
+ amominu.w a0, a2, (a1)
+ lw a0, 0(a1)
+ li t2, 5
+ bne a0, t2, fail
+
+  #-------------------------------------------------------------
+  # LR/SC tests
+  #-------------------------------------------------------------
+
+test_13:
+ la a1, d3
+ lr.d a0, (a1)
+ li a2, 0x123456789
+ sc.d a3, a2, (a1)
+ li gp, 13
+ bne a0, zero, fail
+ bne a3, zero, fail
+ ld a0, 0(a1)
+ bne a0, a2, fail
+
+test_14:
+ # A reservation of a word does not cover a doubleword store-conditional
+ lr.w a0, (a1)
+ sc.d a3, zero, (a1)
+ li gp, 14
+ beq a3, zero, fail
+ ld a0, 0(a1)
+ bne a0, a2, fail
+
+test_15:
+ lr.d.aqrl a0, (a1)
+ sc.d.aqrl a3, zero, (a1)
+ li gp, 15
+ bne a3, zero, fail
+ ld a0, 0(a1)
+ bne a0, zero, fail
+
+ bne zero, gp, pass
+
+pass:
+ li a0, 42
+ li a7, 93
+ ecall
+
+fail:
+ li a0, 0
+ li a7, 93
+ ecall
+
+.data
+
+d1: .dword 0x0000000000000001
+d2: .dword 0x8000000000000000
+d3: .dword 0x0000000000000000
+d4: .word 0x7fffffff
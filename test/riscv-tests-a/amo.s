@@ -0,0 +1,168 @@
+.text
+main:
+
+  #-------------------------------------------------------------
+  # AMO tests
+  #-------------------------------------------------------------
+
+test_2:
+ la a1, d1
+ li a2, 7
+ amoswap.w a0, a2, (a1)
+ li t2, 1
+ li gp, 2
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 7
+ bne a0, t2, fail
+
+test_3:
+ amoadd.w a0, a2, (a1)
+ li t2, 7
+ li gp, 3
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 14
+ bne a0, t2, fail
+
+test_4:
+ li a2, 0xff
+ amoxor.w a0, a2, (a1)
+ li t2, 14
+ li gp, 4
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 0xf1
+ bne a0, t2, fail
+
+test_5:
+ li a2, 0x0f
+ amoand.w a0, a2, (a1)
+ li t2, 0xf1
+ li gp, 5
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 0x01
+ bne a0, t2, fail
+
+test_6:
+ li a2, 0x30
+ amoor.w a0, a2, (a1)
+ li t2, 0x01
+ li gp, 6
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 0x31
+ bne a0, t2, fail
+
+test_7:
+ la a1, d2
+ li a2, 5
+ amomin.w a0, a2, (a1)
+ li t2, 0x80000000
+ li gp, 7
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ bne a0, t2, fail
+
+test_8:
+ amomax.w a0, a2, (a1)
+ li t2, 0x80000000
+ li gp, 8
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, 5
+ bne a0, t2, fail
+
+test_9:
+ li a2, -1
+ amominu.w a0, a2, (a1)
+ li t2, 5
+ li gp, 9
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ bne a0, t2, fail
+
+test_10:
+ amomaxu.w a0, a2, (a1)
+ li t2, 5
+ li gp, 10
+ bne a0, t2, fail
+ lw a0, 0(a1)
+ li t2, -1
+ bne a0, t2, fail
+
+  #-------------------------------------------------------------
+  # LR/SC tests
+  #-------------------------------------------------------------
+
+test_11:
+ la a1, d3
+ lr.w a0, (a1)
+ li a2, 9
+ sc.w a3, a2, (a1)
+ li gp, 11
+ bne a0, zero, fail
+ bne a3, zero, fail
+ lw a0, 0(a1)
+ li t2, 9
+ bne a0, t2, fail
+
+test_12:
+ # The reservation was released by the previous store-conditional
+ li a2, 10
+ sc.w a3, a2, (a1)
+ li gp, 12
+ beq a3, zero, fail
+ lw a0, 0(a1)
+ li t2, 9
+ bne a0, t2, fail
+
+test_13:
+ # A store to the reserved address invalidates the reservation
+ lr.w a0, (a1)
+ sw zero, 0(a1)
+ sc.w a3, a2, (a1)
+ li gp, 13
+ beq a3, zero, fail
+ lw a0, 0(a1)
+ bne a0, zero, fail
+
+test_14:
+ li a2, 9
+ amoadd.w.aqrl a0, a2, (a1)
+ lr.w.aq a0, (a1)
+ sc.w.rl a3, a2, (a1)
+ li gp, 14
+ bne a3, zero, fail
+ li t2, 9
+ bne a0, t2, fail
+
+test_15:
+ # The result of an AMO is used by the next instruction
+ amoadd.w a0, a2, (a1)
+ addi a4, a0, 1
+ li t2, 10
+ li gp, 15
+ bne a4, t2, fail
+ lw a0, 0(a1)
+ li t2, 18
+ bne a0, t2, fail
+
+ bne zero, gp, pass
+
+pass:
+ li a0, 42
+ li a7, 93
+ ecall
+
+fail:
+ li a0, 0
+ li a7, 93
+ ecall
+
+.data
+
+d1: .word 0x00000001
+d2: .word 0x80000000
+d3: .word 0x00000000
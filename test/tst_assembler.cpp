@@ -45,6 +45,7 @@ private slots:
   void tst_stringDirectives();
   void tst_riscv();
   void tst_relativeLabels();
+  void tst_disassemblyCache();
 
 private:
   QString createProgram(int entries) {
@@ -416,5 +417,26 @@ void tst_Assembler::tst_matcher() {
   }
 }
 
+void tst_Assembler::tst_disassemblyCache() {
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_SS, {"M"});
+  auto res = ProcessorHandler::getAssembler()->assembleRaw(
+      "addi a0 a0 1\nadd a1 a1 a2");
+  QVERIFY(res.errors.size() == 0);
+  ProcessorHandler::loadProgram(std::make_shared<Program>(res.program));
+
+  const AInt textStart = ProcessorHandler::getTextStart();
+  const QString first = ProcessorHandler::disassembleInstr(textStart);
+  QVERIFY(first.startsWith("addi"));
+  // Repeated lookups are served from the cache.
+  QCOMPARE(ProcessorHandler::disassembleInstr(textStart), first);
+
+  // Writes to the text section are reflected in the disassembly.
+  const VInt add = ProcessorHandler::getMemory().readMem(textStart + 4, 4);
+  ProcessorHandler::writeMem(textStart, add, 4);
+  QCOMPARE(ProcessorHandler::disassembleInstr(textStart),
+           ProcessorHandler::disassembleInstr(textStart + 4));
+  QVERIFY(ProcessorHandler::disassembleInstr(textStart).startsWith("add "));
+}
+
 QTEST_APPLESS_MAIN(tst_Assembler)
 #include "tst_assembler.moc"
@@ -0,0 +1,161 @@
+#include <QSignalSpy>
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "isa/rvisainfo_common.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+// This test ensures that conditional breakpoints and watchpoints stop the
+// processor at the expected point of execution.
+
+class tst_breakpoints : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void init();
+  void tst_condition();
+  void tst_hitCount();
+  void tst_invalidCondition();
+  void tst_writeWatchpoint();
+  void tst_changeWatchpoint();
+  void tst_watchpointAtConditionalBreakpoint();
+
+private:
+  /// Clocks the processor until a breakpoint or watchpoint triggers. Returns
+  /// false if the program finished first.
+  bool runToBreakpoint();
+  AInt symbolAddress(const QString &name);
+  VInt a0() { return ProcessorHandler::getRegisterValue(RVISA::GPR, 10); }
+
+  ProgramLoader *m_loader = nullptr;
+};
+
+static const QStringList s_program = {".data",
+                                      "a: .word 0",
+                                      ".text",
+                                      "li a0 0",
+                                      "loop:",
+                                      "addi a0 a0 1",
+                                      "li t0 10",
+                                      "blt a0 t0 loop",
+                                      "la a1 a",
+                                      "store:",
+                                      "sw a0 0 a1"};
+
+void tst_breakpoints::initTestCase() {
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_SS, {});
+  m_loader = new ProgramLoader();
+  m_loader->loadTest(s_program.join("\n"));
+}
+
+void tst_breakpoints::init() {
+  ProcessorHandler::clearBreakpoints();
+  ProcessorHandler::clearWatchpoints();
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  ProcessorHandler::getProcessorNonConst()->trapHandler = [] {};
+}
+
+bool tst_breakpoints::runToBreakpoint() {
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000) {
+    if (ProcessorHandler::checkBreakpoint())
+      return true;
+    proc->clock();
+  }
+  return false;
+}
+
+AInt tst_breakpoints::symbolAddress(const QString &name) {
+  for (const auto &[address, symbol] : ProcessorHandler::getProgram()->symbols)
+    if (symbol.v == name)
+      return address;
+  QTest::qFail("Symbol not found", __FILE__, __LINE__);
+  return 0;
+}
+
+void tst_breakpoints::tst_condition() {
+  const AInt loop = symbolAddress("loop");
+  QString errorMessage;
+  ProcessorHandler::setBreakpoint(loop, true);
+  QVERIFY(ProcessorHandler::setBreakpointCondition(loop, "a0 == 5",
+                                                   errorMessage));
+  QVERIFY(runToBreakpoint());
+  QCOMPARE(a0(), VInt(5));
+  QCOMPARE(ProcessorHandler::breakpointCondition(loop), QString("a0 == 5"));
+}
+
+void tst_breakpoints::tst_hitCount() {
+  const AInt loop = symbolAddress("loop");
+  QString errorMessage;
+  ProcessorHandler::setBreakpoint(loop, true);
+  QVERIFY(ProcessorHandler::setBreakpointCondition(
+      loop, "hits > 3 && a0 >= 0x2", errorMessage));
+  QVERIFY(runToBreakpoint());
+  // The loop is entered for the fourth time with a0 == 3.
+  QCOMPARE(a0(), VInt(3));
+}
+
+void tst_breakpoints::tst_invalidCondition() {
+  const AInt loop = symbolAddress("loop");
+  QString errorMessage;
+  ProcessorHandler::setBreakpoint(loop, true);
+  for (const auto &condition : {"a0 === 5", "foo == 1", "a0 == 5 && pc"})
+    QVERIFY(!ProcessorHandler::setBreakpointCondition(loop, condition,
+                                                      errorMessage));
+  // Conditions can only be set for existing breakpoints.
+  QVERIFY(!ProcessorHandler::setBreakpointCondition(loop + 4, "a0 == 1",
+                                                    errorMessage));
+  QVERIFY(ProcessorHandler::breakpointCondition(loop).isEmpty());
+}
+
+void tst_breakpoints::tst_writeWatchpoint() {
+  const QString spec = "w:" + QString::number(symbolAddress("a")) + "+4";
+  QString errorMessage;
+  QVERIFY(!ProcessorHandler::addWatchpoint("w:a0", errorMessage));
+  QVERIFY(ProcessorHandler::addWatchpoint(spec, errorMessage));
+  QVERIFY(runToBreakpoint());
+  // Write watchpoints stop before the write is performed.
+  QCOMPARE(ProcessorHandler::getProcessor()->getPcForStage({0, 0}),
+           symbolAddress("store"));
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(symbolAddress("a"), 4),
+           VInt(0));
+  QVERIFY(ProcessorHandler::stopMessage().contains(spec));
+}
+
+void tst_breakpoints::tst_changeWatchpoint() {
+  QString errorMessage;
+  QVERIFY(ProcessorHandler::addWatchpoint("c:a0", errorMessage));
+  QVERIFY(runToBreakpoint());
+  // Loading 0 into a0 does not change it; the first increment does.
+  QCOMPARE(a0(), VInt(1));
+}
+
+void tst_breakpoints::tst_watchpointAtConditionalBreakpoint() {
+  // Running past a breakpoint whose condition does not hold must still check
+  // the watchpoints of the instruction at the breakpoint.
+  const AInt store = symbolAddress("store");
+  const QString spec = "w:" + QString::number(symbolAddress("a")) + "+4";
+  QString errorMessage;
+  ProcessorHandler::setBreakpoint(store, true);
+  QVERIFY(ProcessorHandler::setBreakpointCondition(store, "a0 == 0",
+                                                   errorMessage));
+  QVERIFY(ProcessorHandler::addWatchpoint(spec, errorMessage));
+
+  QSignalSpy runFinished(ProcessorHandler::get(),
+                         &ProcessorHandler::runFinished);
+  ProcessorHandler::run();
+  QVERIFY(runFinished.wait(10000));
+  QCOMPARE(ProcessorHandler::getProcessor()->getPcForStage({0, 0}), store);
+  QCOMPARE(ProcessorHandler::getMemory().readMemConst(symbolAddress("a"), 4),
+           VInt(0));
+  QVERIFY(ProcessorHandler::stopMessage().contains(spec));
+}
+
+QTEST_MAIN(tst_breakpoints)
+#include "tst_breakpoints.moc"
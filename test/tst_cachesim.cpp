@@ -0,0 +1,488 @@
+#include <QtTest/QTest>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
+#include "cachesim/stackdistance.h"
+#include "processorhandler.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+// This test runs small programs on the processor models with a data cache
+// attached, and verifies the resulting cache statistics and cache state.
+
+class tst_cachesim : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_hitsMissesDirty();
+  void tst_stackDistance();
+  void tst_reverse();
+  void tst_reverseManyEntriesPerCycle();
+  void tst_hierarchy();
+  void tst_replacementPolicies();
+  void tst_prefetchers();
+  void tst_randomSeed();
+  void tst_missClassification();
+  void tst_missAttribution();
+  void tst_splitAccesses();
+
+private:
+  std::shared_ptr<CacheSim> runProgram(const ProcessorID &id,
+                                       const QStringList &program,
+                                       const CachePreset &preset,
+                                       QStringList *states = nullptr);
+
+  std::unique_ptr<L1CacheShim> m_shim;
+};
+
+// Loads every word of a 64-byte array, and then stores to every word.
+static const QStringList s_loadStoreProgram = {".data",
+                                               "arr: .zero 64",
+                                               ".text",
+                                               "la a0 arr",
+                                               "li t0 0",
+                                               "li t1 16",
+                                               "load:",
+                                               "slli t2 t0 2",
+                                               "add t3 a0 t2",
+                                               "lw t4, 0(t3)",
+                                               "addi t0 t0 1",
+                                               "blt t0 t1 load",
+                                               "li t0 0",
+                                               "store:",
+                                               "slli t2 t0 2",
+                                               "add t3 a0 t2",
+                                               "sw t0, 0(t3)",
+                                               "addi t0 t0 1",
+                                               "blt t0 t1 store"};
+
+// Returns a textual representation of the contents and statistics of a cache.
+static QString cacheState(const CacheSim &cache) {
+  QString state;
+  for (int lineIdx = 0; lineIdx < cache.getLines(); ++lineIdx) {
+    for (int wayIdx = 0; wayIdx < cache.getWays(); ++wayIdx) {
+      const auto way = cache.getWay(lineIdx, wayIdx);
+      state += QString("%1%2 %3 %4 %5;")
+                   .arg(way.valid)
+                   .arg(way.dirty)
+                   .arg(way.valid ? way.lru : 0)
+                   .arg(way.valid ? way.tag : 0)
+                   .arg(way.dirtyBlocks.size());
+    }
+  }
+  return state + QString("%1 %2 %3")
+                     .arg(cache.getHits())
+                     .arg(cache.getMisses())
+                     .arg(cache.getWritebacks());
+}
+
+std::shared_ptr<CacheSim> tst_cachesim::runProgram(const ProcessorID &id,
+                                                   const QStringList &program,
+                                                   const CachePreset &preset,
+                                                   QStringList *states) {
+  ProcessorHandler::get()->selectProcessor(id, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setPreset(preset);
+  m_shim =
+      std::make_unique<L1CacheShim>(L1CacheShim::CacheType::DataCache, nullptr);
+  m_shim->setNextLevelCache(cache);
+
+  auto loader = new ProgramLoader();
+  loader->loadTest(program.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  while (!proc->finished() && proc->getCycleCount() < 1000) {
+    if (states)
+      *states << cacheState(*cache);
+    proc->clock();
+  }
+
+  if (!proc->finished())
+    QTest::qFail("Execution never finished", __FILE__, __LINE__);
+  return cache;
+}
+
+void tst_cachesim::tst_hitsMissesDirty() {
+  // 4 lines of 4 blocks; exactly fits the 16-word array.
+  CachePreset preset{"test", 2, 2, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+
+  for (auto processor : {ProcessorID::RV32_SS, ProcessorID::RV32_5S}) {
+    auto cache = runProgram(processor, s_loadStoreProgram, preset);
+
+    // One compulsory miss per line, after which all accesses hit.
+    QCOMPARE(cache->getMisses(), 4u);
+    QCOMPARE(cache->getHits(), 28u);
+    QCOMPARE(cache->getWritebacks(), 0u);
+
+    // All lines are valid, and every block has been written to.
+    for (int lineIdx = 0; lineIdx < cache->getLines(); ++lineIdx) {
+      const auto way = cache->getWay(lineIdx, 0);
+      QVERIFY(way.valid);
+      QVERIFY(way.dirty);
+      QCOMPARE(static_cast<int>(way.dirtyBlocks.size()), cache->getBlocks());
+    }
+  }
+}
+
+void tst_cachesim::tst_stackDistance() {
+  // A pseudo-random access stream with a mix of short- and long-range reuse.
+  std::vector<AInt> addresses;
+  uint32_t state = 1;
+  for (unsigned i = 0; i < 20000; ++i) {
+    state = state * 1103515245 + 12345;
+    const unsigned r = (state >> 16) % 100;
+    const unsigned offset = (state >> 8) % 8192;
+    addresses.push_back(r < 60 ? (offset % 512) * 4
+                               : (r < 90 ? offset * 4 : (i * 4) % 65536));
+  }
+
+  // The single-pass analysis must match simulating each LRU cache separately.
+  for (unsigned blockBits = 0; blockBits <= 2; ++blockBits) {
+    StackDistanceAnalyzer analyzer(2, blockBits, 6);
+    for (const auto address : addresses)
+      analyzer.access(address);
+    QCOMPARE(analyzer.accesses(), static_cast<uint64_t>(addresses.size()));
+
+    for (unsigned lineBits = 0; lineBits <= 6; ++lineBits) {
+      for (unsigned wayBits = 0; wayBits <= 3; ++wayBits) {
+        CacheSim cache(32);
+        cache.setPreset({"test", static_cast<int>(blockBits),
+                         static_cast<int>(lineBits), static_cast<int>(wayBits),
+                         WritePolicy::WriteBack,
+                         WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+        for (const auto address : addresses)
+          cache.access(address, MemoryAccess::Read);
+        QCOMPARE(analyzer.misses(lineBits, wayBits),
+                 static_cast<uint64_t>(cache.getMisses()));
+      }
+    }
+  }
+
+  // Memory usage is bounded by the # of distinct blocks accessed, regardless of
+  // the # of accesses: each line tracks at most twice as many access times as
+  // blocks mapping to it, at each of the analyzed line counts.
+  StackDistanceAnalyzer analyzer(2, 0, 6);
+  for (unsigned i = 0; i < 1000000; ++i)
+    analyzer.access((i % 300) * 4);
+  QCOMPARE(analyzer.coldMisses(), uint64_t(300));
+  QVERIFY(analyzer.accessTimes() <= 2 * 300 * (analyzer.maxLineBits() + 1));
+}
+
+void tst_cachesim::tst_reverse() {
+  // 2 lines of 2 ways; the array does not fit, so lines are evicted and
+  // written back.
+  CachePreset preset{"test", 1, 1, 1, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+
+  for (auto processor : {ProcessorID::RV32_SS, ProcessorID::RV32_5S}) {
+    QStringList states;
+    auto cache = runProgram(processor, s_loadStoreProgram, preset, &states);
+    QVERIFY(cache->getWritebacks() > 0);
+
+    // Reversing the processor must restore the cache state of each cycle, up
+    // until the size of the undo stack.
+    auto proc = ProcessorHandler::get()->getProcessorNonConst();
+    const unsigned cyclesToReverse = std::min<unsigned>(
+        RipesSettings::value(RIPES_SETTING_REWINDSTACKSIZE).toUInt(),
+        states.size());
+    for (unsigned i = 0; i < cyclesToReverse; ++i) {
+      proc->reverseProcessor();
+      cache->reverse();
+      QCOMPARE(cacheState(*cache), states.at(proc->getCycleCount()));
+    }
+  }
+}
+
+void tst_cachesim::tst_reverseManyEntriesPerCycle() {
+  CachePreset preset{"test", 1, 1, 1, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU};
+  ProcessorHandler::get()->selectProcessor(ProcessorID::RV32_SS, {});
+  ProcessorHandler::get()->getProcessorNonConst()->trapHandler = [=] {};
+  auto cache = std::make_shared<CacheSim>(nullptr);
+  cache->setPreset(preset);
+  auto loader = new ProgramLoader();
+  loader->loadTest(s_loadStoreProgram.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+
+  // Each cycle modifies the cache far more than 8 times, and the cycles hold
+  // more undo entries in total than 8 per cycle of the undo stack.
+  auto proc = ProcessorHandler::get()->getProcessorNonConst();
+  const unsigned cycles = 20;
+  const unsigned accessesPerCycle = 64;
+  const unsigned depth =
+      RipesSettings::value(RIPES_SETTING_REWINDSTACKSIZE).toUInt();
+  QVERIFY(cycles < depth);
+  QVERIFY(cycles * accessesPerCycle > 8 * depth);
+  QStringList states;
+  for (unsigned i = 0; i < cycles; ++i) {
+    states << cacheState(*cache);
+    proc->clock();
+    for (unsigned j = 0; j < accessesPerCycle; ++j)
+      cache->access((i * accessesPerCycle + j) * 12, MemoryAccess::Write);
+  }
+
+  // Every cycle, including the oldest ones, must be restored completely.
+  for (unsigned i = 0; i < cycles; ++i) {
+    proc->reverseProcessor();
+    cache->reverse();
+    QCOMPARE(cacheState(*cache), states.at(proc->getCycleCount()));
+  }
+  QCOMPARE(cache->getHits() + cache->getMisses(), 0u);
+}
+
+static bool holdsBlock(const CacheSim &cache, AInt address) {
+  for (int wayIdx = 0; wayIdx < cache.getWays(); ++wayIdx) {
+    const auto way = cache.getWay(cache.getLineIdx(address), wayIdx);
+    if (way.valid && way.tag == cache.getTag(address))
+      return true;
+  }
+  return false;
+}
+
+void tst_cachesim::tst_hierarchy() {
+  // Single-line caches of single-word blocks; A, B and C map to the same line.
+  const AInt A = 0, B = 4, C = 8;
+  auto makeCache = [](int ways) {
+    auto cache = std::make_shared<CacheSim>(32);
+    cache->setPreset({"test", 0, 0, ways, WritePolicy::WriteBack,
+                      WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+    return cache;
+  };
+
+  for (auto policy : {InclusionPolicy::NINE, InclusionPolicy::Inclusive}) {
+    auto l1 = makeCache(1);
+    auto l2 = makeCache(1);
+    l2->setInclusionPolicy(policy);
+    l1->setNextLevelCache(l2);
+
+    // Reading C evicts A from the L2 cache, which is the LRU block in the L2
+    // cache but not in the L1 cache.
+    for (auto address : {A, B, A, C, A})
+      l1->access(address, MemoryAccess::Read);
+    QCOMPARE(l2->getMisses(), policy == InclusionPolicy::Inclusive ? 4u : 3u);
+    if (policy == InclusionPolicy::Inclusive) {
+      // A was back-invalidated from the L1 cache, and missed once more.
+      QCOMPARE(l1->getHits(), 1u);
+      QVERIFY(holdsBlock(*l2, A));
+    } else {
+      // The L1 cache holds A, which is not held by the L2 cache.
+      QCOMPARE(l1->getHits(), 2u);
+      QVERIFY(holdsBlock(*l1, A));
+      QVERIFY(!holdsBlock(*l2, A));
+    }
+  }
+
+  {
+    // Exclusive L2 cache; only holds the victims of the L1 cache.
+    auto l1 = makeCache(0);
+    auto l2 = makeCache(1);
+    l2->setInclusionPolicy(InclusionPolicy::Exclusive);
+    l1->setNextLevelCache(l2);
+
+    l1->access(A, MemoryAccess::Read);
+    QVERIFY(!holdsBlock(*l2, A));
+    l1->access(B, MemoryAccess::Read);
+    QVERIFY(holdsBlock(*l2, A));
+    // A moves back to the L1 cache, and B is moved to the L2 cache.
+    l1->access(A, MemoryAccess::Read);
+    QVERIFY(holdsBlock(*l1, A));
+    QVERIFY(!holdsBlock(*l2, A));
+    QVERIFY(holdsBlock(*l2, B));
+    QCOMPARE(l2->getHits(), 1u);
+    QCOMPARE(l2->getMisses(), 2u);
+
+    // The AMAT accounts for the latency of each level.
+    l1->setHitLatency(1);
+    l2->setHitLatency(10);
+    l2->setMemoryLatency(100);
+    QCOMPARE(l1->getAMAT(), 1 + (10 + (2.0 / 3) * 100));
+  }
+}
+
+void tst_cachesim::tst_replacementPolicies() {
+  // A single line of 4 ways of single-word blocks. A, B, C and D fill the
+  // line, after which A is reused and E evicts a block.
+  const AInt A = 0, B = 4, C = 8, D = 12, E = 16;
+  const std::map<ReplPolicy, AInt> expectedVictims = {
+      {ReplPolicy::LRU, B},   {ReplPolicy::PLRU, C},  {ReplPolicy::FIFO, A},
+      {ReplPolicy::SRRIP, B}, {ReplPolicy::BRRIP, B}, {ReplPolicy::LFU, B}};
+
+  for (const auto &[policy, victim] : expectedVictims) {
+    CacheSim cache(32);
+    cache.setPreset({"test", 0, 0, 2, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, policy});
+    for (auto address : {A, B, C, D, A, E})
+      cache.access(address, MemoryAccess::Read);
+
+    QCOMPARE(cache.getHits(), 1u);
+    for (auto address : {A, B, C, D, E})
+      QCOMPARE(holdsBlock(cache, address), address != victim);
+    QVERIFY(cache.getCacheSize().bits > 0);
+  }
+}
+
+void tst_cachesim::tst_prefetchers() {
+  // A sequential stream of words through a cache of 16 lines of 4-word
+  // blocks, performed by a single load instruction.
+  const AInt pc = 0x40;
+  const unsigned words = 1024;
+  for (auto policy : {PrefetchPolicy::NextLine, PrefetchPolicy::Stride,
+                      PrefetchPolicy::Stream}) {
+    CacheSim cache(32);
+    cache.setPreset({"test", 2, 4, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+    cache.setPrefetchPolicy(policy);
+    for (unsigned i = 0; i < words; ++i)
+      cache.access(0x1000 + i * 4, MemoryAccess::Read, pc);
+
+    // Without prefetching, each block misses once. The prefetchers hide all
+    // but the misses required for training.
+    QVERIFY(cache.getMisses() <= 3);
+    QVERIFY(cache.getPrefetches() > 0);
+    QCOMPARE(cache.getHits() + cache.getMisses(), words);
+    QVERIFY(cache.getUsefulPrefetches() >= words / 4 - 3);
+    QVERIFY(cache.getLatePrefetches() <= cache.getUsefulPrefetches());
+    QCOMPARE(cache.getPollutingPrefetches(), 0u);
+  }
+
+  // Two lines of a single 4-word block each. The next-line prefetch issued by
+  // the second access evicts the block of the first access.
+  CacheSim cache(32);
+  cache.setPreset({"test", 2, 1, 0, WritePolicy::WriteBack,
+                   WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+  cache.setPrefetchPolicy(PrefetchPolicy::NextLine);
+  cache.access(0x20, MemoryAccess::Read);
+  cache.access(0x50, MemoryAccess::Read);
+  QVERIFY(!holdsBlock(cache, 0x20));
+  cache.access(0x20, MemoryAccess::Read);
+  QCOMPARE(cache.getPollutingPrefetches(), 1u);
+  QCOMPARE(cache.getUsefulPrefetches(), 0u);
+}
+
+void tst_cachesim::tst_randomSeed() {
+  // Replays a pseudo-random access stream through a 4-way Random cache
+  // seeded with @p seed.
+  const auto replay = [](uint32_t seed) {
+    CachePreset preset{"test", 1, 2, 2, WritePolicy::WriteBack,
+                       WriteAllocPolicy::WriteAllocate, ReplPolicy::Random};
+    preset.seed = seed;
+    CacheSim cache(32);
+    cache.setPreset(preset);
+    uint32_t address = 1;
+    for (unsigned i = 0; i < 2000; ++i) {
+      address = address * 1103515245 + 12345;
+      cache.access((address >> 8) % 1024, MemoryAccess::Read);
+    }
+    return cacheState(cache);
+  };
+
+  // Victims are fully determined by the seed.
+  QCOMPARE(replay(1), replay(1));
+  QVERIFY(replay(1) != replay(2));
+}
+
+void tst_cachesim::tst_missClassification() {
+  // A direct-mapped cache of 4 lines of single-word blocks. A and E map to the
+  // same line.
+  const AInt A = 0, B = 4, C = 8, D = 12, E = 16, F = 20;
+  CacheSim cache(32);
+  cache.setPreset({"test", 0, 2, 0, WritePolicy::WriteBack,
+                   WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+
+  // 4 compulsory misses, of which E evicts A. A then misses in the cache, but
+  // not in a fully associative cache of 4 blocks (a conflict miss).
+  for (auto address : {A, B, C, E, A})
+    cache.access(address, MemoryAccess::Read);
+  QCOMPARE(cache.getCompulsoryMisses(), 4u);
+  QCOMPARE(cache.getConflictMisses(), 1u);
+  QCOMPARE(cache.getCapacityMisses(), 0u);
+
+  // D and F exceed the capacity of the cache, after which B also misses in a
+  // fully associative cache (a capacity miss).
+  for (auto address : {D, F, B})
+    cache.access(address, MemoryAccess::Read);
+  QCOMPARE(cache.getCompulsoryMisses(), 6u);
+  QCOMPARE(cache.getCapacityMisses(), 1u);
+  QCOMPARE(cache.getCompulsoryMisses() + cache.getCapacityMisses() +
+               cache.getConflictMisses(),
+           cache.getMisses());
+}
+
+void tst_cachesim::tst_missAttribution() {
+  // A direct-mapped cache of 2 lines of single-word blocks. The instructions at
+  // 0x100 and 0x104 both access line 0, evicting each other's blocks.
+  CacheSim cache(32);
+  cache.setPreset({"test", 0, 1, 0, WritePolicy::WriteBack,
+                   WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+  cache.setPCAccounting(true);
+  for (int i = 0; i < 4; ++i) {
+    cache.access(0x0, MemoryAccess::Read, 0x100);
+    cache.access(0x8, MemoryAccess::Read, 0x104);
+    cache.access(0x4, MemoryAccess::Read, 0x200);
+  }
+
+  const auto &counters = cache.getPCAccessCounters();
+  QCOMPARE(counters.size(), size_t(3));
+  QCOMPARE(counters.at(0x100).accesses, 4u);
+  QCOMPARE(counters.at(0x100).misses, 4u);
+  QCOMPARE(counters.at(0x104).misses, 4u);
+  QCOMPARE(counters.at(0x200).misses, 1u);
+
+  // Per-PC accounting is opt-in.
+  CacheSim unattributed(32);
+  unattributed.access(0x0, MemoryAccess::Read, 0x100);
+  QVERIFY(unattributed.getPCAccessCounters().empty());
+
+  const auto sorted = sortByMisses(counters);
+  QCOMPARE(sorted.front().first, AInt(0x100));
+  QCOMPARE(sorted.back().first, AInt(0x200));
+
+  // Instructions are attributed to the closest preceding non-local symbol.
+  const ReverseSymbolMap symbols = {
+      {0x100, Symbol("loop")}, {0x104, Symbol("1")}, {0x200, Symbol("done")}};
+  const auto bySymbol = aggregateBySymbol(counters, symbols);
+  QCOMPARE(bySymbol.size(), size_t(2));
+  QCOMPARE(bySymbol.at(0).symbol, QString("loop"));
+  QCOMPARE(bySymbol.at(0).counters.accesses, 8u);
+  QCOMPARE(bySymbol.at(0).counters.misses, 8u);
+  QCOMPARE(bySymbol.at(1).symbol, QString("done"));
+  QCOMPARE(bySymbol.at(1).counters.misses, 1u);
+}
+
+void tst_cachesim::tst_splitAccesses() {
+  // A direct-mapped cache of 2 lines of 2-word blocks.
+  CacheSim cache(32);
+  cache.setPreset({"test", 1, 1, 0, WritePolicy::WriteBack,
+                   WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+
+  // A misaligned word access straddling both lines is split into an access of
+  // the last halfword of the first block and the first halfword of the second.
+  cache.access(0x6, MemoryAccess::Write, 0, 4);
+  QCOMPARE(cache.getMisses(), 2u);
+  QCOMPARE(cache.getWay(0, 0).dirtyBlocks, std::set<unsigned>({1}));
+  QCOMPARE(cache.getWay(1, 0).dirtyBlocks, std::set<unsigned>({0}));
+
+  // A doubleword access within a block is a single access, which dirties both
+  // words of the block.
+  cache.access(0x0, MemoryAccess::Write, 0, 8);
+  QCOMPARE(cache.getHits(), 1u);
+  QCOMPARE(cache.getWay(0, 0).dirtyBlocks, std::set<unsigned>({0, 1}));
+
+  // On RV64, a misaligned doubleword access straddles two single-word blocks.
+  CacheSim cache64(64);
+  cache64.setPreset({"test", 0, 1, 0, WritePolicy::WriteBack,
+                     WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+  cache64.access(0x4, MemoryAccess::Read, 0, 8);
+  QCOMPARE(cache64.getMisses(), 2u);
+  cache64.access(0x8, MemoryAccess::Read, 0, 8);
+  QCOMPARE(cache64.getHits(), 1u);
+}
+
+QTEST_MAIN(tst_cachesim)
+#include "tst_cachesim.moc"
@@ -0,0 +1,311 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "cachesim/cachesim.h"
+#include "cachesim/l1cacheshim.h"
+#include "cli/cachesweep.h"
+#include "cli/clioptions.h"
+#include "cli/clirunner.h"
+#include "processorhandler.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+// This test runs programs through the CLI mode, and verifies the reports of
+// its telemetry against the simulator models which they summarize.
+
+class tst_cli : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_cacheSweep();
+  void tst_cacheSweepSpecErrors();
+  void tst_timeSeries();
+  void tst_harts();
+
+private:
+  /// Writes @p program to a source file, and runs the CLI mode on it with the
+  /// additional @p args. The JSON report of the run is written to @p report.
+  /// Returns the exit code of the run.
+  int runCLI(const QStringList &program, const QStringList &args,
+             QJsonObject &report);
+  QString path(const QString &fileName) const {
+    return m_dir.filePath(fileName);
+  }
+
+  QTemporaryDir m_dir;
+};
+
+// Loads every word of a 32-word array, and then stores to every word.
+static const QStringList s_loadStoreProgram = {".data",
+                                               "arr: .zero 128",
+                                               ".text",
+                                               "la a0 arr",
+                                               "li t0 0",
+                                               "li t1 32",
+                                               "load:",
+                                               "slli t2 t0 2",
+                                               "add t3 a0 t2",
+                                               "lw t4, 0(t3)",
+                                               "addi t0 t0 1",
+                                               "blt t0 t1 load",
+                                               "li t0 0",
+                                               "store:",
+                                               "slli t2 t0 2",
+                                               "add t3 a0 t2",
+                                               "sw t0, 0(t3)",
+                                               "addi t0 t0 1",
+                                               "blt t0 t1 store"};
+
+int tst_cli::runCLI(const QStringList &program, const QStringList &args,
+                    QJsonObject &report) {
+  QFile src(path("program.s"));
+  if (!src.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    return -1;
+  src.write(program.join("\n").toUtf8());
+  src.close();
+
+  QCommandLineParser parser;
+  CLIModeOptions options;
+  addCLIOptions(parser, options);
+  QString errorMessage;
+  if (!parser.parse(QStringList({"ripes", "--src", src.fileName(), "-t", "asm",
+                                 "--json", "--output", path("report.json")}) +
+                    args) ||
+      !parseCLIOptions(parser, errorMessage, options)) {
+    qWarning() << parser.errorText() << errorMessage;
+    return -1;
+  }
+
+  const int exitCode = CLIRunner(options).run();
+  QFile output(path("report.json"));
+  if (!output.open(QIODevice::ReadOnly))
+    return -1;
+  report = QJsonDocument::fromJson(output.readAll()).object();
+  return exitCode;
+}
+
+void tst_cli::tst_cacheSweep() {
+  QVERIFY(m_dir.isValid());
+  QJsonObject report;
+  QCOMPARE(runCLI(s_loadStoreProgram,
+                  {"--proc", "RV32_5S", "--engine", "vsrtl", "--cache-sweep",
+                   "lines=1-3;ways=1;blocks=1"},
+                  report),
+           0);
+  const QJsonArray rows = report.value("cache sweep").toArray();
+  QCOMPARE(rows.size(), qsizetype(3));
+
+  // Each configuration of the sweep must report the same statistics as a
+  // cache of that configuration attached to the processor, running the same
+  // program.
+  auto proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+  for (int i = 0; i < rows.size(); ++i) {
+    const QJsonObject row = rows.at(i).toObject();
+    QCOMPARE(row.value("cache").toString(), QString("data"));
+    QCOMPARE(row.value("lines").toInt(), 2 << i);
+    QCOMPARE(row.value("ways").toInt(), 2);
+    QCOMPARE(row.value("blocks").toInt(), 2);
+
+    auto cache = std::make_shared<CacheSim>(nullptr);
+    cache->setPreset({"test", 1, i + 1, 1, WritePolicy::WriteBack,
+                      WriteAllocPolicy::WriteAllocate, ReplPolicy::LRU});
+    L1CacheShim shim(L1CacheShim::CacheType::DataCache, nullptr);
+    shim.setNextLevelCache(cache);
+    RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+    while (!proc->finished() && proc->getCycleCount() < 10000)
+      proc->clock();
+    QVERIFY(proc->finished());
+
+    QCOMPARE(row.value("hits").toInt(), int(cache->getHits()));
+    QCOMPARE(row.value("misses").toInt(), int(cache->getMisses()));
+    QCOMPARE(row.value("writebacks").toInt(), int(cache->getWritebacks()));
+    QVERIFY(cache->getMisses() > 0);
+    QVERIFY(cache->getWritebacks() > 0);
+  }
+}
+
+void tst_cli::tst_cacheSweepSpecErrors() {
+  std::vector<CacheSweepConfig> configs;
+  QString errorMessage;
+  QVERIFY(parseCacheSweepSpec("lines=1,2;ways=0-1;repl=lru,fifo", configs,
+                              errorMessage));
+  QCOMPARE(configs.size(), std::size_t(8));
+
+  for (const QString spec :
+       {"lines", "lines=", "lines=a", "lines=3-1", "lines=1-2-3", "lines=-1",
+        "lines=17", "ways=1;blocks=x", "repl=foo", "wr=wb,foo",
+        "pf=none;size=1", "lines=1=2"}) {
+    errorMessage.clear();
+    QVERIFY2(!parseCacheSweepSpec(spec, configs, errorMessage),
+             qPrintable(spec));
+    QVERIFY2(errorMessage.contains("--cache-sweep"), qPrintable(spec));
+  }
+
+  // Malformed specifications are rejected when parsing the CLI options.
+  QCommandLineParser parser;
+  CLIModeOptions options;
+  addCLIOptions(parser, options);
+  QVERIFY(parser.parse({"ripes", "--src", "program.s", "-t", "asm", "--proc",
+                        "RV32_5S", "--cache-sweep", "lines=a"}));
+  QVERIFY(!parseCLIOptions(parser, errorMessage, options));
+  QVERIFY(errorMessage.contains("'lines'"));
+}
+
+void tst_cli::tst_timeSeries() {
+  QVERIFY(m_dir.isValid());
+  const QStringList columns = {"cycle",
+                               "instructions",
+                               "cpi",
+                               "ipc",
+                               "cumulative cpi",
+                               "dcache accesses",
+                               "dcache hit rate",
+                               "icache accesses",
+                               "icache hit rate",
+                               "stalls",
+                               "flushes",
+                               "forwards",
+                               "dual-issue",
+                               "way-hazards"};
+  const long long interval = 10;
+
+  for (const QString format : {"csv", "jsonl"}) {
+    const QString seriesPath = path("series." + format);
+    QJsonObject report;
+    QCOMPARE(runCLI(s_loadStoreProgram,
+                    {"--proc", "RV32_5S", "--engine", "vsrtl", "--timeseries",
+                     seriesPath, "--timeseries-interval",
+                     QString::number(interval), "--timeseries-format", format,
+                     "--cycles", "--iret", "--stalls", "--flushes",
+                     "--forwards"},
+                    report),
+             0);
+
+    // Read the samples of the time series, keyed by column.
+    QFile file(seriesPath);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QStringList lines =
+        QString(file.readAll()).split('\n', Qt::SkipEmptyParts);
+    std::vector<QVariantMap> samples;
+    if (format == "csv") {
+      QCOMPARE(lines.takeFirst().split(','), columns);
+      for (const auto &line : lines) {
+        const QStringList fields = line.split(',');
+        QCOMPARE(fields.size(), columns.size());
+        QVariantMap sample;
+        for (int i = 0; i < fields.size(); ++i)
+          sample[columns.at(i)] = fields.at(i).isEmpty()
+                                      ? QVariant()
+                                      : QVariant(fields.at(i).toDouble());
+        samples.push_back(sample);
+      }
+    } else {
+      for (const auto &line : lines) {
+        const QJsonObject object =
+            QJsonDocument::fromJson(line.toUtf8()).object();
+        QCOMPARE(object.keys().size(), columns.size());
+        QVariantMap sample;
+        for (const auto &column : columns) {
+          QVERIFY2(object.contains(column), qPrintable(column));
+          sample[column] = object.value(column).toVariant();
+        }
+        samples.push_back(sample);
+      }
+    }
+
+    // One sample per interval, and a final sample of the remaining cycles.
+    const long long cycles = report.value("cycles").toInteger();
+    QVERIFY(cycles > interval);
+    const long long expectedSamples = (cycles + interval - 1) / interval;
+    QCOMPARE(static_cast<long long>(samples.size()), expectedSamples);
+    const QJsonObject seriesReport = report.value("time series").toObject();
+    QCOMPARE(seriesReport.value("samples").toInteger(), expectedSamples);
+    QCOMPARE(samples.back().value("cycle").toLongLong(), cycles);
+
+    // The samples of each interval sum up to the totals of the run.
+    const std::map<QString, QString> totals = {
+        {"instructions", "# instructions retired"},
+        {"stalls", "# data hazard stalls"},
+        {"flushes", "# control flushes"},
+        {"forwards", "# forwarded operands"}};
+    for (const auto &[column, key] : totals) {
+      long long sum = 0;
+      for (const auto &sample : samples)
+        sum += sample.value(column).toLongLong();
+      QCOMPARE(sum, report.value(key).toInteger());
+    }
+    QVERIFY(report.value("# control flushes").toInteger() > 0);
+
+    // The processor does not count dual issue.
+    for (const auto &sample : samples)
+      QVERIFY(!sample.value("dual-issue").isValid() ||
+              sample.value("dual-issue").isNull());
+  }
+}
+
+// Each hart increments 'amo' through an AMO, and 'lrsc' through an LR/SC loop,
+// s_hartIncrements times.
+static constexpr unsigned s_hartIncrements = 1000;
+static const QStringList s_atomicCounterProgram = {
+    ".data",
+    "amo: .word 0",
+    "lrsc: .word 0",
+    ".text",
+    "la a1 amo",
+    "la a2 lrsc",
+    "li t0 " + QString::number(s_hartIncrements),
+    "li t1 1",
+    "loop:",
+    "amoadd.w zero, t1, (a1)",
+    "retry:",
+    "lr.w t2, (a2)",
+    "addi t2 t2 1",
+    "sc.w t3, t2, (a2)",
+    "bnez t3 retry",
+    "addi t0 t0 -1",
+    "bnez t0 loop"};
+
+void tst_cli::tst_harts() {
+  QVERIFY(m_dir.isValid());
+  const unsigned harts = 4;
+
+  // Harts run both unsynchronized, and synchronized at a small quantum.
+  for (const QString quantum : {"0", "100"}) {
+    QJsonObject report;
+    QCOMPARE(runCLI(s_atomicCounterProgram,
+                    {"--proc", "RV32_SS", "--isaexts", "M,A", "--engine",
+                     "interpreter", "--harts", QString::number(harts),
+                     "--hart-quantum", quantum, "--timeout", "60000"},
+                    report),
+             0);
+
+    // Every hart finished after executing all of its increments.
+    const QJsonObject hartsReport = report.value("harts").toObject();
+    QCOMPARE(hartsReport.value("quantum").toInteger(), quantum.toLongLong());
+    for (unsigned hartId = 0; hartId < harts; ++hartId) {
+      const QJsonObject hart =
+          hartsReport.value("hart " + QString::number(hartId)).toObject();
+      QVERIFY2(hart.value("instructions retired").toInteger() >=
+                   7 * s_hartIncrements,
+               qPrintable(quantum));
+    }
+
+    // No increment was lost.
+    std::map<QString, AInt> counters;
+    for (const auto &[address, symbol] :
+         ProcessorHandler::getProgram()->symbols)
+      counters[symbol.v] = address;
+    for (const QString counter : {"amo", "lrsc"})
+      QCOMPARE(ProcessorHandler::getMemory().readMemConst(counters.at(counter),
+                                                          4),
+               VInt(harts * s_hartIncrements));
+  }
+}
+
+QTEST_MAIN(tst_cli)
+#include "tst_cli.moc"
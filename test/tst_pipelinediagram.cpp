@@ -0,0 +1,85 @@
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "pipelinediagrammodel.h"
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+// This test ensures that the pipeline diagram keeps the most recent cycles of
+// execution, also when the processor is reversed, and that its viewport shows
+// the recorded cycles.
+
+class tst_pipelinediagram : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_ringBuffer();
+};
+
+static const QStringList s_program = {"li a0 0",       "loop:",
+                                      "addi a0 a0 1",  "li t0 10",
+                                      "blt a0 t0 loop", "li a1 1"};
+
+void tst_pipelinediagram::tst_ringBuffer() {
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_5S, {});
+  ProgramLoader loader;
+  loader.loadTest(s_program.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+
+  constexpr unsigned ringCycles = 8;
+  RipesSettings::setValue(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES, 1000);
+  PipelineDiagramModel fullModel;
+  RipesSettings::setValue(RIPES_SETTING_PIPEDIAGRAM_MAXCYCLES, ringCycles);
+  PipelineDiagramModel ringModel;
+
+  for (unsigned i = 0; i < 20; ++i)
+    proc->clock();
+  for (unsigned i = 0; i < 3; ++i)
+    proc->reverseProcessor();
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  QVERIFY(proc->finished());
+
+  const long long lastCycle = proc->getCycleCount();
+  QCOMPARE(fullModel.firstCycle(), 0LL);
+  QCOMPARE(fullModel.recordedCycles(), lastCycle + 1);
+  QCOMPARE(ringModel.recordedCycles(), static_cast<long long>(ringCycles));
+  QCOMPARE(ringModel.firstCycle(),
+           lastCycle + 1 - static_cast<long long>(ringCycles));
+
+  fullModel.setViewport(ringModel.firstCycle(), ringCycles);
+  ringModel.setViewport(0, ringCycles);
+  QCOMPARE(ringModel.viewportFirstCycle(), ringModel.firstCycle());
+  QCOMPARE(ringModel.columnCount(), int(ringCycles));
+
+  // The first recorded cycle of the ring cannot tell whether an instruction
+  // remained in its stage, so cells are compared from the second cycle.
+  for (int row = 0; row < ringModel.rowCount(); ++row) {
+    for (int col = 1; col < ringModel.columnCount(); ++col) {
+      QCOMPARE(ringModel.data(ringModel.index(row, col)),
+               fullModel.data(fullModel.index(row, col)));
+    }
+  }
+
+  // Moving the viewport past the recorded cycles keeps it full.
+  ringModel.setViewport(lastCycle, ringCycles);
+  QCOMPARE(ringModel.viewportFirstCycle(), ringModel.firstCycle());
+
+  QString textualRepr;
+  QTextStream stream(&textualRepr);
+  ringModel.toString(stream);
+  stream.flush();
+  const QStringList lines = textualRepr.split('\n', Qt::SkipEmptyParts);
+  QCOMPARE(lines.size(), ringModel.rowCount() + 1);
+  QCOMPARE(lines.front().split('\t', Qt::SkipEmptyParts).front(),
+           QString::number(ringModel.firstCycle()));
+}
+
+QTEST_MAIN(tst_pipelinediagram)
+#include "tst_pipelinediagram.moc"
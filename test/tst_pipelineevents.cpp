@@ -0,0 +1,110 @@
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "programloader.h"
+#include "ripessettings.h"
+
+using namespace Ripes;
+
+// This test ensures that the pipeline events counted by the processors are
+// consistent with the executed program, also when reversing.
+
+class tst_pipelineevents : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_reverse();
+  void tst_fiveStage();
+  void tst_dualIssue();
+};
+
+using PipelineEvent = RipesProcessor::PipelineEvent;
+
+// The loop branches back 9 times, and the final load is followed by a use of
+// the loaded register.
+static const QStringList s_program = {"li a0 0",
+                                      "loop:",
+                                      "addi a0 a0 1",
+                                      "li t0 10",
+                                      "blt a0 t0 loop",
+                                      "li a1 1",
+                                      "sw a0 0(sp)",
+                                      "lw t1 0(sp)",
+                                      "add t2 t1 t1"};
+
+static RipesProcessor *runProgram(ProcessorID id, const QStringList &program) {
+  ProcessorHandler::selectProcessor(id, {});
+  ProgramLoader loader;
+  loader.loadTest(program.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  if (!proc->finished())
+    QTest::qFail("Execution never finished", __FILE__, __LINE__);
+  return proc;
+}
+
+static std::vector<std::optional<long long>>
+pipelineEventCounts(const RipesProcessor *proc) {
+  std::vector<std::optional<long long>> counts;
+  for (unsigned i = 0; i < static_cast<unsigned>(PipelineEvent::NEvents); ++i)
+    counts.push_back(proc->pipelineEventCount(static_cast<PipelineEvent>(i)));
+  return counts;
+}
+
+void tst_pipelineevents::tst_reverse() {
+  for (const auto id : {ProcessorID::RV32_5S, ProcessorID::RV32_5S_NO_FW,
+                        ProcessorID::RV32_5S_NO_HZ,
+                        ProcessorID::RV32_5S_NO_FW_HZ,
+                        ProcessorID::RV32_6S_DUAL}) {
+    auto *proc = runProgram(id, s_program);
+    const auto counts = pipelineEventCounts(proc);
+
+    // Reversing un-counts the events of the reversed cycles.
+    for (unsigned i = 0; i < 10; ++i)
+      proc->reverseProcessor();
+    while (!proc->finished())
+      proc->clock();
+    QVERIFY(pipelineEventCounts(proc) == counts);
+
+    // Events are reported by the processors which implement them.
+    QVERIFY(proc->pipelineEventCount(PipelineEvent::ControlFlush).has_value());
+    const auto forwards = proc->pipelineEventCount(PipelineEvent::Forward);
+    QCOMPARE(forwards.has_value(), id != ProcessorID::RV32_5S_NO_FW &&
+                                       id != ProcessorID::RV32_5S_NO_FW_HZ);
+    if (forwards)
+      QVERIFY(*forwards > 0);
+    const auto dualIssue = proc->pipelineEventCount(PipelineEvent::DualIssue);
+    QCOMPARE(dualIssue.has_value(), id == ProcessorID::RV32_6S_DUAL);
+  }
+}
+
+void tst_pipelineevents::tst_fiveStage() {
+  auto *proc = runProgram(ProcessorID::RV32_5S, s_program);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::ControlFlush) == 9);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::DataHazardStall) == 1);
+  QVERIFY(!proc->pipelineEventCount(PipelineEvent::DualIssue));
+  QVERIFY(!proc->pipelineEventCount(PipelineEvent::WayHazard));
+}
+
+void tst_pipelineevents::tst_dualIssue() {
+  // Instructions are fetched in pairs. The first pair is an independent
+  // arithmetic instruction and store, and is issued in both ways. The second
+  // pair has a read-after-write dependency, and is split by the way control.
+  const QStringList program = {"addi a0 zero 1", "sw zero 0(sp)",
+                               "addi a1 a0 1", "addi a2 a1 1"};
+  auto *proc = runProgram(ProcessorID::RV32_6S_DUAL, program);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::DualIssue) == 1);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::WayHazard) == 1);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::ControlFlush) == 0);
+  QVERIFY(proc->pipelineEventCount(PipelineEvent::DataHazardStall) == 0);
+  QCOMPARE(ProcessorHandler::getRegisterValue(RVISA::GPR, 12), VInt(3));
+}
+
+QTEST_MAIN(tst_pipelineevents)
+#include "tst_pipelineevents.moc"
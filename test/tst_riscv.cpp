@@ -10,7 +10,8 @@
 #include "systemio.h"
 
 #if !defined(RISCV32_TEST_DIR) || !defined(RISCV64_TEST_DIR) ||                \
-    !defined(RISCV32_C_TEST_DIR) || !defined(RISCV64_C_TEST_DIR)
+    !defined(RISCV32_C_TEST_DIR) || !defined(RISCV64_C_TEST_DIR) ||            \
+    !defined(RISCV32_A_TEST_DIR) || !defined(RISCV64_A_TEST_DIR)
 static_assert(false, "RISCV test directiories must be defined");
 #endif
 
@@ -59,33 +60,65 @@ private:
                 const QStringList &testdirs);
 
   void trapHandler();
+  void installTrapHandler();
+
+  // If set, the state of the processor is transferred into processor
+  // m_switchTo once m_switchCycle cycles have been executed.
+  unsigned m_switchCycle = 0;
+  ProcessorID m_switchTo;
+  QStringList m_switchExtensions;
 
   bool m_stop = false;
   std::shared_ptr<Program> m_program;
   QString m_err;
 
 private slots:
+  void cleanup() {
+    ProcessorHandler::setPreferInterpreter(false);
+    m_switchCycle = 0;
+  }
 
   void testRV64_SingleCycle() {
-    runTests(ProcessorID::RV64_SS, {"M", "C"},
-             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+    runTests(ProcessorID::RV64_SS, {"M", "A", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR, RISCV64_A_TEST_DIR});
+  }
+  void testRV64_Interpreter() {
+    ProcessorHandler::setPreferInterpreter(true);
+    runTests(ProcessorID::RV64_SS, {"M", "A", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR, RISCV64_A_TEST_DIR});
   }
   void testRV64_5StagePipeline() {
-    runTests(ProcessorID::RV64_5S, {"M", "C"},
-             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+    runTests(ProcessorID::RV64_5S, {"M", "A", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR, RISCV64_A_TEST_DIR});
   }
   void testRV64_5StagePipelineNOFW() {
-    runTests(ProcessorID::RV64_5S_NO_FW, {"M", "C"},
-             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+    runTests(ProcessorID::RV64_5S_NO_FW, {"M", "A", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR, RISCV64_A_TEST_DIR});
   }
   void testRV64_6SDual() {
-    runTests(ProcessorID::RV64_6S_DUAL, {"M", "C"},
-             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR});
+    runTests(ProcessorID::RV64_6S_DUAL, {"M", "A", "C"},
+             {RISCV64_TEST_DIR, RISCV64_C_TEST_DIR, RISCV64_A_TEST_DIR});
   }
 
   void testRV32_SingleCycle() {
-    runTests(ProcessorID::RV32_SS, {"M", "C"},
-             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+    runTests(ProcessorID::RV32_SS, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
+  }
+
+  void testRV32_Interpreter() {
+    ProcessorHandler::setPreferInterpreter(true);
+    runTests(ProcessorID::RV32_SS, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
+  }
+
+  void testRV32_InterpreterTo5StagePipeline() {
+    // Start out on the interpreter, and continue on the pipeline.
+    ProcessorHandler::setPreferInterpreter(true);
+    m_switchCycle = 100;
+    m_switchTo = ProcessorID::RV32_5S;
+    m_switchExtensions = {"M", "A", "C"};
+    runTests(ProcessorID::RV32_SS, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
   }
 
   void testRV32_SingleCycle_traps() {
@@ -94,16 +127,16 @@ private slots:
   }
 
   void testRV32_5StagePipeline() {
-    runTests(ProcessorID::RV32_5S, {"M", "C"},
-             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+    runTests(ProcessorID::RV32_5S, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
   }
   void testRV32_5StagePipelineNOFW() {
-    runTests(ProcessorID::RV32_5S_NO_FW, {"M", "C"},
-             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+    runTests(ProcessorID::RV32_5S_NO_FW, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
   }
   void testRV32_6SDual() {
-    runTests(ProcessorID::RV32_6S_DUAL, {"M", "C"},
-             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR});
+    runTests(ProcessorID::RV32_6S_DUAL, {"M", "A", "C"},
+             {RISCV32_TEST_DIR, RISCV32_C_TEST_DIR, RISCV32_A_TEST_DIR});
   }
 };
 
@@ -164,6 +197,22 @@ void tst_RISCV::trapHandler() {
   m_stop |= true;
 }
 
+void tst_RISCV::installTrapHandler() {
+  // Override the ProcessorHandler's ECALL Exit2 handling. In doing so, we
+  // verify whether the correct test value was reached.
+  ProcessorHandler::getProcessorNonConst()->trapHandler = [=] {
+    if (ProcessorHandler::getProcessor()->getRegister(
+            RVISA::GPR, s_ecallopreg) == RVABI::Exit2) {
+      trapHandler();
+    } else {
+      const unsigned int function =
+          ProcessorHandler::getProcessor()->getRegister(RVISA::GPR,
+                                                        s_ecallopreg);
+      ProcessorHandler::getSyscallManagerNonConst().execute(function);
+    }
+  };
+}
+
 QString tst_RISCV::executeSimulator() {
   m_stop = false;
   m_err = QString();
@@ -174,6 +223,13 @@ QString tst_RISCV::executeSimulator() {
 
     cycles++;
 
+    if (cycles == m_switchCycle && !m_stop) {
+      if (!ProcessorHandler::switchProcessor(m_switchTo, m_switchExtensions))
+        return "Test: '" + m_currentTest +
+               "' failed: Could not switch processor.";
+      installTrapHandler();
+    }
+
     maxCyclesReached |= cycles >= s_maxCycles;
     m_stop |= maxCyclesReached;
   } while (!m_stop);
@@ -220,19 +276,11 @@ void tst_RISCV::runTests(const ProcessorID &id, const QStringList &extensions,
       }
       auto spProgram = std::make_shared<Program>(program.program);
 
-      // Override the ProcessorHandler's ECALL Exit2 handling. In doing so, we
-      // verify whether the correct test value was reached.
-      ProcessorHandler::getProcessorNonConst()->trapHandler = [=] {
-        if (ProcessorHandler::getProcessor()->getRegister(
-                RVISA::GPR, s_ecallopreg) == RVABI::Exit2) {
-          trapHandler();
-        } else {
-          const unsigned int function =
-              ProcessorHandler::getProcessor()->getRegister(RVISA::GPR,
-                                                            s_ecallopreg);
-          ProcessorHandler::getSyscallManagerNonConst().execute(function);
-        }
-      };
+      // A previous test may have switched to another processor.
+      if (m_switchCycle != 0)
+        ProcessorHandler::selectProcessor(id, extensions);
+
+      installTrapHandler();
       ProcessorHandler::get()->loadProgram(spProgram);
       RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
 
@@ -0,0 +1,143 @@
+#include <QtTest/QTest>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "processors/interface/processorsnapshot.h"
+#include "programloader.h"
+#include "ripessettings.h"
+#include "triplebuffer.h"
+
+using namespace Ripes;
+
+// This test ensures that the triple buffer hands the most recently published
+// buffer to the reader without the writer touching the buffer being read, and
+// that processor snapshots capture exactly the requested memory pages.
+
+class tst_snapshot : public QObject {
+  Q_OBJECT
+
+private slots:
+  void tst_tripleBuffer();
+  void tst_pagesFor();
+  void tst_capture();
+};
+
+void tst_snapshot::tst_tripleBuffer() {
+  TripleBuffer<int> buffer;
+
+  // Nothing has been published yet.
+  QVERIFY(!buffer.fetch());
+
+  buffer.back() = 1;
+  buffer.publish();
+  QVERIFY(buffer.fetch());
+  QCOMPARE(buffer.front(), 1);
+  // A stale fetch leaves the front buffer unchanged.
+  QVERIFY(!buffer.fetch());
+  QCOMPARE(buffer.front(), 1);
+
+  // Buffers published in between fetches are dropped; the reader fetches the
+  // most recent one.
+  buffer.back() = 2;
+  buffer.publish();
+  buffer.back() = 3;
+  buffer.publish();
+  QVERIFY(buffer.fetch());
+  QCOMPARE(buffer.front(), 3);
+  QVERIFY(!buffer.fetch());
+
+  // However often the writer publishes, it never writes the front buffer.
+  for (int i = 4; i < 20; ++i) {
+    QVERIFY(&buffer.back() != &buffer.front());
+    buffer.back() = i;
+    buffer.publish();
+    QCOMPARE(buffer.front(), 3);
+  }
+  QVERIFY(buffer.fetch());
+  QCOMPARE(buffer.front(), 19);
+
+  // Alternating publishes and fetches hands over every buffer, in order.
+  for (int i = 20; i < 30; ++i) {
+    buffer.back() = i;
+    buffer.publish();
+    QVERIFY(buffer.fetch());
+    QCOMPARE(buffer.front(), i);
+  }
+}
+
+void tst_snapshot::tst_pagesFor() {
+  constexpr AInt pageBytes = ProcessorSnapshot::s_pageBytes;
+  std::set<AInt> indices;
+  ProcessorSnapshot::pagesFor(pageBytes, 0, indices);
+  QVERIFY(indices.empty());
+
+  ProcessorSnapshot::pagesFor(pageBytes - 1, 1, indices);
+  QCOMPARE(indices, std::set<AInt>({0}));
+
+  indices.clear();
+  ProcessorSnapshot::pagesFor(pageBytes, pageBytes, indices);
+  QCOMPARE(indices, std::set<AInt>({1}));
+
+  // A range crossing a page boundary covers both pages.
+  indices.clear();
+  ProcessorSnapshot::pagesFor(2 * pageBytes - 2, 4, indices);
+  QCOMPARE(indices, std::set<AInt>({1, 2}));
+}
+
+void tst_snapshot::tst_capture() {
+  constexpr AInt pageBytes = ProcessorSnapshot::s_pageBytes;
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_SS, {});
+  ProgramLoader loader;
+  loader.loadTest(QStringList({".data", "pad: .zero 254",
+                               "b: .byte 1, 2, 3, 4", ".text", "nop"})
+                      .join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+  proc->clock();
+
+  AInt b = 0;
+  for (const auto &[address, symbol] : ProcessorHandler::getProgram()->symbols)
+    if (symbol.v == "b")
+      b = address;
+  // The bytes of 'b' straddle two pages.
+  QCOMPARE(b % pageBytes, pageBytes - 2);
+
+  // A page far from the program, which is not present in memory.
+  const AInt unused = b + 0x100000;
+  QVERIFY(!proc->getMemory().contains(unused));
+
+  std::set<AInt> indices;
+  ProcessorSnapshot::pagesFor(b, 4, indices);
+  ProcessorSnapshot::pagesFor(unused, 1, indices);
+  ProcessorSnapshot snapshot;
+  snapshot.capture(*proc, indices);
+  QCOMPARE(snapshot.cycleCount, proc->getCycleCount());
+  QCOMPARE(snapshot.pages.size(), std::size_t(3));
+
+  uint8_t value = 0;
+  for (unsigned i = 0; i < 4; ++i) {
+    QVERIFY(snapshot.readByte(b + i, value));
+    QCOMPARE(value, uint8_t(i + 1));
+  }
+  // Bytes which are not present in memory are captured as such, without being
+  // allocated in memory.
+  QVERIFY(!snapshot.readByte(unused, value));
+  QVERIFY(!proc->getMemory().contains(unused));
+  // Bytes outside of the captured pages are not part of the snapshot.
+  QVERIFY(!snapshot.readByte(b + 2 * pageBytes, value));
+
+  // Recapturing drops the pages which are no longer requested.
+  indices.clear();
+  ProcessorSnapshot::pagesFor(b, 1, indices);
+  snapshot.capture(*proc, indices);
+  QCOMPARE(snapshot.pages.size(), std::size_t(1));
+  QVERIFY(snapshot.readByte(b + 1, value));
+  QCOMPARE(value, uint8_t(2));
+  QVERIFY(!snapshot.readByte(b + 2, value));
+  QVERIFY(!snapshot.readByte(unused, value));
+}
+
+QTEST_MAIN(tst_snapshot)
+#include "tst_snapshot.moc"
@@ -0,0 +1,336 @@
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+#include "processorhandler.h"
+#include "processorregistry.h"
+
+#include "isa/rvisainfo_common.h"
+#include "programloader.h"
+#include "ripessettings.h"
+#include "trace/blockcompression.h"
+#include "trace/tracereader.h"
+#include "trace/tracerecorder.h"
+#include "trace/tracereplayer.h"
+
+using namespace Ripes;
+
+// This test ensures that execution traces are read back exactly as they were
+// written, and that a recorded trace follows the execution of the processor.
+// Furthermore, it ensures that the interpreter reports the same data memory
+// accesses as the VSRTL models, which traces are recorded from.
+
+class tst_trace : public QObject {
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void tst_blockCompression();
+  void tst_roundtrip_data();
+  void tst_roundtrip();
+  void tst_truncated();
+  void tst_record();
+  void tst_replay();
+  void tst_atomicAccesses();
+
+private:
+  /// Records the execution of s_program on the 5-stage processor.
+  void recordProgram();
+  QString tracePath() const { return m_dir.filePath("trace.bin"); }
+
+  QTemporaryDir m_dir;
+};
+
+static const QStringList s_program = {".data",
+                                      "a: .word 0",
+                                      ".text",
+                                      "li a0 0",
+                                      "la a1 a",
+                                      "loop:",
+                                      "addi a0 a0 1",
+                                      "sw a0 0 a1",
+                                      "li t0 10",
+                                      "blt a0 t0 loop",
+                                      "li a2 1"};
+
+/// Generates a pseudo-random cycle resembling the execution of a pipeline with
+/// the stages of @p info.
+static TraceCycle makeCycle(const TraceInfo &info, uint64_t i) {
+  TraceCycle cycle;
+  // Cycles are occasionally skipped, as when a processor is reversed.
+  cycle.cycle = i + (i / 1000) * 7;
+  cycle.fetched = i % 5 != 0;
+  cycle.fetchPC = 0x1000 + (i % 64) * 4;
+  cycle.instruction = static_cast<uint32_t>(i * 2654435761u);
+  if (i % 3 == 0)
+    cycle.dataAccess = {i % 2 ? MemoryAccess::Read : MemoryAccess::Write,
+                        0x10000000 + (i % 256) * 4, 4, cycle.fetchPC - 12};
+  if (i % 2 == 0)
+    cycle.regWrites.push_back({0, static_cast<uint8_t>(i % 32), i * 3 - 100});
+  for (unsigned stage = 0; stage < info.numStages(); ++stage)
+    cycle.stages.push_back({cycle.fetchPC - stage * 4, stage != i % 7,
+                            static_cast<StageInfo::State>(i % 5)});
+  return cycle;
+}
+
+static bool equal(const TraceCycle &a, const TraceCycle &b) {
+  if (a.cycle != b.cycle || a.fetched != b.fetched ||
+      a.dataAccess.type != b.dataAccess.type ||
+      a.regWrites.size() != b.regWrites.size() ||
+      a.stages.size() != b.stages.size())
+    return false;
+  if (a.fetched &&
+      (a.fetchPC != b.fetchPC || a.instruction != b.instruction))
+    return false;
+  if (a.dataAccess.type != MemoryAccess::None &&
+      (a.dataAccess.address != b.dataAccess.address ||
+       a.dataAccess.bytes != b.dataAccess.bytes ||
+       a.dataAccess.pc != b.dataAccess.pc))
+    return false;
+  for (unsigned i = 0; i < a.regWrites.size(); ++i)
+    if (a.regWrites[i].regFile != b.regWrites[i].regFile ||
+        a.regWrites[i].index != b.regWrites[i].index ||
+        a.regWrites[i].value != b.regWrites[i].value)
+      return false;
+  for (unsigned i = 0; i < a.stages.size(); ++i)
+    if (a.stages[i].pc != b.stages[i].pc ||
+        a.stages[i].valid != b.stages[i].valid ||
+        a.stages[i].state != b.stages[i].state)
+      return false;
+  return true;
+}
+
+void tst_trace::initTestCase() { QVERIFY(m_dir.isValid()); }
+
+void tst_trace::tst_blockCompression() {
+  std::vector<uint8_t> data;
+  for (unsigned i = 0; i < 100000; ++i)
+    data.push_back(i % 1000 < 500 ? (i * 7) % 13 : (i * 2654435761u) >> 24);
+
+  std::vector<uint8_t> compressed;
+  BlockCompression::compress(data.data(), data.size(), compressed);
+  QVERIFY(compressed.size() < data.size());
+
+  std::vector<uint8_t> decompressed(data.size());
+  QVERIFY(BlockCompression::decompress(compressed.data(), compressed.size(),
+                                       decompressed.data(), data.size()));
+  QVERIFY(decompressed == data);
+
+  // A corrupted stream must be rejected rather than overrun the buffer.
+  QVERIFY(!BlockCompression::decompress(compressed.data(),
+                                        compressed.size() / 2,
+                                        decompressed.data(), data.size()));
+}
+
+void tst_trace::tst_roundtrip_data() {
+  QTest::addColumn<bool>("compress");
+  QTest::addColumn<std::vector<unsigned>>("lanes");
+  QTest::newRow("single lane") << false << std::vector<unsigned>{5};
+  QTest::newRow("single lane, compressed")
+      << true << std::vector<unsigned>{5};
+  QTest::newRow("dual lane, compressed")
+      << true << std::vector<unsigned>{3, 3};
+  QTest::newRow("no stages") << false << std::vector<unsigned>{};
+}
+
+void tst_trace::tst_roundtrip() {
+  QFETCH(bool, compress);
+  QFETCH(std::vector<unsigned>, lanes);
+
+  TraceInfo info;
+  info.processor = "RV32_5S";
+  info.lanes = lanes;
+  info.regFiles = {"gpr"};
+  info.bits = 64;
+  info.instrBytes = 2;
+  constexpr unsigned cycles = 20000;
+
+  // Small blocks and a small ring, such that the writer thread must keep up
+  // with the recording.
+  TraceWriter::Options options;
+  options.compress = compress;
+  options.blockBytes = 4096;
+  options.ringBlocks = 2;
+  TraceWriter writer;
+  QString errorMessage;
+  QVERIFY2(writer.open(tracePath(), info, options, errorMessage),
+           qPrintable(errorMessage));
+  for (unsigned i = 0; i < cycles; ++i)
+    writer.append(makeCycle(info, i));
+  QVERIFY2(writer.close(errorMessage), qPrintable(errorMessage));
+  QCOMPARE(writer.stats().cycles, uint64_t(cycles));
+  QCOMPARE(writer.stats().fileBytes,
+           uint64_t(QFileInfo(tracePath()).size()));
+
+  TraceReader reader;
+  QVERIFY2(reader.open(tracePath(), errorMessage), qPrintable(errorMessage));
+  QCOMPARE(reader.info().processor, info.processor);
+  QVERIFY(reader.info().lanes == info.lanes);
+  QVERIFY(reader.info().regFiles == info.regFiles);
+  QCOMPARE(reader.info().bits, info.bits);
+  QCOMPARE(reader.info().instrBytes, info.instrBytes);
+  QCOMPARE(reader.info().compressed, compress);
+
+  // Read the trace twice to verify that rewinding restarts the trace.
+  for (unsigned pass = 0; pass < 2; ++pass) {
+    TraceCycle cycle;
+    unsigned i = 0;
+    for (; reader.next(cycle); ++i)
+      QVERIFY2(equal(cycle, makeCycle(info, i)),
+               qPrintable("Cycle " + QString::number(i) + " differs"));
+    QVERIFY2(reader.error().isEmpty(), qPrintable(reader.error()));
+    QCOMPARE(i, cycles);
+    reader.rewind();
+  }
+}
+
+void tst_trace::tst_truncated() {
+  TraceInfo info;
+  info.lanes = {5};
+  TraceWriter writer;
+  QString errorMessage;
+  QVERIFY(writer.open(tracePath(), info, {}, errorMessage));
+  for (unsigned i = 0; i < 1000; ++i)
+    writer.append(makeCycle(info, i));
+  QVERIFY(writer.close(errorMessage));
+
+  QFile file(tracePath());
+  QVERIFY(file.resize(file.size() - 10));
+  TraceReader reader;
+  QVERIFY(reader.open(tracePath(), errorMessage));
+  TraceCycle cycle;
+  while (reader.next(cycle))
+    ;
+  QCOMPARE(reader.error(), "Truncated trace block.");
+}
+
+void tst_trace::recordProgram() {
+  ProcessorHandler::selectProcessor(ProcessorID::RV32_5S, {});
+  ProgramLoader loader;
+  loader.loadTest(s_program.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+
+  TraceRecorder recorder(tracePath(), {});
+  while (!proc->finished() && proc->getCycleCount() < 1000)
+    proc->clock();
+  QString errorMessage;
+  QVERIFY2(recorder.finish(errorMessage), qPrintable(errorMessage));
+  QCOMPARE(recorder.stats().cycles, uint64_t(proc->getCycleCount() + 1));
+}
+
+void tst_trace::tst_record() {
+  recordProgram();
+  const auto *proc = ProcessorHandler::getProcessor();
+
+  QString errorMessage;
+  TraceReader reader;
+  QVERIFY2(reader.open(tracePath(), errorMessage), qPrintable(errorMessage));
+  QVERIFY(reader.info().lanes == std::vector<unsigned>{5});
+
+  TraceCycle cycle;
+  uint64_t expectedCycle = 0, stores = 0;
+  VInt a0 = 0;
+  const auto &regFiles = reader.info().regFiles;
+  const unsigned gpr =
+      std::find(regFiles.begin(), regFiles.end(),
+                QString::fromUtf8(RVISA::GPR.data(), RVISA::GPR.size())) -
+      regFiles.begin();
+  while (reader.next(cycle)) {
+    QCOMPARE(cycle.cycle, expectedCycle++);
+    QCOMPARE(cycle.stages.size(), size_t(5));
+    if (cycle.dataAccess.type == MemoryAccess::Write)
+      ++stores;
+    for (const auto &write : cycle.regWrites)
+      if (write.regFile == gpr && write.index == 10)
+        a0 = write.value;
+  }
+  QVERIFY2(reader.error().isEmpty(), qPrintable(reader.error()));
+  QCOMPARE(expectedCycle, uint64_t(proc->getCycleCount() + 1));
+  QCOMPARE(stores, uint64_t(10));
+  QCOMPARE(a0, VInt(10));
+}
+
+void tst_trace::tst_replay() {
+  recordProgram();
+
+  QString errorMessage;
+  TraceReader reader;
+  QVERIFY2(reader.open(tracePath(), errorMessage), qPrintable(errorMessage));
+  QCOMPARE(reader.info().bits, 32u);
+
+  CacheSim cache(reader.info().bits);
+  BranchPredictor notTaken({BranchPredictorType::NotTaken});
+  BranchPredictor taken({BranchPredictorType::Taken});
+  TraceReplayer replayer;
+  replayer.addDataCache(&cache);
+  replayer.addPredictor(&notTaken);
+  replayer.addPredictor(&taken);
+  std::atomic<bool> abort = false;
+  QVERIFY2(replayer.replay(reader, abort, errorMessage),
+           qPrintable(errorMessage));
+
+  // The loop stores to the same word in each of its 10 iterations.
+  QCOMPARE(replayer.stats().dataAccesses, uint64_t(10));
+  QCOMPARE(cache.getMisses(), 1u);
+  QCOMPARE(cache.getHits(), 9u);
+
+  // The loop branch is taken in all but the last iteration.
+  QCOMPARE(replayer.stats().branches, uint64_t(10));
+  QCOMPARE(notTaken.branches(), uint64_t(10));
+  QCOMPARE(notTaken.mispredictions(), uint64_t(9));
+  QCOMPARE(taken.mispredictions(), uint64_t(1));
+}
+
+static const QStringList s_atomicProgram = {".data",
+                                            "a: .word 5",
+                                            ".text",
+                                            "la a1 a",
+                                            "li a2 3",
+                                            "lr.w a0, (a1)",
+                                            "sc.w a3, a2, (a1)",
+                                            "amoadd.w a0, a2, (a1)",
+                                            "amoswap.w.aqrl a0, a2, (a1)",
+                                            "lr.w.aq a0, (a1)",
+                                            "amomaxu.w a0, a3, (a1)",
+                                            "lw a4 0 a1"};
+
+/// Returns the addresses of the data memory accesses of s_atomicProgram on
+/// processor @p id, in the order of execution.
+static std::vector<AInt> atomicProgramAccesses(ProcessorID id,
+                                               bool interpreter) {
+  ProcessorHandler::setPreferInterpreter(interpreter);
+  ProcessorHandler::selectProcessor(id, {"M", "A"});
+  ProcessorHandler::setPreferInterpreter(false);
+  ProgramLoader loader;
+  loader.loadTest(s_atomicProgram.join("\n"));
+  RipesSettings::getObserver(RIPES_GLOBALSIGNAL_REQRESET)->trigger();
+  auto *proc = ProcessorHandler::getProcessorNonConst();
+  proc->trapHandler = [] {};
+
+  std::vector<AInt> addresses;
+  while (!proc->finished() && proc->getCycleCount() < 1000) {
+    const auto access = proc->dataMemAccess();
+    if (access.type != MemoryAccess::None)
+      addresses.push_back(access.address);
+    proc->clock();
+  }
+  return addresses;
+}
+
+void tst_trace::tst_atomicAccesses() {
+  const auto interpreted = atomicProgramAccesses(ProcessorID::RV32_SS, true);
+  const auto pipelined = atomicProgramAccesses(ProcessorID::RV32_5S, false);
+  QCOMPARE(interpreted.size(), size_t(7));
+  QVERIFY(interpreted == pipelined);
+
+  // All accesses address the word 'a', which is loaded by the final lw.
+  for (const AInt address : interpreted)
+    QCOMPARE(address, interpreted.back());
+}
+
+QTEST_MAIN(tst_trace)
+#include "tst_trace.moc"